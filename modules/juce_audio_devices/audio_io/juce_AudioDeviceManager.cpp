@@ -810,6 +810,7 @@ void AudioDeviceManager::audioDeviceIOCallbackInt (const float** inputChannelDat
                                                    int numOutputChannels,
                                                    int numSamples)
 {
+    JUCE_TRACE_SCOPE ("AudioDeviceManager::audioDeviceIOCallback");
     const ScopedLock sl (audioCallbackLock);
 
     inputLevelGetter->updateLevel (inputChannelData, numInputChannels, numSamples);
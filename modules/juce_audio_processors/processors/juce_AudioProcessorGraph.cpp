@@ -45,9 +45,11 @@ struct GraphRenderSequence
         MidiBuffer* midiBuffers;
         AudioPlayHead* audioPlayHead;
         int numSamples;
+        int64 blockDurationTicks;   // zero if the nodes aren't being timed
     };
 
-    void perform (AudioBuffer<FloatType>& buffer, MidiBuffer& midiMessages, AudioPlayHead* audioPlayHead)
+    void perform (AudioBuffer<FloatType>& buffer, MidiBuffer& midiMessages, AudioPlayHead* audioPlayHead,
+                  double nodeTimingSampleRate)
     {
         auto numSamples = buffer.getNumSamples();
         auto maxSamples = renderingBuffer.getNumSamples();
@@ -64,7 +66,7 @@ struct GraphRenderSequence
                 midiChunk.clear();
                 midiChunk.addEvents (midiMessages, chunkStartSample, chunkSize, -chunkStartSample);
 
-                perform (audioChunk, midiChunk, audioPlayHead);
+                perform (audioChunk, midiChunk, audioPlayHead, nodeTimingSampleRate);
 
                 chunkStartSample += maxSamples;
             }
@@ -79,7 +81,14 @@ struct GraphRenderSequence
         currentMidiOutputBuffer.clear();
 
         {
-            const Context context { renderingBuffer.getArrayOfWritePointers(), midiBuffers.begin(), audioPlayHead, numSamples };
+            int64 blockDurationTicks = 0;
+
+            if (nodeTimingSampleRate > 0)
+                blockDurationTicks = jmax ((int64) 1, (int64) ((double) numSamples * (double) Time::getHighResolutionTicksPerSecond()
+                                                                 / nodeTimingSampleRate));
+
+            const Context context { renderingBuffer.getArrayOfWritePointers(), midiBuffers.begin(), audioPlayHead,
+                                    numSamples, blockDurationTicks };
 
             for (auto* op : renderOps)
                 op->perform (context);
@@ -128,9 +137,10 @@ struct GraphRenderSequence
                                                                                  0, c.numSamples, 0); });
     }
 
-    void addDelayChannelOp (int chan, int delaySize)
+    size_t addDelayChannelOp (int chan, int delaySize)
     {
         renderOps.add (new DelayChannelOp (chan, delaySize));
+        return (size_t) (delaySize + 1) * sizeof (FloatType);
     }
 
     void addProcessOp (const AudioProcessorGraph::Node::Ptr& node,
@@ -250,6 +260,7 @@ private:
                    int totalNumChans, int midiBuffer)
             : node (n),
               processor (*n->getProcessor()),
+              traceName (Tracer::getPersistentName (processor.getName())),
               audioChannelsToUse (audioChannelsUsed),
               totalChans (jmax (1, totalNumChans)),
               midiBufferToUse (midiBuffer)
@@ -262,6 +273,7 @@ private:
 
         void perform (const Context& c) override
         {
+            JUCE_TRACE_SCOPE (traceName);
             processor.setPlayHead (c.audioPlayHead);
 
             for (int i = 0; i < totalChans; ++i)
@@ -270,9 +282,19 @@ private:
             AudioBuffer<FloatType> buffer (audioChannels, totalChans, c.numSamples);
 
             if (processor.isSuspended())
+            {
                 buffer.clear();
+            }
+            else if (c.blockDurationTicks > 0)
+            {
+                auto startTicks = Time::getHighResolutionTicks();
+                callProcess (buffer, c.midiBuffers[midiBufferToUse]);
+                node->addProcessingTime (Time::getHighResolutionTicks() - startTicks, c.blockDurationTicks);
+            }
             else
+            {
                 callProcess (buffer, c.midiBuffers[midiBufferToUse]);
+            }
         }
 
         void callProcess (AudioBuffer<float>& buffer, MidiBuffer& midiMessages)
@@ -321,6 +343,7 @@ private:
 
         const AudioProcessorGraph::Node::Ptr node;
         AudioProcessor& processor;
+        const char* const traceName;
 
         Array<int> audioChannelsToUse;
         HeapBlock<FloatType*> audioChannels;
@@ -396,6 +419,7 @@ struct RenderSequenceBuilder
     };
 
     HashMap<uint32, int> delays;
+    HashMap<uint32, size_t> delayBufferBytes;
     int totalLatency = 0;
 
     int getNodeDelay (NodeID nodeID) const noexcept
@@ -414,6 +438,12 @@ struct RenderSequenceBuilder
         return maxLatency;
     }
 
+    void addDelayChannelOp (AudioProcessorGraph::Node& node, int chan, int delaySize)
+    {
+        auto bytes = sequence.addDelayChannelOp (chan, delaySize);
+        delayBufferBytes.set (node.nodeID.uid, delayBufferBytes[node.nodeID.uid] + bytes);
+    }
+
     //==============================================================================
     void createOrderedNodeList()
     {
@@ -476,7 +506,7 @@ struct RenderSequenceBuilder
             auto nodeDelay = getNodeDelay (src.nodeID);
 
             if (nodeDelay < maxLatency)
-                sequence.addDelayChannelOp (bufIndex, maxLatency - nodeDelay);
+                addDelayChannelOp (node, bufIndex, maxLatency - nodeDelay);
 
             return bufIndex;
         }
@@ -499,7 +529,7 @@ struct RenderSequenceBuilder
                 auto nodeDelay = getNodeDelay (src.nodeID);
 
                 if (nodeDelay < maxLatency)
-                    sequence.addDelayChannelOp (bufIndex, maxLatency - nodeDelay);
+                    addDelayChannelOp (node, bufIndex, maxLatency - nodeDelay);
 
                 break;
             }
@@ -524,7 +554,7 @@ struct RenderSequenceBuilder
             auto nodeDelay = getNodeDelay (sources.getFirst().nodeID);
 
             if (nodeDelay < maxLatency)
-                sequence.addDelayChannelOp (bufIndex, maxLatency - nodeDelay);
+                addDelayChannelOp (node, bufIndex, maxLatency - nodeDelay);
         }
 
         for (int i = 0; i < sources.size(); ++i)
@@ -542,13 +572,13 @@ struct RenderSequenceBuilder
                     {
                         if (! isBufferNeededLater (ourRenderingIndex, inputChan, src))
                         {
-                            sequence.addDelayChannelOp (srcIndex, maxLatency - nodeDelay);
+                            addDelayChannelOp (node, srcIndex, maxLatency - nodeDelay);
                         }
                         else // buffer is reused elsewhere, can't be delayed
                         {
                             auto bufferToDelay = getFreeBuffer (audioBuffers);
                             sequence.addCopyChannelOp (srcIndex, bufferToDelay);
-                            sequence.addDelayChannelOp (bufferToDelay, maxLatency - nodeDelay);
+                            addDelayChannelOp (node, bufferToDelay, maxLatency - nodeDelay);
                             srcIndex = bufferToDelay;
                         }
                     }
@@ -881,6 +911,91 @@ void AudioProcessorGraph::Node::setBypassed (bool shouldBeBypassed) noexcept
     bypassed = shouldBeBypassed;
 }
 
+//==============================================================================
+void AudioProcessorGraph::Node::addProcessingTime (int64 ticks, int64 blockDurationTicks) noexcept
+{
+    // This is only called from the audio thread, so there's only ever one writer. The block
+    // count is always written last, with release ordering, so that a reader who sees it has
+    // also seen the values that go with it.
+    if (statisticsResetPending.load (std::memory_order_relaxed) && statisticsResetPending.exchange (false))
+    {
+        // The other values are overwritten by the first block after a reset rather than being
+        // cleared here, and the fence makes sure that a reader who sees any of them will also
+        // see the count go back to zero.
+        numBlocksTimed.store (0, std::memory_order_release);
+        std::atomic_thread_fence (std::memory_order_release);
+    }
+
+    auto numBlocks = numBlocksTimed.load (std::memory_order_relaxed);
+    auto isFirstBlock = (numBlocks == 0);
+
+    if (isFirstBlock || ticks < minimumTicks.load (std::memory_order_relaxed))
+        minimumTicks.store (ticks, std::memory_order_relaxed);
+
+    if (isFirstBlock || ticks > maximumTicks.load (std::memory_order_relaxed))
+        maximumTicks.store (ticks, std::memory_order_relaxed);
+
+    auto overruns = isFirstBlock ? (int64) 0 : numOverruns.load (std::memory_order_relaxed);
+    auto total    = isFirstBlock ? (int64) 0 : totalTicks.load (std::memory_order_relaxed);
+
+    if (ticks > blockDurationTicks)
+        ++overruns;
+
+    numOverruns.store (overruns, std::memory_order_relaxed);
+    totalTicks.store (total + ticks, std::memory_order_relaxed);
+    lastTicks.store (ticks, std::memory_order_relaxed);
+    numBlocksTimed.store (numBlocks + 1, std::memory_order_release);
+}
+
+AudioProcessorGraph::Node::ProcessingStatistics AudioProcessorGraph::Node::getProcessingStatistics() const noexcept
+{
+    ProcessingStatistics stats;
+    stats.delayBufferBytes = delayBufferBytes;
+
+    if (statisticsResetPending)
+        return stats;
+
+    // If the block count changes while the other values are being read, they may not match
+    // it, so they're read again. A count that goes down means that they've been reset.
+    for (int attempt = 0; attempt < 4; ++attempt)
+    {
+        auto numBlocks = numBlocksTimed.load (std::memory_order_acquire);
+
+        if (numBlocks == 0)
+            return stats;
+
+        auto overruns = numOverruns.load (std::memory_order_relaxed);
+        auto minimum  = minimumTicks.load (std::memory_order_relaxed);
+        auto maximum  = maximumTicks.load (std::memory_order_relaxed);
+        auto last     = lastTicks.load (std::memory_order_relaxed);
+        auto total    = totalTicks.load (std::memory_order_relaxed);
+
+        std::atomic_thread_fence (std::memory_order_acquire);
+        auto numBlocksAfterReading = numBlocksTimed.load (std::memory_order_relaxed);
+
+        if (numBlocksAfterReading < numBlocks
+             || (numBlocksAfterReading != numBlocks && attempt < 3))
+            continue;
+
+        auto ticksToMs = 1000.0 / (double) Time::getHighResolutionTicksPerSecond();
+
+        stats.numBlocks           = numBlocks;
+        stats.numOverruns         = jmin (overruns, numBlocks);
+        stats.minimumMilliseconds = (double) minimum * ticksToMs;
+        stats.maximumMilliseconds = (double) maximum * ticksToMs;
+        stats.lastMilliseconds    = (double) last * ticksToMs;
+        stats.averageMilliseconds = (double) total * ticksToMs / (double) numBlocks;
+        break;
+    }
+
+    return stats;
+}
+
+void AudioProcessorGraph::Node::resetProcessingStatistics() noexcept
+{
+    statisticsResetPending = true;
+}
+
 //==============================================================================
 struct AudioProcessorGraph::RenderSequenceFloat   : public GraphRenderSequence<float> {};
 struct AudioProcessorGraph::RenderSequenceDouble  : public GraphRenderSequence<double> {};
@@ -1250,6 +1365,12 @@ void AudioProcessorGraph::buildRenderingSequence()
 
     isPrepared = 1;
 
+    auto& delayBufferBytes = getProcessingPrecision() == doublePrecision ? builderD.delayBufferBytes
+                                                                         : builderF.delayBufferBytes;
+
+    for (auto* node : nodes)
+        node->delayBufferBytes = delayBufferBytes[node->nodeID.uid];
+
     std::swap (renderSequenceFloat,  newSequenceF);
     std::swap (renderSequenceDouble, newSequenceD);
 }
@@ -1325,6 +1446,10 @@ static void processBlockForBuffer (AudioBuffer<FloatType>& buffer, MidiBuffer& m
                                    std::unique_ptr<SequenceType>& renderSequence,
                                    std::atomic<bool>& isPrepared)
 {
+    JUCE_TRACE_SCOPE ("AudioProcessorGraph::processBlock");
+
+    auto timingSampleRate = graph.isNodeTimingEnabled() ? graph.getSampleRate() : 0.0;
+
     if (graph.isNonRealtime())
     {
         while (! isPrepared)
@@ -1333,7 +1458,7 @@ static void processBlockForBuffer (AudioBuffer<FloatType>& buffer, MidiBuffer& m
         const ScopedLock sl (graph.getCallbackLock());
 
         if (renderSequence != nullptr)
-            renderSequence->perform (buffer, midiMessages, graph.getPlayHead());
+            renderSequence->perform (buffer, midiMessages, graph.getPlayHead(), timingSampleRate);
     }
     else
     {
@@ -1342,7 +1467,7 @@ static void processBlockForBuffer (AudioBuffer<FloatType>& buffer, MidiBuffer& m
         if (isPrepared)
         {
             if (renderSequence != nullptr)
-                renderSequence->perform (buffer, midiMessages, graph.getPlayHead());
+                renderSequence->perform (buffer, midiMessages, graph.getPlayHead(), timingSampleRate);
         }
         else
         {
@@ -1524,4 +1649,167 @@ void AudioProcessorGraph::AudioGraphIOProcessor::setParentGraph (AudioProcessorG
     }
 }
 
+
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class AudioProcessorGraphTests  : public UnitTest
+{
+public:
+    AudioProcessorGraphTests()
+        : UnitTest ("AudioProcessorGraph", UnitTestCategories::audio)
+    {}
+
+    void runTest() override
+    {
+        MessageManager::getInstance();
+
+        const double sampleRate = 48000.0;
+        const int blockSize = 480;   // (10 milliseconds)
+
+        AudioProcessorGraph graph;
+        graph.setPlayConfigDetails (2, 2, sampleRate, blockSize);
+
+        auto* busyProcessor = new TestProcessor (0);
+        auto input   = graph.addNode (std::make_unique<AudioProcessorGraph::AudioGraphIOProcessor> (AudioProcessorGraph::AudioGraphIOProcessor::audioInputNode));
+        auto output  = graph.addNode (std::make_unique<AudioProcessorGraph::AudioGraphIOProcessor> (AudioProcessorGraph::AudioGraphIOProcessor::audioOutputNode));
+        auto busy    = graph.addNode (std::unique_ptr<AudioProcessor> (busyProcessor));
+        auto delayed = graph.addNode (std::make_unique<TestProcessor> (100));
+
+        for (int channel = 0; channel < 2; ++channel)
+        {
+            for (auto& node : { busy, delayed })
+            {
+                expect (graph.addConnection ({ { input->nodeID, channel }, { node->nodeID, channel } }));
+                expect (graph.addConnection ({ { node->nodeID, channel }, { output->nodeID, channel } }));
+            }
+        }
+
+        graph.prepareToPlay (sampleRate, blockSize);
+
+        AudioBuffer<float> buffer (2, blockSize);
+        MidiBuffer midi;
+
+        auto processBlocks = [&] (int numBlocks, double busyMilliseconds)
+        {
+            busyProcessor->busyMilliseconds = busyMilliseconds;
+
+            for (int i = 0; i < numBlocks; ++i)
+            {
+                buffer.clear();
+                graph.processBlock (buffer, midi);
+            }
+        };
+
+        beginTest ("Nothing is measured unless timing is enabled");
+        {
+            processBlocks (3, 0.0);
+            expectEquals (busy->getProcessingStatistics().numBlocks, (int64) 0);
+        }
+
+        beginTest ("Node processing times");
+        {
+            graph.setNodeTimingEnabled (true);
+            processBlocks (10, 1.0);
+
+            auto stats = busy->getProcessingStatistics();
+            expectEquals (stats.numBlocks, (int64) 10);
+            expectEquals (stats.numOverruns, (int64) 0);
+            expectGreaterOrEqual (stats.minimumMilliseconds, 1.0);
+            expectGreaterOrEqual (stats.averageMilliseconds, stats.minimumMilliseconds);
+            expectGreaterOrEqual (stats.maximumMilliseconds, stats.averageMilliseconds);
+            expectGreaterOrEqual (stats.lastMilliseconds, stats.minimumMilliseconds);
+            expectLessOrEqual (stats.lastMilliseconds, stats.maximumMilliseconds);
+
+            expectEquals (delayed->getProcessingStatistics().numBlocks, (int64) 10);
+            expectLessThan (delayed->getProcessingStatistics().maximumMilliseconds, stats.minimumMilliseconds);
+        }
+
+        beginTest ("Overruns");
+        {
+            processBlocks (3, 12.0);
+
+            auto stats = busy->getProcessingStatistics();
+            expectEquals (stats.numBlocks, (int64) 13);
+            expectEquals (stats.numOverruns, (int64) 3);
+            expectGreaterOrEqual (stats.maximumMilliseconds, 12.0);
+            expectGreaterOrEqual (stats.lastMilliseconds, 12.0);
+            expectGreaterThan (stats.averageMilliseconds, (10 * 1.0 + 3 * 12.0) / 13.0 - 0.01);
+        }
+
+        beginTest ("Resetting the statistics");
+        {
+            busy->resetProcessingStatistics();
+            expectEquals (busy->getProcessingStatistics().numBlocks, (int64) 0);
+
+            processBlocks (2, 1.0);
+
+            auto stats = busy->getProcessingStatistics();
+            expectEquals (stats.numBlocks, (int64) 2);
+            expectEquals (stats.numOverruns, (int64) 0);
+            expectLessThan (stats.maximumMilliseconds, 12.0);
+            expectEquals (delayed->getProcessingStatistics().numBlocks, (int64) 15);
+
+            graph.setNodeTimingEnabled (false);
+            processBlocks (2, 0.0);
+            expectEquals (busy->getProcessingStatistics().numBlocks, (int64) 2);
+        }
+
+        beginTest ("Delay buffers");
+        {
+            // The output needs to delay the signal from the busy node to line it up with the
+            // delayed one, so it should be the only node with any delay buffers.
+            expectEquals ((int) output->getProcessingStatistics().delayBufferBytes, 2 * (100 + 1) * (int) sizeof (float));
+
+            for (auto& node : { input, busy, delayed })
+                expectEquals ((int) node->getProcessingStatistics().delayBufferBytes, 0);
+        }
+
+        graph.releaseResources();
+    }
+
+private:
+    struct TestProcessor  : public AudioProcessor
+    {
+        explicit TestProcessor (int latency)
+            : AudioProcessor (BusesProperties().withInput  ("Input",  AudioChannelSet::stereo())
+                                               .withOutput ("Output", AudioChannelSet::stereo()))
+        {
+            setLatencySamples (latency);
+        }
+
+        const String getName() const override                        { return "Test"; }
+        void prepareToPlay (double, int) override                    {}
+        void releaseResources() override                             {}
+
+        void processBlock (AudioBuffer<float>&, MidiBuffer&) override
+        {
+            auto endTicks = Time::getHighResolutionTicks()
+                             + Time::secondsToHighResolutionTicks (busyMilliseconds / 1000.0);
+
+            while (Time::getHighResolutionTicks() < endTicks)
+            {}
+        }
+
+        double getTailLengthSeconds() const override                 { return 0; }
+        bool acceptsMidi() const override                            { return false; }
+        bool producesMidi() const override                           { return false; }
+        AudioProcessorEditor* createEditor() override                { return nullptr; }
+        bool hasEditor() const override                              { return false; }
+        int getNumPrograms() override                                { return 1; }
+        int getCurrentProgram() override                             { return 0; }
+        void setCurrentProgram (int) override                        {}
+        const String getProgramName (int) override                   { return {}; }
+        void changeProgramName (int, const String&) override         {}
+        void getStateInformation (juce::MemoryBlock&) override       {}
+        void setStateInformation (const void*, int) override         {}
+
+        std::atomic<double> busyMilliseconds { 0.0 };
+    };
+};
+
+static AudioProcessorGraphTests audioProcessorGraphTests;
+
+#endif
+
 } // namespace juce
@@ -124,6 +124,44 @@ public:
         /** Tell this node to bypass processing. */
         void setBypassed (bool shouldBeBypassed) noexcept;
 
+        //==============================================================================
+        /** Measurements of the time that this node has spent processing.
+            @see getProcessingStatistics, AudioProcessorGraph::setNodeTimingEnabled
+        */
+        struct ProcessingStatistics
+        {
+            /** The number of blocks that have been timed. */
+            int64 numBlocks = 0;
+
+            /** The number of blocks for which this node alone took longer than the
+                real-time duration of the block.
+            */
+            int64 numOverruns = 0;
+
+            double minimumMilliseconds = 0;     /**< The quickest time that a block took. */
+            double averageMilliseconds = 0;     /**< The average time that a block took. */
+            double maximumMilliseconds = 0;     /**< The slowest time that a block took. */
+            double lastMilliseconds = 0;        /**< The time that the most recent block took. */
+
+            /** The number of bytes used by the buffers that delay this node's inputs to
+                compensate for the latency of the nodes that feed it.
+            */
+            size_t delayBufferBytes = 0;
+        };
+
+        /** Returns the time that this node has spent processing since its statistics were
+            last reset.
+
+            Nothing is measured unless AudioProcessorGraph::setNodeTimingEnabled() has been
+            called. The values are recorded on the audio thread without any locking, so this
+            can safely be called from any other thread, although the values may be from
+            slightly different blocks.
+        */
+        ProcessingStatistics getProcessingStatistics() const noexcept;
+
+        /** Clears the node's timing statistics. */
+        void resetProcessingStatistics() noexcept;
+
         //==============================================================================
         /** A convenient typedef for referring to a pointer to a node object. */
         using Ptr = ReferenceCountedObjectPtr<Node>;
@@ -147,8 +185,15 @@ public:
         bool isPrepared = false;
         std::atomic<bool> bypassed { false };
 
+        std::atomic<int64> numBlocksTimed { 0 }, numOverruns { 0 }, totalTicks { 0 },
+                           minimumTicks { 0 }, maximumTicks { 0 }, lastTicks { 0 };
+        std::atomic<bool> statisticsResetPending { false };
+        std::atomic<size_t> delayBufferBytes { 0 };
+
         Node (NodeID, std::unique_ptr<AudioProcessor>) noexcept;
 
+        void addProcessingTime (int64 ticks, int64 blockDurationTicks) noexcept;
+
         void setParentGraph (AudioProcessorGraph*) const;
         void prepare (double newSampleRate, int newBlockSize, AudioProcessorGraph*, ProcessingPrecision);
         void unprepare();
@@ -291,6 +336,19 @@ public:
     */
     bool removeIllegalConnections();
 
+    //==============================================================================
+    /** Turns on measurement of the time that each node spends processing.
+
+        This adds a couple of calls to Time::getHighResolutionTicks() for each node in
+        every block, so it's off by default.
+
+        @see Node::getProcessingStatistics
+    */
+    void setNodeTimingEnabled (bool shouldMeasureNodes) noexcept    { nodeTimingEnabled = shouldMeasureNodes; }
+
+    /** Returns true if setNodeTimingEnabled() has been turned on. */
+    bool isNodeTimingEnabled() const noexcept                       { return nodeTimingEnabled; }
+
     //==============================================================================
     /** A special type of AudioProcessor that can live inside an AudioProcessorGraph
         in order to use the audio that comes into and out of the graph itself.
@@ -414,7 +472,7 @@ private:
 
     friend class AudioGraphIOProcessor;
 
-    std::atomic<bool> isPrepared { false };
+    std::atomic<bool> isPrepared { false }, nodeTimingEnabled { false };
 
     void topologyChanged();
     void handleAsyncUpdate() override;
@@ -0,0 +1,250 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2020 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   To use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    A hash map that can be safely used by many threads at once, e.g. as a shared cache.
+
+    Rather than using one lock for the whole map, the items are divided between a
+    number of stripes, each of which is a FlatHashMap with its own lock, so threads
+    that are accessing different keys will rarely have to wait for each other.
+
+    Because other threads may be changing the map at any time, this class doesn't
+    provide references to its values or iterators, only operations that work on a
+    single key at a time, plus forEach() which visits each stripe under its lock.
+
+    @code
+    ConcurrentHashMap<String, Image> thumbnailCache;
+
+    Image getThumbnail (const String& path)
+    {
+        return thumbnailCache.getOrCreate (path, [&] { return loadThumbnail (path); });
+    }
+    @endcode
+
+    The TypeOfCriticalSectionToUse parameter sets the type of lock used for each stripe.
+    If the keys and values are cheap to copy, a SpinLock can be faster than the default
+    CriticalSection.
+
+    @see FlatHashMap, HashMap
+
+    @tags{Core}
+*/
+template <typename KeyType,
+          typename ValueType,
+          class HashFunctionType = DefaultHashFunctions,
+          class TypeOfCriticalSectionToUse = CriticalSection>
+class ConcurrentHashMap
+{
+private:
+    using KeyTypeParameter   = typename TypeHelpers::ParameterType<KeyType>::type;
+    using ValueTypeParameter = typename TypeHelpers::ParameterType<ValueType>::type;
+    using ScopedLockType     = typename TypeOfCriticalSectionToUse::ScopedLockType;
+
+public:
+    //==============================================================================
+    /** Creates an empty map.
+
+        @param numberOfStripes  The number of independently-locked parts to divide the map into.
+                                This will be rounded up to a power of two, and should be a few
+                                times larger than the number of threads that will use the map.
+        @param hashFunction     An instance of HashFunctionType, which will be copied and
+                                stored to use with the map.
+    */
+    explicit ConcurrentHashMap (int numberOfStripes = 16,
+                                HashFunctionType hashFunction = HashFunctionType())
+       : hashFunctionToUse (hashFunction)
+    {
+        numberOfStripes = nextPowerOfTwo (jlimit (1, 1024, numberOfStripes));
+        stripeShift = 32 - findHighestSetBit ((uint32) numberOfStripes);
+        stripeBits = 32 - stripeShift;
+
+        for (int i = 0; i < numberOfStripes; ++i)
+            stripes.add (new Stripe (hashFunction));
+    }
+
+    //==============================================================================
+    /** Returns the number of items in the map.
+        Obviously if other threads are modifying the map, this may have changed by the
+        time it returns.
+    */
+    int size() const
+    {
+        int total = 0;
+
+        for (auto* s : stripes)
+        {
+            const ScopedLockType sl (s->lock);
+            total += s->map.size();
+        }
+
+        return total;
+    }
+
+    /** Removes all the items from the map. */
+    void clear()
+    {
+        for (auto* s : stripes)
+        {
+            const ScopedLockType sl (s->lock);
+            s->map.clear();
+        }
+    }
+
+    //==============================================================================
+    /** Returns a copy of the value corresponding to a given key, or a default-constructed
+        value if the key isn't in the map.
+    */
+    ValueType operator[] (KeyTypeParameter keyToLookFor) const
+    {
+        ValueType result = ValueType();
+        get (keyToLookFor, result);
+        return result;
+    }
+
+    /** Looks for a key, and if it's found, copies its value into the result parameter and
+        returns true. If the key isn't found, this returns false and leaves the result alone.
+    */
+    bool get (KeyTypeParameter keyToLookFor, ValueType& result) const
+    {
+        auto hash = getHash (keyToLookFor);
+        auto& s = getStripe (hash);
+        const ScopedLockType sl (s.lock);
+        auto index = s.map.findIndex (keyToLookFor, getHashWithinStripe (hash));
+
+        if (index < 0)
+            return false;
+
+        result = s.map.slots[index].getEntry().value;
+        return true;
+    }
+
+    /** Returns true if the map contains an item with the specified key. */
+    bool contains (KeyTypeParameter keyToLookFor) const
+    {
+        auto hash = getHash (keyToLookFor);
+        auto& s = getStripe (hash);
+        const ScopedLockType sl (s.lock);
+        return s.map.findIndex (keyToLookFor, getHashWithinStripe (hash)) >= 0;
+    }
+
+    //==============================================================================
+    /** Adds or replaces an item in the map. */
+    void set (KeyTypeParameter newKey, ValueTypeParameter newValue)
+    {
+        auto hash = getHash (newKey);
+        auto& s = getStripe (hash);
+        const ScopedLockType sl (s.lock);
+        s.map.getReference (newKey, getHashWithinStripe (hash)) = newValue;
+    }
+
+    /** Returns the value for a key, or if the key isn't in the map, calls the given
+        function to create a value, adds it, and returns it.
+
+        The function is called while the key's stripe is locked, so no other thread can
+        add the same key at the same time, but it also means that other threads using
+        keys in the same stripe will have to wait until it has finished.
+    */
+    template <typename CreateValueFunction>
+    ValueType getOrCreate (KeyTypeParameter key, CreateValueFunction&& createValue)
+    {
+        auto hash = getHash (key);
+        auto stripeHash = getHashWithinStripe (hash);
+        auto& s = getStripe (hash);
+        const ScopedLockType sl (s.lock);
+        auto index = s.map.findIndex (key, stripeHash);
+
+        if (index >= 0)
+            return s.map.slots[index].getEntry().value;
+
+        ValueType newValue (createValue());
+        s.map.getReference (key, stripeHash) = newValue;
+        return newValue;
+    }
+
+    /** Removes the item with the given key, returning true if there was one. */
+    bool remove (KeyTypeParameter keyToRemove)
+    {
+        auto hash = getHash (keyToRemove);
+        auto& s = getStripe (hash);
+        const ScopedLockType sl (s.lock);
+        auto index = s.map.findIndex (keyToRemove, getHashWithinStripe (hash));
+
+        if (index < 0)
+            return false;
+
+        s.map.removeAtIndex (index);
+        return true;
+    }
+
+    //==============================================================================
+    /** Calls a function for each key and value in the map.
+
+        The function should have the form (const KeyType&, const ValueType&). Each stripe
+        is locked while its items are being visited, so the function mustn't try to use
+        the map itself.
+    */
+    template <typename Function>
+    void forEach (Function&& function) const
+    {
+        for (auto* s : stripes)
+        {
+            const ScopedLockType sl (s->lock);
+
+            for (int i = 0; i < s->map.numSlots; ++i)
+                if (s->map.slots[i].distance != 0)
+                    function (s->map.slots[i].getEntry().key, s->map.slots[i].getEntry().value);
+        }
+    }
+
+    /** Returns the number of stripes that the map is divided into. */
+    int getNumStripes() const noexcept      { return stripes.size(); }
+
+private:
+    //==============================================================================
+    using MapType = FlatHashMap<KeyType, ValueType, HashFunctionType>;
+
+    struct Stripe
+    {
+        explicit Stripe (HashFunctionType hashFunction)  : map (0, hashFunction) {}
+
+        TypeOfCriticalSectionToUse lock;
+        MapType map;
+    };
+
+    HashFunctionType hashFunctionToUse;
+    OwnedArray<Stripe> stripes;
+    int stripeShift = 32, stripeBits = 0;
+
+    // The top bits of the hash pick a stripe, and the rest are shifted up to be
+    // used to pick a slot in that stripe's map
+    uint32 getHash (KeyTypeParameter key) const            { return MapType::mixHash (hashFunctionToUse.generateHash (key, std::numeric_limits<int>::max())); }
+    Stripe& getStripe (uint32 hash) const noexcept          { return *stripes.getUnchecked (stripeShift < 32 ? (int) (hash >> stripeShift) : 0); }
+    uint32 getHashWithinStripe (uint32 hash) const noexcept { return hash << stripeBits; }
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ConcurrentHashMap)
+};
+
+} // namespace juce
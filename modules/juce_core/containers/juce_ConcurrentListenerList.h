@@ -0,0 +1,311 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2020 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   To use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    A list of listeners that can be called from any thread without taking a lock.
+
+    This has the same interface as ListenerList, but is designed for lists that are
+    called from several threads at once, or that hold so many listeners that holding
+    a lock for the duration of a call would cause problems.
+
+    Whenever a listener is added or removed, a new copy of the list is made, and
+    the old copy is kept until no calls are using it any more. A call just takes the
+    copy that was current when it started and walks through it, so calls never wait
+    for each other or for a thread that's changing the list, and adding or removing
+    listeners never waits for a call to finish. The cost of this is that adding and
+    removing listeners takes time proportional to the number of listeners.
+
+    As with ListenerList, if a listener is removed during a call, it's guaranteed
+    that the call won't go on to invoke it. A listener that's added during a call
+    won't be called until the next call. Bear in mind that if you remove a listener
+    on one thread while another thread is in the middle of calling it, that callback
+    will still be running when remove() returns.
+
+    @see ListenerList
+
+    @tags{Core}
+*/
+template <class ListenerClass>
+class ConcurrentListenerList
+{
+public:
+    //==============================================================================
+    /** Creates an empty list. */
+    ConcurrentListenerList() = default;
+
+    /** Destructor. */
+    ~ConcurrentListenerList()
+    {
+        // Deleting the list while another thread is calling it is a bad idea!
+        jassert (numActiveCalls[0] == 0 && numActiveCalls[1] == 0);
+
+        std::unique_ptr<Snapshot> snapshot (current.exchange (nullptr));
+
+        if (snapshot != nullptr)
+            for (auto* e : *snapshot)
+                delete e;
+    }
+
+    //==============================================================================
+    /** Adds a listener to the list.
+        A listener can only be added once, so if the listener is already in the list,
+        this method has no effect.
+        @see remove
+    */
+    void add (ListenerClass* listenerToAdd)
+    {
+        if (listenerToAdd == nullptr)
+        {
+            jassertfalse;  // Listeners can't be null pointers!
+            return;
+        }
+
+        const ScopedLock sl (writeLock);
+        auto* oldSnapshot = current.load();
+
+        if (oldSnapshot != nullptr && indexOf (*oldSnapshot, listenerToAdd) >= 0)
+            return;
+
+        std::unique_ptr<Snapshot> newSnapshot (oldSnapshot != nullptr ? new Snapshot (*oldSnapshot) : new Snapshot());
+        newSnapshot->add (new Entry (listenerToAdd));
+        replaceSnapshot (newSnapshot.release(), nullptr);
+    }
+
+    /** Removes a listener from the list.
+        If the listener wasn't in the list, this has no effect.
+    */
+    void remove (ListenerClass* listenerToRemove)
+    {
+        jassert (listenerToRemove != nullptr); // Listeners can't be null pointers!
+
+        const ScopedLock sl (writeLock);
+        auto* oldSnapshot = current.load();
+
+        if (oldSnapshot == nullptr)
+            return;
+
+        auto index = indexOf (*oldSnapshot, listenerToRemove);
+
+        if (index < 0)
+            return;
+
+        auto* entry = oldSnapshot->getUnchecked (index);
+        entry->removed = true;
+
+        std::unique_ptr<Snapshot> newSnapshot (new Snapshot (*oldSnapshot));
+        newSnapshot->remove (index);
+        replaceSnapshot (newSnapshot.release(), entry);
+    }
+
+    /** Removes all the listeners from the list. */
+    void clear()
+    {
+        const ScopedLock sl (writeLock);
+
+        if (auto* oldSnapshot = current.load())
+        {
+            for (auto* e : *oldSnapshot)
+            {
+                e->removed = true;
+                retiredEntries[currentEpoch.load()].add (e);
+            }
+
+            replaceSnapshot (nullptr, nullptr);
+        }
+    }
+
+    /** Returns the number of registered listeners. */
+    int size() const noexcept
+    {
+        const ScopedCall call (*this);
+        return call.snapshot != nullptr ? call.snapshot->size() : 0;
+    }
+
+    /** Returns true if no listeners are registered, false otherwise. */
+    bool isEmpty() const noexcept                           { return size() == 0; }
+
+    /** Returns true if the specified listener has been added to the list. */
+    bool contains (ListenerClass* listener) const noexcept
+    {
+        const ScopedCall call (*this);
+        return call.snapshot != nullptr && indexOf (*call.snapshot, listener) >= 0;
+    }
+
+    //==============================================================================
+    /** Calls a function on each listener in the list. */
+    template <typename Callback>
+    void call (Callback&& callback)
+    {
+        callCheckedExcluding (nullptr, DummyBailOutChecker(), std::forward<Callback> (callback));
+    }
+
+    /** Calls a function on all but the specified listener in the list.
+        This can be useful if the caller is also a listener and needs to exclude itself.
+    */
+    template <typename Callback>
+    void callExcluding (ListenerClass* listenerToExclude, Callback&& callback)
+    {
+        callCheckedExcluding (listenerToExclude, DummyBailOutChecker(), std::forward<Callback> (callback));
+    }
+
+    /** Calls a function on each listener in the list, with a bail-out-checker.
+        See the ListenerList class description for info about writing a bail-out checker.
+    */
+    template <typename Callback, typename BailOutCheckerType>
+    void callChecked (const BailOutCheckerType& bailOutChecker, Callback&& callback)
+    {
+        callCheckedExcluding (nullptr, bailOutChecker, std::forward<Callback> (callback));
+    }
+
+    /** Calls a function on all but the specified listener in the list, with a
+        bail-out-checker. See the ListenerList class description for info about
+        writing a bail-out checker.
+    */
+    template <typename Callback, typename BailOutCheckerType>
+    void callCheckedExcluding (ListenerClass* listenerToExclude,
+                               const BailOutCheckerType& bailOutChecker,
+                               Callback&& callback)
+    {
+        const ScopedCall call (*this);
+
+        if (call.snapshot == nullptr)
+            return;
+
+        for (int i = call.snapshot->size(); --i >= 0;)
+        {
+            if (bailOutChecker.shouldBailOut())
+                return;
+
+            auto* entry = call.snapshot->getUnchecked (i);
+
+            if (! entry->removed && entry->listener != listenerToExclude)
+                callback (*entry->listener);
+        }
+    }
+
+    //==============================================================================
+    /** A dummy bail-out checker that always returns false. */
+    struct DummyBailOutChecker
+    {
+        bool shouldBailOut() const noexcept                 { return false; }
+    };
+
+    using ListenerType = ListenerClass;
+
+private:
+    //==============================================================================
+    struct Entry
+    {
+        explicit Entry (ListenerClass* l) noexcept  : listener (l) {}
+
+        ListenerClass* const listener;
+        std::atomic<bool> removed { false };
+    };
+
+    using Snapshot = Array<Entry*>;
+
+    struct ScopedCall
+    {
+        explicit ScopedCall (const ConcurrentListenerList& l) noexcept
+            : owner (l)
+        {
+            for (;;)
+            {
+                epoch = owner.currentEpoch.load();
+                ++owner.numActiveCalls[epoch];
+
+                // If the epoch moved on before the call was counted, a writer may
+                // not have seen it, so it needs to register in the new one instead
+                if (owner.currentEpoch.load() == epoch)
+                    break;
+
+                --owner.numActiveCalls[epoch];
+            }
+
+            snapshot = owner.current.load();
+        }
+
+        ~ScopedCall() noexcept
+        {
+            --owner.numActiveCalls[epoch];
+        }
+
+        const ConcurrentListenerList& owner;
+        const Snapshot* snapshot;
+        int epoch;
+
+        JUCE_DECLARE_NON_COPYABLE (ScopedCall)
+    };
+
+    std::atomic<Snapshot*> current { nullptr };
+    std::atomic<int> currentEpoch { 0 };
+    mutable std::atomic<int> numActiveCalls[2] = {};
+
+    CriticalSection writeLock;
+    OwnedArray<Snapshot> retiredSnapshots[2];
+    OwnedArray<Entry> retiredEntries[2];
+
+    static int indexOf (const Snapshot& snapshot, const ListenerClass* listener) noexcept
+    {
+        for (int i = 0; i < snapshot.size(); ++i)
+            if (snapshot.getUnchecked (i)->listener == listener)
+                return i;
+
+        return -1;
+    }
+
+    // Must be called with the write lock held.
+    //
+    // Each call registers itself in the current epoch, and anything that's replaced is
+    // retired into the current epoch's lists. The epoch can only move on when all the
+    // calls from the previous one have finished, and at that point nothing that was
+    // retired during the previous epoch can still be in use: calls in the current epoch
+    // all started after it was replaced. So memory is reclaimed even when calls are
+    // overlapping continuously, as long as each call eventually finishes.
+    void replaceSnapshot (Snapshot* newSnapshot, Entry* removedEntry)
+    {
+        auto epoch = currentEpoch.load();
+
+        if (auto* oldSnapshot = current.exchange (newSnapshot))
+            retiredSnapshots[epoch].add (oldSnapshot);
+
+        if (removedEntry != nullptr)
+            retiredEntries[epoch].add (removedEntry);
+
+        auto previousEpoch = epoch ^ 1;
+
+        if (numActiveCalls[previousEpoch].load() == 0)
+        {
+            retiredSnapshots[previousEpoch].clear();
+            retiredEntries[previousEpoch].clear();
+            currentEpoch = previousEpoch;
+        }
+    }
+
+    JUCE_DECLARE_NON_COPYABLE (ConcurrentListenerList)
+};
+
+} // namespace juce
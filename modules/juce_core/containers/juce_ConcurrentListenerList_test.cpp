@@ -0,0 +1,167 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2020 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   To use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+class ConcurrentListenerListTests  : public UnitTest
+{
+public:
+    ConcurrentListenerListTests()
+        : UnitTest ("ConcurrentListenerList", UnitTestCategories::containers)
+    {}
+
+    struct Listener
+    {
+        void callback()    { ++numCalls; }
+        std::atomic<int> numCalls { 0 };
+    };
+
+    void runTest() override
+    {
+        beginTest ("Adding and removing");
+        {
+            ConcurrentListenerList<Listener> list;
+            Listener a, b, c;
+
+            expect (list.isEmpty());
+
+            list.add (&a);
+            list.add (&b);
+            list.add (&a);
+            expectEquals (list.size(), 2);
+            expect (list.contains (&a) && list.contains (&b) && ! list.contains (&c));
+
+            list.call ([] (Listener& l) { l.callback(); });
+            expectEquals (a.numCalls.load(), 1);
+            expectEquals (b.numCalls.load(), 1);
+
+            list.callExcluding (&a, [] (Listener& l) { l.callback(); });
+            expectEquals (a.numCalls.load(), 1);
+            expectEquals (b.numCalls.load(), 2);
+
+            list.remove (&a);
+            list.remove (&c);
+            expectEquals (list.size(), 1);
+            expect (! list.contains (&a));
+
+            list.clear();
+            expect (list.isEmpty());
+
+            list.call ([] (Listener& l) { l.callback(); });
+            expectEquals (b.numCalls.load(), 2);
+        }
+
+        beginTest ("Changing the list during a call");
+        {
+            ConcurrentListenerList<Listener> list;
+            Listener a, b, c, d;
+            list.add (&a);
+            list.add (&b);
+            list.add (&c);
+
+            // The list is called from last to first, so c removes b before it gets called
+            list.call ([&] (Listener& l)
+            {
+                l.callback();
+
+                if (&l == &c)
+                {
+                    list.remove (&b);
+                    list.add (&d);
+                }
+            });
+
+            expectEquals (a.numCalls.load(), 1);
+            expectEquals (b.numCalls.load(), 0);
+            expectEquals (c.numCalls.load(), 1);
+            expectEquals (d.numCalls.load(), 0);
+            expectEquals (list.size(), 3);
+
+            struct BailOutAfter
+            {
+                bool shouldBailOut() const noexcept  { return count++ >= limit; }
+                int limit;
+                mutable int count;
+            };
+
+            list.callChecked (BailOutAfter { 1, 0 }, [] (Listener& l) { l.callback(); });
+            expectEquals (a.numCalls.load() + c.numCalls.load() + d.numCalls.load(), 3);
+        }
+
+        beginTest ("Calling from several threads");
+        {
+            ConcurrentListenerList<Listener> list;
+            OwnedArray<Listener> listeners;
+
+            for (int i = 0; i < 100; ++i)
+                list.add (listeners.add (new Listener()));
+
+            std::atomic<bool> finished { false };
+            std::atomic<int> numBadCalls { 0 };
+            Listener transient;
+
+            struct Caller  : public Thread
+            {
+                Caller (std::function<void()> f)  : Thread ("caller"), fn (std::move (f)) {}
+                void run() override   { fn(); }
+                std::function<void()> fn;
+            };
+
+            OwnedArray<Caller> callers;
+
+            for (int i = 0; i < 3; ++i)
+            {
+                callers.add (new Caller ([&]
+                {
+                    while (! finished)
+                        list.call ([&] (Listener& l)
+                        {
+                            if (&l != &transient && ! listeners.contains (&l))
+                                ++numBadCalls;
+
+                            l.callback();
+                        });
+                }))->startThread();
+            }
+
+            for (int i = 0; i < 2000; ++i)
+            {
+                list.add (&transient);
+                list.remove (&transient);
+            }
+
+            finished = true;
+
+            for (auto* c : callers)
+                c->stopThread (-1);
+
+            expectEquals (numBadCalls.load(), 0);
+            expectEquals (list.size(), 100);
+            expect (! list.contains (&transient));
+        }
+    }
+};
+
+static ConcurrentListenerListTests concurrentListenerListTests;
+
+} // namespace juce
@@ -0,0 +1,495 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2020 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   To use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    Holds a set of mappings between some key/value pairs, using a flat, open-addressed
+    hash table.
+
+    This has the same interface as HashMap, and can be used as a drop-in replacement
+    for it, but rather than allocating a separate object for each item and chaining
+    them together, it keeps all of its keys and values in a single contiguous block,
+    using Robin Hood hashing to keep the probe sequences short. This makes lookups
+    much more cache-friendly, and means that adding an item doesn't usually need to
+    allocate any memory.
+
+    The price for this is that, unlike HashMap, adding or removing items can move the
+    other items around in memory, so references returned by getReference() are only
+    valid until the next time the map is modified.
+
+    The hash function class is used in the same way as for HashMap, but the map will
+    always pass a large upperLimit to it and then spread the result over its slots
+    itself, so the hash function doesn't need to worry about the number of slots.
+
+    @code
+    FlatHashMap<int, String> map;
+    map.set (1, "item1");
+    map.set (2, "item2");
+
+    DBG (map[1]); // prints "item1"
+
+    for (FlatHashMap<int, String>::Iterator i (map); i.next();)
+        DBG (i.getKey() << " -> " << i.getValue());
+    @endcode
+
+    @see HashMap, ConcurrentHashMap, DefaultHashFunctions
+
+    @tags{Core}
+*/
+template <typename KeyType,
+          typename ValueType,
+          class HashFunctionType = DefaultHashFunctions,
+          class TypeOfCriticalSectionToUse = DummyCriticalSection>
+class FlatHashMap
+{
+private:
+    using KeyTypeParameter   = typename TypeHelpers::ParameterType<KeyType>::type;
+    using ValueTypeParameter = typename TypeHelpers::ParameterType<ValueType>::type;
+
+public:
+    //==============================================================================
+    /** Creates an empty map.
+
+        @param numberOfSlots An initial number of slots to allocate. This will be rounded up
+                             to a power of two, and will grow automatically as items are added.
+        @param hashFunction  An instance of HashFunctionType, which will be copied and
+                             stored to use with the map.
+    */
+    explicit FlatHashMap (int numberOfSlots = 0,
+                          HashFunctionType hashFunction = HashFunctionType())
+       : hashFunctionToUse (hashFunction)
+    {
+        if (numberOfSlots > 0)
+            remapTable (numberOfSlots);
+    }
+
+    /** Destructor. */
+    ~FlatHashMap()
+    {
+        clear();
+    }
+
+    //==============================================================================
+    /** Removes all values from the map.
+        Note that this will clear the content, but won't release the memory used by the
+        slots (see remapTable and getNumSlots).
+    */
+    void clear()
+    {
+        const ScopedLockType sl (getLock());
+
+        for (int i = 0; i < numSlots; ++i)
+        {
+            if (slots[i].distance != 0)
+            {
+                slots[i].getEntry().~Entry();
+                slots[i].distance = 0;
+            }
+        }
+
+        totalNumItems = 0;
+    }
+
+    //==============================================================================
+    /** Returns the current number of items in the map. */
+    inline int size() const noexcept
+    {
+        return totalNumItems;
+    }
+
+    /** Returns the value corresponding to a given key.
+        If the map doesn't contain the key, a default instance of the value type is returned.
+        @param keyToLookFor    the key of the item being requested
+    */
+    inline ValueType operator[] (KeyTypeParameter keyToLookFor) const
+    {
+        const ScopedLockType sl (getLock());
+        auto index = findIndex (keyToLookFor, getHash (keyToLookFor));
+        return index >= 0 ? slots[index].getEntry().value : ValueType();
+    }
+
+    /** Returns a reference to the value corresponding to a given key.
+        If the map doesn't contain the key, a default instance of the value type is
+        added to the map and a reference to this is returned.
+
+        Note that the reference will only remain valid until the next time that an item
+        is added to or removed from the map.
+
+        @param keyToLookFor    the key of the item being requested
+    */
+    inline ValueType& getReference (KeyTypeParameter keyToLookFor)
+    {
+        const ScopedLockType sl (getLock());
+        return getReference (keyToLookFor, getHash (keyToLookFor));
+    }
+
+    //==============================================================================
+    /** Returns true if the map contains an item with the specified key. */
+    bool contains (KeyTypeParameter keyToLookFor) const
+    {
+        const ScopedLockType sl (getLock());
+        return findIndex (keyToLookFor, getHash (keyToLookFor)) >= 0;
+    }
+
+    /** Returns true if the map contains at least one occurrence of a given value. */
+    bool containsValue (ValueTypeParameter valueToLookFor) const
+    {
+        const ScopedLockType sl (getLock());
+
+        for (int i = 0; i < numSlots; ++i)
+            if (slots[i].distance != 0 && slots[i].getEntry().value == valueToLookFor)
+                return true;
+
+        return false;
+    }
+
+    //==============================================================================
+    /** Adds or replaces an element in the map.
+        If there's already an item with the given key, this will replace its value. Otherwise, a new item
+        will be added to the map.
+    */
+    void set (KeyTypeParameter newKey, ValueTypeParameter newValue)        { getReference (newKey) = newValue; }
+
+    /** Removes an item with the given key. */
+    void remove (KeyTypeParameter keyToRemove)
+    {
+        const ScopedLockType sl (getLock());
+        remove (keyToRemove, getHash (keyToRemove));
+    }
+
+    /** Removes all items with the given value. */
+    void removeValue (ValueTypeParameter valueToRemove)
+    {
+        const ScopedLockType sl (getLock());
+
+        for (int i = 0; i < numSlots;)
+        {
+            // removing an item may shift the next one back into this slot, so only
+            // move on once the slot holds something that we're keeping
+            if (slots[i].distance != 0 && slots[i].getEntry().value == valueToRemove)
+                removeAtIndex (i);
+            else
+                ++i;
+        }
+    }
+
+    /** Changes the number of slots that the map uses.
+        The number will be rounded up to a power of two that's large enough to hold the
+        items that are currently in the map.
+        @see getNumSlots()
+    */
+    void remapTable (int newNumberOfSlots)
+    {
+        const ScopedLockType sl (getLock());
+        rehash (jmax (newNumberOfSlots, (totalNumItems * 8) / 7 + 1));
+    }
+
+    /** Returns the number of slots which are available for items.
+        Each slot can hold a single item, and the map will grow when about 7/8 of them are used.
+        @see remapTable()
+    */
+    inline int getNumSlots() const noexcept
+    {
+        return numSlots;
+    }
+
+    //==============================================================================
+    /** Efficiently swaps the contents of two maps. */
+    template <class OtherHashMapType>
+    void swapWith (OtherHashMapType& otherHashMap) noexcept
+    {
+        const ScopedLockType lock1 (getLock());
+        const typename OtherHashMapType::ScopedLockType lock2 (otherHashMap.getLock());
+
+        slots.swapWith (otherHashMap.slots);
+        std::swap (numSlots, otherHashMap.numSlots);
+        std::swap (slotShift, otherHashMap.slotShift);
+        std::swap (totalNumItems, otherHashMap.totalNumItems);
+    }
+
+    //==============================================================================
+    /** Returns the CriticalSection that locks this structure.
+        To lock, you can call getLock().enter() and getLock().exit(), or preferably use
+        an object of ScopedLockType as an RAII lock for it.
+    */
+    inline const TypeOfCriticalSectionToUse& getLock() const noexcept      { return lock; }
+
+    /** Returns the type of scoped lock to use for locking this map */
+    using ScopedLockType = typename TypeOfCriticalSectionToUse::ScopedLockType;
+
+    //==============================================================================
+    /** Iterates over the items in a FlatHashMap.
+
+        This works in the same way as HashMap::Iterator. The order in which items are
+        iterated bears no resemblance to the order in which they were added, and any
+        iterators become invalid as soon as you call a non-const method on the map.
+    */
+    struct Iterator
+    {
+        Iterator (const FlatHashMap& hashMapToIterate) noexcept
+            : hashMap (hashMapToIterate)
+        {}
+
+        Iterator (const Iterator& other) noexcept
+            : hashMap (other.hashMap), index (other.index)
+        {}
+
+        /** Moves to the next item, if one is available.
+            When this returns true, you can get the item's key and value using getKey() and
+            getValue(). If it returns false, the iteration has finished and you should stop.
+        */
+        bool next() noexcept
+        {
+            while (++index < hashMap.numSlots)
+                if (hashMap.slots[index].distance != 0)
+                    return true;
+
+            index = hashMap.numSlots;
+            return false;
+        }
+
+        /** Returns the current item's key.
+            This should only be called when a call to next() has just returned true.
+        */
+        KeyType getKey() const
+        {
+            return isValid() ? hashMap.slots[index].getEntry().key : KeyType();
+        }
+
+        /** Returns the current item's value.
+            This should only be called when a call to next() has just returned true.
+        */
+        ValueType getValue() const
+        {
+            return isValid() ? hashMap.slots[index].getEntry().value : ValueType();
+        }
+
+        /** Resets the iterator to its starting position. */
+        void reset() noexcept
+        {
+            index = -1;
+        }
+
+        Iterator& operator++() noexcept                         { next(); return *this; }
+        ValueType operator*() const                             { return getValue(); }
+        bool operator!= (const Iterator& other) const noexcept  { return index != other.index; }
+        void resetToEnd() noexcept                              { index = hashMap.numSlots; }
+
+    private:
+        //==============================================================================
+        const FlatHashMap& hashMap;
+        int index = -1;
+
+        bool isValid() const noexcept   { return isPositiveAndBelow (index, hashMap.numSlots) && hashMap.slots[index].distance != 0; }
+
+        // using the copy constructor is ok, but you cannot assign iterators
+        Iterator& operator= (const Iterator&) = delete;
+
+        JUCE_LEAK_DETECTOR (Iterator)
+    };
+
+    /** Returns a start iterator for the values in this map. */
+    Iterator begin() const noexcept             { Iterator i (*this); i.next(); return i; }
+
+    /** Returns an end iterator for the values in this map. */
+    Iterator end() const noexcept               { Iterator i (*this); i.resetToEnd(); return i; }
+
+private:
+    //==============================================================================
+    struct Entry
+    {
+        KeyType key;
+        ValueType value;
+    };
+
+    // The distance is 0 for an empty slot, otherwise it's 1 + the number of slots
+    // between the item and the slot where its hash would ideally have put it. The
+    // entry is only constructed when the slot is in use.
+    struct Slot
+    {
+        uint32 hash, distance;
+        typename std::aligned_storage<sizeof (Entry), alignof (Entry)>::type storage;
+
+        Entry& getEntry() noexcept               { return *reinterpret_cast<Entry*> (&storage); }
+        const Entry& getEntry() const noexcept   { return *reinterpret_cast<const Entry*> (&storage); }
+    };
+
+    enum { minimumNumSlots = 8 };
+
+    template <typename, typename, class, class>
+    friend class FlatHashMap;
+
+    template <typename, typename, class, class>
+    friend class ConcurrentHashMap;
+
+    HashFunctionType hashFunctionToUse;
+    HeapBlock<Slot> slots;
+    int numSlots = 0, slotShift = 32, totalNumItems = 0;
+    TypeOfCriticalSectionToUse lock;
+
+    uint32 getHash (KeyTypeParameter key) const
+    {
+        return mixHash (hashFunctionToUse.generateHash (key, std::numeric_limits<int>::max()));
+    }
+
+    static uint32 mixHash (int hash) noexcept
+    {
+        jassert (hash >= 0); // your hash function is generating out-of-range numbers!
+
+        // Fibonacci hashing, so that the top bits, which are used to pick a slot,
+        // depend on all of the bits of the original hash
+        return (uint32) hash * 2654435769u;
+    }
+
+    int findIndex (KeyTypeParameter key, uint32 hash) const
+    {
+        if (totalNumItems == 0)
+            return -1;
+
+        auto mask = numSlots - 1;
+
+        for (auto i = (int) (hash >> slotShift), distance = 1;; i = (i + 1) & mask, ++distance)
+        {
+            auto& slot = slots[i];
+
+            // An item that's closer to its ideal slot than this one would be means that
+            // the key isn't in the map, as it would have displaced that item
+            if ((int) slot.distance < distance)
+                return -1;
+
+            if (slot.hash == hash && slots[i].getEntry().key == key)
+                return i;
+        }
+    }
+
+    ValueType& getReference (KeyTypeParameter key, uint32 hash)
+    {
+        auto index = findIndex (key, hash);
+
+        if (index < 0)
+        {
+            if ((totalNumItems + 1) * 8 > numSlots * 7)
+                rehash (jmax ((int) minimumNumSlots, numSlots * 2));
+
+            index = place (Entry { key, ValueType() }, hash);
+            ++totalNumItems;
+        }
+
+        return slots[index].getEntry().value;
+    }
+
+    void remove (KeyTypeParameter key, uint32 hash)
+    {
+        auto index = findIndex (key, hash);
+
+        if (index >= 0)
+            removeAtIndex (index);
+    }
+
+    // Puts an entry into the table, swapping it with any item that's closer to its own
+    // ideal slot, and returns the slot where the new entry ended up.
+    int place (Entry&& newEntry, uint32 hash)
+    {
+        auto mask = numSlots - 1;
+        uint32 carriedHash = hash, carriedDistance = 1;
+        int result = -1;
+
+        for (auto i = (int) (hash >> slotShift);; i = (i + 1) & mask, ++carriedDistance)
+        {
+            auto& slot = slots[i];
+
+            if (slot.distance == 0)
+            {
+                new (&slot.storage) Entry (std::move (newEntry));
+                slot.hash = carriedHash;
+                slot.distance = carriedDistance;
+                return result >= 0 ? result : i;
+            }
+
+            if (slot.distance < carriedDistance)
+            {
+                std::swap (slot.getEntry(), newEntry);
+                std::swap (slot.hash, carriedHash);
+                std::swap (slot.distance, carriedDistance);
+
+                if (result < 0)
+                    result = i;
+            }
+        }
+    }
+
+    void removeAtIndex (int index)
+    {
+        auto mask = numSlots - 1;
+
+        // shifts any following items that aren't in their ideal slots back by one
+        for (;;)
+        {
+            auto next = (index + 1) & mask;
+            auto& nextSlot = slots[next];
+
+            if (nextSlot.distance <= 1)
+                break;
+
+            slots[index].getEntry() = std::move (nextSlot.getEntry());
+            slots[index].hash = nextSlot.hash;
+            slots[index].distance = nextSlot.distance - 1;
+            index = next;
+        }
+
+        slots[index].getEntry().~Entry();
+        slots[index].distance = 0;
+        --totalNumItems;
+    }
+
+    void rehash (int newNumSlots)
+    {
+        newNumSlots = jmax ((int) minimumNumSlots, nextPowerOfTwo (newNumSlots));
+
+        if (newNumSlots == numSlots)
+            return;
+
+        HeapBlock<Slot> oldSlots;
+        oldSlots.swapWith (slots);
+        slots.calloc (newNumSlots);
+
+        auto oldNumSlots = numSlots;
+        numSlots = newNumSlots;
+        slotShift = 32 - findHighestSetBit ((uint32) newNumSlots);
+
+        for (int i = 0; i < oldNumSlots; ++i)
+        {
+            if (oldSlots[i].distance != 0)
+            {
+                place (std::move (oldSlots[i].getEntry()), oldSlots[i].hash);
+                oldSlots[i].getEntry().~Entry();
+            }
+        }
+    }
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (FlatHashMap)
+};
+
+} // namespace juce
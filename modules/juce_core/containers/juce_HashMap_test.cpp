@@ -31,20 +31,41 @@ struct HashMapTest : public UnitTest
 
     void runTest() override
     {
-        doTest<AddElementsTest> ("AddElementsTest");
-        doTest<AccessTest> ("AccessTest");
-        doTest<RemoveTest> ("RemoveTest");
-        doTest<PersistantMemoryLocationOfValues> ("PersistantMemoryLocationOfValues");
+        doTest<AddElementsTest, UseHashMap> ("AddElementsTest");
+        doTest<AccessTest, UseHashMap> ("AccessTest");
+        doTest<RemoveTest, UseHashMap> ("RemoveTest");
+        doTest<PersistantMemoryLocationOfValues, UseHashMap> ("PersistantMemoryLocationOfValues");
+
+        doTest<AddElementsTest, UseFlatHashMap> ("FlatHashMap AddElementsTest");
+        doTest<AccessTest, UseFlatHashMap> ("FlatHashMap AccessTest");
+        doTest<RemoveTest, UseFlatHashMap> ("FlatHashMap RemoveTest");
+        doTest<IterationTest, UseFlatHashMap> ("FlatHashMap IterationTest");
+
+        beginTest ("ConcurrentHashMap");
+        testConcurrentHashMap();
     }
 
+    //==============================================================================
+    struct UseHashMap
+    {
+        template <typename KeyType, typename ValueType>
+        using Map = HashMap<KeyType, ValueType>;
+    };
+
+    struct UseFlatHashMap
+    {
+        template <typename KeyType, typename ValueType>
+        using Map = FlatHashMap<KeyType, ValueType>;
+    };
+
     //==============================================================================
     struct AddElementsTest
     {
-        template <typename KeyType>
+        template <typename KeyType, typename MapKind>
         static void run (UnitTest& u)
         {
             AssociativeMap<KeyType, int> groundTruth;
-            HashMap<KeyType, int> hashMap;
+            typename MapKind::template Map<KeyType, int> hashMap;
 
             RandomKeys<KeyType> keyOracle (300, 3827829);
             Random valueOracle (48735);
@@ -70,11 +91,11 @@ struct HashMapTest : public UnitTest
 
     struct AccessTest
     {
-        template <typename KeyType>
+        template <typename KeyType, typename MapKind>
         static void run (UnitTest& u)
         {
             AssociativeMap<KeyType, int> groundTruth;
-            HashMap<KeyType, int> hashMap;
+            typename MapKind::template Map<KeyType, int> hashMap;
 
             fillWithRandomValues (hashMap, groundTruth);
 
@@ -85,11 +106,11 @@ struct HashMapTest : public UnitTest
 
     struct RemoveTest
     {
-        template <typename KeyType>
+        template <typename KeyType, typename MapKind>
         static void run (UnitTest& u)
         {
             AssociativeMap<KeyType, int> groundTruth;
-            HashMap<KeyType, int> hashMap;
+            typename MapKind::template Map<KeyType, int> hashMap;
 
             fillWithRandomValues (hashMap, groundTruth);
             auto n = groundTruth.size();
@@ -117,11 +138,11 @@ struct HashMapTest : public UnitTest
     {
         struct AddressAndValue { int value; const int* valueAddress; };
 
-        template <typename KeyType>
+        template <typename KeyType, typename MapKind>
         static void run (UnitTest& u)
         {
             AssociativeMap<KeyType, AddressAndValue> groundTruth;
-            HashMap<KeyType, int> hashMap;
+            typename MapKind::template Map<KeyType, int> hashMap;
 
             RandomKeys<KeyType> keyOracle (300, 3827829);
             Random valueOracle (48735);
@@ -174,15 +195,105 @@ struct HashMapTest : public UnitTest
         }
     };
 
+    struct IterationTest
+    {
+        template <typename KeyType, typename MapKind>
+        static void run (UnitTest& u)
+        {
+            AssociativeMap<KeyType, int> groundTruth;
+            typename MapKind::template Map<KeyType, int> hashMap;
+
+            fillWithRandomValues (hashMap, groundTruth);
+
+            int numItems = 0;
+
+            for (typename MapKind::template Map<KeyType, int>::Iterator i (hashMap); i.next();)
+            {
+                auto* expected = groundTruth.find (i.getKey());
+                u.expect (expected != nullptr && *expected == i.getValue());
+                ++numItems;
+            }
+
+            u.expectEquals (numItems, groundTruth.size());
+
+            auto valueToRemove = groundTruth.pairs.getReference (0).value;
+            hashMap.removeValue (valueToRemove);
+            u.expect (! hashMap.containsValue (valueToRemove));
+
+            for (auto pair : groundTruth.pairs)
+                if (pair.value != valueToRemove)
+                    u.expectEquals (hashMap[pair.key], pair.value);
+
+            hashMap.remapTable (4096);
+            u.expectEquals (hashMap.getNumSlots(), 4096);
+
+            for (auto pair : groundTruth.pairs)
+                u.expect (hashMap.contains (pair.key) == (pair.value != valueToRemove));
+
+            hashMap.clear();
+            u.expectEquals (hashMap.size(), 0);
+            u.expect (! hashMap.contains (groundTruth.pairs.getReference (0).key));
+        }
+    };
+
+    //==============================================================================
+    void testConcurrentHashMap()
+    {
+        ConcurrentHashMap<int, int> map (8);
+        expectEquals (map.getNumStripes(), 8);
+
+        struct WriterThread  : public Thread
+        {
+            WriterThread (ConcurrentHashMap<int, int>& m, int first)
+                : Thread ("ConcurrentHashMap test"), map (m), firstKey (first) {}
+
+            void run() override
+            {
+                for (int i = 0; i < 5000; ++i)
+                {
+                    map.set (firstKey + i, i);
+                    map.getOrCreate (-1, [] { return 1; });
+
+                    if (i % 3 == 0)
+                        map.remove (firstKey + i);
+                }
+            }
+
+            ConcurrentHashMap<int, int>& map;
+            const int firstKey;
+        };
+
+        OwnedArray<WriterThread> threads;
+
+        for (int i = 0; i < 4; ++i)
+            threads.add (new WriterThread (map, i * 100000))->startThread();
+
+        for (auto* t : threads)
+            t->stopThread (-1);
+
+        expectEquals (map.size(), 4 * 3333 + 1);
+        expectEquals (map[-1], 1);
+        expectEquals (map[100001], 1);
+        expect (! map.contains (100000));
+
+        int value = 0;
+        expect (map.get (304999, value) && value == 4999);
+        expect (! map.get (304998, value));
+
+        int64 total = 0;
+        map.forEach ([&] (int key, int v) { if (key >= 0) total += v; });
+        expectEquals (total, (int64) 4 * (12497500 - 4165833));
+    }
+
     //==============================================================================
-    template <class Test>
+    template <class Test, class MapKind>
     void doTest (const String& testName)
     {
         beginTest (testName);
 
-        Test::template run<int> (*this);
-        Test::template run<void*> (*this);
-        Test::template run<String> (*this);
+        Test::template run<int, MapKind> (*this);
+        Test::template run<void*, MapKind> (*this);
+        Test::template run<String, MapKind> (*this);
     }
 
     //==============================================================================
@@ -219,8 +330,8 @@ struct HashMapTest : public UnitTest
         Array<KeyValuePair> pairs;
     };
 
-    template <typename KeyType, typename ValueType>
-    static void fillWithRandomValues (HashMap<KeyType, int>& hashMap, AssociativeMap<KeyType, ValueType>& groundTruth)
+    template <typename MapType, typename KeyType, typename ValueType>
+    static void fillWithRandomValues (MapType& hashMap, AssociativeMap<KeyType, ValueType>& groundTruth)
     {
         RandomKeys<KeyType> keyOracle (300, 3827829);
         Random valueOracle (48735);
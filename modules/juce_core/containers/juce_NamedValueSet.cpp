@@ -55,35 +55,108 @@ bool NamedValueSet::NamedValue::operator== (const NamedValue& other) const noexc
 bool NamedValueSet::NamedValue::operator!= (const NamedValue& other) const noexcept   { return ! operator== (other); }
 
 //==============================================================================
+namespace NamedValueSetHelpers
+{
+    // Sets with more values than this will use a hash table to find them
+    constexpr int minSizeForHashTable = 16;
+
+    // Identifiers are pooled, so the address of the name is enough to identify one
+    static uint32 getHash (const Identifier& name) noexcept
+    {
+        auto address = (uint64) (pointer_sized_uint) name.getCharPointer().getAddress();
+        return (uint32) ((address * 0x9e3779b97f4a7c15ull) >> 32);
+    }
+}
+
 NamedValueSet::NamedValueSet() noexcept {}
 NamedValueSet::~NamedValueSet() noexcept {}
 
-NamedValueSet::NamedValueSet (const NamedValueSet& other)  : values (other.values) {}
+NamedValueSet::NamedValueSet (const NamedValueSet& other)  : values (other.values)
+{
+    updateHashTable();
+}
 
 NamedValueSet::NamedValueSet (NamedValueSet&& other) noexcept
-   : values (std::move (other.values)) {}
+   : values (std::move (other.values)),
+     hashTable (std::move (other.hashTable)),
+     hashTableSize (other.hashTableSize)
+{
+    other.hashTableSize = 0;
+}
 
 NamedValueSet::NamedValueSet (std::initializer_list<NamedValue> list)
    : values (std::move (list))
 {
+    updateHashTable();
 }
 
 NamedValueSet& NamedValueSet::operator= (const NamedValueSet& other)
 {
     clear();
     values = other.values;
+    updateHashTable();
     return *this;
 }
 
 NamedValueSet& NamedValueSet::operator= (NamedValueSet&& other) noexcept
 {
     other.values.swapWith (values);
+    other.hashTable.swapWith (hashTable);
+    std::swap (other.hashTableSize, hashTableSize);
     return *this;
 }
 
 void NamedValueSet::clear()
 {
     values.clear();
+    updateHashTable();
+}
+
+//==============================================================================
+void NamedValueSet::updateHashTable()
+{
+    auto numValues = values.size();
+
+    if (numValues <= NamedValueSetHelpers::minSizeForHashTable)
+    {
+        hashTable.free();
+        hashTableSize = 0;
+        return;
+    }
+
+    auto newSize = (int) nextPowerOfTwo (numValues * 2);
+
+    if (newSize != hashTableSize)
+    {
+        hashTable.malloc (newSize);
+        hashTableSize = newSize;
+    }
+
+    zeromem (hashTable, sizeof (int) * (size_t) hashTableSize);
+
+    for (int i = 0; i < numValues; ++i)
+        addToHashTable (i);
+}
+
+void NamedValueSet::addToHashTable (int index) noexcept
+{
+    auto mask = (uint32) hashTableSize - 1;
+    auto slot = NamedValueSetHelpers::getHash (values.getReference (index).name) & mask;
+
+    while (hashTable[slot] != 0)
+        slot = (slot + 1) & mask;
+
+    hashTable[slot] = index + 1;
+}
+
+void NamedValueSet::addValue (NamedValue&& newValue)
+{
+    values.add (std::move (newValue));
+
+    if (values.size() * 2 > hashTableSize)
+        updateHashTable();
+    else
+        addToHashTable (values.size() - 1);
 }
 
 bool NamedValueSet::operator== (const NamedValueSet& other) const noexcept
@@ -149,20 +222,12 @@ var NamedValueSet::getWithDefault (const Identifier& name, const var& defaultRet
 
 var* NamedValueSet::getVarPointer (const Identifier& name) noexcept
 {
-    for (auto& i : values)
-        if (i.name == name)
-            return &(i.value);
-
-    return {};
+    return getVarPointerAt (indexOf (name));
 }
 
 const var* NamedValueSet::getVarPointer (const Identifier& name) const noexcept
 {
-    for (auto& i : values)
-        if (i.name == name)
-            return &(i.value);
-
-    return {};
+    return getVarPointerAt (indexOf (name));
 }
 
 bool NamedValueSet::set (const Identifier& name, var&& newValue)
@@ -176,7 +241,7 @@ bool NamedValueSet::set (const Identifier& name, var&& newValue)
         return true;
     }
 
-    values.add ({ name, std::move (newValue) });
+    addValue ({ name, std::move (newValue) });
     return true;
 }
 
@@ -191,7 +256,7 @@ bool NamedValueSet::set (const Identifier& name, const var& newValue)
         return true;
     }
 
-    values.add ({ name, newValue });
+    addValue ({ name, newValue });
     return true;
 }
 
@@ -202,6 +267,19 @@ bool NamedValueSet::contains (const Identifier& name) const noexcept
 
 int NamedValueSet::indexOf (const Identifier& name) const noexcept
 {
+    if (hashTableSize > 0)
+    {
+        auto mask = (uint32) hashTableSize - 1;
+
+        for (auto slot = NamedValueSetHelpers::getHash (name) & mask;; slot = (slot + 1) & mask)
+        {
+            auto index = hashTable[slot] - 1;
+
+            if (index < 0 || values.getReference (index).name == name)
+                return index;
+        }
+    }
+
     auto numValues = values.size();
 
     for (int i = 0; i < numValues; ++i)
@@ -213,18 +291,17 @@ int NamedValueSet::indexOf (const Identifier& name) const noexcept
 
 bool NamedValueSet::remove (const Identifier& name)
 {
-    auto numValues = values.size();
+    auto index = indexOf (name);
 
-    for (int i = 0; i < numValues; ++i)
-    {
-        if (values.getReference(i).name == name)
-        {
-            values.remove (i);
-            return true;
-        }
-    }
+    if (index < 0)
+        return false;
+
+    values.remove (index);
+
+    if (hashTableSize > 0)
+        updateHashTable();
 
-    return false;
+    return true;
 }
 
 Identifier NamedValueSet::getName (const int index) const noexcept
@@ -280,6 +357,8 @@ void NamedValueSet::setFromXmlAttributes (const XmlElement& xml)
 
         values.add ({ att->name, var (att->value) });
     }
+
+    updateHashTable();
 }
 
 void NamedValueSet::copyToXmlAttributes (XmlElement& xml) const
@@ -303,4 +382,61 @@ void NamedValueSet::copyToXmlAttributes (XmlElement& xml) const
     }
 }
 
+//==============================================================================
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class NamedValueSetTests  : public UnitTest
+{
+public:
+    NamedValueSetTests()
+        : UnitTest ("NamedValueSet class", UnitTestCategories::containers)
+    {}
+
+    void runTest() override
+    {
+        beginTest ("Large sets");
+        {
+            NamedValueSet set;
+
+            auto getName = [] (int i) { return Identifier ("value" + String (i)); };
+
+            for (int i = 0; i < 200; ++i)
+                expect (set.set (getName (i), i));
+
+            for (int i = 0; i < 200; i += 3)
+                expect (set.remove (getName (i)));
+
+            expect (! set.set (getName (1), 1));
+            expect (set.set (getName (1), "changed"));
+
+            for (int i = 0; i < 200; ++i)
+            {
+                expect (set.contains (getName (i)) == (i % 3 != 0));
+
+                if (i % 3 != 0)
+                {
+                    expect (set[getName (i)] == (i == 1 ? var ("changed") : var (i)));
+                    expectEquals (set.getName (set.indexOf (getName (i))).toString(), getName (i).toString());
+                }
+            }
+
+            auto copy = set;
+            expect (copy == set);
+
+            NamedValueSet moved (std::move (copy));
+            expect (moved == set && moved.getVarPointer (getName (2)) != nullptr);
+
+            for (int i = 0; i < 200; ++i)
+                set.remove (getName (i));
+
+            expect (set.isEmpty() && ! set.contains (getName (2)));
+        }
+    }
+};
+
+static NamedValueSetTests namedValueSetTests;
+
+#endif
+
 } // namespace juce
@@ -29,6 +29,10 @@ namespace juce
     This can be used as a basic structure to hold a set of var object, which can
     be retrieved by using their identifier.
 
+    Small sets are simply searched in order, but once a set holds more than a few
+    values it also keeps a hash table of their names, so that looking up a value
+    in a large set doesn't need to check every item.
+
     @tags{Core}
 */
 class JUCE_API  NamedValueSet
@@ -180,6 +184,12 @@ public:
 private:
     //==============================================================================
     Array<NamedValue> values;
+    HeapBlock<int> hashTable;   // holds (index + 1) of each value, or 0 for an empty slot
+    int hashTableSize = 0;
+
+    void addValue (NamedValue&&);
+    void updateHashTable();
+    void addToHashTable (int index) noexcept;
 };
 
 } // namespace juce
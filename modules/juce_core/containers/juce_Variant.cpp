@@ -40,9 +40,27 @@ enum VariantStreamMarkers
 class var::VariantType
 {
 public:
-    VariantType() noexcept {}
+    /*  The primitive types are given a tag, so that the common queries and conversions
+        can just switch on it rather than making a virtual call.
+    */
+    enum Tag
+    {
+        otherTag,
+        voidTag,
+        undefinedTag,
+        intTag,
+        int64Tag,
+        boolTag,
+        doubleTag,
+        stringTag,
+        smallStringTag
+    };
+
+    explicit VariantType (Tag t = otherTag) noexcept  : tag (t) {}
     virtual ~VariantType() noexcept {}
 
+    const Tag tag;
+
     virtual int toInt (const ValueUnion&) const noexcept                        { return 0; }
     virtual int64 toInt64 (const ValueUnion&) const noexcept                    { return 0; }
     virtual double toDouble (const ValueUnion&) const noexcept                  { return 0; }
@@ -76,7 +94,7 @@ public:
 class var::VariantType_Void  : public var::VariantType
 {
 public:
-    VariantType_Void() noexcept {}
+    VariantType_Void() noexcept  : VariantType (voidTag) {}
     static const VariantType_Void instance;
 
     bool isVoid() const noexcept override           { return true; }
@@ -89,7 +107,7 @@ public:
 class var::VariantType_Undefined  : public var::VariantType
 {
 public:
-    VariantType_Undefined() noexcept {}
+    VariantType_Undefined() noexcept  : VariantType (undefinedTag) {}
     static const VariantType_Undefined instance;
 
     bool isUndefined() const noexcept override           { return true; }
@@ -107,7 +125,7 @@ public:
 class var::VariantType_Int  : public var::VariantType
 {
 public:
-    VariantType_Int() noexcept {}
+    VariantType_Int() noexcept  : VariantType (intTag) {}
     static const VariantType_Int instance;
 
     int toInt (const ValueUnion& data) const noexcept override       { return data.intValue; }
@@ -138,7 +156,7 @@ public:
 class var::VariantType_Int64  : public var::VariantType
 {
 public:
-    VariantType_Int64() noexcept {}
+    VariantType_Int64() noexcept  : VariantType (int64Tag) {}
     static const VariantType_Int64 instance;
 
     int toInt (const ValueUnion& data) const noexcept override       { return (int) data.int64Value; }
@@ -169,7 +187,7 @@ public:
 class var::VariantType_Double   : public var::VariantType
 {
 public:
-    VariantType_Double() noexcept {}
+    VariantType_Double() noexcept  : VariantType (doubleTag) {}
     static const VariantType_Double instance;
 
     int toInt (const ValueUnion& data) const noexcept override       { return (int) data.doubleValue; }
@@ -197,7 +215,7 @@ public:
 class var::VariantType_Bool   : public var::VariantType
 {
 public:
-    VariantType_Bool() noexcept {}
+    VariantType_Bool() noexcept  : VariantType (boolTag) {}
     static const VariantType_Bool instance;
 
     int toInt (const ValueUnion& data) const noexcept override       { return data.boolValue ? 1 : 0; }
@@ -224,7 +242,7 @@ public:
 class var::VariantType_String   : public var::VariantType
 {
 public:
-    VariantType_String() noexcept {}
+    VariantType_String() noexcept  : VariantType (stringTag) {}
     static const VariantType_String instance;
 
     void cleanUp (ValueUnion& data) const noexcept override                       { getString (data)-> ~String(); }
@@ -235,16 +253,24 @@ public:
     int64 toInt64 (const ValueUnion& data) const noexcept override   { return getString (data)->getLargeIntValue(); }
     double toDouble (const ValueUnion& data) const noexcept override { return getString (data)->getDoubleValue(); }
     String toString (const ValueUnion& data) const override          { return *getString (data); }
-    bool toBool (const ValueUnion& data) const noexcept override     { return getString (data)->getIntValue() != 0
-                                                                           || getString (data)->trim().equalsIgnoreCase ("true")
-                                                                           || getString (data)->trim().equalsIgnoreCase ("yes"); }
+    bool toBool (const ValueUnion& data) const noexcept override     { return stringToBool (*getString (data)); }
     bool isComparable() const noexcept override                      { return true; }
 
     bool equals (const ValueUnion& data, const ValueUnion& otherData, const VariantType& otherType) const noexcept override
     {
+        if (otherType.tag == smallStringTag)
+            return *getString (data) == otherData.smallStringValue;
+
         return otherType.toString (otherData) == *getString (data);
     }
 
+    static bool stringToBool (const String& s) noexcept
+    {
+        return s.getIntValue() != 0
+                || s.trim().equalsIgnoreCase ("true")
+                || s.trim().equalsIgnoreCase ("yes");
+    }
+
     void writeToStream (const ValueUnion& data, OutputStream& output) const override
     {
         auto* s = getString (data);
@@ -261,6 +287,109 @@ private:
     static String* getString (ValueUnion& data) noexcept             { return unalignedPointerCast<String*> (data.stringValue); }
 };
 
+//==============================================================================
+/*  Holds a short ASCII string inside the ValueUnion itself, so that vars created from
+    literals and other short text don't need a heap-allocated String.
+*/
+class var::VariantType_SmallString   : public var::VariantType
+{
+public:
+    VariantType_SmallString() noexcept  : VariantType (smallStringTag) {}
+    static const VariantType_SmallString instance;
+
+    static constexpr int maxLength = (int) sizeof (ValueUnion::smallStringValue) - 1;
+
+    template <typename CharType>
+    static void create (var& v, const CharType* text)
+    {
+        if (canHold (text))
+        {
+            v.type = &instance;
+            zerostruct (v.value.smallStringValue);
+
+            if (text != nullptr)
+                for (int i = 0; text[i] != 0; ++i)
+                    v.value.smallStringValue[i] = (char) text[i];
+        }
+        else
+        {
+            v.type = &VariantType_String::instance;
+            new (v.value.stringValue) String (text);
+        }
+    }
+
+    template <typename CharType>
+    static bool canHold (const CharType* text) noexcept
+    {
+        if (text != nullptr)
+        {
+            for (int i = 0; text[i] != 0; ++i)
+                if (i >= maxLength || (uint32) text[i] >= 128)
+                    return false;
+        }
+
+        return true;
+    }
+
+    bool isString() const noexcept override                          { return true; }
+    int toInt (const ValueUnion& data) const noexcept override       { return CharacterFunctions::getIntValue<int> (getText (data)); }
+    int64 toInt64 (const ValueUnion& data) const noexcept override   { return CharacterFunctions::getIntValue<int64> (getText (data)); }
+    double toDouble (const ValueUnion& data) const noexcept override { return getText (data).getDoubleValue(); }
+    bool toBool (const ValueUnion& data) const noexcept override     { return VariantType_String::stringToBool (toString (data)); }
+
+    // Each thread remembers the Strings that it has recently made from short strings, so
+    // that converting the same text over and over (e.g. reading a ValueTree property that
+    // was loaded from a stream) shares one String instead of creating a new one each time.
+    String toString (const ValueUnion& data) const override
+    {
+        uint64 key;
+        memcpy (&key, data.smallStringValue, sizeof (key));
+
+        if (key == 0)
+            return {};
+
+        struct ConversionCache
+        {
+            uint64 keys[64] = {};
+            String strings[64];
+        };
+
+        thread_local ConversionCache cache;
+        auto index = (size_t) ((key * 0x9e3779b97f4a7c15ull) >> 58);
+
+        if (cache.keys[index] != key)
+        {
+            cache.strings[index] = String (getText (data));
+            cache.keys[index] = key;
+        }
+
+        return cache.strings[index];
+    }
+    bool isComparable() const noexcept override                      { return true; }
+
+    bool equals (const ValueUnion& data, const ValueUnion& otherData, const VariantType& otherType) const noexcept override
+    {
+        if (otherType.tag == smallStringTag)
+            return memcmp (data.smallStringValue, otherData.smallStringValue, sizeof (data.smallStringValue)) == 0;
+
+        if (otherType.tag == stringTag)
+            return otherType.equals (otherData, data, *this);
+
+        return otherType.toString (otherData) == data.smallStringValue;
+    }
+
+    void writeToStream (const ValueUnion& data, OutputStream& output) const override
+    {
+        auto len = strlen (data.smallStringValue) + 1;
+        output.writeCompressedInt ((int) (len + 1));
+        output.writeByte (varMarker_String);
+        output.write (data.smallStringValue, len);
+    }
+
+private:
+    static CharPointer_ASCII getText (const ValueUnion& data) noexcept   { return CharPointer_ASCII (data.smallStringValue); }
+};
+
 //==============================================================================
 class var::VariantType_Object   : public var::VariantType
 {
@@ -431,6 +560,7 @@ const var::VariantType_Int64        var::VariantType_Int64::instance;
 const var::VariantType_Bool         var::VariantType_Bool::instance;
 const var::VariantType_Double       var::VariantType_Double::instance;
 const var::VariantType_String       var::VariantType_String::instance;
+const var::VariantType_SmallString  var::VariantType_SmallString::instance;
 const var::VariantType_Object       var::VariantType_Object::instance;
 const var::VariantType_Array        var::VariantType_Array::instance;
 const var::VariantType_Binary       var::VariantType_Binary::instance;
@@ -457,8 +587,8 @@ var::var (const double v) noexcept    : type (&VariantType_Double::instance) { v
 var::var (NativeFunction m) noexcept  : type (&VariantType_Method::instance) { value.methodValue = new NativeFunction (m); }
 var::var (const Array<var>& v)        : type (&VariantType_Array::instance)  { value.objectValue = new VariantType_Array::RefCountedArray(v); }
 var::var (const String& v)            : type (&VariantType_String::instance) { new (value.stringValue) String (v); }
-var::var (const char* const v)        : type (&VariantType_String::instance) { new (value.stringValue) String (v); }
-var::var (const wchar_t* const v)     : type (&VariantType_String::instance) { new (value.stringValue) String (v); }
+var::var (const char* const v)        { VariantType_SmallString::create (*this, v); }
+var::var (const wchar_t* const v)     { VariantType_SmallString::create (*this, v); }
 var::var (const void* v, size_t sz)   : type (&VariantType_Binary::instance) { value.binaryValue = new MemoryBlock (v, sz); }
 var::var (const MemoryBlock& v)       : type (&VariantType_Binary::instance) { value.binaryValue = new MemoryBlock (v); }
 
@@ -484,23 +614,68 @@ var::var (ReferenceCountedObject* const object)  : type (&VariantType_Object::in
 var var::undefined() noexcept           { return var (VariantType_Undefined::instance); }
 
 //==============================================================================
-bool var::isVoid() const noexcept       { return type->isVoid(); }
-bool var::isUndefined() const noexcept  { return type->isUndefined(); }
-bool var::isInt() const noexcept        { return type->isInt(); }
-bool var::isInt64() const noexcept      { return type->isInt64(); }
-bool var::isBool() const noexcept       { return type->isBool(); }
-bool var::isDouble() const noexcept     { return type->isDouble(); }
-bool var::isString() const noexcept     { return type->isString(); }
+bool var::isVoid() const noexcept       { return type->tag == VariantType::voidTag; }
+bool var::isUndefined() const noexcept  { return type->tag == VariantType::undefinedTag; }
+bool var::isInt() const noexcept        { return type->tag == VariantType::intTag; }
+bool var::isInt64() const noexcept      { return type->tag == VariantType::int64Tag; }
+bool var::isBool() const noexcept       { return type->tag == VariantType::boolTag; }
+bool var::isDouble() const noexcept     { return type->tag == VariantType::doubleTag; }
+bool var::isString() const noexcept     { return type->tag == VariantType::stringTag || type->tag == VariantType::smallStringTag; }
 bool var::isObject() const noexcept     { return type->isObject(); }
 bool var::isArray() const noexcept      { return type->isArray(); }
 bool var::isBinaryData() const noexcept { return type->isBinary(); }
 bool var::isMethod() const noexcept     { return type->isMethod(); }
 
-var::operator int() const noexcept                      { return type->toInt (value); }
-var::operator int64() const noexcept                    { return type->toInt64 (value); }
-var::operator bool() const noexcept                     { return type->toBool (value); }
-var::operator float() const noexcept                    { return (float) type->toDouble (value); }
-var::operator double() const noexcept                   { return type->toDouble (value); }
+var::operator int() const noexcept
+{
+    auto tag = type->tag;
+
+    if (tag == VariantType::intTag)     return value.intValue;
+    if (tag == VariantType::int64Tag)   return (int) value.int64Value;
+    if (tag == VariantType::doubleTag)  return (int) value.doubleValue;
+    if (tag == VariantType::boolTag)    return value.boolValue ? 1 : 0;
+
+    return type->toInt (value);
+}
+
+var::operator int64() const noexcept
+{
+    auto tag = type->tag;
+
+    if (tag == VariantType::intTag)     return (int64) value.intValue;
+    if (tag == VariantType::int64Tag)   return value.int64Value;
+    if (tag == VariantType::doubleTag)  return (int64) value.doubleValue;
+    if (tag == VariantType::boolTag)    return value.boolValue ? 1 : 0;
+
+    return type->toInt64 (value);
+}
+
+var::operator bool() const noexcept
+{
+    auto tag = type->tag;
+
+    if (tag == VariantType::boolTag)    return value.boolValue;
+    if (tag == VariantType::intTag)     return value.intValue != 0;
+    if (tag == VariantType::int64Tag)   return value.int64Value != 0;
+    if (tag == VariantType::doubleTag)  return value.doubleValue != 0.0;
+    if (tag == VariantType::voidTag)    return false;
+
+    return type->toBool (value);
+}
+
+var::operator double() const noexcept
+{
+    auto tag = type->tag;
+
+    if (tag == VariantType::doubleTag)  return value.doubleValue;
+    if (tag == VariantType::intTag)     return (double) value.intValue;
+    if (tag == VariantType::int64Tag)   return (double) value.int64Value;
+    if (tag == VariantType::boolTag)    return value.boolValue ? 1.0 : 0.0;
+
+    return type->toDouble (value);
+}
+
+var::operator float() const noexcept                    { return (float) operator double(); }
 String var::toString() const                            { return type->toString (value); }
 var::operator String() const                            { return type->toString (value); }
 ReferenceCountedObject* var::getObject() const noexcept { return type->toObject (value); }
@@ -520,8 +695,8 @@ var& var::operator= (const int v)                { type->cleanUp (value); type =
 var& var::operator= (const int64 v)              { type->cleanUp (value); type = &VariantType_Int64::instance; value.int64Value = v; return *this; }
 var& var::operator= (const bool v)               { type->cleanUp (value); type = &VariantType_Bool::instance; value.boolValue = v; return *this; }
 var& var::operator= (const double v)             { type->cleanUp (value); type = &VariantType_Double::instance; value.doubleValue = v; return *this; }
-var& var::operator= (const char* const v)        { type->cleanUp (value); type = &VariantType_String::instance; new (value.stringValue) String (v); return *this; }
-var& var::operator= (const wchar_t* const v)     { type->cleanUp (value); type = &VariantType_String::instance; new (value.stringValue) String (v); return *this; }
+var& var::operator= (const char* const v)        { type->cleanUp (value); VariantType_SmallString::create (*this, v); return *this; }
+var& var::operator= (const wchar_t* const v)     { type->cleanUp (value); VariantType_SmallString::create (*this, v); return *this; }
 var& var::operator= (const String& v)            { type->cleanUp (value); type = &VariantType_String::instance; new (value.stringValue) String (v); return *this; }
 var& var::operator= (const MemoryBlock& v)       { type->cleanUp (value); type = &VariantType_Binary::instance; value.binaryValue = new MemoryBlock (v); return *this; }
 var& var::operator= (const Array<var>& v)        { var v2 (v); swapWith (v2); return *this; }
@@ -567,6 +742,23 @@ var& var::operator= (String&& v)
 //==============================================================================
 bool var::equals (const var& other) const noexcept
 {
+    if (type == other.type)
+    {
+        switch (type->tag)
+        {
+            case VariantType::voidTag:
+            case VariantType::undefinedTag:  return true;
+            case VariantType::intTag:        return value.intValue == other.value.intValue;
+            case VariantType::int64Tag:      return value.int64Value == other.value.int64Value;
+            case VariantType::boolTag:       return value.boolValue == other.value.boolValue;
+
+            case VariantType::doubleTag:
+            case VariantType::stringTag:
+            case VariantType::smallStringTag:
+            case VariantType::otherTag:      break;
+        }
+    }
+
     return type->equals (value, other.value, *other.type);
 }
 
@@ -577,7 +769,7 @@ bool var::equalsWithSameType (const var& other) const noexcept
 
 bool var::hasSameTypeAs (const var& other) const noexcept
 {
-    return type == other.type;
+    return type == other.type || (isString() && other.isString());
 }
 
 bool canCompare (const var& v1, const var& v2)
@@ -787,6 +979,14 @@ var var::readFromStream (InputStream& input)
             {
                 MemoryOutputStream mo;
                 mo.writeFromInputStream (input, numBytes - 1);
+
+                auto* text = static_cast<const char*> (mo.getData());
+                auto size = mo.getDataSize();
+
+                if (size > 0 && size <= (size_t) VariantType_SmallString::maxLength + 1
+                     && text[size - 1] == 0 && VariantType_SmallString::canHold (text))
+                    return var (text);
+
                 return var (mo.toUTF8());
             }
 
@@ -827,4 +1027,77 @@ var::NativeFunctionArgs::NativeFunctionArgs (const var& t, const var* args, int
 {
 }
 
+
+//==============================================================================
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class VariantTests  : public UnitTest
+{
+public:
+    VariantTests()
+        : UnitTest ("var class", UnitTestCategories::containers)
+    {}
+
+    void runTest() override
+    {
+        beginTest ("Primitive conversions");
+        {
+            expectEquals ((int) var (3.7), 3);
+            expectEquals ((int64) var (true), (int64) 1);
+            expectEquals ((double) var ((int64) 1 << 40), (double) ((int64) 1 << 40));
+            expect (! (bool) var());
+            expect ((bool) var (0.5));
+            expect (var (2) == var (2.0));
+            expect (var ((int64) 5) == var (5));
+            expect (var (true) != var (false));
+        }
+
+        beginTest ("Short strings");
+        {
+            var shortString ("abc"), longString ("a longer string");
+            var fromString (String ("abc")), wide (L"abc");
+
+            expect (shortString.isString() && longString.isString() && wide.isString());
+            expect (shortString == fromString && fromString == shortString && wide == shortString);
+            expect (shortString.equalsWithSameType (fromString));
+            expect (shortString != var ("abd"));
+            expect (shortString == "abc" && shortString == String ("abc"));
+            expectEquals (shortString.toString(), String ("abc"));
+            expectEquals (var ("1234567").toString(), String ("1234567"));
+
+            // Converting the same short string again shouldn't make a new String
+            expect (shortString.toString().getCharPointer() == var ("abc").toString().getCharPointer());
+            expectEquals (var (L"\u00e9t\u00e9").toString(), String (CharPointer_UTF8 ("\xc3\xa9t\xc3\xa9")));
+
+            expectEquals ((int) var ("42"), 42);
+            expectEquals ((int64) var ("-42"), (int64) -42);
+            expectEquals ((double) var ("1.5"), 1.5);
+            expect ((bool) var ("yes") && (bool) var ("1") && ! (bool) var ("no"));
+            expect (var ("12") == var (12) && var (12) == var ("12"));
+            expect (var ("") == var (String()) && var ("").toString().isEmpty());
+            expect (var ("a") < var ("b"));
+
+            var v;
+            v = "xyz";
+            expectEquals (v.toString(), String ("xyz"));
+            v = "a string too long to fit";
+            expectEquals (v.toString(), String ("a string too long to fit"));
+
+            for (auto& s : { var ("abc"), var (""), longString })
+            {
+                MemoryOutputStream out;
+                s.writeToStream (out);
+                MemoryInputStream in (out.getData(), out.getDataSize(), false);
+                auto result = var::readFromStream (in);
+                expect (result.isString() && result == s);
+            }
+        }
+    }
+};
+
+static VariantTests variantTests;
+
+#endif
+
 } // namespace juce
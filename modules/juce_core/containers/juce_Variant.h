@@ -291,6 +291,7 @@ private:
     class VariantType_Double;
     class VariantType_Bool;
     class VariantType_String;
+    class VariantType_SmallString;
     class VariantType_Object;
     class VariantType_Array;
     class VariantType_Binary;
@@ -303,6 +304,7 @@ private:
         bool boolValue;
         double doubleValue;
         char stringValue[sizeof (String)];
+        char smallStringValue[sizeof (int64)];
         ReferenceCountedObject* objectValue;
         MemoryBlock* binaryValue;
         NativeFunction* methodValue;
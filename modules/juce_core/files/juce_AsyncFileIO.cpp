@@ -0,0 +1,375 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2020 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   To use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+#if ! (JUCE_LINUX && JUCE_USE_IO_URING)
+struct AsyncFileIO::KernelQueue
+{
+    static std::unique_ptr<KernelQueue> create (AsyncFileIO&, int)     { return {}; }
+    void submit (Request*)                                              { jassertfalse; }
+};
+#endif
+
+//==============================================================================
+class AsyncFileIO::WorkerThread  : public Thread
+{
+public:
+    WorkerThread (AsyncFileIO& o)  : Thread ("AsyncFileIO worker"), owner (o) {}
+
+    void run() override
+    {
+        while (! threadShouldExit())
+        {
+            if (auto* request = owner.takeNextQueuedRequest())
+                owner.performOnWorkerThread (*request);
+            else
+                wait (-1);
+        }
+    }
+
+private:
+    AsyncFileIO& owner;
+
+    JUCE_DECLARE_NON_COPYABLE (WorkerThread)
+};
+
+//==============================================================================
+AsyncFileIO::OpenFile::OpenFile (const File& fileToOpen, bool openForWriting)
+    : file (fileToOpen)
+{
+    openHandle (openForWriting);
+}
+
+AsyncFileIO::OpenFile::~OpenFile()
+{
+    closeHandle();
+}
+
+//==============================================================================
+AsyncFileIO::AsyncFileIO (int maxRequestsInFlight, int numThreadsToUse, bool allowKernelQueue)
+    : numThreads (jmax (1, numThreadsToUse))
+{
+    if (allowKernelQueue)
+        kernelQueue = KernelQueue::create (*this, maxRequestsInFlight);
+}
+
+AsyncFileIO::~AsyncFileIO()
+{
+    waitForAll();
+
+    for (auto* w : workers)
+        w->signalThreadShouldExit();
+
+    for (auto* w : workers)
+    {
+        w->notify();
+        w->stopThread (-1);
+    }
+
+    kernelQueue.reset();
+}
+
+void AsyncFileIO::read (OpenFile& file, int64 position, void* destBuffer, size_t numBytes, Callback callback)
+{
+    jassert (file.openedOk());
+
+    auto* r = new Request();
+    r->file = &file;
+    r->position = position;
+    r->data = static_cast<char*> (destBuffer);
+    r->numBytes = numBytes;
+    r->callback = std::move (callback);
+    addRequest (r);
+}
+
+void AsyncFileIO::write (OpenFile& file, int64 position, const void* sourceData, size_t numBytes, Callback callback)
+{
+    jassert (file.openedOk());
+
+    auto* r = new Request();
+    r->file = &file;
+    r->position = position;
+    r->data = static_cast<char*> (const_cast<void*> (sourceData));
+    r->numBytes = numBytes;
+    r->isWrite = true;
+    r->callback = std::move (callback);
+    addRequest (r);
+}
+
+void AsyncFileIO::read (InputStream& source, void* destBuffer, size_t numBytes, Callback callback)
+{
+    auto* r = new Request();
+    r->input = &source;
+    r->data = static_cast<char*> (destBuffer);
+    r->numBytes = numBytes;
+    r->callback = std::move (callback);
+    addRequest (r);
+}
+
+void AsyncFileIO::write (OutputStream& destination, const void* sourceData, size_t numBytes, Callback callback)
+{
+    auto* r = new Request();
+    r->output = &destination;
+    r->data = static_cast<char*> (const_cast<void*> (sourceData));
+    r->numBytes = numBytes;
+    r->isWrite = true;
+    r->callback = std::move (callback);
+    addRequest (r);
+}
+
+bool AsyncFileIO::waitForAll (int timeoutMilliseconds)
+{
+    std::unique_lock<std::mutex> lock (finishedLock);
+    auto allFinished = [this] { return numPending.load() == 0; };
+
+    if (timeoutMilliseconds < 0)
+    {
+        finishedCondition.wait (lock, allFinished);
+        return true;
+    }
+
+    return finishedCondition.wait_for (lock, std::chrono::milliseconds (timeoutMilliseconds), allFinished);
+}
+
+//==============================================================================
+void AsyncFileIO::addRequest (Request* r)
+{
+    ++numPending;
+
+    if (r->file != nullptr && kernelQueue != nullptr)
+        kernelQueue->submit (r);
+    else
+        addToWorkerQueue (r);
+}
+
+void AsyncFileIO::addToWorkerQueue (Request* r)
+{
+    const ScopedLock sl (queueLock);
+    queue.add (r);
+
+    while (workers.size() < numThreads)
+        workers.add (new WorkerThread (*this))->startThread();
+
+    for (auto* w : workers)
+        w->notify();
+}
+
+AsyncFileIO::Request* AsyncFileIO::takeNextQueuedRequest()
+{
+    const ScopedLock sl (queueLock);
+
+    for (int i = 0; i < queue.size(); ++i)
+    {
+        auto* r = queue.getUnchecked (i);
+        auto* stream = r->getStream();
+
+        if (stream != nullptr)
+        {
+            // Only one thread at a time can use a stream, and its requests must stay in order
+            if (streamsInUse.contains (stream))
+                continue;
+
+            streamsInUse.add (stream);
+        }
+
+        queue.remove (i);
+        return r;
+    }
+
+    return nullptr;
+}
+
+void AsyncFileIO::performOnWorkerThread (Request& r)
+{
+    auto result = Result::ok();
+
+    if (r.file != nullptr)
+    {
+        result = r.file->transfer (r.isWrite, r.position, r.data, r.numBytes, r.numDone);
+    }
+    else if (r.input != nullptr)
+    {
+        while (r.numDone < r.numBytes)
+        {
+            auto numToRead = (int) jmin ((size_t) std::numeric_limits<int>::max(), r.numBytes - r.numDone);
+            auto numRead = r.input->read (r.data + r.numDone, numToRead);
+
+            if (numRead <= 0)
+                break;
+
+            r.numDone += (size_t) numRead;
+        }
+    }
+    else if (r.output != nullptr)
+    {
+        if (r.output->write (r.data, r.numBytes))
+            r.numDone = r.numBytes;
+        else
+            result = Result::fail ("Couldn't write to the stream");
+    }
+
+    auto* stream = r.getStream();
+    finishRequest (&r, result);
+
+    if (stream != nullptr)
+    {
+        const ScopedLock sl (queueLock);
+        streamsInUse.removeFirstMatchingValue (stream);
+
+        // Another thread may have skipped a request that was waiting for this stream
+        for (auto* w : workers)
+            w->notify();
+    }
+}
+
+void AsyncFileIO::finishRequest (Request* r, const Result& result)
+{
+    std::unique_ptr<Request> request (r);
+
+    if (request->callback != nullptr)
+        request->callback (result, request->numDone);
+
+    request.reset();
+
+    std::lock_guard<std::mutex> lock (finishedLock);
+
+    if (--numPending == 0)
+        finishedCondition.notify_all();
+}
+
+
+//==============================================================================
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class AsyncFileIOTests  : public UnitTest
+{
+public:
+    AsyncFileIOTests()
+        : UnitTest ("AsyncFileIO", UnitTestCategories::files)
+    {}
+
+    void runTest() override
+    {
+        runTestsWithBackend (true);
+        runTestsWithBackend (false);
+    }
+
+    void runTestsWithBackend (bool allowKernelQueue)
+    {
+        const String suffix (allowKernelQueue ? " (kernel queue)" : " (threads)");
+        constexpr int blockSize = 4096, numBlocks = 64;
+
+        TemporaryFile tempFile;
+        HeapBlock<uint8> written (blockSize * numBlocks), readBack (blockSize * numBlocks, true);
+
+        auto random = getRandom();
+
+        for (int i = 0; i < blockSize * numBlocks; ++i)
+            written[i] = (uint8) random.nextInt (256);
+
+        beginTest ("Writing blocks" + suffix);
+        {
+            AsyncFileIO io (16, 4, allowKernelQueue);
+            AsyncFileIO::OpenFile file (tempFile.getFile(), true);
+            expect (file.openedOk());
+
+            std::atomic<int> numOk { 0 };
+
+            for (int i = numBlocks; --i >= 0;)
+                io.write (file, i * blockSize, written + i * blockSize, blockSize,
+                          [&numOk] (const Result& r, size_t numBytes)
+                          {
+                              if (r.wasOk() && numBytes == (size_t) blockSize)
+                                  ++numOk;
+                          });
+
+            expect (io.waitForAll (10000));
+            expectEquals (numOk.load(), numBlocks);
+            expectEquals (io.getNumPendingRequests(), 0);
+            expectEquals (file.getSize(), (int64) (blockSize * numBlocks));
+        }
+
+        beginTest ("Reading blocks" + suffix);
+        {
+            AsyncFileIO io (16, 4, allowKernelQueue);
+            AsyncFileIO::OpenFile file (tempFile.getFile());
+            expect (file.openedOk());
+
+            std::atomic<int> numOk { 0 };
+            std::atomic<size_t> numAtEnd { 0 };
+
+            for (int i = 0; i < numBlocks; ++i)
+                io.read (file, i * blockSize, readBack + i * blockSize, blockSize,
+                         [&numOk] (const Result& r, size_t numBytes)
+                         {
+                             if (r.wasOk() && numBytes == (size_t) blockSize)
+                                 ++numOk;
+                         });
+
+            char overflow[100];
+
+            io.read (file, blockSize * numBlocks - 10, overflow, sizeof (overflow),
+                     [&numAtEnd] (const Result&, size_t numBytes) { numAtEnd = numBytes; });
+
+            expect (io.waitForAll (10000));
+            expectEquals (numOk.load(), numBlocks);
+            expectEquals ((int) numAtEnd.load(), 10);
+            expect (memcmp (written, readBack, (size_t) (blockSize * numBlocks)) == 0);
+        }
+
+        beginTest ("Streams" + suffix);
+        {
+            AsyncFileIO io (16, 4, allowKernelQueue);
+            FileInputStream in (tempFile.getFile());
+            MemoryOutputStream out;
+            HeapBlock<uint8> fromStream (blockSize * numBlocks, true);
+
+            for (int i = 0; i < numBlocks; ++i)
+            {
+                io.read (in, fromStream + i * blockSize, blockSize, nullptr);
+                io.write (out, written + i * blockSize, blockSize, nullptr);
+            }
+
+            expect (io.waitForAll (10000));
+            expect (memcmp (written, fromStream, (size_t) (blockSize * numBlocks)) == 0);
+            expect (out.getDataSize() == (size_t) (blockSize * numBlocks));
+            expect (memcmp (written, out.getData(), out.getDataSize()) == 0);
+        }
+
+        beginTest ("Errors" + suffix);
+        {
+            AsyncFileIO::OpenFile missing (File::getSpecialLocation (File::tempDirectory)
+                                              .getNonexistentChildFile ("AsyncFileIO", ".tmp"));
+            expect (! missing.openedOk());
+            expect (missing.getStatus().failed());
+        }
+    }
+};
+
+static AsyncFileIOTests asyncFileIOTests;
+
+#endif
+
+} // namespace juce
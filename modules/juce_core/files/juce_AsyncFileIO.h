@@ -0,0 +1,211 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2020 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   To use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    Performs file reads and writes in the background, calling a function when each
+    one has finished.
+
+    This lets you keep many reads or writes outstanding at once without needing a
+    thread for each file, e.g. when streaming samples from disk or importing a
+    large number of files.
+
+    On Linux, reads and writes to an OpenFile are handed to the kernel using
+    io_uring, so a single background thread collects all their results. If that
+    isn't available (or on other platforms), a small pool of threads performs
+    them using blocking positional reads and writes.
+
+    @code
+    AsyncFileIO io;
+    AsyncFileIO::OpenFile sampleFile (file);
+
+    for (auto& block : blocksToLoad)
+        io.read (sampleFile, block.filePosition, block.data, block.numBytes,
+                 [&block] (const Result& result, size_t numBytesRead)
+                 {
+                     block.isLoaded = result.wasOk() && numBytesRead == block.numBytes;
+                 });
+    @endcode
+
+    The callbacks are made on a background thread, so they must be thread-safe, and
+    should be kept short because they hold up the delivery of other results.
+    The memory that's being read into or written from must stay valid until the
+    request's callback has been made.
+
+    @see FileInputStream, FileOutputStream, TimeSliceThread
+
+    @tags{Core}
+*/
+class JUCE_API  AsyncFileIO
+{
+public:
+    //==============================================================================
+    /** Creates an AsyncFileIO object.
+
+        @param maxRequestsInFlight  the number of reads and writes that can be waiting
+                                    in the kernel at once. Any more than this are
+                                    queued until some have finished.
+        @param numThreads           the number of threads to use for requests that
+                                    can't be handed to the kernel
+        @param allowKernelQueue     if false, io_uring won't be used even if it's
+                                    available
+    */
+    explicit AsyncFileIO (int maxRequestsInFlight = 128,
+                          int numThreads = 4,
+                          bool allowKernelQueue = true);
+
+    /** Destructor.
+        This waits for all outstanding requests to finish, and makes their callbacks.
+    */
+    ~AsyncFileIO();
+
+    //==============================================================================
+    /** A file that has been opened for use with AsyncFileIO.
+
+        Unlike a FileInputStream, this doesn't have a current position, so any
+        number of reads and writes can be made on it at once.
+    */
+    class JUCE_API  OpenFile
+    {
+    public:
+        /** Opens a file for reading, or for reading and writing. If it's opened for writing
+            and doesn't exist, it will be created.
+        */
+        explicit OpenFile (const File& fileToOpen, bool openForWriting = false);
+
+        /** Closes the file. There mustn't be any outstanding requests that use it. */
+        ~OpenFile();
+
+        /** Returns the file that was opened. */
+        const File& getFile() const noexcept                { return file; }
+
+        /** Returns true if the file was opened successfully. */
+        bool openedOk() const noexcept                      { return fileHandle != nullptr; }
+
+        /** If the file couldn't be opened, this describes the problem. */
+        const Result& getStatus() const noexcept            { return status; }
+
+        /** Returns the current size of the file. */
+        int64 getSize() const;
+
+    private:
+        friend class AsyncFileIO;
+
+        File file;
+        void* fileHandle = nullptr;
+        Result status { Result::ok() };
+
+        void openHandle (bool forWriting);
+        void closeHandle();
+        Result transfer (bool isWrite, int64 position, char* data, size_t numBytes, size_t& numDone) const;
+
+        JUCE_DECLARE_NON_COPYABLE (OpenFile)
+    };
+
+    //==============================================================================
+    /** The type of function that's called when a request has finished.
+        If the request failed, the Result describes the problem. The number of bytes
+        will be less than the amount that was requested if the end of the file was
+        reached or an error happened.
+    */
+    using Callback = std::function<void (const Result&, size_t numBytesTransferred)>;
+
+    /** Starts reading a block of data from a file. */
+    void read (OpenFile& file, int64 position, void* destBuffer, size_t numBytes, Callback callback);
+
+    /** Starts writing a block of data to a file. */
+    void write (OpenFile& file, int64 position, const void* sourceData, size_t numBytes, Callback callback);
+
+    /** Starts reading a block of data from an InputStream, from its current position.
+
+        This lets any kind of stream be used asynchronously, although it'll always be
+        read by one of the background threads. Requests on the same stream are
+        performed one at a time, in the order they were made, and the stream must not
+        be used by anything else until they've all finished.
+    */
+    void read (InputStream& source, void* destBuffer, size_t numBytes, Callback callback);
+
+    /** Starts writing a block of data to an OutputStream, at its current position.
+        @see read (InputStream&, void*, size_t, Callback)
+    */
+    void write (OutputStream& destination, const void* sourceData, size_t numBytes, Callback callback);
+
+    //==============================================================================
+    /** Waits until all the outstanding requests have finished and their callbacks
+        have been made. Returns false if this timed out first.
+    */
+    bool waitForAll (int timeoutMilliseconds = -1);
+
+    /** Returns the number of requests that haven't finished yet. */
+    int getNumPendingRequests() const noexcept          { return numPending.load(); }
+
+    /** Returns true if requests on an OpenFile are being handed to the kernel, or false
+        if they're being performed by background threads.
+    */
+    bool isUsingKernelQueue() const noexcept            { return kernelQueue != nullptr; }
+
+private:
+    //==============================================================================
+    struct Request
+    {
+        OpenFile* file = nullptr;
+        InputStream* input = nullptr;
+        OutputStream* output = nullptr;
+        int64 position = 0;
+        char* data = nullptr;
+        size_t numBytes = 0, numDone = 0;
+        bool isWrite = false;
+        Callback callback;
+
+        void* getStream() const noexcept
+        {
+            return input != nullptr ? static_cast<void*> (input) : static_cast<void*> (output);
+        }
+    };
+
+    struct KernelQueue;
+    class WorkerThread;
+
+    const int numThreads;
+    std::unique_ptr<KernelQueue> kernelQueue;
+    OwnedArray<WorkerThread> workers;
+    CriticalSection queueLock;
+    Array<Request*> queue;
+    Array<void*> streamsInUse;
+
+    std::atomic<int> numPending { 0 };
+    std::mutex finishedLock;
+    std::condition_variable finishedCondition;
+
+    void addRequest (Request*);
+    void addToWorkerQueue (Request*);
+    Request* takeNextQueuedRequest();
+    void performOnWorkerThread (Request&);
+    void finishRequest (Request*, const Result&);
+
+    JUCE_DECLARE_NON_COPYABLE (AsyncFileIO)
+};
+
+} // namespace juce
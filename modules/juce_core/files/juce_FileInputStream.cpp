@@ -55,6 +55,18 @@ int FileInputStream::read (void* buffer, int bytesToRead)
     return (int) num;
 }
 
+int64 FileInputStream::readIntoMultipleBuffers (void* const* destBuffers, const size_t* bufferSizes, int numBuffers)
+{
+    // You should always check that a stream opened successfully before using it!
+    jassert (openedOk());
+    jassert (destBuffers != nullptr && bufferSizes != nullptr && numBuffers >= 0);
+
+    auto num = readInternal (destBuffers, bufferSizes, numBuffers);
+    currentPosition += (int64) num;
+
+    return (int64) num;
+}
+
 bool FileInputStream::isExhausted()
 {
     return currentPosition >= getTotalLength();
@@ -139,6 +151,23 @@ struct FileInputStreamTests   : public UnitTest
             expect (readBuffer == data);
         }
 
+        beginTest ("Read into multiple buffers");
+        {
+            stream.setPosition (0);
+
+            char first[5], second[1], third[30];
+            void* buffers[] = { first, second, third };
+            const size_t sizes[] = { sizeof (first), sizeof (second), sizeof (third) };
+
+            expectEquals (stream.readIntoMultipleBuffers (buffers, sizes, 3), (int64) data.getSize());
+            expectEquals (stream.getPosition(), (int64) data.getSize());
+            expect (stream.isExhausted());
+
+            expect (memcmp (first, data.begin(), sizeof (first)) == 0);
+            expectEquals (second[0], 'f');
+            expect (memcmp (third, data.begin() + 6, data.getSize() - 6) == 0);
+        }
+
         beginTest ("Skip");
         {
             stream.setPosition (0);
@@ -66,6 +66,20 @@ public:
     */
     bool openedOk() const noexcept                      { return status.wasOk(); }
 
+    //==============================================================================
+    /** Reads data from the current position into a set of separate buffers, filling
+        each one in turn.
+
+        Where possible this is done with a single call to the operating system, so
+        it's quicker than calling read() for each buffer when they're small.
+
+        @param destBuffers  an array of numBuffers pointers to the memory to fill
+        @param bufferSizes  an array of numBuffers sizes of the memory blocks
+        @param numBuffers   the number of buffers
+        @returns the total number of bytes that were read, which may be less than the
+                 sum of the sizes if the end of the file is reached
+    */
+    int64 readIntoMultipleBuffers (void* const* destBuffers, const size_t* bufferSizes, int numBuffers);
 
     //==============================================================================
     int64 getTotalLength() override;
@@ -83,6 +97,7 @@ private:
 
     void openHandle();
     size_t readInternal (void*, size_t);
+    size_t readInternal (void* const*, const size_t*, int);
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (FileInputStream)
 };
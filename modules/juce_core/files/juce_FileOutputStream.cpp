@@ -23,6 +23,189 @@
 namespace juce
 {
 
+//==============================================================================
+/*  Collects the data in blocks which start on the file-system's block boundaries, so
+    that they can be written without going through the system cache, and optionally
+    hands each full block to a shared background thread while the next one is filled.
+*/
+class FileOutputStream::BlockWriter
+{
+public:
+    BlockWriter (FileOutputStream& o, const Options& options)
+        : owner (o),
+          alignment (options.bypassSystemCache ? (size_t) 4096 : (size_t) 1),
+          blockSize (jmax ((size_t) 4096, (options.blockSize + 4095) & ~(size_t) 4095)),
+          writeInBackground (options.writeInBackground)
+    {
+        for (int i = 0; i < (writeInBackground ? 2 : 1); ++i)
+        {
+            storage[i].malloc (blockSize + 4096);
+            blocks[i] = addBytesToPointer (storage[i].get(), 4096 - ((pointer_sized_uint) storage[i].get() & 4095));
+        }
+
+        if (writeInBackground)
+            backgroundThread = std::make_unique<SharedResourcePointer<BackgroundThread>>();
+
+        startBlock (owner.currentPosition);
+    }
+
+    ~BlockWriter()
+    {
+        // The owner should have flushed before deleting this
+        jassert (! writePending);
+        waitForPendingWrite();
+    }
+
+    bool write (const char* data, size_t numBytes)
+    {
+        while (numBytes > 0)
+        {
+            auto numToCopy = jmin (numBytes, blockCapacity - bytesInBlock);
+            memcpy (blocks[currentBlock] + bytesInBlock, data, numToCopy);
+
+            bytesInBlock += numToCopy;
+            owner.currentPosition += (int64) numToCopy;
+            data += numToCopy;
+            numBytes -= numToCopy;
+
+            if (bytesInBlock == blockCapacity && ! writeCurrentBlock())
+                return false;
+        }
+
+        return true;
+    }
+
+    bool flush()
+    {
+        auto ok = bytesInBlock == 0 || writeCurrentBlock();
+        ok = waitForPendingWrite() && ok;
+
+        // Anything that uses the file's own position needs it to be where the stream thinks it is
+        juce_fileSetPosition (owner.fileHandle, owner.currentPosition);
+        return ok;
+    }
+
+    void startBlock (int64 position) noexcept
+    {
+        blockStart = position;
+        bytesInBlock = 0;
+        blockCapacity = blockSize - (size_t) (position % (int64) alignment);
+    }
+
+private:
+    struct BackgroundThread  : public Thread
+    {
+        BackgroundThread()  : Thread ("FileOutputStream writer")    { startThread(); }
+        ~BackgroundThread() override                                { stopThread (-1); }
+
+        void addWrite (BlockWriter& writer)
+        {
+            {
+                const ScopedLock sl (lock);
+                queue.add (&writer);
+            }
+
+            notify();
+        }
+
+        void run() override
+        {
+            while (! threadShouldExit())
+            {
+                BlockWriter* next = nullptr;
+
+                {
+                    const ScopedLock sl (lock);
+
+                    if (! queue.isEmpty())
+                        next = queue.removeAndReturn (0);
+                }
+
+                if (next != nullptr)
+                    next->performPendingWrite();
+                else
+                    wait (-1);
+            }
+        }
+
+        CriticalSection lock;
+        Array<BlockWriter*> queue;
+    };
+
+    FileOutputStream& owner;
+    const size_t alignment, blockSize;
+    const bool writeInBackground;
+    HeapBlock<char> storage[2];
+    char* blocks[2] = {};
+    int currentBlock = 0;
+    size_t bytesInBlock = 0, blockCapacity = 0;
+    int64 blockStart = 0;
+
+    std::unique_ptr<SharedResourcePointer<BackgroundThread>> backgroundThread;
+    const char* pendingData = nullptr;
+    size_t pendingSize = 0;
+    int64 pendingPosition = 0;
+    bool writePending = false;
+    Result pendingResult { Result::ok() };
+    WaitableEvent pendingWriteFinished;
+
+    bool writeCurrentBlock()
+    {
+        if (! waitForPendingWrite())
+            return false;
+
+        auto ok = true;
+
+        if (writeInBackground)
+        {
+            pendingData = blocks[currentBlock];
+            pendingSize = bytesInBlock;
+            pendingPosition = blockStart;
+            writePending = true;
+            (*backgroundThread)->addWrite (*this);
+            currentBlock ^= 1;
+        }
+        else
+        {
+            auto result = owner.writeInternalAt (blockStart, blocks[currentBlock], bytesInBlock);
+
+            if (result.failed())
+            {
+                owner.status = result;
+                ok = false;
+            }
+        }
+
+        startBlock (blockStart + (int64) bytesInBlock);
+        return ok;
+    }
+
+    void performPendingWrite()
+    {
+        pendingResult = owner.writeInternalAt (pendingPosition, pendingData, pendingSize);
+        pendingWriteFinished.signal();
+    }
+
+    bool waitForPendingWrite()
+    {
+        if (! writePending)
+            return true;
+
+        pendingWriteFinished.wait();
+        writePending = false;
+
+        if (pendingResult.failed())
+        {
+            owner.status = pendingResult;
+            return false;
+        }
+
+        return true;
+    }
+
+    JUCE_DECLARE_NON_COPYABLE (BlockWriter)
+};
+
 //==============================================================================
 FileOutputStream::FileOutputStream (const File& f, const size_t bufferSizeToUse)
     : file (f),
@@ -32,9 +215,30 @@ FileOutputStream::FileOutputStream (const File& f, const size_t bufferSizeToUse)
     openHandle();
 }
 
+FileOutputStream::FileOutputStream (const File& f, const Options& options)
+    : file (f),
+      bufferSize (0)
+{
+    openHandle();
+
+    if (openedOk())
+    {
+        if (options.preallocatedSize > 0)
+            preallocate (options.preallocatedSize);
+
+        Options optionsToUse (options);
+
+        if (options.bypassSystemCache && ! setSystemCacheBypassed (true))
+            optionsToUse.bypassSystemCache = false;
+
+        blockWriter = std::make_unique<BlockWriter> (*this, optionsToUse);
+    }
+}
+
 FileOutputStream::~FileOutputStream()
 {
     flushBuffer();
+    blockWriter.reset();
     closeHandle();
 }
 
@@ -49,6 +253,9 @@ bool FileOutputStream::setPosition (int64 newPosition)
     {
         flushBuffer();
         currentPosition = juce_fileSetPosition (fileHandle, newPosition);
+
+        if (blockWriter != nullptr)
+            blockWriter->startBlock (currentPosition);
     }
 
     return newPosition == currentPosition;
@@ -56,6 +263,9 @@ bool FileOutputStream::setPosition (int64 newPosition)
 
 bool FileOutputStream::flushBuffer()
 {
+    if (blockWriter != nullptr)
+        return blockWriter->flush();
+
     bool ok = true;
 
     if (bytesInBuffer > 0)
@@ -80,6 +290,9 @@ bool FileOutputStream::write (const void* const src, const size_t numBytes)
     if (! openedOk())
         return false;
 
+    if (blockWriter != nullptr)
+        return blockWriter->write (static_cast<const char*> (src), numBytes);
+
     if (bytesInBuffer + numBytes < bufferSize)
     {
         memcpy (buffer + bytesInBuffer, src, numBytes);
@@ -116,7 +329,7 @@ bool FileOutputStream::writeRepeatedByte (uint8 byte, size_t numBytes)
 {
     jassert (((ssize_t) numBytes) >= 0);
 
-    if (bytesInBuffer + numBytes < bufferSize)
+    if (blockWriter == nullptr && bytesInBuffer + numBytes < bufferSize)
     {
         memset (buffer + bytesInBuffer, byte, numBytes);
         bytesInBuffer += numBytes;
@@ -127,4 +340,112 @@ bool FileOutputStream::writeRepeatedByte (uint8 byte, size_t numBytes)
     return OutputStream::writeRepeatedByte (byte, numBytes);
 }
 
+//==============================================================================
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+struct FileOutputStreamTests   : public UnitTest
+{
+    FileOutputStreamTests()
+        : UnitTest ("FileOutputStream", UnitTestCategories::streams)
+    {}
+
+    void runTest() override
+    {
+        auto random = getRandom();
+
+        MemoryBlock data (300000);
+
+        for (size_t i = 0; i < data.getSize(); ++i)
+            data[i] = (char) random.nextInt (256);
+
+        for (auto inBackground : { false, true })
+        {
+            for (auto bypassCache : { false, true })
+            {
+                beginTest (String ("Block writing") + (inBackground ? ", in background" : "")
+                             + (bypassCache ? ", bypassing cache" : ""));
+
+                FileOutputStream::Options options;
+                options.blockSize = 65536;
+                options.writeInBackground = inBackground;
+                options.bypassSystemCache = bypassCache;
+                options.preallocatedSize = (int64) data.getSize();
+
+                TemporaryFile tempFile;
+                MemoryBlock expected;
+
+                {
+                    FileOutputStream out (tempFile.getFile(), options);
+                    expect (out.openedOk());
+
+                    for (size_t pos = 0; pos < data.getSize();)
+                    {
+                        auto numBytes = jmin ((size_t) random.nextInt (20000) + 1, data.getSize() - pos);
+                        expect (out.write (addBytesToPointer (data.getData(), pos), numBytes));
+                        pos += numBytes;
+                        expectEquals (out.getPosition(), (int64) pos);
+                    }
+
+                    expected = data;
+                    expect (out.writeRepeatedByte (7, 100));
+                    expected.setSize (data.getSize() + 100);
+                    memset (addBytesToPointer (expected.getData(), data.getSize()), 7, 100);
+
+                    out.flush();
+                    expect (out.getStatus().wasOk());
+                    expectEquals (tempFile.getFile().getSize(), (int64) expected.getSize());
+
+                    expect (out.setPosition (1000));
+                    expect (out.write ("overwritten", 11));
+                    memcpy (addBytesToPointer (expected.getData(), 1000), "overwritten", 11);
+
+                    expect (out.setPosition ((int64) expected.getSize() - 50));
+                    expect (out.truncate().wasOk());
+                    expected.setSize (expected.getSize() - 50);
+                }
+
+                MemoryBlock written;
+                expect (tempFile.getFile().loadFileAsData (written));
+                expect (written == expected);
+            }
+        }
+
+        beginTest ("Appending to an existing file");
+        {
+            TemporaryFile tempFile;
+            tempFile.getFile().replaceWithData (data.getData(), 1234);
+
+            FileOutputStream::Options options;
+            options.bypassSystemCache = true;
+
+            {
+                FileOutputStream out (tempFile.getFile(), options);
+                expectEquals (out.getPosition(), (int64) 1234);
+                expect (out.write (addBytesToPointer (data.getData(), 1234), data.getSize() - 1234));
+            }
+
+            MemoryBlock written;
+            expect (tempFile.getFile().loadFileAsData (written));
+            expect (written == data);
+        }
+
+        beginTest ("Preallocating");
+        {
+            TemporaryFile tempFile;
+            FileOutputStream out (tempFile.getFile());
+            expect (out.write ("abc", 3));
+
+            // Not every file-system can do this, but it mustn't change the size either way
+            out.preallocate (1000000);
+            out.flush();
+            expectEquals (tempFile.getFile().getSize(), (int64) 3);
+        }
+    }
+};
+
+static FileOutputStreamTests fileOutputStreamTests;
+
+#endif
+
 } // namespace juce
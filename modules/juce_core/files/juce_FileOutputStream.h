@@ -66,6 +66,45 @@ public:
     FileOutputStream (const File& fileToWriteTo,
                       size_t bufferSizeToUse = 16384);
 
+    //==============================================================================
+    /** Settings for a FileOutputStream that's going to be used to write a large amount
+        of data quickly, e.g. when recording many channels of audio to disk.
+    */
+    struct Options
+    {
+        /** The size of the blocks in which the data is written to the file. */
+        size_t blockSize = 1024 * 1024;
+
+        /** If this is greater than zero, disk space for this many bytes will be reserved
+            when the file is opened, which avoids fragmenting a file that grows slowly. The
+            file's size isn't changed by this.
+            @see preallocate
+        */
+        int64 preallocatedSize = 0;
+
+        /** If true, each block is written by a background thread while the next one is
+            being filled, so write() only has to wait for the disk if the background thread
+            falls behind by a whole block.
+        */
+        bool writeInBackground = true;
+
+        /** If true, the blocks are written without going through the operating system's
+            file cache where possible (O_DIRECT on Linux, F_NOCACHE on macOS and iOS). This
+            stops a long recording from pushing everything else out of the cache. It has no
+            effect on Windows.
+        */
+        bool bypassSystemCache = false;
+    };
+
+    /** Creates a FileOutputStream that writes its data in large blocks.
+
+        This behaves like a normal FileOutputStream, but the data is collected in blocks
+        that are aligned to the file-system's block boundaries, and these can be written
+        by a background thread. If a background write fails, the error will be returned
+        by the next write() or flush() call, and by getStatus().
+    */
+    FileOutputStream (const File& fileToWriteTo, const Options& options);
+
     /** Destructor. */
     ~FileOutputStream() override;
 
@@ -96,6 +135,14 @@ public:
     */
     Result truncate();
 
+    /** Asks the file-system to reserve space for the file to grow to the given size.
+
+        This doesn't change the file's size, but makes it likely that the data will be
+        stored contiguously. It isn't supported by all file-systems, in which case it
+        returns an error and has no other effect.
+    */
+    Result preallocate (int64 totalNumBytes);
+
     //==============================================================================
     void flush() override;
     int64 getPosition() override;
@@ -106,12 +153,15 @@ public:
 
 private:
     //==============================================================================
+    class BlockWriter;
+
     File file;
     void* fileHandle = nullptr;
     Result status { Result::ok() };
     int64 currentPosition = 0;
     size_t bufferSize, bytesInBuffer = 0;
     HeapBlock<char> buffer;
+    std::unique_ptr<BlockWriter> blockWriter;
 
     void openHandle();
     void closeHandle();
@@ -119,6 +169,8 @@ private:
     bool flushBuffer();
     int64 setPositionInternal (int64);
     ssize_t writeInternal (const void*, size_t);
+    Result writeInternalAt (int64 position, const char* data, size_t numBytes) const;
+    bool setSystemCacheBypassed (bool);
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (FileOutputStream)
 };
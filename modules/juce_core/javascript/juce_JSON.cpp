@@ -629,6 +629,36 @@ public:
         }
     }
 
+    static void writeWithStreamWriter (JSONStreamWriter& writer, const var& v)
+    {
+        if (auto* array = v.getArray())
+        {
+            writer.startArray();
+
+            for (auto& element : *array)
+                writeWithStreamWriter (writer, element);
+
+            writer.endArray();
+        }
+        else if (auto* object = v.getDynamicObject())
+        {
+            writer.startObject();
+
+            for (auto& property : object->getProperties())
+            {
+                writer.writeName (property.name.toString());
+                writeWithStreamWriter (writer, property.value);
+            }
+
+            writer.endObject();
+        }
+        else if (v.isString())   writer.writeString (v.toString());
+        else if (v.isDouble())   writer.writeDouble (v);
+        else if (v.isBool())     writer.writeBool (v);
+        else if (v.isVoid())     writer.writeNull();
+        else                     writer.writeInt (v);
+    }
+
     void runTest() override
     {
         {
@@ -683,6 +713,118 @@ public:
             for (auto& test : tests)
                 expectEquals (JSON::toString (test.first), test.second);
         }
+
+        {
+            beginTest ("Stream reader");
+
+            auto r = getRandom();
+
+            for (int i = 100; --i >= 0;)
+            {
+                auto v = createRandomVar (r, 0);
+                auto asString = JSON::toString (v, r.nextBool());
+
+                // (small buffers, to make sure that tokens spanning a refill are handled)
+                MemoryInputStream in (asString.toRawUTF8(), asString.getNumBytesAsUTF8(), false);
+                JSONStreamReader reader (in, 16 + r.nextInt (100));
+
+                reader.next();
+                auto parsed = reader.readValue();
+                expect (reader.next() == JSONStreamReader::Event::endOfStream);
+                expectEquals (JSON::toString (parsed, true), JSON::toString (v, true));
+            }
+
+            {
+                using Event = JSONStreamReader::Event;
+
+                String text ("{ \"a\": [1, -2.5e1, \"x\\u00e9\\ud83d\\ude00\"], \"b\": { \"c\": true }, \"d\": null }\n[]");
+                MemoryInputStream in (text.toRawUTF8(), text.getNumBytesAsUTF8(), false);
+                JSONStreamReader reader (in);
+
+                expect (reader.next() == Event::startObject);
+                expect (reader.next() == Event::propertyName && reader.getString() == "a");
+                expect (reader.next() == Event::startArray);
+                expect (reader.getDepth() == 2);
+                expect (reader.next() == Event::number && reader.isInteger() && reader.getInt64() == 1);
+                expect (reader.next() == Event::number && ! reader.isInteger() && reader.getDouble() == -25.0);
+                expect (reader.next() == Event::string && reader.getString() == String (CharPointer_UTF8 ("x\xc3\xa9\xf0\x9f\x98\x80")));
+                expect (reader.next() == Event::endArray);
+                expect (reader.next() == Event::propertyName && reader.getString() == "b");
+                expect (reader.next() == Event::startObject);
+                reader.skipValue();
+                expect (reader.getCurrentEvent() == Event::endObject && reader.getDepth() == 1);
+                expect (reader.next() == Event::propertyName && reader.getString() == "d");
+                expect (reader.next() == Event::null);
+                expect (reader.next() == Event::endObject && reader.getDepth() == 0);
+                expect (reader.next() == Event::startArray);
+                expect (reader.next() == Event::endArray);
+                expect (reader.next() == Event::endOfStream);
+                expect (reader.getError().wasOk());
+            }
+
+            {
+                String text ("{ \"a\": 1,\n  \"b\" 2 }");
+                MemoryInputStream in (text.toRawUTF8(), text.getNumBytesAsUTF8(), false);
+                JSONStreamReader reader (in);
+
+                while (reader.next() != JSONStreamReader::Event::error)
+                    expect (reader.getCurrentEvent() != JSONStreamReader::Event::endOfStream);
+
+                expectEquals (reader.getError().getErrorMessage(), String ("2:7: error: Expected ':'"));
+            }
+        }
+
+        {
+            beginTest ("Stream writer");
+
+            auto r = getRandom();
+
+            for (int i = 100; --i >= 0;)
+            {
+                auto v = createRandomVar (r, 0);
+                auto oneLine = r.nextBool();
+
+                MemoryOutputStream out;
+
+                {
+                    JSONStreamWriter writer (out, oneLine);
+                    writeWithStreamWriter (writer, v);
+                }
+
+                expectEquals (out.toString(), JSON::toString (v, oneLine));
+            }
+        }
+
+        {
+            beginTest ("JSONDocument");
+
+            auto r = getRandom();
+
+            for (int i = 100; --i >= 0;)
+            {
+                auto v = createRandomVar (r, 0);
+                auto asString = JSON::toString (v, r.nextBool());
+
+                JSONDocument doc;
+                expect (doc.parse (asString).wasOk());
+                expectEquals (JSON::toString (doc.getRoot().toVar(), true), JSON::toString (v, true));
+            }
+
+            JSONDocument doc;
+            expect (doc.parse ("{ \"x\": [10, 20, { \"y\": \"z\" }], \"n\": 1.5 }").wasOk());
+
+            auto root = doc.getRoot();
+            expect (root.isObject() && root.getNumChildren() == 2);
+            expect (root["x"].isArray() && root["x"].getNumChildren() == 3);
+            expect (root["x"][1].getInt64() == 20);
+            expect (root["x"][2]["y"].toString() == "z");
+            expect (root["n"].getDouble() == 1.5);
+            expect (String (root["n"].getName()) == "n");
+            expect (! root["missing"].isValid() && ! root["x"][3].isValid());
+
+            expect (doc.parse ("[1, 2").failed());
+            expect (! doc.getRoot().isValid());
+        }
     }
 };
 
@@ -0,0 +1,373 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2020 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   To use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+JSONDocument::JSONDocument() = default;
+JSONDocument::~JSONDocument() = default;
+
+JSONDocument::JSONDocument (JSONDocument&& other) noexcept
+    : items (std::move (other.items)),
+      text (std::move (other.text)),
+      textSize (other.textSize)
+{
+    other.textSize = 0;
+}
+
+JSONDocument& JSONDocument::operator= (JSONDocument&& other) noexcept
+{
+    items = std::move (other.items);
+    text = std::move (other.text);
+    textSize = other.textSize;
+    other.textSize = 0;
+    return *this;
+}
+
+//==============================================================================
+Result JSONDocument::parse (InputStream& input)
+{
+    clear();
+    addText ("", 0); // offset 0 is used as the empty name of nodes that aren't object properties
+
+    struct OpenContainer
+    {
+        uint32 index;
+        int lastChild;
+    };
+
+    JSONStreamReader reader (input);
+    Array<OpenContainer> openContainers;
+    uint32 pendingName = 0;
+
+    auto addItem = [&] (Type type) -> Item&
+    {
+        auto newIndex = items.size();
+
+        if (! openContainers.isEmpty())
+        {
+            auto& parent = openContainers.getReference (openContainers.size() - 1);
+            ++(items.getReference ((int) parent.index).numChildren);
+
+            if (parent.lastChild >= 0)
+                items.getReference (parent.lastChild).nextSibling = (uint32) newIndex;
+
+            parent.lastChild = newIndex;
+        }
+
+        Item item;
+        item.type = type;
+        item.nameOffset = pendingName;
+        item.numChildren = 0;
+        item.nextSibling = 0;
+        item.intValue = 0;
+        pendingName = 0;
+
+        items.add (item);
+        return items.getReference (newIndex);
+    };
+
+    for (;;)
+    {
+        switch (reader.next())
+        {
+            case JSONStreamReader::Event::startObject:
+            case JSONStreamReader::Event::startArray:
+                addItem (reader.getCurrentEvent() == JSONStreamReader::Event::startObject ? Type::object : Type::array);
+                openContainers.add ({ (uint32) (items.size() - 1), -1 });
+                break;
+
+            case JSONStreamReader::Event::endObject:
+            case JSONStreamReader::Event::endArray:
+                openContainers.removeLast();
+                break;
+
+            case JSONStreamReader::Event::propertyName:
+                pendingName = addText (reader.getUTF8().getAddress(), reader.getUTF8Length());
+                break;
+
+            case JSONStreamReader::Event::string:
+            {
+                auto offset = addText (reader.getUTF8().getAddress(), reader.getUTF8Length());
+                addItem (Type::string).textOffset = offset;
+                break;
+            }
+
+            case JSONStreamReader::Event::number:
+                if (reader.isInteger())
+                    addItem (Type::integer).intValue = reader.getInt64();
+                else
+                    addItem (Type::floatingPoint).doubleValue = reader.getDouble();
+
+                break;
+
+            case JSONStreamReader::Event::boolean:
+                addItem (Type::boolean).boolValue = reader.getBool();
+                break;
+
+            case JSONStreamReader::Event::null:
+                addItem (Type::null);
+                break;
+
+            case JSONStreamReader::Event::endOfStream:
+                return Result::ok();
+
+            case JSONStreamReader::Event::error:
+            default:
+                clear();
+                return reader.getError();
+        }
+
+        if (openContainers.isEmpty() && ! items.isEmpty())
+        {
+            items.minimiseStorageOverheads();
+            text.setSize (textSize);
+            return Result::ok();
+        }
+    }
+}
+
+Result JSONDocument::parse (const String& textToParse)
+{
+    MemoryInputStream in (textToParse.toRawUTF8(), textToParse.getNumBytesAsUTF8(), false);
+    return parse (in);
+}
+
+void JSONDocument::clear()
+{
+    items.clear();
+    text.reset();
+    textSize = 0;
+}
+
+size_t JSONDocument::getMemoryUsage() const noexcept
+{
+    return (size_t) items.size() * sizeof (Item) + text.getSize();
+}
+
+JSONDocument::Node JSONDocument::getRoot() const noexcept
+{
+    if (items.isEmpty())
+        return {};
+
+    return { this, 0 };
+}
+
+uint32 JSONDocument::addText (const char* data, size_t numBytes)
+{
+    auto offset = textSize;
+    auto spaceNeeded = textSize + numBytes + 1;
+
+    // The offsets are stored as 32-bit values, so the total amount of text is limited to 4GB
+    jassert (spaceNeeded <= std::numeric_limits<uint32>::max());
+
+    if (spaceNeeded > text.getSize())
+        text.setSize (jmax ((size_t) 1024, text.getSize() * 2, spaceNeeded));
+
+    auto* dest = static_cast<char*> (text.getData()) + offset;
+    memcpy (dest, data, numBytes);
+    dest[numBytes] = 0;
+    textSize = spaceNeeded;
+
+    return (uint32) offset;
+}
+
+const char* JSONDocument::getText (uint32 offset) const noexcept
+{
+    return static_cast<const char*> (text.getData()) + offset;
+}
+
+//==============================================================================
+JSONDocument::Type JSONDocument::Node::getType() const noexcept
+{
+    return document != nullptr ? document->items.getReference ((int) index).type
+                               : Type::null;
+}
+
+bool JSONDocument::Node::getBool() const
+{
+    switch (getType())
+    {
+        case Type::boolean:         return document->items.getReference ((int) index).boolValue;
+        case Type::integer:         return getInt64() != 0;
+        case Type::floatingPoint:   return getDouble() != 0;
+        case Type::string:          return toString().getIntValue() != 0 || toString().trim().equalsIgnoreCase ("true");
+        case Type::null:
+        case Type::array:
+        case Type::object:
+        default:                    return false;
+    }
+}
+
+int64 JSONDocument::Node::getInt64() const
+{
+    switch (getType())
+    {
+        case Type::boolean:         return document->items.getReference ((int) index).boolValue ? 1 : 0;
+        case Type::integer:         return document->items.getReference ((int) index).intValue;
+        case Type::floatingPoint:   return (int64) document->items.getReference ((int) index).doubleValue;
+        case Type::string:          return toString().getLargeIntValue();
+        case Type::null:
+        case Type::array:
+        case Type::object:
+        default:                    return 0;
+    }
+}
+
+double JSONDocument::Node::getDouble() const
+{
+    switch (getType())
+    {
+        case Type::boolean:         return document->items.getReference ((int) index).boolValue ? 1.0 : 0.0;
+        case Type::integer:         return (double) document->items.getReference ((int) index).intValue;
+        case Type::floatingPoint:   return document->items.getReference ((int) index).doubleValue;
+        case Type::string:          return toString().getDoubleValue();
+        case Type::null:
+        case Type::array:
+        case Type::object:
+        default:                    return 0.0;
+    }
+}
+
+CharPointer_UTF8 JSONDocument::Node::getUTF8() const noexcept
+{
+    if (getType() == Type::string)
+        return CharPointer_UTF8 (document->getText (document->items.getReference ((int) index).textOffset));
+
+    return CharPointer_UTF8 ("");
+}
+
+String JSONDocument::Node::toString() const
+{
+    if (getType() == Type::string)
+        return String (getUTF8());
+
+    return toVar().toString();
+}
+
+var JSONDocument::Node::toVar() const
+{
+    switch (getType())
+    {
+        case Type::boolean:         return getBool();
+        case Type::floatingPoint:   return getDouble();
+        case Type::string:          return toString();
+
+        case Type::integer:
+        {
+            auto value = getInt64();
+            auto magnitude = value < 0 ? -value : value;
+
+            return (magnitude >> 31) != 0 ? var (value)
+                                          : var ((int) value);
+        }
+
+        case Type::array:
+        {
+            Array<var> elements;
+            elements.ensureStorageAllocated (getNumChildren());
+
+            for (auto child = getFirstChild(); child.isValid(); child = child.getNextSibling())
+                elements.add (child.toVar());
+
+            return elements;
+        }
+
+        case Type::object:
+        {
+            auto* object = new DynamicObject();
+            var result (object);
+            auto& properties = object->getProperties();
+
+            for (auto child = getFirstChild(); child.isValid(); child = child.getNextSibling())
+                properties.set (Identifier (String (child.getName())), child.toVar());
+
+            return result;
+        }
+
+        case Type::null:
+        default:
+            return {};
+    }
+}
+
+//==============================================================================
+int JSONDocument::Node::getNumChildren() const noexcept
+{
+    auto type = getType();
+
+    if (type == Type::array || type == Type::object)
+        return (int) document->items.getReference ((int) index).numChildren;
+
+    return 0;
+}
+
+JSONDocument::Node JSONDocument::Node::getFirstChild() const noexcept
+{
+    if (getNumChildren() > 0)
+        return { document, index + 1 };
+
+    return {};
+}
+
+JSONDocument::Node JSONDocument::Node::getNextSibling() const noexcept
+{
+    if (document != nullptr)
+        if (auto next = document->items.getReference ((int) index).nextSibling)
+            return { document, next };
+
+    return {};
+}
+
+JSONDocument::Node JSONDocument::Node::operator[] (int childIndex) const noexcept
+{
+    if (! isPositiveAndBelow (childIndex, getNumChildren()))
+        return {};
+
+    auto child = getFirstChild();
+
+    while (--childIndex >= 0)
+        child = child.getNextSibling();
+
+    return child;
+}
+
+JSONDocument::Node JSONDocument::Node::operator[] (StringRef propertyName) const noexcept
+{
+    if (getType() == Type::object)
+        for (auto child = getFirstChild(); child.isValid(); child = child.getNextSibling())
+            if (strcmp (document->getText (document->items.getReference ((int) child.index).nameOffset),
+                        propertyName.text.getAddress()) == 0)
+                return child;
+
+    return {};
+}
+
+CharPointer_UTF8 JSONDocument::Node::getName() const noexcept
+{
+    if (document != nullptr)
+        return CharPointer_UTF8 (document->getText (document->items.getReference ((int) index).nameOffset));
+
+    return CharPointer_UTF8 ("");
+}
+
+} // namespace juce
@@ -0,0 +1,203 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2020 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   To use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    A compact, read-only tree representation of some JSON data.
+
+    When you need random access to a large JSON document, building it as a var
+    tree means allocating a DynamicObject or Array for every container, a var and
+    a NamedValueSet entry for every value, and a String for every piece of text.
+    A JSONDocument instead stores all of its nodes in one contiguous array, and
+    all of its text in one block of memory, so loading it performs a handful of
+    allocations, and freeing it is almost instant.
+
+    The document is navigated with lightweight Node objects, e.g.
+
+    @code
+    JSONDocument doc;
+
+    if (doc.parse (inputStream).wasOk())
+    {
+        auto presets = doc.getRoot()["presets"];
+
+        for (auto preset = presets.getFirstChild(); preset.isValid(); preset = preset.getNextSibling())
+            DBG (preset["name"].toString());
+    }
+    @endcode
+
+    A Node is only valid while the document that it came from is alive and unchanged.
+
+    @see JSONStreamReader, JSON
+
+    @tags{Core}
+*/
+class JUCE_API  JSONDocument
+{
+public:
+    //==============================================================================
+    /** Creates an empty document. */
+    JSONDocument();
+
+    /** Destructor. */
+    ~JSONDocument();
+
+    JSONDocument (JSONDocument&&) noexcept;
+    JSONDocument& operator= (JSONDocument&&) noexcept;
+
+    //==============================================================================
+    /** Replaces the contents of this document by parsing the first value from the given stream.
+        If the data is malformed, this returns an error, and the document will be left empty.
+    */
+    Result parse (InputStream& input);
+
+    /** Replaces the contents of this document by parsing the given text.
+        If the data is malformed, this returns an error, and the document will be left empty.
+    */
+    Result parse (const String& text);
+
+    /** Empties the document. */
+    void clear();
+
+    /** Returns the number of bytes of memory that the document is using. */
+    size_t getMemoryUsage() const noexcept;
+
+    //==============================================================================
+    /** The types of value that a Node can hold. */
+    enum class Type : uint8
+    {
+        null,
+        boolean,
+        integer,
+        floatingPoint,
+        string,
+        array,
+        object
+    };
+
+    /**
+        Refers to one of the values in a JSONDocument.
+
+        A default-constructed Node, or one that's been returned when looking up a
+        child that doesn't exist, is invalid, and will behave like a null value.
+    */
+    class JUCE_API  Node
+    {
+    public:
+        /** Creates an invalid node. */
+        Node() = default;
+
+        /** Returns true if this refers to a value in a document. */
+        bool isValid() const noexcept                   { return document != nullptr; }
+
+        /** Returns the type of this value. */
+        Type getType() const noexcept;
+
+        bool isNull() const noexcept                    { return getType() == Type::null; }
+        bool isBool() const noexcept                    { return getType() == Type::boolean; }
+        bool isInteger() const noexcept                 { return getType() == Type::integer; }
+        bool isDouble() const noexcept                  { return getType() == Type::floatingPoint; }
+        bool isString() const noexcept                  { return getType() == Type::string; }
+        bool isArray() const noexcept                   { return getType() == Type::array; }
+        bool isObject() const noexcept                  { return getType() == Type::object; }
+
+        /** Returns the value as a boolean. */
+        bool getBool() const;
+
+        /** Returns the value as an integer. */
+        int64 getInt64() const;
+
+        /** Returns the value as a double. */
+        double getDouble() const;
+
+        /** Returns the UTF-8 text of a string value, without copying it. */
+        CharPointer_UTF8 getUTF8() const noexcept;
+
+        /** Returns a string value as a String, or other values converted to a string. */
+        String toString() const;
+
+        /** Returns a copy of this value (including any children) as a var. */
+        var toVar() const;
+
+        //==============================================================================
+        /** Returns the number of elements in an array, or properties in an object. */
+        int getNumChildren() const noexcept;
+
+        /** Returns the first element or property of an array or object. */
+        Node getFirstChild() const noexcept;
+
+        /** Returns the next element or property of the array or object that contains this node. */
+        Node getNextSibling() const noexcept;
+
+        /** Returns one of the elements or properties of an array or object.
+            Note that this needs to step through the preceding children to find it, so if you
+            want to visit them all, it's faster to use getFirstChild() and getNextSibling().
+        */
+        Node operator[] (int index) const noexcept;
+
+        /** Returns the value of the property with the given name, if this is an object. */
+        Node operator[] (StringRef propertyName) const noexcept;
+
+        /** If this node is a property of an object, this returns its name. */
+        CharPointer_UTF8 getName() const noexcept;
+
+    private:
+        friend class JSONDocument;
+        Node (const JSONDocument* d, uint32 i) noexcept : document (d), index (i) {}
+
+        const JSONDocument* document = nullptr;
+        uint32 index = 0;
+    };
+
+    /** Returns the root value of the document. */
+    Node getRoot() const noexcept;
+
+private:
+    //==============================================================================
+    struct Item
+    {
+        Type type;
+        uint32 nameOffset, numChildren, nextSibling;
+
+        union
+        {
+            bool boolValue;
+            int64 intValue;
+            double doubleValue;
+            uint32 textOffset;
+        };
+    };
+
+    Array<Item> items;
+    MemoryBlock text;
+    size_t textSize = 0;
+
+    uint32 addText (const char*, size_t);
+    const char* getText (uint32 offset) const noexcept;
+
+    JUCE_DECLARE_NON_COPYABLE (JSONDocument)
+};
+
+} // namespace juce
@@ -0,0 +1,641 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2020 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   To use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+JSONStreamReader::JSONStreamReader (InputStream& source, int sizeOfBuffer)
+    : input (source), bufferSize (jmax (16, sizeOfBuffer))
+{
+    buffer.malloc ((size_t) bufferSize);
+    appendToToken ("", 0);
+
+    // skip any UTF-8 byte-order-mark
+    if (refill() && bufferEnd >= 3
+         && (uint8) buffer[0] == 0xef && (uint8) buffer[1] == 0xbb && (uint8) buffer[2] == 0xbf)
+        bufferPos = 3;
+}
+
+JSONStreamReader::~JSONStreamReader() = default;
+
+//==============================================================================
+JSONStreamReader::Event JSONStreamReader::next()
+{
+    if (currentEvent == Event::error || state == State::finished)
+        return currentEvent;
+
+    try
+    {
+        currentEvent = parseNext();
+    }
+    catch (const ParseError&)
+    {
+        currentEvent = Event::error;
+    }
+
+    return currentEvent;
+}
+
+Result JSONStreamReader::getError() const
+{
+    if (errorMessage.isEmpty())
+        return Result::ok();
+
+    return Result::fail (errorMessage);
+}
+
+String JSONStreamReader::getString() const
+{
+    return String::fromUTF8 (token, (int) tokenLength);
+}
+
+CharPointer_UTF8 JSONStreamReader::getUTF8() const noexcept
+{
+    return CharPointer_UTF8 (token);
+}
+
+int64 JSONStreamReader::getInt64() const noexcept
+{
+    return numberIsInteger ? intValue : (int64) doubleValue;
+}
+
+double JSONStreamReader::getDouble() const noexcept
+{
+    return numberIsInteger ? (double) intValue : doubleValue;
+}
+
+//==============================================================================
+var JSONStreamReader::readValue()
+{
+    switch (currentEvent)
+    {
+        case Event::startObject:
+        {
+            auto* object = new DynamicObject();
+            var result (object);
+            auto& properties = object->getProperties();
+
+            for (;;)
+            {
+                auto event = next();
+
+                if (event == Event::endObject)
+                    return result;
+
+                if (event != Event::propertyName)
+                    break;
+
+                Identifier name (getString());
+                next();
+                auto value = readValue();
+
+                if (currentEvent == Event::error)
+                    break;
+
+                properties.set (name, std::move (value));
+            }
+
+            return {};
+        }
+
+        case Event::startArray:
+        {
+            auto result = var (Array<var>());
+            auto* array = result.getArray();
+
+            for (;;)
+            {
+                auto event = next();
+
+                if (event == Event::endArray)
+                    return result;
+
+                if (event == Event::error)
+                    break;
+
+                auto value = readValue();
+
+                if (currentEvent == Event::error)
+                    break;
+
+                array->add (std::move (value));
+            }
+
+            return {};
+        }
+
+        case Event::string:
+            return getString();
+
+        case Event::number:
+        {
+            if (! numberIsInteger)
+                return doubleValue;
+
+            auto magnitude = intValue < 0 ? -intValue : intValue;
+
+            return (magnitude >> 31) != 0 ? var (intValue)
+                                          : var ((int) intValue);
+        }
+
+        case Event::boolean:
+            return boolValue;
+
+        case Event::propertyName:
+            jassertfalse; // a property name isn't a value - call next() to move to the value itself
+            return {};
+
+        case Event::endObject:
+        case Event::endArray:
+        case Event::null:
+        case Event::endOfStream:
+        case Event::error:
+        default:
+            return {};
+    }
+}
+
+void JSONStreamReader::skipValue()
+{
+    if (currentEvent != Event::startObject && currentEvent != Event::startArray)
+        return;
+
+    auto targetDepth = getDepth() - 1;
+
+    while (! ((currentEvent == Event::endObject || currentEvent == Event::endArray) && getDepth() == targetDepth))
+        if (next() == Event::error)
+            return;
+}
+
+//==============================================================================
+bool JSONStreamReader::refill()
+{
+    if (bufferPos < bufferEnd)
+        return true;
+
+    bufferStartPosition += bufferEnd;
+    bufferPos = 0;
+    bufferEnd = jmax (0, input.read (buffer, bufferSize));
+    return bufferEnd > 0;
+}
+
+int JSONStreamReader::peekByte()
+{
+    if (bufferPos >= bufferEnd && ! refill())
+        return -1;
+
+    return (uint8) buffer[bufferPos];
+}
+
+int JSONStreamReader::readByte()
+{
+    auto c = peekByte();
+
+    if (c >= 0)
+    {
+        ++bufferPos;
+
+        if (c == '\n')
+            startNewLine();
+    }
+
+    return c;
+}
+
+void JSONStreamReader::startNewLine() noexcept
+{
+    ++line;
+    lineStartPosition = bufferStartPosition + bufferPos;
+}
+
+int JSONStreamReader::skipWhitespaceAndPeek()
+{
+    for (;;)
+    {
+        if (bufferPos >= bufferEnd && ! refill())
+            return -1;
+
+        while (bufferPos < bufferEnd)
+        {
+            auto c = (uint8) buffer[bufferPos];
+
+            if (c != ' ' && c != '\n' && c != '\r' && c != '\t')
+                return c;
+
+            ++bufferPos;
+
+            if (c == '\n')
+                startNewLine();
+        }
+    }
+}
+
+void JSONStreamReader::expectByte (char expected, const char* message)
+{
+    if (skipWhitespaceAndPeek() != (uint8) expected)
+        throwError (message);
+
+    readByte();
+}
+
+void JSONStreamReader::throwError (const String& message)
+{
+    auto column = bufferStartPosition + bufferPos - lineStartPosition + 1;
+    errorMessage = String (line) + ":" + String (column) + ": error: " + message;
+    throw ParseError();
+}
+
+void JSONStreamReader::appendToToken (const char* data, size_t numBytes)
+{
+    auto spaceNeeded = tokenLength + numBytes + 1;
+
+    if (spaceNeeded > tokenSpace)
+    {
+        tokenSpace = jmax ((size_t) 256, tokenSpace * 2, spaceNeeded);
+        token.realloc (tokenSpace);
+    }
+
+    memcpy (token + tokenLength, data, numBytes);
+    tokenLength += numBytes;
+    token[tokenLength] = 0;
+}
+
+void JSONStreamReader::appendCharToToken (juce_wchar c)
+{
+    char utf8[8];
+    CharPointer_UTF8 dest (utf8);
+    dest.write (c);
+    appendToToken (utf8, (size_t) (dest.getAddress() - utf8));
+}
+
+juce_wchar JSONStreamReader::readUnicodeEscape()
+{
+    juce_wchar c = 0;
+
+    for (int i = 4; --i >= 0;)
+    {
+        auto digitValue = CharacterFunctions::getHexDigitValue ((juce_wchar) readByte());
+
+        if (digitValue < 0)
+            throwError ("Syntax error in unicode escape sequence");
+
+        c = (juce_wchar) ((c << 4) + static_cast<juce_wchar> (digitValue));
+    }
+
+    return c;
+}
+
+void JSONStreamReader::readString (char quote)
+{
+    tokenLength = 0;
+    juce_wchar highSurrogate = 0;
+
+    auto flushHighSurrogate = [&]
+    {
+        if (highSurrogate != 0)
+        {
+            appendCharToToken (highSurrogate);
+            highSurrogate = 0;
+        }
+    };
+
+    for (;;)
+    {
+        if (bufferPos >= bufferEnd && ! refill())
+            throwError ("Unexpected EOF in string constant");
+
+        // Copy runs of plain characters straight out of the buffer..
+        auto* start = buffer + bufferPos;
+        auto* end = buffer + bufferEnd;
+        auto* p = start;
+
+        while (p < end && *p != quote && *p != '\\' && *p != '\n' && *p != 0)
+            ++p;
+
+        if (p != start)
+        {
+            flushHighSurrogate();
+            auto numBytes = (int) (p - start);
+            appendToToken (start, (size_t) numBytes);
+            bufferPos += numBytes;
+        }
+
+        if (p == end)
+            continue;
+
+        auto c = (juce_wchar) readByte();
+
+        if (c == (juce_wchar) quote)
+            break;
+
+        if (c == 0)
+            throwError ("Unexpected EOF in string constant");
+
+        if (c == '\\')
+        {
+            auto escaped = readByte();
+
+            switch (escaped)
+            {
+                case 'a':  c = '\a'; break;
+                case 'b':  c = '\b'; break;
+                case 'f':  c = '\f'; break;
+                case 'n':  c = '\n'; break;
+                case 'r':  c = '\r'; break;
+                case 't':  c = '\t'; break;
+
+                case 'u':
+                {
+                    c = readUnicodeEscape();
+
+                    if (highSurrogate != 0 && c >= 0xdc00 && c <= 0xdfff)
+                    {
+                        c = (juce_wchar) (0x10000 + ((highSurrogate - 0xd800) << 10) + (c - 0xdc00));
+                        highSurrogate = 0;
+                    }
+                    else if (c >= 0xd800 && c <= 0xdbff)
+                    {
+                        flushHighSurrogate();
+                        highSurrogate = c;
+                        continue;
+                    }
+
+                    break;
+                }
+
+                case -1:
+                    throwError ("Unexpected EOF in string constant");
+
+                default:
+                    c = (juce_wchar) escaped;
+                    break;
+            }
+        }
+
+        flushHighSurrogate();
+
+        if (c < 0x80)
+        {
+            auto ch = (char) c;
+            appendToToken (&ch, 1);
+        }
+        else
+        {
+            appendCharToToken (c);
+        }
+    }
+
+    flushHighSurrogate();
+}
+
+void JSONStreamReader::readNumber()
+{
+    tokenLength = 0;
+    bool isFloatingPoint = false;
+
+    for (;;)
+    {
+        if (bufferPos >= bufferEnd && ! refill())
+            break;
+
+        auto* start = buffer + bufferPos;
+        auto* end = buffer + bufferEnd;
+        auto* p = start;
+
+        for (; p < end; ++p)
+        {
+            auto c = *p;
+
+            if (c == '.' || c == 'e' || c == 'E')
+                isFloatingPoint = true;
+            else if (! (isPositiveAndBelow (c - '0', 10) || c == '-' || c == '+'))
+                break;
+        }
+
+        appendToToken (start, (size_t) (p - start));
+        bufferPos += (int) (p - start);
+
+        if (p < end)
+            break;
+    }
+
+    auto next = peekByte();
+
+    if (! (next < 0 || next == ',' || next == '}' || next == ']'
+            || CharacterFunctions::isWhitespace ((juce_wchar) next)))
+        throwError ("Syntax error in number");
+
+    numberIsInteger = ! isFloatingPoint;
+
+    if (isFloatingPoint)
+    {
+        CharPointer_UTF8 t (token);
+        doubleValue = CharacterFunctions::readDoubleValue (t);
+
+        if (! t.isEmpty())
+            throwError ("Syntax error in number");
+
+        return;
+    }
+
+    auto* p = token.get();
+    auto isNegative = (*p == '-');
+
+    if (isNegative)
+        ++p;
+
+    if (*p == 0)
+        throwError ("Syntax error in number");
+
+    int64 value = 0;
+
+    for (; *p != 0; ++p)
+    {
+        auto digit = *p - '0';
+
+        if (! isPositiveAndBelow (digit, 10))
+            throwError ("Syntax error in number");
+
+        value = value * 10 + digit;
+    }
+
+    intValue = isNegative ? -value : value;
+}
+
+void JSONStreamReader::readLiteral (const char* remainingChars)
+{
+    while (*remainingChars != 0)
+        if (readByte() != *remainingChars++)
+            throwError ("Syntax error");
+}
+
+JSONStreamReader::Event JSONStreamReader::finishValue (Event event)
+{
+    state = containers.isEmpty() ? State::topLevel : State::commaOrEnd;
+    return event;
+}
+
+JSONStreamReader::Event JSONStreamReader::readValueStart (int c)
+{
+    switch (c)
+    {
+        case '{':
+            readByte();
+            containers.add (true);
+            state = State::nameOrEndOfObject;
+            return Event::startObject;
+
+        case '[':
+            readByte();
+            containers.add (false);
+            state = State::valueOrEndOfArray;
+            return Event::startArray;
+
+        case '"':
+        case '\'':
+            readByte();
+            readString ((char) c);
+            return finishValue (Event::string);
+
+        case '-':
+        case '0': case '1': case '2': case '3': case '4':
+        case '5': case '6': case '7': case '8': case '9':
+            readNumber();
+            return finishValue (Event::number);
+
+        case 't':
+            readLiteral ("true");
+            boolValue = true;
+            return finishValue (Event::boolean);
+
+        case 'f':
+            readLiteral ("false");
+            boolValue = false;
+            return finishValue (Event::boolean);
+
+        case 'n':
+            readLiteral ("null");
+            return finishValue (Event::null);
+
+        default:
+            break;
+    }
+
+    throwError ("Syntax error");
+}
+
+JSONStreamReader::Event JSONStreamReader::parseNext()
+{
+    for (;;)
+    {
+        auto c = skipWhitespaceAndPeek();
+
+        switch (state)
+        {
+            case State::topLevel:
+                if (c < 0)
+                {
+                    state = State::finished;
+                    return Event::endOfStream;
+                }
+
+                return readValueStart (c);
+
+            case State::value:
+                if (c < 0)
+                    throwError ("Unexpected EOF");
+
+                return readValueStart (c);
+
+            case State::valueOrEndOfArray:
+                if (c == ']')
+                {
+                    readByte();
+                    containers.removeLast();
+                    return finishValue (Event::endArray);
+                }
+
+                if (c < 0)
+                    throwError ("Unexpected EOF in array declaration");
+
+                return readValueStart (c);
+
+            case State::nameOrEndOfObject:
+                if (c == '}')
+                {
+                    readByte();
+                    containers.removeLast();
+                    return finishValue (Event::endObject);
+                }
+
+                JUCE_FALLTHROUGH
+
+            case State::name:
+                if (c < 0)
+                    throwError ("Unexpected EOF in object declaration");
+
+                if (c != '"')
+                    throwError ("Expected a property name in double-quotes");
+
+                readByte();
+                readString ('"');
+
+                if (tokenLength == 0)
+                    throwError ("Invalid property name");
+
+                expectByte (':', "Expected ':'");
+                state = State::value;
+                return Event::propertyName;
+
+            case State::commaOrEnd:
+            {
+                auto isObject = containers.getLast();
+
+                if (c == ',')
+                {
+                    readByte();
+                    state = isObject ? State::nameOrEndOfObject : State::valueOrEndOfArray;
+                    continue;
+                }
+
+                if (c == (isObject ? '}' : ']'))
+                {
+                    readByte();
+                    containers.removeLast();
+                    return finishValue (isObject ? Event::endObject : Event::endArray);
+                }
+
+                if (c < 0)
+                    throwError (isObject ? "Unexpected EOF in object declaration"
+                                         : "Unexpected EOF in array declaration");
+
+                throwError (isObject ? "Expected ',' or '}'" : "Expected ',' or ']'");
+            }
+
+            case State::finished:
+            default:
+                return Event::endOfStream;
+        }
+    }
+}
+
+} // namespace juce
@@ -0,0 +1,201 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2020 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   To use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    Reads JSON-formatted data incrementally from a stream, as a sequence of events.
+
+    Unlike JSON::parse(), which reads the whole input into a String and then builds
+    a complete var tree from it, this class only keeps a small buffer of the input
+    in memory, and reports each element of the data as it's encountered, so it can
+    be used to process files that are far too large to hold as a var.
+
+    Call next() repeatedly to move through the data. Each call returns an Event
+    describing the item that was just read, and you can use the getter methods to
+    find out the value of that item, e.g.
+
+    @code
+    JSONStreamReader reader (inputStream);
+
+    for (auto event = reader.next(); event != JSONStreamReader::Event::endOfStream; event = reader.next())
+    {
+        if (event == JSONStreamReader::Event::error)
+        {
+            DBG (reader.getError().getErrorMessage());
+            break;
+        }
+
+        if (event == JSONStreamReader::Event::propertyName && reader.getString() == "presets")
+        {
+            if (reader.next() == JSONStreamReader::Event::startArray)
+                while (reader.next() == JSONStreamReader::Event::startObject)
+                    loadPreset (reader.readValue());    // builds a var for just this element
+        }
+    }
+    @endcode
+
+    The input must be UTF-8 encoded (a leading byte-order-mark is skipped). The
+    stream may contain any number of top-level values one after the other, so
+    newline-delimited JSON can be read with the same object.
+
+    @see JSONStreamWriter, JSONDocument, JSON
+
+    @tags{Core}
+*/
+class JUCE_API  JSONStreamReader
+{
+public:
+    //==============================================================================
+    /** Creates a reader for the given stream.
+        The stream is not owned by the reader, so it must stay alive for as long as
+        the reader is being used. It will be read in blocks of the given size.
+    */
+    explicit JSONStreamReader (InputStream& source, int bufferSize = 16384);
+
+    /** Destructor. */
+    ~JSONStreamReader();
+
+    //==============================================================================
+    /** The types of item that next() can return. */
+    enum class Event
+    {
+        startObject,    /**< A '{' was read. It will be followed by pairs of propertyName and value events, and then an endObject. */
+        endObject,      /**< The '}' that closes an object was read. */
+        startArray,     /**< A '[' was read. It will be followed by the element values, and then an endArray. */
+        endArray,       /**< The ']' that closes an array was read. */
+        propertyName,   /**< The name of an object property was read. Use getString() to find out what it was. */
+        string,         /**< A string value was read. Use getString() to find out what it was. */
+        number,         /**< A numeric value was read. Use isInteger(), getInt64() or getDouble() to find out what it was. */
+        boolean,        /**< A 'true' or 'false' was read. Use getBool() to find out which. */
+        null,           /**< A 'null' value was read. */
+        endOfStream,    /**< The end of the input was reached. */
+        error           /**< The input is malformed. Use getError() to find out what the problem was. */
+    };
+
+    /** Reads the next item from the stream.
+        Once this has returned endOfStream or error, it'll keep on returning the same value.
+    */
+    Event next();
+
+    /** Returns the event that was last returned by next(). */
+    Event getCurrentEvent() const noexcept                  { return currentEvent; }
+
+    /** Returns the number of objects and arrays that enclose the current position. */
+    int getDepth() const noexcept                           { return containers.size(); }
+
+    /** If next() has returned an error, this describes the problem. */
+    Result getError() const;
+
+    //==============================================================================
+    /** Returns the text of the current string or propertyName item. */
+    String getString() const;
+
+    /** Returns the UTF-8 text of the current string, propertyName or number item.
+
+        This avoids creating a String, but the data that it points to is only valid
+        until next() is called again.
+    */
+    CharPointer_UTF8 getUTF8() const noexcept;
+
+    /** Returns the number of bytes in the text returned by getUTF8(). */
+    size_t getUTF8Length() const noexcept                   { return tokenLength; }
+
+    /** Returns true if the current number item has no fractional part or exponent. */
+    bool isInteger() const noexcept                         { return numberIsInteger; }
+
+    /** Returns the current number item as an integer. */
+    int64 getInt64() const noexcept;
+
+    /** Returns the current number item as a double. */
+    double getDouble() const noexcept;
+
+    /** Returns the value of the current boolean item. */
+    bool getBool() const noexcept                           { return boolValue; }
+
+    //==============================================================================
+    /** Returns the value of the current item as a var.
+
+        If the current item is a startObject or startArray, this reads the rest of
+        the object or array from the stream and returns it as a var tree, leaving
+        the reader positioned on its matching endObject or endArray. For any other
+        value it just returns the value, without moving.
+
+        If an error occurs while reading, this returns a void var and the reader
+        will be left in the error state.
+    */
+    var readValue();
+
+    /** Moves past the current item.
+
+        If the current item is a startObject or startArray, this skips over the rest
+        of its content without storing it, leaving the reader positioned on the
+        matching endObject or endArray. Otherwise it does nothing.
+    */
+    void skipValue();
+
+private:
+    //==============================================================================
+    enum class State { topLevel, value, valueOrEndOfArray, nameOrEndOfObject, name, commaOrEnd, finished };
+
+    struct ParseError {};
+
+    InputStream& input;
+    HeapBlock<char> buffer;
+    int bufferSize, bufferPos = 0, bufferEnd = 0;
+    Array<bool> containers;
+    State state = State::topLevel;
+    Event currentEvent = Event::null;
+
+    HeapBlock<char> token;
+    size_t tokenLength = 0, tokenSpace = 0;
+    int64 intValue = 0;
+    double doubleValue = 0;
+    bool numberIsInteger = false, boolValue = false;
+
+    int64 bufferStartPosition = 0, lineStartPosition = 0;
+    int line = 1;
+    String errorMessage;
+
+    bool refill();
+    int peekByte();
+    int readByte();
+    int skipWhitespaceAndPeek();
+    void startNewLine() noexcept;
+    void expectByte (char, const char* errorMessage);
+    void appendToToken (const char*, size_t);
+    void appendCharToToken (juce_wchar);
+    juce_wchar readUnicodeEscape();
+    void readString (char quote);
+    void readNumber();
+    void readLiteral (const char* remainingChars);
+    Event readValueStart (int firstChar);
+    Event parseNext();
+    Event finishValue (Event);
+    [[noreturn]] void throwError (const String&);
+
+    JUCE_DECLARE_NON_COPYABLE (JSONStreamReader)
+};
+
+} // namespace juce
@@ -0,0 +1,202 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2020 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   To use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+JSONStreamWriter::JSONStreamWriter (OutputStream& destination, bool oneLine, int decimalPlaces)
+    : output (destination), allOnOneLine (oneLine), maximumDecimalPlaces (decimalPlaces)
+{
+}
+
+JSONStreamWriter::~JSONStreamWriter()
+{
+    // You must close all your objects and arrays before the writer is deleted!
+    jassert (containers.isEmpty() && ! isExpectingPropertyValue);
+}
+
+//==============================================================================
+int JSONStreamWriter::getIndent() const noexcept
+{
+    return containers.size() * JSONFormatter::indentSize;
+}
+
+void JSONStreamWriter::startItem (bool isPropertyName)
+{
+    ignoreUnused (isPropertyName);
+
+    if (containers.isEmpty())
+    {
+        jassert (! isPropertyName); // property names can only be written inside an object!
+
+        if (numTopLevelValues++ > 0)
+            output << newLine;
+
+        return;
+    }
+
+    auto& container = containers.getReference (containers.size() - 1);
+
+    if (container.isObject)
+    {
+        if (isExpectingPropertyValue)
+        {
+            jassert (! isPropertyName); // a property name must be followed by a value
+            isExpectingPropertyValue = false;
+            return;
+        }
+
+        jassert (isPropertyName); // each value in an object needs to be preceded by a call to writeName()
+    }
+    else
+    {
+        jassert (! isPropertyName); // arrays can't contain property names!
+    }
+
+    if (container.numItems++ > 0)
+    {
+        if (allOnOneLine)
+            output << ", ";
+        else
+            output << ',' << newLine;
+    }
+    else if (! (container.isObject || allOnOneLine))
+    {
+        output << newLine;
+    }
+
+    if (! allOnOneLine)
+        JSONFormatter::writeSpaces (output, getIndent());
+}
+
+void JSONStreamWriter::endContainer (bool isObject)
+{
+    // This must match the most recent call to startObject() or startArray()!
+    jassert (! containers.isEmpty() && containers.getLast().isObject == isObject);
+    jassert (! isExpectingPropertyValue);
+
+    if (containers.isEmpty())
+        return;
+
+    auto numItems = containers.getLast().numItems;
+    containers.removeLast();
+
+    if (! allOnOneLine)
+    {
+        if (numItems > 0)
+            output << newLine;
+
+        if (isObject || numItems > 0)
+            JSONFormatter::writeSpaces (output, getIndent());
+    }
+
+    output << (isObject ? '}' : ']');
+}
+
+//==============================================================================
+void JSONStreamWriter::startObject()
+{
+    startItem (false);
+    output << '{';
+
+    if (! allOnOneLine)
+        output << newLine;
+
+    containers.add ({ true, 0 });
+}
+
+void JSONStreamWriter::endObject()
+{
+    endContainer (true);
+}
+
+void JSONStreamWriter::startArray()
+{
+    startItem (false);
+    output << '[';
+    containers.add ({ false, 0 });
+}
+
+void JSONStreamWriter::endArray()
+{
+    endContainer (false);
+}
+
+void JSONStreamWriter::writeName (StringRef propertyName)
+{
+    startItem (true);
+    output << '"';
+    JSONFormatter::writeString (output, propertyName.text);
+    output << "\": ";
+    isExpectingPropertyValue = true;
+}
+
+//==============================================================================
+void JSONStreamWriter::writeValue (const var& value)
+{
+    startItem (false);
+    JSONFormatter::write (output, value, getIndent(), allOnOneLine, maximumDecimalPlaces);
+}
+
+void JSONStreamWriter::writeString (StringRef text)
+{
+    startItem (false);
+    output << '"';
+    JSONFormatter::writeString (output, text.text);
+    output << '"';
+}
+
+void JSONStreamWriter::writeInt (int64 value)
+{
+    startItem (false);
+    output << String (value);
+}
+
+void JSONStreamWriter::writeDouble (double value)
+{
+    startItem (false);
+
+    if (juce_isfinite (value))
+        output << serialiseDouble (value);
+    else
+        output << "null";
+}
+
+void JSONStreamWriter::writeBool (bool value)
+{
+    startItem (false);
+    output << (value ? "true" : "false");
+}
+
+void JSONStreamWriter::writeNull()
+{
+    startItem (false);
+    output << "null";
+}
+
+void JSONStreamWriter::writeProperty (StringRef propertyName, const var& value)
+{
+    writeName (propertyName);
+    writeValue (value);
+}
+
+} // namespace juce
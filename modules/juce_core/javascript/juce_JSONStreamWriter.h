@@ -0,0 +1,144 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2020 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   To use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    Writes JSON-formatted data to a stream, one element at a time.
+
+    This lets you write large amounts of JSON without first having to build a
+    var tree to pass to JSON::writeToStream(). The layout of the text matches
+    what JSON::writeToStream() would produce for the equivalent var, e.g.
+
+    @code
+    JSONStreamWriter writer (outputStream);
+
+    writer.startObject();
+    writer.writeProperty ("version", 2);
+    writer.writeName ("presets");
+    writer.startArray();
+
+    for (auto& preset : presets)
+        writer.writeValue (preset.toVar());
+
+    writer.endArray();
+    writer.endObject();
+    @endcode
+
+    If you write more than one top-level value, they'll be separated by new-lines.
+
+    @see JSONStreamReader, JSON
+
+    @tags{Core}
+*/
+class JUCE_API  JSONStreamWriter
+{
+public:
+    //==============================================================================
+    /** Creates a writer that will write to the given stream.
+
+        The stream is not owned by the writer, so it must stay alive for as long as
+        the writer is being used. The allOnOneLine and maximumDecimalPlaces
+        parameters have the same meanings as in JSON::writeToStream().
+    */
+    JSONStreamWriter (OutputStream& destination,
+                      bool allOnOneLine = false,
+                      int maximumDecimalPlaces = 15);
+
+    /** Destructor.
+        All the objects and arrays that were started must have been ended before the
+        writer is deleted.
+    */
+    ~JSONStreamWriter();
+
+    //==============================================================================
+    /** Writes the opening of an object. Its properties must be written as pairs of
+        calls to writeName() and one of the value-writing methods, and then the object
+        must be closed with endObject().
+    */
+    void startObject();
+
+    /** Closes the object that was opened by the last call to startObject(). */
+    void endObject();
+
+    /** Writes the opening of an array. Its elements can then be written with any of
+        the value-writing methods, and then the array must be closed with endArray().
+    */
+    void startArray();
+
+    /** Closes the array that was opened by the last call to startArray(). */
+    void endArray();
+
+    /** Writes the name of an object property. This must be followed by the property's value. */
+    void writeName (StringRef propertyName);
+
+    //==============================================================================
+    /** Writes a var, including the contents of any arrays or objects that it contains. */
+    void writeValue (const var& value);
+
+    /** Writes a string value. */
+    void writeString (StringRef text);
+
+    /** Writes an integer value. */
+    void writeInt (int64 value);
+
+    /** Writes a floating-point value. Values that aren't finite are written as null. */
+    void writeDouble (double value);
+
+    /** Writes a boolean value. */
+    void writeBool (bool value);
+
+    /** Writes a null value. */
+    void writeNull();
+
+    /** Writes an object property name, followed by its value. */
+    void writeProperty (StringRef propertyName, const var& value);
+
+    //==============================================================================
+    /** Returns the number of objects and arrays that are currently open. */
+    int getDepth() const noexcept           { return containers.size(); }
+
+private:
+    //==============================================================================
+    struct Container
+    {
+        bool isObject;
+        int numItems;
+    };
+
+    OutputStream& output;
+    Array<Container> containers;
+    const bool allOnOneLine;
+    const int maximumDecimalPlaces;
+    bool isExpectingPropertyValue = false;
+    int numTopLevelValues = 0;
+
+    int getIndent() const noexcept;
+    void startItem (bool isPropertyName);
+    void endContainer (bool isObject);
+
+    JUCE_DECLARE_NON_COPYABLE (JSONStreamWriter)
+};
+
+} // namespace juce
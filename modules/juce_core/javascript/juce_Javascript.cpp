@@ -71,6 +71,7 @@ struct JavascriptEngine::RootObject   : public DynamicObject
     }
 
     Time timeout;
+    int timeoutCheckCountdown = 0;
 
     using Args = const var::NativeFunctionArgs&;
     using TokenType = const char*;
@@ -102,6 +103,138 @@ struct JavascriptEngine::RootObject   : public DynamicObject
     static Identifier getPrototypeIdentifier()                { static const Identifier i ("prototype"); return i; }
     static var* getPropertyPointer (DynamicObject& o, const Identifier& i) noexcept   { return o.getProperties().getVarPointer (i); }
 
+    // Objects that are built by the same bit of code tend to have their properties in the same
+    // order, so each expression that looks up a property remembers where it last found it, and
+    // checks that position before falling back to a search.
+    static var* getPropertyPointer (DynamicObject& o, const Identifier& i, int& cachedIndex) noexcept
+    {
+        auto& props = o.getProperties();
+
+        if (isPositiveAndBelow (cachedIndex, props.size()) && props.begin()[cachedIndex].name == i)
+            return props.getVarPointerAt (cachedIndex);
+
+        cachedIndex = props.indexOf (i);
+        return cachedIndex >= 0 ? props.getVarPointerAt (cachedIndex) : nullptr;
+    }
+
+    //==============================================================================
+    /** Holds the local variables of a function call.
+
+        When a function is parsed, its parameters and var declarations are each given a slot,
+        so the expressions in its body can access them directly by index rather than by name.
+        A var only becomes visible once its declaration has run, so until then the name is
+        looked up in the enclosing scopes, as it would be if the locals were held in an object.
+
+        Slot 0 always holds 'this'. A plain call made from inside a function gets the caller's
+        scope as its 'this', so if anything needs that scope as an object, the locals are moved
+        into one and are accessed by name from then on. That's only done when it's actually
+        needed, as most functions never look at 'this'.
+    */
+    struct LocalVariables
+    {
+        LocalVariables (const Array<Identifier>& localNames)  : names (localNames)
+        {
+            auto num = (size_t) names.size();
+
+            if (num <= (size_t) numElementsInArray (localStorage))
+            {
+                values = localStorage;
+            }
+            else
+            {
+                heapStorage.reset (new var[num]);
+                heapIsDefined.calloc (num);
+                values = heapStorage.get();
+                isDefined = heapIsDefined;
+            }
+        }
+
+        enum { thisSlot = 0 };
+
+        var* get (int slot)
+        {
+            if (slot == thisSlot)
+                resolveCallerScopeAsThis();
+
+            if (object != nullptr)
+                return getPropertyPointer (*object, names.getReference (slot));
+
+            return isDefined[slot] ? values + slot : nullptr;
+        }
+
+        void set (int slot, const var& newValue)
+        {
+            if (object != nullptr)
+            {
+                object->setProperty (names.getReference (slot), newValue);
+            }
+            else
+            {
+                values[slot] = newValue;
+                isDefined[slot] = true;
+            }
+        }
+
+        var* find (const Identifier& name)
+        {
+            if (name == names.getReference (thisSlot))
+                resolveCallerScopeAsThis();
+
+            if (object != nullptr)
+                return getPropertyPointer (*object, name);
+
+            for (int i = 0; i < names.size(); ++i)
+                if (isDefined[i] && names.getReference (i) == name)
+                    return values + i;
+
+            return nullptr;
+        }
+
+        void setThisToCallerScope (LocalVariables& caller) noexcept
+        {
+            callerScopeAsThis = &caller;
+            isDefined[thisSlot] = true;
+        }
+
+        DynamicObject* getObject()
+        {
+            if (object == nullptr)
+            {
+                resolveCallerScopeAsThis();
+                object = new DynamicObject();
+
+                for (int i = 0; i < names.size(); ++i)
+                    if (isDefined[i])
+                        object->setProperty (names.getReference (i), values[i]);
+            }
+
+            return object.get();
+        }
+
+        const Array<Identifier>& names;
+
+    private:
+        var localStorage[12];
+        bool localIsDefined[12] = {};
+        std::unique_ptr<var[]> heapStorage;
+        HeapBlock<bool> heapIsDefined;
+        var* values = nullptr;
+        bool* isDefined = localIsDefined;
+        DynamicObject::Ptr object;
+        LocalVariables* callerScopeAsThis = nullptr;
+
+        void resolveCallerScopeAsThis()
+        {
+            if (callerScopeAsThis != nullptr)
+            {
+                values[thisSlot] = callerScopeAsThis->getObject();
+                callerScopeAsThis = nullptr;
+            }
+        }
+
+        JUCE_DECLARE_NON_COPYABLE (LocalVariables)
+    };
+
     //==============================================================================
     struct CodeLocation
     {
@@ -132,15 +265,21 @@ struct JavascriptEngine::RootObject   : public DynamicObject
             : parent (p), root (std::move (rt)),
               scope (std::move (scp)) {}
 
+        Scope (const Scope* p, ReferenceCountedObjectPtr<RootObject> rt, LocalVariables& locals) noexcept
+            : parent (p), root (std::move (rt)),
+              localVariables (&locals) {}
+
         const Scope* const parent;
         ReferenceCountedObjectPtr<RootObject> root;
-        DynamicObject::Ptr scope;
+        DynamicObject::Ptr scope;              // (null for a function call's scope)
+        LocalVariables* localVariables = nullptr;
 
-        var findFunctionCall (const CodeLocation& location, const var& targetObject, const Identifier& functionName) const
+        var findFunctionCall (const CodeLocation& location, const var& targetObject,
+                              const Identifier& functionName, int& cachedIndex) const
         {
             if (auto* o = targetObject.getDynamicObject())
             {
-                if (auto* prop = getPropertyPointer (*o, functionName))
+                if (auto* prop = getPropertyPointer (*o, functionName, cachedIndex))
                     return *prop;
 
                 for (auto* p = o->getProperty (getPrototypeIdentifier()).getDynamicObject(); p != nullptr;
@@ -180,15 +319,30 @@ struct JavascriptEngine::RootObject   : public DynamicObject
 
         var findSymbolInParentScopes (const Identifier& name) const
         {
-            if (auto v = getPropertyPointer (*scope, name))
+            int cachedIndex = -1;
+            return findSymbolInParentScopes (name, cachedIndex);
+        }
+
+        var findSymbolInParentScopes (const Identifier& name, int& cachedRootIndex) const
+        {
+            if (localVariables != nullptr)
+            {
+                if (auto v = localVariables->find (name))
+                    return *v;
+            }
+            else if (auto v = parent == nullptr ? getPropertyPointer (*scope, name, cachedRootIndex)
+                                                : getPropertyPointer (*scope, name))
+            {
                 return *v;
+            }
 
-            return parent != nullptr ? parent->findSymbolInParentScopes (name)
+            return parent != nullptr ? parent->findSymbolInParentScopes (name, cachedRootIndex)
                                      : var::undefined();
         }
 
         bool findAndInvokeMethod (const Identifier& function, const var::NativeFunctionArgs& args, var& result) const
         {
+            jassert (scope != nullptr);
             auto* target = args.thisObject.getDynamicObject();
 
             if (target == nullptr || target == scope.get())
@@ -234,6 +388,13 @@ struct JavascriptEngine::RootObject   : public DynamicObject
 
         void checkTimeOut (const CodeLocation& location) const
         {
+            // Reading the clock costs more than a lot of the things that get checked, so it's
+            // only done every few calls
+            if (--(root->timeoutCheckCountdown) > 0)
+                return;
+
+            root->timeoutCheckCountdown = 16;
+
             if (Time::getCurrentTime() > root->timeout)
                 location.throwError (root->timeout == Time() ? "Interrupted" : "Execution timed-out");
         }
@@ -301,12 +462,22 @@ struct JavascriptEngine::RootObject   : public DynamicObject
 
         ResultCode perform (const Scope& s, var*) const override
         {
-            s.scope->setProperty (name, initialiser->getResult (s));
+            if (slot >= 0)
+            {
+                jassert (s.localVariables != nullptr);
+                s.localVariables->set (slot, initialiser->getResult (s));
+            }
+            else
+            {
+                s.scope->setProperty (name, initialiser->getResult (s));
+            }
+
             return ok;
         }
 
         Identifier name;
         ExpPtr initialiser;
+        int slot = -1;
     };
 
     struct LoopStatement  : public Statement
@@ -375,17 +546,39 @@ struct JavascriptEngine::RootObject   : public DynamicObject
     {
         UnqualifiedName (const CodeLocation& l, const Identifier& n) noexcept : Expression (l), name (n) {}
 
-        var getResult (const Scope& s) const override  { return s.findSymbolInParentScopes (name); }
+        var getResult (const Scope& s) const override
+        {
+            if (slot >= 0)
+            {
+                jassert (s.localVariables != nullptr);
+
+                if (auto* v = s.localVariables->get (slot))
+                    return *v;
+
+                return s.parent != nullptr ? s.parent->findSymbolInParentScopes (name, cachedRootIndex)
+                                           : var::undefined();
+            }
+
+            return s.findSymbolInParentScopes (name, cachedRootIndex);
+        }
 
         void assign (const Scope& s, const var& newValue) const override
         {
-            if (auto* v = getPropertyPointer (*s.scope, name))
+            jassert (slot < 0 || s.localVariables != nullptr);
+
+            auto* v = slot >= 0 ? s.localVariables->get (slot)
+                                : (s.localVariables != nullptr ? s.localVariables->find (name)
+                                                               : getPropertyPointer (*s.scope, name));
+
+            if (v != nullptr)
                 *v = newValue;
             else
                 s.root->setProperty (name, newValue);
         }
 
         Identifier name;
+        int slot = -1;   // the index of the local variable, if this is one of the enclosing function's locals
+        mutable int cachedRootIndex = -1;
     };
 
     struct DotOperator  : public Expression
@@ -404,7 +597,7 @@ struct JavascriptEngine::RootObject   : public DynamicObject
             }
 
             if (auto* o = p.getDynamicObject())
-                if (auto* v = getPropertyPointer (*o, child))
+                if (auto* v = getPropertyPointer (*o, child, cachedIndex))
                     return *v;
 
             return var::undefined();
@@ -420,6 +613,7 @@ struct JavascriptEngine::RootObject   : public DynamicObject
 
         ExpPtr parent;
         Identifier child;
+        mutable int cachedIndex = -1;
     };
 
     struct ArraySubscript  : public Expression
@@ -500,6 +694,9 @@ struct JavascriptEngine::RootObject   : public DynamicObject
         {
             var a (lhs->getResult (s)), b (rhs->getResult (s));
 
+            if (a.isInt() && b.isInt())  // (the most common case, so worth checking first)
+                return getWithInts (a, b);
+
             if ((a.isUndefined() || a.isVoid()) && (b.isUndefined() || b.isVoid()))
                 return getWithUndefinedArg();
 
@@ -723,42 +920,80 @@ struct JavascriptEngine::RootObject   : public DynamicObject
 
         var getResult (const Scope& s) const override
         {
-            if (auto* dot = dynamic_cast<DotOperator*> (object.get()))
+            if (dotOperator != nullptr)
             {
-                auto thisObject = dot->parent->getResult (s);
-                return invokeFunction (s, s.findFunctionCall (location, thisObject, dot->child), thisObject);
+                auto thisObject = dotOperator->parent->getResult (s);
+                return invokeFunction (s, s.findFunctionCall (location, thisObject, dotOperator->child, cachedMethodIndex), thisObject);
             }
 
             auto function = object->getResult (s);
+
+            if (s.localVariables != nullptr)
+                return invokeFunction (s, function, {}, s.localVariables);
+
             return invokeFunction (s, function, var (s.scope.get()));
         }
 
-        var invokeFunction (const Scope& s, const var& function, const var& thisObject) const
+        var invokeFunction (const Scope& s, const var& function, const var& thisObject,
+                            LocalVariables* callerScopeAsThis = nullptr) const
         {
             s.checkTimeOut (location);
-            Array<var> argVars;
+            ArgumentList argVars (arguments.size());
 
-            for (auto* a : arguments)
-                argVars.add (a->getResult (s));
+            for (int i = 0; i < arguments.size(); ++i)
+                argVars.set (i, arguments.getUnchecked (i)->getResult (s));
 
-            const var::NativeFunctionArgs args (thisObject, argVars.begin(), argVars.size());
+            const var::NativeFunctionArgs args (thisObject, argVars.begin(), arguments.size());
 
             if (var::NativeFunction nativeFunction = function.getNativeFunction())
+            {
+                if (callerScopeAsThis != nullptr)
+                    return nativeFunction (var::NativeFunctionArgs (callerScopeAsThis->getObject(), argVars.begin(), arguments.size()));
+
                 return nativeFunction (args);
+            }
 
             if (auto* fo = dynamic_cast<FunctionObject*> (function.getObject()))
-                return fo->invoke (s, args);
+                return fo->invoke (s, args, callerScopeAsThis);
 
-            if (auto* dot = dynamic_cast<DotOperator*> (object.get()))
+            if (dotOperator != nullptr)
                 if (auto* o = thisObject.getDynamicObject())
-                    if (o->hasMethod (dot->child)) // allow an overridden DynamicObject::invokeMethod to accept a method call.
-                        return o->invokeMethod (dot->child, args);
+                    if (o->hasMethod (dotOperator->child)) // allow an overridden DynamicObject::invokeMethod to accept a method call.
+                        return o->invokeMethod (dotOperator->child, args);
 
             location.throwError ("This expression is not a function!"); return {};
         }
 
+        void setFunction (Expression* function)
+        {
+            object.reset (function);
+            dotOperator = dynamic_cast<DotOperator*> (function);
+        }
+
+        // The arguments are built on the stack unless there are lots of them
+        struct ArgumentList
+        {
+            ArgumentList (int num)
+            {
+                if (num > numElementsInArray (localStorage))
+                {
+                    heapStorage.reset (new var[(size_t) num]);
+                    values = heapStorage.get();
+                }
+            }
+
+            void set (int index, var&& v) noexcept    { values[index] = std::move (v); }
+            const var* begin() const noexcept         { return values; }
+
+            var localStorage[6];
+            std::unique_ptr<var[]> heapStorage;
+            var* values = localStorage;
+        };
+
         ExpPtr object;
         OwnedArray<Expression> arguments;
+        DotOperator* dotOperator = nullptr;
+        mutable int cachedMethodIndex = -1;
     };
 
     struct NewOperator  : public FunctionCall
@@ -840,25 +1075,34 @@ struct JavascriptEngine::RootObject   : public DynamicObject
             out << "function " << functionCode;
         }
 
-        var invoke (const Scope& s, const var::NativeFunctionArgs& args) const
+        var invoke (const Scope& s, const var::NativeFunctionArgs& args,
+                    LocalVariables* callerScopeAsThis = nullptr) const
         {
-            DynamicObject::Ptr functionRoot (new DynamicObject());
+            LocalVariables locals (localNames);
 
-            static const Identifier thisIdent ("this");
-            functionRoot->setProperty (thisIdent, args.thisObject);
+            if (callerScopeAsThis != nullptr)
+                locals.setThisToCallerScope (*callerScopeAsThis);
+            else
+                locals.set (LocalVariables::thisSlot, args.thisObject);
 
             for (int i = 0; i < parameters.size(); ++i)
-                functionRoot->setProperty (parameters.getReference(i),
-                                           i < args.numArguments ? args.arguments[i] : var::undefined());
+                locals.set (parameterSlots.getUnchecked (i),
+                            i < args.numArguments ? args.arguments[i] : var::undefined());
 
             var result;
-            body->perform (Scope (&s, s.root, functionRoot), &result);
+            body->perform (Scope (&s, s.root, locals), &result);
             return result;
         }
 
+        static Identifier getThisIdentifier()    { static const Identifier i ("this"); return i; }
+
         String functionCode;
         Array<Identifier> parameters;
         std::unique_ptr<Statement> body;
+
+        // The names of all the function's local variables, in slot order.
+        Array<Identifier> localNames;
+        Array<int> parameterSlots;
     };
 
     //==============================================================================
@@ -1072,6 +1316,7 @@ struct JavascriptEngine::RootObject   : public DynamicObject
 
         void parseFunctionParamsAndBody (FunctionObject& fo)
         {
+            LocalVariableResolver resolver (*this, fo);
             match (TokenTypes::openParen);
 
             while (currentType != TokenTypes::closeParen)
@@ -1079,6 +1324,7 @@ struct JavascriptEngine::RootObject   : public DynamicObject
                 auto paramName = currentValue.toString();
                 match (TokenTypes::identifier);
                 fo.parameters.add (paramName);
+                fo.parameterSlots.add (resolver.getSlotFor (paramName));
 
                 if (currentType != TokenTypes::closeParen)
                     match (TokenTypes::comma);
@@ -1086,6 +1332,7 @@ struct JavascriptEngine::RootObject   : public DynamicObject
 
             match (TokenTypes::closeParen);
             fo.body.reset (parseBlock());
+            resolver.resolveNames();
         }
 
         Expression* parseExpression()
@@ -1106,6 +1353,63 @@ struct JavascriptEngine::RootObject   : public DynamicObject
         }
 
     private:
+        //==============================================================================
+        // While a function is being parsed, this gives each of its parameters and var
+        // declarations a slot, and afterwards points all the names in its body that refer
+        // to them at their slots.
+        struct LocalVariableResolver
+        {
+            LocalVariableResolver (ExpressionTreeBuilder& b, FunctionObject& f)
+                : builder (b), function (f), previous (b.currentFunction)
+            {
+                function.localNames.clearQuick();
+                function.parameterSlots.clearQuick();
+                function.localNames.add (FunctionObject::getThisIdentifier());
+                builder.currentFunction = this;
+            }
+
+            ~LocalVariableResolver()
+            {
+                builder.currentFunction = previous;
+            }
+
+            int getSlotFor (const Identifier& name)
+            {
+                auto index = function.localNames.indexOf (name);
+
+                if (index >= 0)
+                    return index;
+
+                function.localNames.add (name);
+                return function.localNames.size() - 1;
+            }
+
+            void resolveNames()
+            {
+                for (auto* n : names)
+                    n->slot = function.localNames.indexOf (n->name);
+            }
+
+            ExpressionTreeBuilder& builder;
+            FunctionObject& function;
+            LocalVariableResolver* const previous;
+            Array<UnqualifiedName*> names;
+
+            JUCE_DECLARE_NON_COPYABLE (LocalVariableResolver)
+        };
+
+        LocalVariableResolver* currentFunction = nullptr;
+
+        UnqualifiedName* createName (const Identifier& name)
+        {
+            auto* n = new UnqualifiedName (location, name);
+
+            if (currentFunction != nullptr)
+                currentFunction->names.add (n);
+
+            return n;
+        }
+
         void throwError (const String& err) const  { location.throwError (err); }
 
         template <typename OpType>
@@ -1178,6 +1482,9 @@ struct JavascriptEngine::RootObject   : public DynamicObject
         {
             std::unique_ptr<VarStatement> s (new VarStatement (location));
             s->name = parseIdentifier();
+
+            if (currentFunction != nullptr)
+                s->slot = currentFunction->getSlotFor (s->name);
             s->initialiser.reset (matchIf (TokenTypes::assign) ? parseExpression() : new Expression (location));
 
             if (matchIf (TokenTypes::comma))
@@ -1200,7 +1507,7 @@ struct JavascriptEngine::RootObject   : public DynamicObject
             if (name.isNull())
                 throwError ("Functions defined at statement-level must have a name");
 
-            ExpPtr nm (new UnqualifiedName (location, name)), value (new LiteralValue (location, fn));
+            ExpPtr nm (createName (name)), value (new LiteralValue (location, fn));
             return new Assignment (location, nm, value);
         }
 
@@ -1278,7 +1585,7 @@ struct JavascriptEngine::RootObject   : public DynamicObject
         Expression* parseFunctionCall (FunctionCall* call, ExpPtr& function)
         {
             std::unique_ptr<FunctionCall> s (call);
-            s->object.reset (function.release());
+            s->setFunction (function.release());
             match (TokenTypes::openParen);
 
             while (currentType != TokenTypes::closeParen)
@@ -1318,7 +1625,7 @@ struct JavascriptEngine::RootObject   : public DynamicObject
 
         Expression* parseFactor()
         {
-            if (currentType == TokenTypes::identifier)  return parseSuffixes (new UnqualifiedName (location, parseIdentifier()));
+            if (currentType == TokenTypes::identifier)  return parseSuffixes (createName (parseIdentifier()));
             if (matchIf (TokenTypes::openParen))        return parseSuffixes (matchCloseParen (parseExpression()));
             if (matchIf (TokenTypes::true_))            return parseSuffixes (new LiteralValue (location, (int) 1));
             if (matchIf (TokenTypes::false_))           return parseSuffixes (new LiteralValue (location, (int) 0));
@@ -1382,7 +1689,7 @@ struct JavascriptEngine::RootObject   : public DynamicObject
 
             if (matchIf (TokenTypes::new_))
             {
-                ExpPtr name (new UnqualifiedName (location, parseIdentifier()));
+                ExpPtr name (createName (parseIdentifier()));
 
                 while (matchIf (TokenTypes::dot))
                     name.reset (new DotOperator (location, name, parseIdentifier()));
@@ -1413,7 +1720,7 @@ struct JavascriptEngine::RootObject   : public DynamicObject
         Expression* parseTypeof()
         {
             std::unique_ptr<FunctionCall> f (new FunctionCall (location));
-            f->object.reset (new UnqualifiedName (location, "typeof"));
+            f->setFunction (createName ("typeof"));
             f->arguments.add (parseUnary());
             return f.release();
         }
@@ -1914,6 +2221,85 @@ const NamedValueSet& JavascriptEngine::getRootObjectProperties() const noexcept
     return root->getProperties();
 }
 
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class JavascriptEngineTests  : public UnitTest
+{
+public:
+    JavascriptEngineTests()
+        : UnitTest ("JavascriptEngine", UnitTestCategories::javascript)
+    {}
+
+    static var evaluate (const String& code, const String& expression)
+    {
+        JavascriptEngine engine;
+        auto result = engine.execute (code);
+
+        if (result.failed())
+            return result.getErrorMessage();
+
+        return engine.evaluate (expression);
+    }
+
+    void runTest() override
+    {
+        beginTest ("Local variables");
+        {
+            expectEquals ((int) evaluate ("function f (a, b) { var c = a * b; return c + a; }", "f (3, 4)"), 15);
+            expectEquals ((int) evaluate ("function f (n) { var t = 0; for (var i = 0; i < n; ++i) t += i; return t; }", "f (100)"), 4950);
+            expectEquals ((int) evaluate ("function f (n) { return n <= 1 ? 1 : n * f (n - 1); }", "f (10)"), 3628800);
+            expect (evaluate ("function f() { var x = typeof y; var y = 1; return x; }", "f()").toString() == "undefined");
+        }
+
+        beginTest ("Dynamic scoping");
+        {
+            expectEquals ((int) evaluate ("var g = 1; function f() { g = 5; } f();", "g"), 5);
+            expectEquals ((int) evaluate ("function f() { h = 7; } f();", "h"), 7);
+            expectEquals ((int) evaluate ("function inner() { return x; } function outer() { var x = 9; return inner(); }", "outer()"), 9);
+            expectEquals ((int) evaluate ("var x = 2; function inner() { return x; } function outer() { return inner(); }", "outer()"), 2);
+        }
+
+        beginTest ("Objects and methods");
+        {
+            expectEquals ((int) evaluate ("var o = { v: 3, get: function() { return this.v; } }; o.v = 4;", "o.get()"), 4);
+            expectEquals ((int) evaluate ("var a = [1, 2, 3]; var t = 0; for (var i = 0; i < a.length; ++i) t += a[i];", "t"), 6);
+            expectEquals ((int) evaluate ("function f (a, b, c, d, e, g, h, k) { return a + k; }", "f (1, 2, 3, 4, 5, 6, 7, 8)"), 9);
+        }
+
+        beginTest ("'this' in method calls");
+        {
+            expectEquals ((int) evaluate ("var o = { v: 2, get: function() { return this.v; }, twice: function() { return this.get() * 2; } };", "o.twice()"), 4);
+            expectEquals ((int) evaluate ("var o = { v: 3, get: function() { return this.v; } }; function f() { return o.get(); }", "f()"), 3);
+            expectEquals ((int) evaluate ("var o = { v: 1, inner: { v: 2, get: function() { return this.v; } }, get: function() { return this.inner.get() + this.v; } };", "o.get()"), 3);
+            expectEquals ((int) evaluate ("function C() { this.v = 3; this.get = function() { return this.v; }; } var c = new C();", "c.get()"), 3);
+        }
+
+        beginTest ("'this' in nested function calls");
+        {
+            expectEquals ((int) evaluate ("var x = 4; function f() { return this.x; }", "f()"), 4);
+            expectEquals ((int) evaluate ("function inner() { return this.x; } function outer() { var x = 6; return inner(); }", "outer()"), 6);
+            expectEquals ((int) evaluate ("function inner() { return this.x; } function outer() { var x = 6; var r = inner(); x = 7; return r + inner(); }", "outer()"), 13);
+            expectEquals ((int) evaluate ("function inner() { this.x = 8; } function outer() { var x = 1; inner(); return x; }", "outer()"), 8);
+            expectEquals ((int) evaluate ("function inner() { this.y = 8; } function outer() { inner(); return y; }", "outer()"), 8);
+            expectEquals ((int) evaluate ("function inner() { return this.this.v; } var o = { v: 5, get: function() { return inner(); } };", "o.get()"), 5);
+            expectEquals ((int) evaluate ("function inner() { return this.this.x; } function middle() { return inner(); } function outer() { var x = 9; return middle(); }", "outer()"), 9);
+            expect (evaluate ("function inner() { return typeof this.v; } var o = { v: 5, get: function() { return inner(); } };", "o.get()").toString() == "undefined");
+        }
+
+        beginTest ("Timeout");
+        {
+            JavascriptEngine engine;
+            engine.maximumExecutionTime = RelativeTime::milliseconds (20);
+            expect (engine.execute ("function f() { while (true) {} } f();").failed());
+        }
+    }
+};
+
+static JavascriptEngineTests javascriptEngineTests;
+
+#endif
+
 JUCE_END_IGNORE_WARNINGS_MSVC
 
 } // namespace juce
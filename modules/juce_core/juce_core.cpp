@@ -76,14 +76,32 @@
   #include <langinfo.h>
   #include <ifaddrs.h>
   #include <sys/resource.h>
+  #include <sys/syscall.h>
 
   #if JUCE_USE_CURL
    #include <curl/curl.h>
   #endif
+
+  #if JUCE_USE_IO_URING && defined (__has_include)
+   #if __has_include (<linux/io_uring.h>)
+    #include <linux/io_uring.h>
+   #endif
+  #endif
+
+  // AsyncFileIO needs the io_uring definitions from the Linux 5.4 headers or later
+  #if JUCE_USE_IO_URING && ! defined (IORING_FEAT_SINGLE_MMAP)
+   #undef JUCE_USE_IO_URING
+   #define JUCE_USE_IO_URING 0
+  #endif
+
+  #if JUCE_USE_IO_URING
+   #include <sys/eventfd.h>
+  #endif
  #endif
 
  #include <pwd.h>
  #include <fcntl.h>
+ #include <sys/uio.h>
  #include <netdb.h>
  #include <arpa/inet.h>
  #include <netinet/tcp.h>
@@ -137,6 +155,8 @@
 #include "maths/juce_Random.cpp"
 #include "memory/juce_MemoryBlock.cpp"
 #include "memory/juce_AllocationHooks.cpp"
+#include "memory/juce_MemoryArena.cpp"
+#include "memory/juce_RealtimeMemoryPool.cpp"
 #include "misc/juce_RuntimePermissions.cpp"
 #include "misc/juce_Result.cpp"
 #include "misc/juce_Uuid.cpp"
@@ -160,22 +180,30 @@
 #include "text/juce_StringArray.cpp"
 #include "text/juce_StringPairArray.cpp"
 #include "text/juce_StringPool.cpp"
+#include "text/juce_StringView.cpp"
 #include "text/juce_TextDiff.cpp"
 #include "text/juce_Base64.cpp"
 #include "threads/juce_ReadWriteLock.cpp"
 #include "threads/juce_Thread.cpp"
 #include "threads/juce_ThreadPool.cpp"
+#include "threads/juce_TaskScheduler.cpp"
+#include "threads/juce_RealtimeWorkerGroup.cpp"
 #include "threads/juce_TimeSliceThread.cpp"
 #include "time/juce_PerformanceCounter.cpp"
+#include "time/juce_Tracer.cpp"
 #include "time/juce_RelativeTime.cpp"
 #include "time/juce_Time.cpp"
 #include "unit_tests/juce_UnitTest.cpp"
 #include "containers/juce_Variant.cpp"
 #include "javascript/juce_JSON.cpp"
+#include "javascript/juce_JSONStreamReader.cpp"
+#include "javascript/juce_JSONStreamWriter.cpp"
+#include "javascript/juce_JSONDocument.cpp"
 #include "javascript/juce_Javascript.cpp"
 #include "containers/juce_DynamicObject.cpp"
 #include "xml/juce_XmlDocument.cpp"
 #include "xml/juce_XmlElement.cpp"
+#include "xml/juce_XmlStreamReader.cpp"
 #include "zip/juce_GZIPDecompressorInputStream.cpp"
 #include "zip/juce_GZIPCompressorOutputStream.cpp"
 #include "zip/juce_ZipFile.cpp"
@@ -231,6 +259,7 @@
 
 #endif
 
+#include "files/juce_AsyncFileIO.cpp"
 #include "threads/juce_ChildProcess.cpp"
 #include "threads/juce_HighResolutionTimer.cpp"
 #include "threads/juce_WaitableEvent.cpp"
@@ -241,6 +270,7 @@
 //==============================================================================
 #if JUCE_UNIT_TESTS
  #include "containers/juce_HashMap_test.cpp"
+ #include "containers/juce_ConcurrentListenerList_test.cpp"
 #endif
 
 //==============================================================================
@@ -151,6 +151,16 @@
  #define JUCE_LOAD_CURL_SYMBOLS_LAZILY 0
 #endif
 
+/** Config: JUCE_USE_IO_URING
+    Lets AsyncFileIO hand its requests to the kernel using io_uring (Linux only). This needs
+    the kernel headers for version 5.4 or later at compile-time, and is turned off if they
+    can't be found. If the kernel that the app runs on doesn't support it, AsyncFileIO will
+    fall back to using threads.
+*/
+#ifndef JUCE_USE_IO_URING
+ #define JUCE_USE_IO_URING 1
+#endif
+
 /** Config: JUCE_CATCH_UNHANDLED_EXCEPTIONS
     If enabled, this will add some exception-catching code to forward unhandled exceptions
     to your JUCEApplicationBase::unhandledException() callback.
@@ -185,6 +195,14 @@
  #define JUCE_ENABLE_ALLOCATION_HOOKS 0
 #endif
 
+/** Config: JUCE_ENABLE_TRACING
+    If enabled, the JUCE_TRACE_SCOPE and related macros will record events when Tracer::start()
+    has been called. Disable this to remove them from the build completely.
+*/
+#ifndef JUCE_ENABLE_TRACING
+ #define JUCE_ENABLE_TRACING 1
+#endif
+
 #ifndef JUCE_STRING_UTF_TYPE
  #define JUCE_STRING_UTF_TYPE 8
 #endif
@@ -235,12 +253,15 @@ JUCE_END_IGNORE_WARNINGS_MSVC
 
 #include "text/juce_String.h"
 #include "text/juce_StringRef.h"
+#include "text/juce_StringView.h"
 #include "logging/juce_Logger.h"
 #include "memory/juce_LeakedObjectDetector.h"
 #include "memory/juce_ContainerDeletePolicy.h"
 #include "memory/juce_HeapBlock.h"
 #include "memory/juce_MemoryBlock.h"
 #include "memory/juce_ReferenceCountedObject.h"
+#include "memory/juce_MemoryArena.h"
+#include "memory/juce_RealtimeMemoryPool.h"
 #include "memory/juce_ScopedPointer.h"
 #include "memory/juce_OptionalScopedPointer.h"
 #include "memory/juce_Singleton.h"
@@ -279,6 +300,9 @@ JUCE_END_IGNORE_WARNINGS_MSVC
 #include "containers/juce_NamedValueSet.h"
 #include "containers/juce_DynamicObject.h"
 #include "containers/juce_HashMap.h"
+#include "containers/juce_FlatHashMap.h"
+#include "containers/juce_ConcurrentHashMap.h"
+#include "containers/juce_ConcurrentListenerList.h"
 #include "time/juce_RelativeTime.h"
 #include "time/juce_Time.h"
 #include "streams/juce_InputStream.h"
@@ -298,9 +322,13 @@ JUCE_END_IGNORE_WARNINGS_MSVC
 #include "files/juce_TemporaryFile.h"
 #include "files/juce_FileFilter.h"
 #include "files/juce_WildcardFileFilter.h"
+#include "files/juce_AsyncFileIO.h"
 #include "streams/juce_FileInputSource.h"
 #include "logging/juce_FileLogger.h"
 #include "javascript/juce_JSON.h"
+#include "javascript/juce_JSONStreamReader.h"
+#include "javascript/juce_JSONStreamWriter.h"
+#include "javascript/juce_JSONDocument.h"
 #include "javascript/juce_Javascript.h"
 #include "maths/juce_BigInteger.h"
 #include "maths/juce_Expression.h"
@@ -317,6 +345,8 @@ JUCE_END_IGNORE_WARNINGS_MSVC
 #include "threads/juce_Thread.h"
 #include "threads/juce_ThreadLocalValue.h"
 #include "threads/juce_ThreadPool.h"
+#include "threads/juce_TaskScheduler.h"
+#include "threads/juce_RealtimeWorkerGroup.h"
 #include "threads/juce_TimeSliceThread.h"
 #include "threads/juce_ReadWriteLock.h"
 #include "threads/juce_ScopedReadLock.h"
@@ -329,9 +359,11 @@ JUCE_END_IGNORE_WARNINGS_MSVC
 #include "network/juce_WebInputStream.h"
 #include "streams/juce_URLInputSource.h"
 #include "time/juce_PerformanceCounter.h"
+#include "time/juce_Tracer.h"
 #include "unit_tests/juce_UnitTest.h"
 #include "xml/juce_XmlDocument.h"
 #include "xml/juce_XmlElement.h"
+#include "xml/juce_XmlStreamReader.h"
 #include "zip/juce_GZIPCompressorOutputStream.h"
 #include "zip/juce_GZIPDecompressorInputStream.h"
 #include "zip/juce_ZipFile.h"
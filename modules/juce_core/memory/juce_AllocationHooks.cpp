@@ -43,24 +43,28 @@ void notifyAllocationHooksForThread()
 
 void* operator new (size_t s)
 {
+    juce::RealtimeSafetyGuard::checkOperation (juce::RealtimeSafetyGuard::Violation::allocation);
     juce::notifyAllocationHooksForThread();
     return std::malloc (s);
 }
 
 void* operator new[] (size_t s)
 {
+    juce::RealtimeSafetyGuard::checkOperation (juce::RealtimeSafetyGuard::Violation::allocation);
     juce::notifyAllocationHooksForThread();
     return std::malloc (s);
 }
 
 void operator delete (void* p) noexcept
 {
+    juce::RealtimeSafetyGuard::checkOperation (juce::RealtimeSafetyGuard::Violation::deallocation);
     juce::notifyAllocationHooksForThread();
     std::free (p);
 }
 
 void operator delete[] (void* p) noexcept
 {
+    juce::RealtimeSafetyGuard::checkOperation (juce::RealtimeSafetyGuard::Violation::deallocation);
     juce::notifyAllocationHooksForThread();
     std::free (p);
 }
@@ -69,12 +73,14 @@ void operator delete[] (void* p) noexcept
 
 void operator delete (void* p, size_t) noexcept
 {
+    juce::RealtimeSafetyGuard::checkOperation (juce::RealtimeSafetyGuard::Violation::deallocation);
     juce::notifyAllocationHooksForThread();
     std::free (p);
 }
 
 void operator delete[] (void* p, size_t) noexcept
 {
+    juce::RealtimeSafetyGuard::checkOperation (juce::RealtimeSafetyGuard::Violation::deallocation);
     juce::notifyAllocationHooksForThread();
     std::free (p);
 }
@@ -34,6 +34,45 @@ namespace HeapBlockHelper
 }
 #endif
 
+#ifndef DOXYGEN
+namespace HeapBlockHelper
+{
+    /*  HeapBlock uses these in place of the C allocation functions. While any
+        RealtimeMemoryPool or RealtimeSafetyGuard exists, they go through the pooled
+        versions, so that the memory can come from the calling thread's pool.
+    */
+    extern JUCE_API std::atomic<int> numRealtimeMemoryUsers;
+
+    JUCE_API void* JUCE_CALLTYPE allocatePooled (size_t numBytes, bool initialiseToZero) noexcept;
+    JUCE_API void* JUCE_CALLTYPE reallocatePooled (void* data, size_t numBytes) noexcept;
+    JUCE_API void JUCE_CALLTYPE freePooled (void* data) noexcept;
+
+    inline void* allocateMemory (size_t numBytes, bool initialiseToZero) noexcept
+    {
+        if (numRealtimeMemoryUsers.load (std::memory_order_relaxed) != 0)
+            return allocatePooled (numBytes, initialiseToZero);
+
+        return initialiseToZero ? std::calloc (numBytes, 1) : std::malloc (numBytes);
+    }
+
+    inline void* reallocateMemory (void* data, size_t numBytes) noexcept
+    {
+        if (numRealtimeMemoryUsers.load (std::memory_order_relaxed) != 0)
+            return reallocatePooled (data, numBytes);
+
+        return data == nullptr ? std::malloc (numBytes) : std::realloc (data, numBytes);
+    }
+
+    inline void freeMemory (void* data) noexcept
+    {
+        if (numRealtimeMemoryUsers.load (std::memory_order_relaxed) != 0)
+            freePooled (data);
+        else
+            std::free (data);
+    }
+}
+#endif
+
 //==============================================================================
 /**
     Very simple container class to hold a pointer to some data on the heap.
@@ -109,7 +148,7 @@ public:
     */
     template <typename SizeType>
     explicit HeapBlock (SizeType numElements)
-        : data (static_cast<ElementType*> (std::malloc (static_cast<size_t> (numElements) * sizeof (ElementType))))
+        : data (static_cast<ElementType*> (HeapBlockHelper::allocateMemory (static_cast<size_t> (numElements) * sizeof (ElementType), false)))
     {
         throwOnAllocationFailure();
     }
@@ -121,9 +160,8 @@ public:
     */
     template <typename SizeType>
     HeapBlock (SizeType numElements, bool initialiseToZero)
-        : data (static_cast<ElementType*> (initialiseToZero
-                                               ? std::calloc (static_cast<size_t> (numElements), sizeof (ElementType))
-                                               : std::malloc (static_cast<size_t> (numElements) * sizeof (ElementType))))
+        : data (static_cast<ElementType*> (HeapBlockHelper::allocateMemory (static_cast<size_t> (numElements) * sizeof (ElementType),
+                                                                            initialiseToZero)))
     {
         throwOnAllocationFailure();
     }
@@ -133,7 +171,7 @@ public:
     */
     ~HeapBlock()
     {
-        std::free (data);
+        HeapBlockHelper::freeMemory (data);
     }
 
     /** Move constructor */
@@ -251,8 +289,8 @@ public:
     template <typename SizeType>
     void malloc (SizeType newNumElements, size_t elementSize = sizeof (ElementType))
     {
-        std::free (data);
-        data = static_cast<ElementType*> (std::malloc (static_cast<size_t> (newNumElements) * elementSize));
+        HeapBlockHelper::freeMemory (data);
+        data = static_cast<ElementType*> (HeapBlockHelper::allocateMemory (static_cast<size_t> (newNumElements) * elementSize, false));
         throwOnAllocationFailure();
     }
 
@@ -262,8 +300,8 @@ public:
     template <typename SizeType>
     void calloc (SizeType newNumElements, const size_t elementSize = sizeof (ElementType))
     {
-        std::free (data);
-        data = static_cast<ElementType*> (std::calloc (static_cast<size_t> (newNumElements), elementSize));
+        HeapBlockHelper::freeMemory (data);
+        data = static_cast<ElementType*> (HeapBlockHelper::allocateMemory (static_cast<size_t> (newNumElements) * elementSize, true));
         throwOnAllocationFailure();
     }
 
@@ -274,10 +312,9 @@ public:
     template <typename SizeType>
     void allocate (SizeType newNumElements, bool initialiseToZero)
     {
-        std::free (data);
-        data = static_cast<ElementType*> (initialiseToZero
-                                             ? std::calloc (static_cast<size_t> (newNumElements), sizeof (ElementType))
-                                             : std::malloc (static_cast<size_t> (newNumElements) * sizeof (ElementType)));
+        HeapBlockHelper::freeMemory (data);
+        data = static_cast<ElementType*> (HeapBlockHelper::allocateMemory (static_cast<size_t> (newNumElements) * sizeof (ElementType),
+                                                                           initialiseToZero));
         throwOnAllocationFailure();
     }
 
@@ -289,8 +326,7 @@ public:
     template <typename SizeType>
     void realloc (SizeType newNumElements, size_t elementSize = sizeof (ElementType))
     {
-        data = static_cast<ElementType*> (data == nullptr ? std::malloc (static_cast<size_t> (newNumElements) * elementSize)
-                                                          : std::realloc (data, static_cast<size_t> (newNumElements) * elementSize));
+        data = static_cast<ElementType*> (HeapBlockHelper::reallocateMemory (data, static_cast<size_t> (newNumElements) * elementSize));
         throwOnAllocationFailure();
     }
 
@@ -299,7 +335,7 @@ public:
     */
     void free() noexcept
     {
-        std::free (data);
+        HeapBlockHelper::freeMemory (data);
         data = nullptr;
     }
 
@@ -0,0 +1,391 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2020 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   To use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+namespace MemoryArenaHelpers
+{
+    constexpr size_t alignment = alignof (std::max_align_t);
+    constexpr size_t maxGrowthBlockSize = 16 * 1024 * 1024;
+    constexpr int maxNumBlocks = 256;
+
+    constexpr size_t roundUp (size_t n) noexcept    { return (n + alignment - 1) & ~(alignment - 1); }
+
+    // Objects don't carry any record of where they came from, so freeObject() finds out
+    // whether a pointer belongs to an arena by looking for it in this table of the blocks
+    // that arenas currently own. As in RealtimeMemoryPool, each range is guarded by a
+    // sequence count that's odd while it's being changed. The arena can't go away while
+    // one of its objects is being freed, because the object holds a reference to it.
+    struct RegisteredBlock
+    {
+        std::atomic<bool> inUse { false };
+        std::atomic<uint32> sequence { 0 };
+        std::atomic<MemoryArena*> arena { nullptr };
+        std::atomic<const char*> begin { nullptr }, end { nullptr };
+
+        void setRange (MemoryArena* newArena, const char* newBegin, const char* newEnd) noexcept
+        {
+            sequence.fetch_add (1, std::memory_order_relaxed);
+            std::atomic_thread_fence (std::memory_order_release);
+            arena.store (newArena, std::memory_order_relaxed);
+            begin.store (newBegin, std::memory_order_relaxed);
+            end.store (newEnd, std::memory_order_relaxed);
+            sequence.fetch_add (1, std::memory_order_release);
+        }
+
+        MemoryArena* findOwner (const void* address) const noexcept
+        {
+            for (;;)
+            {
+                auto startSequence = sequence.load (std::memory_order_acquire);
+                auto* a = arena.load (std::memory_order_relaxed);
+                auto* b = begin.load (std::memory_order_relaxed);
+                auto* e = end.load (std::memory_order_relaxed);
+                std::atomic_thread_fence (std::memory_order_acquire);
+
+                if ((startSequence & 1) == 0 && startSequence == sequence.load (std::memory_order_relaxed))
+                    return (address >= b && address < e) ? a : nullptr;
+            }
+        }
+    };
+
+    static RegisteredBlock registeredBlocks[maxNumBlocks];
+    static std::atomic<int> numSlotsUsed { 0 }, numRegisteredBlocks { 0 };
+
+    // The number of ScopedUse objects that have an arena. While this is zero, which is
+    // almost always, allocateObject() doesn't need to look at the thread's arena at all.
+    static std::atomic<int> numActiveScopes { 0 };
+
+    static int registerBlock (MemoryArena* arena, const char* begin, const char* end) noexcept
+    {
+        for (int i = 0; i < maxNumBlocks; ++i)
+        {
+            bool expected = false;
+
+            if (registeredBlocks[i].inUse.compare_exchange_strong (expected, true, std::memory_order_acquire))
+            {
+                numRegisteredBlocks.fetch_add (1, std::memory_order_relaxed);
+                registeredBlocks[i].setRange (arena, begin, end);
+
+                auto n = numSlotsUsed.load();
+
+                while (n <= i && ! numSlotsUsed.compare_exchange_weak (n, i + 1))
+                {}
+
+                return i;
+            }
+        }
+
+        return -1;
+    }
+
+    static void deregisterBlock (int slot) noexcept
+    {
+        registeredBlocks[slot].setRange (nullptr, nullptr, nullptr);
+        numRegisteredBlocks.fetch_sub (1, std::memory_order_relaxed);
+        registeredBlocks[slot].inUse.store (false, std::memory_order_release);
+    }
+
+    static MemoryArena* findArenaOwning (const void* address) noexcept
+    {
+        // An arena's blocks are registered before any objects are made from them, so if
+        // this pointer came from one, this thread will see a non-zero count.
+        if (numRegisteredBlocks.load (std::memory_order_relaxed) == 0)
+            return nullptr;
+
+        auto num = numSlotsUsed.load (std::memory_order_acquire);
+
+        for (int i = 0; i < num; ++i)
+            if (auto* arena = registeredBlocks[i].findOwner (address))
+                return arena;
+
+        return nullptr;
+    }
+
+    static MemoryArena*& getCurrentArenaForThread() noexcept
+    {
+        thread_local MemoryArena* current = nullptr;
+        return current;
+    }
+}
+
+struct MemoryArena::Block
+{
+    Block* previous;
+    size_t size;
+    int registrationSlot;
+};
+
+MemoryArena::MemoryArena (size_t blockSizeInBytes)
+    : blockSize (jmax ((size_t) 1024, blockSizeInBytes))
+{
+}
+
+MemoryArena::~MemoryArena()
+{
+    while (lastBlock != nullptr)
+    {
+        if (lastBlock->registrationSlot >= 0)
+            MemoryArenaHelpers::deregisterBlock (lastBlock->registrationSlot);
+
+        auto* previous = lastBlock->previous;
+        ::operator delete (lastBlock);
+        lastBlock = previous;
+    }
+}
+
+void* MemoryArena::allocate (size_t numBytes)
+{
+    using namespace MemoryArenaHelpers;
+    numBytes = roundUp (jmax ((size_t) 1, numBytes));
+
+    if (numBytes > bytesLeftInBlock)
+    {
+        // (the blocks get bigger as the arena grows, so that even a huge document only
+        // needs a handful of them)
+        auto size = jmax (numBytes, blockSize, jmin (totalBlockSize, maxGrowthBlockSize));
+        auto* block = static_cast<Block*> (::operator new (roundUp (sizeof (Block)) + size));
+        block->previous = lastBlock;
+        block->size = size;
+        lastBlock = block;
+
+        nextFree = reinterpret_cast<char*> (block) + roundUp (sizeof (Block));
+        bytesLeftInBlock = size;
+        totalBlockSize += size;
+
+        block->registrationSlot = registerBlock (this, nextFree, nextFree + size);
+    }
+
+    auto* result = nextFree;
+    nextFree += numBytes;
+    bytesLeftInBlock -= numBytes;
+    return result;
+}
+
+void* MemoryArena::allocateForObject (size_t numBytes)
+{
+    auto* memory = allocate (numBytes);
+
+    // If the table of blocks was full, this block can't be recognised when its
+    // objects are deleted, so they'll have to come from the heap instead.
+    if (lastBlock->registrationSlot < 0)
+        return nullptr;
+
+    incReferenceCount(); // (each object keeps its arena alive)
+    return memory;
+}
+
+//==============================================================================
+MemoryArena::ScopedUse::ScopedUse (MemoryArena* arenaToUse)
+    : arena (arenaToUse),
+      previous (MemoryArenaHelpers::getCurrentArenaForThread())
+{
+    if (arena != nullptr)
+        MemoryArenaHelpers::numActiveScopes.fetch_add (1, std::memory_order_relaxed);
+
+    MemoryArenaHelpers::getCurrentArenaForThread() = arenaToUse;
+}
+
+MemoryArena::ScopedUse::~ScopedUse()
+{
+    MemoryArenaHelpers::getCurrentArenaForThread() = previous;
+
+    if (arena != nullptr)
+        MemoryArenaHelpers::numActiveScopes.fetch_sub (1, std::memory_order_relaxed);
+}
+
+MemoryArena* MemoryArena::getCurrentArena() noexcept
+{
+    return MemoryArenaHelpers::getCurrentArenaForThread();
+}
+
+//==============================================================================
+void* MemoryArena::allocateObject (size_t numBytes)
+{
+    using namespace MemoryArenaHelpers;
+
+    // (a thread's own ScopedUse is always visible to it, so a relaxed load is enough here)
+    if (numActiveScopes.load (std::memory_order_relaxed) != 0)
+        if (auto* arena = getCurrentArenaForThread())
+            if (auto* memory = arena->allocateForObject (numBytes))
+                return memory;
+
+    return ::operator new (numBytes);
+}
+
+void MemoryArena::freeObject (void* object) noexcept
+{
+    if (object == nullptr)
+        return;
+
+    if (auto* arena = MemoryArenaHelpers::findArenaOwning (object))
+        arena->decReferenceCount();
+    else
+        ::operator delete (object);
+}
+
+//==============================================================================
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class MemoryArenaTests  : public UnitTest
+{
+public:
+    MemoryArenaTests()
+        : UnitTest ("MemoryArena", UnitTestCategories::containers)
+    {}
+
+    struct TestObject
+    {
+        JUCE_ARENA_ALLOCATABLE
+
+        int64 values[3] = {};
+    };
+
+    void runTest() override
+    {
+        beginTest ("Objects come from the current arena");
+        {
+            MemoryArena::Ptr arena (new MemoryArena (1024));
+            std::unique_ptr<TestObject> heapObject (new TestObject());
+            std::vector<std::unique_ptr<TestObject>> arenaObjects;
+
+            {
+                MemoryArena::ScopedUse scope (arena.get());
+                expect (MemoryArena::getCurrentArena() == arena.get());
+
+                for (int i = 0; i < 100; ++i)
+                    arenaObjects.emplace_back (new TestObject());
+
+                {
+                    MemoryArena::ScopedUse noArena (nullptr);
+                    std::unique_ptr<TestObject> other (new TestObject());
+                    expectEquals (arena->getReferenceCount(), 102);
+                }
+            }
+
+            expect (MemoryArena::getCurrentArena() == nullptr);
+            expectEquals (arena->getReferenceCount(), 101);
+            expect (arena->getTotalBlockSize() >= 100 * sizeof (TestObject));
+
+            // heap objects can be deleted while the arena is alive..
+            heapObject.reset();
+            std::unique_ptr<TestObject> (new TestObject()).reset();
+            expectEquals (arena->getReferenceCount(), 101);
+
+            arenaObjects.erase (arenaObjects.begin(), arenaObjects.begin() + 50);
+            expectEquals (arena->getReferenceCount(), 51);
+            arenaObjects.clear();
+            expectEquals (arena->getReferenceCount(), 1);
+        }
+
+        beginTest ("The arena outlives its objects");
+        {
+            std::unique_ptr<TestObject> object;
+
+            {
+                MemoryArena::Ptr arena (new MemoryArena());
+                MemoryArena::ScopedUse scope (arena.get());
+                object.reset (new TestObject());
+                object->values[2] = 1234;
+            }
+
+            expect (object->values[2] == 1234);
+            object.reset();
+        }
+
+        beginTest ("Deleting objects on another thread");
+        {
+            MemoryArena::Ptr arena (new MemoryArena (2048));
+            std::vector<TestObject*> objects;
+
+            {
+                MemoryArena::ScopedUse scope (arena.get());
+
+                for (int i = 0; i < 1000; ++i)
+                    objects.push_back (new TestObject());
+            }
+
+            struct Deleter  : public Thread
+            {
+                Deleter (std::vector<TestObject*>& o)  : Thread ("deleter"), objectsToDelete (o) {}
+
+                void run() override
+                {
+                    for (auto* o : objectsToDelete)
+                        delete o;
+                }
+
+                std::vector<TestObject*>& objectsToDelete;
+            };
+
+            Deleter deleter (objects);
+            deleter.startThread();
+
+            std::vector<std::unique_ptr<TestObject>> heapObjects;
+
+            for (int i = 0; i < 1000; ++i)
+                heapObjects.emplace_back (new TestObject());
+
+            heapObjects.clear();
+            deleter.waitForThreadToExit (-1);
+            expectEquals (arena->getReferenceCount(), 1);
+        }
+
+        beginTest ("Running out of registered blocks");
+        {
+            // make more blocks than can be registered, so that the later arenas fall back on the heap
+            std::vector<MemoryArena::Ptr> arenas;
+            std::vector<std::unique_ptr<TestObject>> objects;
+
+            for (int i = 0; i < MemoryArenaHelpers::maxNumBlocks + 10; ++i)
+            {
+                arenas.push_back (new MemoryArena (1024));
+                MemoryArena::ScopedUse scope (arenas.back().get());
+                objects.emplace_back (new TestObject());
+            }
+
+            int numFromArenas = 0;
+
+            for (auto& a : arenas)
+                numFromArenas += a->getReferenceCount() - 1;
+
+            expect (numFromArenas <= MemoryArenaHelpers::maxNumBlocks);
+            expect (numFromArenas >= MemoryArenaHelpers::maxNumBlocks - 20);
+
+            objects.clear();
+
+            for (auto& a : arenas)
+                expectEquals (a->getReferenceCount(), 1);
+
+            arenas.clear();
+            expectEquals (MemoryArenaHelpers::numRegisteredBlocks.load(), 0);
+        }
+    }
+};
+
+static MemoryArenaTests memoryArenaTests;
+
+#endif
+
+} // namespace juce
@@ -0,0 +1,141 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2020 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   To use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    A monotonic allocator, which hands out memory from a few large blocks, and only
+    releases it all in one go when the arena is deleted.
+
+    This is mainly intended for building large trees of small objects, such as
+    XmlElement and ValueTree documents. Classes that support this (see
+    JUCE_ARENA_ALLOCATABLE) will take their memory from the current thread's arena
+    whenever a MemoryArena::ScopedUse object is active, e.g.
+
+    @code
+    MemoryArena::Ptr arena (new MemoryArena());
+
+    std::unique_ptr<XmlElement> xml;
+
+    {
+        MemoryArena::ScopedUse scope (arena);
+        xml = parseXML (hugeDocument);  // all the elements and attributes come from the arena
+    }
+    @endcode
+
+    Objects that were allocated from an arena can be used and deleted exactly like
+    any others - deleting one is very cheap, and the arena's memory is freed when the
+    last of its objects has been deleted and nothing else holds a reference to it. This
+    does mean that while any of its objects remain alive, the whole arena stays in
+    memory, so it's best used for trees that are loaded and discarded as a whole.
+
+    An arena isn't thread-safe, so only one thread at a time may allocate from it,
+    although objects that came from it may be deleted on any thread.
+
+    @tags{Core}
+*/
+class JUCE_API  MemoryArena  : public ReferenceCountedObject
+{
+public:
+    //==============================================================================
+    /** Creates an arena, which will allocate its memory in blocks of at least the given
+        size. The blocks get larger as the arena grows.
+    */
+    explicit MemoryArena (size_t blockSizeInBytes = 65536);
+
+    /** Destructor. This frees all the memory that the arena has allocated. */
+    ~MemoryArena() override;
+
+    using Ptr = ReferenceCountedObjectPtr<MemoryArena>;
+
+    //==============================================================================
+    /** Returns a suitably-aligned block of memory from the arena.
+        The memory remains valid until the arena is deleted.
+    */
+    void* allocate (size_t numBytes);
+
+    /** Returns the total size of the blocks that the arena has allocated. */
+    size_t getTotalBlockSize() const noexcept           { return totalBlockSize; }
+
+    //==============================================================================
+    /**
+        Makes an arena the current one for the calling thread while this object exists.
+
+        These can be nested, and passing a nullptr will temporarily turn off arena
+        allocation for the thread.
+    */
+    class JUCE_API  ScopedUse
+    {
+    public:
+        explicit ScopedUse (MemoryArena* arenaToUse);
+        ~ScopedUse();
+
+    private:
+        MemoryArena::Ptr arena;
+        MemoryArena* previous;
+
+        JUCE_DECLARE_NON_COPYABLE (ScopedUse)
+    };
+
+    /** Returns the arena that the calling thread is currently using, or nullptr if there isn't one. */
+    static MemoryArena* getCurrentArena() noexcept;
+
+    //==============================================================================
+    /** Allocates the memory for an object from the current thread's arena, or from
+        the heap if no arena is active. This is used by JUCE_ARENA_ALLOCATABLE.
+    */
+    static void* allocateObject (size_t numBytes);
+
+    /** Frees some memory that was returned by allocateObject().
+        Objects don't carry a header, so this has to check whether the address lies in
+        one of the arenas' blocks, although that's skipped when no arenas exist.
+    */
+    static void freeObject (void*) noexcept;
+
+private:
+    //==============================================================================
+    struct Block;
+
+    void* allocateForObject (size_t);
+
+    Block* lastBlock = nullptr;
+    char* nextFree = nullptr;
+    size_t bytesLeftInBlock = 0, totalBlockSize = 0;
+    const size_t blockSize;
+
+    JUCE_DECLARE_NON_COPYABLE (MemoryArena)
+};
+
+//==============================================================================
+/** Add this macro inside the public section of a class to make it allocate its instances
+    from the current thread's MemoryArena, when one is active.
+    @see MemoryArena
+*/
+#define JUCE_ARENA_ALLOCATABLE \
+    static void* operator new (size_t size)         { return juce::MemoryArena::allocateObject (size); } \
+    static void* operator new (size_t, void* p)     { return p; } \
+    static void operator delete (void* p)           { juce::MemoryArena::freeObject (p); } \
+    static void operator delete (void*, void*)      {}
+
+} // namespace juce
@@ -0,0 +1,749 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2020 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   To use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+namespace RealtimeMemoryPoolHelpers
+{
+    constexpr int maxNumPools = 64;
+    constexpr int minBlockSizeBits = 5;
+
+    // A table of the pools that exist, so that a block can be given back to the right
+    // pool by whichever thread frees it. Each entry keeps a copy of its pool's address
+    // range, so that finding the owner of a block never touches a pool object, which
+    // could be being deleted on another thread. The range is guarded by a sequence count
+    // that's odd while it's being changed.
+    struct RegisteredPool
+    {
+        std::atomic<RealtimeMemoryPool*> pool { nullptr };
+        std::atomic<uint32> sequence { 0 };
+        std::atomic<const char*> begin { nullptr }, end { nullptr };
+
+        void setRange (const char* newBegin, const char* newEnd) noexcept
+        {
+            sequence.fetch_add (1, std::memory_order_relaxed);
+            std::atomic_thread_fence (std::memory_order_release);
+            begin.store (newBegin, std::memory_order_relaxed);
+            end.store (newEnd, std::memory_order_relaxed);
+            sequence.fetch_add (1, std::memory_order_release);
+        }
+
+        RealtimeMemoryPool* findOwner (const void* address) const noexcept
+        {
+            for (;;)
+            {
+                auto startSequence = sequence.load (std::memory_order_acquire);
+                auto* b = begin.load (std::memory_order_relaxed);
+                auto* e = end.load (std::memory_order_relaxed);
+                auto* p = pool.load (std::memory_order_relaxed);
+                std::atomic_thread_fence (std::memory_order_acquire);
+
+                if ((startSequence & 1) == 0 && startSequence == sequence.load (std::memory_order_relaxed))
+                    return (address >= b && address < e) ? p : nullptr;
+            }
+        }
+    };
+
+    static RegisteredPool pools[maxNumPools];
+    static std::atomic<int> numPools { 0 };
+
+    struct ThreadState
+    {
+        RealtimeMemoryPool* pool;
+        int guardDepth;
+    };
+
+    static ThreadState& getThreadState() noexcept
+    {
+        thread_local ThreadState state {};
+        return state;
+    }
+
+    static std::atomic<RealtimeSafetyGuard::ViolationHandler> violationHandler { nullptr };
+    static std::atomic<int64> violationCounts[3];
+}
+
+//==============================================================================
+struct RealtimeMemoryPool::SizeClass
+{
+    char* start = nullptr;
+    size_t blockSize = 0;
+    uint32 numBlocks = 0;
+
+    // The free list is a stack of block indexes. The head holds the index of the
+    // top block plus one (so that zero means empty) in its low 32 bits, and a counter
+    // in its high 32 bits that's bumped on each change, to avoid the ABA problem.
+    std::atomic<uint64> head { 0 };
+    std::unique_ptr<std::atomic<uint32>[]> nextFree;
+
+    bool contains (const void* p) const noexcept
+    {
+        return p >= start && p < start + blockSize * numBlocks;
+    }
+
+    void* pop() noexcept
+    {
+        auto h = head.load (std::memory_order_acquire);
+
+        for (;;)
+        {
+            auto index = (uint32) h;
+
+            if (index == 0)
+                return nullptr;
+
+            auto newHead = ((h >> 32) + 1) << 32 | nextFree[index - 1].load (std::memory_order_relaxed);
+
+            if (head.compare_exchange_weak (h, newHead, std::memory_order_acquire, std::memory_order_acquire))
+                return start + blockSize * (index - 1);
+        }
+    }
+
+    void push (void* block) noexcept
+    {
+        auto index = (uint32) ((size_t) (static_cast<char*> (block) - start) / blockSize);
+        jassert (start + blockSize * index == block); // this isn't the start of a block!
+
+        auto h = head.load (std::memory_order_relaxed);
+
+        for (;;)
+        {
+            nextFree[index].store ((uint32) h, std::memory_order_relaxed);
+            auto newHead = ((h >> 32) + 1) << 32 | (index + 1);
+
+            if (head.compare_exchange_weak (h, newHead, std::memory_order_release, std::memory_order_relaxed))
+                return;
+        }
+    }
+};
+
+//==============================================================================
+RealtimeMemoryPool::RealtimeMemoryPool (size_t maxBlockSize, int blocksPerSizeClass)
+{
+    using namespace RealtimeMemoryPoolHelpers;
+
+    jassert (blocksPerSizeClass > 0);
+    auto numBlocks = (uint32) jmax (1, blocksPerSizeClass);
+
+    while (((size_t) 1 << (minBlockSizeBits + numSizeClasses)) < maxBlockSize && numSizeClasses < 26)
+        ++numSizeClasses;
+
+    ++numSizeClasses;
+
+    for (int i = 0; i < numSizeClasses; ++i)
+        slabSize += ((size_t) 1 << (minBlockSizeBits + i)) * numBlocks;
+
+    // The memory is zeroed here, so that its pages are all touched before it's used.
+    slab.reset (new char[slabSize]());
+    sizeClasses.reset (new SizeClass[(size_t) numSizeClasses]);
+
+    auto* start = slab.get();
+
+    for (int i = 0; i < numSizeClasses; ++i)
+    {
+        auto& c = sizeClasses[(size_t) i];
+        c.start = start;
+        c.blockSize = (size_t) 1 << (minBlockSizeBits + i);
+        c.numBlocks = numBlocks;
+        c.nextFree.reset (new std::atomic<uint32>[numBlocks]);
+
+        for (uint32 j = numBlocks; j > 0; --j)
+            c.push (start + c.blockSize * (j - 1));
+
+        start += c.blockSize * numBlocks;
+    }
+
+    for (int i = 0;; ++i)
+    {
+        if (i >= maxNumPools)
+        {
+            jassertfalse; // Too many pools! Blocks from this one will not be freed correctly.
+            break;
+        }
+
+        RealtimeMemoryPool* empty = nullptr;
+
+        if (pools[i].pool.compare_exchange_strong (empty, this))
+        {
+            pools[i].setRange (slab.get(), slab.get() + slabSize);
+            ++HeapBlockHelper::numRealtimeMemoryUsers;
+
+            auto n = numPools.load();
+
+            while (n <= i && ! numPools.compare_exchange_weak (n, i + 1))
+            {}
+
+            break;
+        }
+    }
+}
+
+RealtimeMemoryPool::~RealtimeMemoryPool()
+{
+    using namespace RealtimeMemoryPoolHelpers;
+
+    // All the blocks that were allocated from the pool must be freed before it's deleted!
+    jassert (numBlocksInUse == 0);
+
+    for (int i = 0; i < maxNumPools; ++i)
+    {
+        if (pools[i].pool.load() == this)
+        {
+            // (the range has to be cleared before the slot is released, or another
+            // pool could claim it while this one's range is still visible)
+            pools[i].setRange (nullptr, nullptr);
+            pools[i].pool.store (nullptr);
+            --HeapBlockHelper::numRealtimeMemoryUsers;
+            break;
+        }
+    }
+}
+
+size_t RealtimeMemoryPool::getMaxBlockSize() const noexcept
+{
+    return sizeClasses[(size_t) numSizeClasses - 1].blockSize;
+}
+
+void* RealtimeMemoryPool::allocate (size_t numBytes) noexcept
+{
+    using namespace RealtimeMemoryPoolHelpers;
+
+    if (numBytes <= getMaxBlockSize())
+    {
+        auto index = numBytes <= ((size_t) 1 << minBlockSizeBits)
+                        ? 0
+                        : findHighestSetBit ((uint32) (numBytes - 1)) + 1 - minBlockSizeBits;
+
+        // If all the blocks of the right size are in use, try the next size up
+        for (; index < numSizeClasses; ++index)
+        {
+            if (auto* block = sizeClasses[(size_t) index].pop())
+            {
+                ++numBlocksInUse;
+                return block;
+            }
+        }
+    }
+
+    ++numFailedAllocations;
+    return nullptr;
+}
+
+void RealtimeMemoryPool::free (void* block) noexcept
+{
+    if (block == nullptr)
+        return;
+
+    if (auto* c = findSizeClass (block))
+    {
+        const_cast<SizeClass*> (c)->push (block);
+        --numBlocksInUse;
+    }
+    else
+    {
+        jassertfalse; // This block didn't come from this pool!
+    }
+}
+
+const RealtimeMemoryPool::SizeClass* RealtimeMemoryPool::findSizeClass (const void* p) const noexcept
+{
+    if (! owns (p))
+        return nullptr;
+
+    // Size class i starts at an offset of (2^i - 1) * 32 * numBlocks bytes
+    auto offset = (size_t) (static_cast<const char*> (p) - slab.get());
+    auto index = findHighestSetBit ((uint32) (offset / (sizeClasses[0].blockSize * sizeClasses[0].numBlocks) + 1));
+
+    jassert (sizeClasses[(size_t) index].contains (p));
+    return &sizeClasses[(size_t) index];
+}
+
+bool RealtimeMemoryPool::owns (const void* address) const noexcept
+{
+    return address >= slab.get() && address < slab.get() + slabSize;
+}
+
+size_t RealtimeMemoryPool::getBlockSize (const void* block) const noexcept
+{
+    if (auto* c = findSizeClass (block))
+        return c->blockSize;
+
+    return 0;
+}
+
+//==============================================================================
+RealtimeMemoryPool::ScopedUse::ScopedUse (RealtimeMemoryPool* poolToUse) noexcept
+{
+    auto& state = RealtimeMemoryPoolHelpers::getThreadState();
+    previous = state.pool;
+    state.pool = poolToUse;
+}
+
+RealtimeMemoryPool::ScopedUse::ScopedUse (RealtimeMemoryPool& poolToUse) noexcept
+    : ScopedUse (&poolToUse)
+{
+}
+
+RealtimeMemoryPool::ScopedUse::~ScopedUse() noexcept
+{
+    RealtimeMemoryPoolHelpers::getThreadState().pool = previous;
+}
+
+RealtimeMemoryPool* RealtimeMemoryPool::getCurrentPool() noexcept
+{
+    return RealtimeMemoryPoolHelpers::getThreadState().pool;
+}
+
+RealtimeMemoryPool* RealtimeMemoryPool::findPoolOwning (const void* block) noexcept
+{
+    using namespace RealtimeMemoryPoolHelpers;
+
+    auto num = numPools.load (std::memory_order_relaxed);
+
+    for (int i = 0; i < num; ++i)
+        if (auto* p = pools[i].findOwner (block))
+            return p;
+
+    return nullptr;
+}
+
+//==============================================================================
+std::atomic<int> HeapBlockHelper::numRealtimeMemoryUsers { 0 };
+
+void* JUCE_CALLTYPE HeapBlockHelper::allocatePooled (size_t numBytes, bool initialiseToZero) noexcept
+{
+    if (numBytes > 0)
+    {
+        if (auto* pool = RealtimeMemoryPoolHelpers::getThreadState().pool)
+        {
+            if (auto* block = pool->allocate (numBytes))
+            {
+                if (initialiseToZero)
+                    zeromem (block, numBytes);
+
+                return block;
+            }
+        }
+    }
+
+    RealtimeSafetyGuard::checkOperation (RealtimeSafetyGuard::Violation::allocation);
+    return initialiseToZero ? std::calloc (numBytes, 1) : std::malloc (numBytes);
+}
+
+void* JUCE_CALLTYPE HeapBlockHelper::reallocatePooled (void* data, size_t numBytes) noexcept
+{
+    if (data == nullptr)
+        return allocatePooled (numBytes, false);
+
+    if (auto* owner = RealtimeMemoryPool::findPoolOwning (data))
+    {
+        auto oldSize = owner->getBlockSize (data);
+
+        if (numBytes <= oldSize)
+            return data;
+
+        auto* newBlock = owner->allocate (numBytes);
+
+        if (newBlock == nullptr)
+        {
+            RealtimeSafetyGuard::checkOperation (RealtimeSafetyGuard::Violation::allocation);
+            newBlock = std::malloc (numBytes);
+
+            if (newBlock == nullptr)
+                return nullptr;
+        }
+
+        memcpy (newBlock, data, oldSize);
+        owner->free (data);
+        return newBlock;
+    }
+
+    // A block that came from the heap stays there, as there's no portable way to find
+    // out how much of it needs copying into a pool block.
+    RealtimeSafetyGuard::checkOperation (RealtimeSafetyGuard::Violation::allocation);
+    return std::realloc (data, numBytes);
+}
+
+void JUCE_CALLTYPE HeapBlockHelper::freePooled (void* data) noexcept
+{
+    if (data == nullptr)
+        return;
+
+    if (auto* owner = RealtimeMemoryPool::findPoolOwning (data))
+    {
+        owner->free (data);
+        return;
+    }
+
+    RealtimeSafetyGuard::checkOperation (RealtimeSafetyGuard::Violation::deallocation);
+    std::free (data);
+}
+
+//==============================================================================
+std::atomic<int> RealtimeSafetyGuard::numActiveGuards { 0 };
+
+RealtimeSafetyGuard::RealtimeSafetyGuard() noexcept
+{
+    ++RealtimeMemoryPoolHelpers::getThreadState().guardDepth;
+    ++HeapBlockHelper::numRealtimeMemoryUsers;
+    ++numActiveGuards;
+}
+
+RealtimeSafetyGuard::~RealtimeSafetyGuard() noexcept
+{
+    --numActiveGuards;
+    --HeapBlockHelper::numRealtimeMemoryUsers;
+    --RealtimeMemoryPoolHelpers::getThreadState().guardDepth;
+}
+
+void RealtimeSafetyGuard::setViolationHandler (ViolationHandler handler) noexcept
+{
+    RealtimeMemoryPoolHelpers::violationHandler = handler;
+}
+
+int64 RealtimeSafetyGuard::getNumViolations (Violation type) noexcept
+{
+    return RealtimeMemoryPoolHelpers::violationCounts[(int) type].load();
+}
+
+void RealtimeSafetyGuard::resetViolationCounts() noexcept
+{
+    for (auto& c : RealtimeMemoryPoolHelpers::violationCounts)
+        c = 0;
+}
+
+bool RealtimeSafetyGuard::isActiveOnCurrentThread() noexcept
+{
+    return RealtimeMemoryPoolHelpers::getThreadState().guardDepth > 0;
+}
+
+void RealtimeSafetyGuard::checkOperationOnCurrentThread (Violation type) noexcept
+{
+    using namespace RealtimeMemoryPoolHelpers;
+
+    if (getThreadState().guardDepth <= 0)
+        return;
+
+    ++violationCounts[(int) type];
+
+    // The handler may well allocate or lock, so the guard is turned off while it runs
+    const ScopedSuspension suspension;
+
+    if (auto handler = violationHandler.load())
+        handler (type);
+    else
+        jassertfalse; // Something that isn't real-time safe has been done inside a RealtimeSafetyGuard!
+}
+
+RealtimeSafetyGuard::ScopedSuspension::ScopedSuspension() noexcept
+{
+    auto& state = RealtimeMemoryPoolHelpers::getThreadState();
+    previousDepth = state.guardDepth;
+    state.guardDepth = 0;
+}
+
+RealtimeSafetyGuard::ScopedSuspension::~ScopedSuspension() noexcept
+{
+    RealtimeMemoryPoolHelpers::getThreadState().guardDepth = previousDepth;
+}
+
+
+//==============================================================================
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class RealtimeMemoryPoolTests  : public UnitTest
+{
+public:
+    RealtimeMemoryPoolTests()
+        : UnitTest ("RealtimeMemoryPool", UnitTestCategories::containers)
+    {}
+
+    static void countViolation (RealtimeSafetyGuard::Violation) {}
+
+    void runTest() override
+    {
+        beginTest ("Size classes");
+        {
+            RealtimeMemoryPool pool (1000, 4);
+            expectEquals ((int) pool.getMaxBlockSize(), 1024);
+
+            auto* a = pool.allocate (1);
+            auto* b = pool.allocate (33);
+            auto* c = pool.allocate (1024);
+
+            expect (a != nullptr && b != nullptr && c != nullptr);
+            expect (pool.owns (a) && pool.owns (b) && pool.owns (c));
+            expectEquals ((int) pool.getBlockSize (a), 32);
+            expectEquals ((int) pool.getBlockSize (b), 64);
+            expectEquals ((int) pool.getBlockSize (c), 1024);
+            expect (RealtimeMemoryPool::findPoolOwning (b) == &pool);
+            expectEquals (pool.getNumBlocksInUse(), 3);
+
+            expect (pool.allocate (1025) == nullptr);
+            expectEquals (pool.getNumFailedAllocations(), 1);
+
+            pool.free (a);
+            pool.free (b);
+            pool.free (c);
+            expectEquals (pool.getNumBlocksInUse(), 0);
+
+            int dummy = 0;
+            expect (! pool.owns (&dummy));
+            expect (RealtimeMemoryPool::findPoolOwning (&dummy) == nullptr);
+        }
+
+        beginTest ("Exhaustion");
+        {
+            RealtimeMemoryPool pool (64, 3);
+            Array<void*> blocks;
+
+            // 3 blocks of 32 bytes, then 3 of 64 when they've run out
+            for (int i = 0; i < 6; ++i)
+                blocks.add (pool.allocate (16));
+
+            expect (! blocks.contains (nullptr));
+            expect (pool.allocate (16) == nullptr);
+
+            for (auto* b : blocks)
+                pool.free (b);
+
+            expectEquals (pool.getNumBlocksInUse(), 0);
+        }
+
+        beginTest ("HeapBlock and Array");
+        {
+            RealtimeMemoryPool pool;
+
+            {
+                RealtimeMemoryPool::ScopedUse usePool (pool);
+                expect (RealtimeMemoryPool::getCurrentPool() == &pool);
+
+                HeapBlock<float> block (256, true);
+                expect (pool.owns (block.get()));
+                expectEquals (block[255], 0.0f);
+
+                Array<int> array;
+
+                for (int i = 0; i < 1000; ++i)
+                    array.add (i);
+
+                expect (pool.owns (array.data()));
+                expectEquals (array[999], 999);
+
+                MemoryBlock mb (100, true);
+                expect (pool.owns (mb.getData()));
+
+                {
+                    RealtimeMemoryPool::ScopedUse noPool (nullptr);
+                    HeapBlock<char> heapBlock (16);
+                    expect (! pool.owns (heapBlock.get()));
+                }
+            }
+
+            expect (RealtimeMemoryPool::getCurrentPool() == nullptr);
+            expectEquals (pool.getNumBlocksInUse(), 0);
+        }
+
+        beginTest ("Freeing on another thread");
+        {
+            RealtimeMemoryPool pool (4096, 64);
+            std::unique_ptr<Array<int>> array;
+
+            {
+                RealtimeMemoryPool::ScopedUse usePool (pool);
+                array.reset (new Array<int> ({ 1, 2, 3 }));
+            }
+
+            expectEquals (pool.getNumBlocksInUse(), 1);
+
+            struct Deleter  : public Thread
+            {
+                Deleter (std::unique_ptr<Array<int>>& a)  : Thread ("deleter"), arrayToDelete (a) {}
+                void run() override  { arrayToDelete.reset(); }
+                std::unique_ptr<Array<int>>& arrayToDelete;
+            };
+
+            Deleter deleter (array);
+            deleter.startThread();
+            deleter.stopThread (-1);
+
+            expectEquals (pool.getNumBlocksInUse(), 0);
+        }
+
+        beginTest ("Concurrent use");
+        {
+            RealtimeMemoryPool pool (256, 64);
+
+            struct User  : public Thread
+            {
+                User (RealtimeMemoryPool& p)  : Thread ("pool user"), pool (p) {}
+
+                void run() override
+                {
+                    Random r;
+
+                    for (int i = 0; i < 20000; ++i)
+                    {
+                        if (auto* b = static_cast<int*> (pool.allocate ((size_t) r.nextInt (256) + 1)))
+                        {
+                            *b = i;
+                            Thread::yield();
+
+                            if (*b != i)
+                                ++numErrors;
+
+                            pool.free (b);
+                        }
+                    }
+                }
+
+                RealtimeMemoryPool& pool;
+                int numErrors = 0;
+            };
+
+            OwnedArray<User> users;
+
+            for (int i = 0; i < 4; ++i)
+                users.add (new User (pool))->startThread();
+
+            for (auto* u : users)
+            {
+                u->stopThread (-1);
+                expectEquals (u->numErrors, 0);
+            }
+
+            expectEquals (pool.getNumBlocksInUse(), 0);
+        }
+
+        beginTest ("Deleting pools while other threads free heap blocks");
+        {
+            // Every HeapBlock that's freed while a pool exists has to be checked against the
+            // pools' ranges, which mustn't involve looking at a pool that's being deleted.
+            struct HeapUser  : public Thread
+            {
+                HeapUser()  : Thread ("heap user") {}
+
+                void run() override
+                {
+                    Random r;
+
+                    while (! threadShouldExit())
+                    {
+                        HeapBlock<char> block ((size_t) r.nextInt (512) + 1);
+
+                        if (RealtimeMemoryPool::findPoolOwning (block.get()) != nullptr)
+                            ++numErrors;
+                    }
+                }
+
+                std::atomic<int> numErrors { 0 };
+            };
+
+            OwnedArray<HeapUser> users;
+
+            for (int i = 0; i < 3; ++i)
+                users.add (new HeapUser())->startThread();
+
+            for (int i = 0; i < 500; ++i)
+            {
+                std::unique_ptr<RealtimeMemoryPool> pool (new RealtimeMemoryPool (256, 4));
+                RealtimeMemoryPool::ScopedUse usePool (*pool);
+                HeapBlock<char> block (100);
+                expect (RealtimeMemoryPool::findPoolOwning (block.get()) == pool.get());
+            }
+
+            for (auto* u : users)
+            {
+                u->stopThread (-1);
+                expectEquals (u->numErrors.load(), 0);
+            }
+        }
+
+        beginTest ("Safety guard");
+        {
+            RealtimeSafetyGuard::setViolationHandler (countViolation);
+            RealtimeSafetyGuard::resetViolationCounts();
+
+            RealtimeMemoryPool pool (1024, 4);
+            CriticalSection lock;
+            bool wasActive = false, wasActiveWhenSuspended = true;
+            int64 numAllocations = 0, numDeallocations = 0, numLocks = 0, numLocksAfterSuspension = 0;
+
+            // The results have to be checked after the guard has gone, as the UnitTest
+            // methods will allocate and lock.
+            {
+                RealtimeSafetyGuard guard;
+                wasActive = RealtimeSafetyGuard::isActiveOnCurrentThread();
+
+                {
+                    RealtimeMemoryPool::ScopedUse usePool (pool);
+                    HeapBlock<char> fromPool (100);
+                    HeapBlock<char> tooBig (2000);
+                }
+
+                numAllocations = RealtimeSafetyGuard::getNumViolations (RealtimeSafetyGuard::Violation::allocation);
+                numDeallocations = RealtimeSafetyGuard::getNumViolations (RealtimeSafetyGuard::Violation::deallocation);
+
+                {
+                    const ScopedLock sl (lock);
+                }
+
+                numLocks = RealtimeSafetyGuard::getNumViolations (RealtimeSafetyGuard::Violation::lock);
+
+                {
+                    const RealtimeSafetyGuard::ScopedSuspension suspension;
+                    wasActiveWhenSuspended = RealtimeSafetyGuard::isActiveOnCurrentThread();
+                    const ScopedLock sl (lock);
+                }
+
+                numLocksAfterSuspension = RealtimeSafetyGuard::getNumViolations (RealtimeSafetyGuard::Violation::lock);
+            }
+
+            expect (wasActive);
+            expect (! wasActiveWhenSuspended);
+            expect (! RealtimeSafetyGuard::isActiveOnCurrentThread());
+            expectEquals (numAllocations, (int64) 1);
+            expectEquals (numDeallocations, (int64) 1);
+            expectEquals (numLocks, (int64) 1);
+            expectEquals (numLocksAfterSuspension, (int64) 1);
+
+            {
+                const ScopedLock sl (lock);
+                HeapBlock<char> unguarded (10);
+            }
+
+            expectEquals (RealtimeSafetyGuard::getNumViolations (RealtimeSafetyGuard::Violation::lock), (int64) 1);
+            expectEquals (RealtimeSafetyGuard::getNumViolations (RealtimeSafetyGuard::Violation::allocation), (int64) 1);
+
+            RealtimeSafetyGuard::setViolationHandler (nullptr);
+            RealtimeSafetyGuard::resetViolationCounts();
+        }
+    }
+};
+
+static RealtimeMemoryPoolTests realtimeMemoryPoolTests;
+
+#endif
+
+} // namespace juce
@@ -0,0 +1,242 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2020 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   To use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    A lock-free pool of preallocated memory blocks, which can be used to allocate
+    memory safely on a real-time thread.
+
+    The pool allocates all its memory up-front, as a set of blocks in several
+    power-of-two sizes. Allocating and freeing a block never calls the system allocator
+    or takes a lock, so it's safe to do in an audio callback, and blocks may be freed
+    on a different thread from the one that allocated them.
+
+    While a RealtimeMemoryPool::ScopedUse object is active on a thread, any HeapBlock
+    that's allocated on that thread will take its memory from the pool, and this
+    includes the storage of classes such as Array, MemoryBlock and MidiBuffer, e.g.
+
+    @code
+    void processBlock (AudioBuffer<float>& buffer, MidiBuffer& midi) override
+    {
+        RealtimeMemoryPool::ScopedUse usePool (pool);
+
+        Array<NoteEvent> events;    // grows using memory from the pool
+        ...
+    }
+    @endcode
+
+    If the pool has no free block that's big enough, the memory will come from the
+    heap instead, and getNumFailedAllocations() will be incremented. To catch these
+    (and any other heap use) during testing, use a RealtimeSafetyGuard.
+
+    All the blocks that were allocated from a pool must be freed before the pool
+    is deleted.
+
+    @see RealtimeSafetyGuard, MemoryArena
+
+    @tags{Core}
+*/
+class JUCE_API  RealtimeMemoryPool
+{
+public:
+    //==============================================================================
+    /** Creates a pool.
+
+        @param maxBlockSize         the largest allocation that the pool can satisfy. This is
+                                    rounded up to a power of two.
+        @param blocksPerSizeClass   the number of blocks of each size that will be created.
+                                    The smallest blocks are 32 bytes, and there are blocks of
+                                    each power of two from that size up to the maximum.
+    */
+    explicit RealtimeMemoryPool (size_t maxBlockSize = 16384, int blocksPerSizeClass = 32);
+
+    /** Destructor. */
+    ~RealtimeMemoryPool();
+
+    //==============================================================================
+    /** Returns a block that can hold at least the given number of bytes, or nullptr if
+        the size is too large or there are no suitable blocks left.
+        This is lock-free and can be called on any thread.
+    */
+    void* allocate (size_t numBytes) noexcept;
+
+    /** Returns a block to the pool.
+        The block must have come from this pool. This is lock-free and can be called on any thread.
+    */
+    void free (void* block) noexcept;
+
+    /** Returns true if the given address lies within one of this pool's blocks. */
+    bool owns (const void* address) const noexcept;
+
+    /** Returns the usable size of a block that was allocated from this pool. */
+    size_t getBlockSize (const void* block) const noexcept;
+
+    /** Returns the size of the largest block that the pool can provide. */
+    size_t getMaxBlockSize() const noexcept;
+
+    /** Returns the number of blocks that are currently allocated. */
+    int getNumBlocksInUse() const noexcept                  { return numBlocksInUse; }
+
+    /** Returns the number of allocations that the pool couldn't satisfy. */
+    int getNumFailedAllocations() const noexcept            { return numFailedAllocations; }
+
+    //==============================================================================
+    /**
+        Makes a pool the one that HeapBlocks on the calling thread will use, while
+        this object exists.
+
+        These can be nested, and passing a nullptr will temporarily turn off pool
+        allocation for the thread.
+    */
+    class JUCE_API  ScopedUse
+    {
+    public:
+        explicit ScopedUse (RealtimeMemoryPool* poolToUse) noexcept;
+        explicit ScopedUse (RealtimeMemoryPool& poolToUse) noexcept;
+        ~ScopedUse() noexcept;
+
+    private:
+        RealtimeMemoryPool* previous;
+
+        JUCE_DECLARE_NON_COPYABLE (ScopedUse)
+    };
+
+    /** Returns the pool that the calling thread is currently using, or nullptr if there isn't one. */
+    static RealtimeMemoryPool* getCurrentPool() noexcept;
+
+    /** Returns the pool that owns a block of memory, or nullptr if it didn't come from a pool. */
+    static RealtimeMemoryPool* findPoolOwning (const void* block) noexcept;
+
+private:
+    //==============================================================================
+    struct SizeClass;
+
+    std::unique_ptr<char[]> slab;
+    size_t slabSize = 0;
+    std::unique_ptr<SizeClass[]> sizeClasses;
+    int numSizeClasses = 0;
+    std::atomic<int> numBlocksInUse { 0 }, numFailedAllocations { 0 };
+
+    const SizeClass* findSizeClass (const void*) const noexcept;
+
+    JUCE_DECLARE_NON_COPYABLE (RealtimeMemoryPool)
+};
+
+//==============================================================================
+/**
+    Checks that the calling thread doesn't do anything that isn't real-time safe
+    while this object exists.
+
+    Create one of these at the start of an audio callback (or any other code that
+    must not block), and any of the following on that thread will be reported:
+    - memory that a HeapBlock (and hence an Array, MemoryBlock, etc) gets from the heap
+      rather than from a RealtimeMemoryPool
+    - calls to the global operator new and delete, if JUCE_ENABLE_ALLOCATION_HOOKS is enabled
+    - locking a CriticalSection
+
+    Each violation increments a counter, and calls the handler that was given to
+    setViolationHandler(), if there is one. The handler is called on the offending
+    thread, with the guard disabled, so it may do things that would otherwise be
+    reported, but bear in mind that it'll slow down the callback it's called from.
+    In a debug build, a violation will also trigger an assertion if there's no handler.
+
+    Guards can be nested. To allow something unsafe inside a guarded region, e.g.
+    some code that you know only allocates the first time it runs, create a
+    RealtimeSafetyGuard::ScopedSuspension.
+
+    @see RealtimeMemoryPool, UnitTestAllocationChecker
+
+    @tags{Core}
+*/
+class JUCE_API  RealtimeSafetyGuard
+{
+public:
+    /** Starts checking the calling thread. */
+    RealtimeSafetyGuard() noexcept;
+
+    /** Stops checking the calling thread, unless there's an outer guard. */
+    ~RealtimeSafetyGuard() noexcept;
+
+    //==============================================================================
+    /** The kinds of operation that a guard will report. */
+    enum class Violation
+    {
+        allocation,     /**< Memory was allocated from the heap. */
+        deallocation,   /**< Memory was returned to the heap. */
+        lock            /**< A lock was taken. */
+    };
+
+    /** A function that will be called when a violation is detected. */
+    using ViolationHandler = void (*) (Violation);
+
+    /** Sets the function that will be called when any guarded thread commits a violation.
+        Pass nullptr to remove the handler.
+    */
+    static void setViolationHandler (ViolationHandler) noexcept;
+
+    /** Returns the number of violations of a particular type that have been detected,
+        on all threads, since the program started or resetViolationCounts() was called.
+    */
+    static int64 getNumViolations (Violation) noexcept;
+
+    /** Sets all the violation counters to zero. */
+    static void resetViolationCounts() noexcept;
+
+    /** Returns true if a guard is active on the calling thread. */
+    static bool isActiveOnCurrentThread() noexcept;
+
+    /** Reports a violation if a guard is active on the calling thread.
+        JUCE's allocators and locks call this, and you can call it from your own
+        code to flag other unsafe operations. While there are no guards on any thread,
+        it only costs a relaxed atomic read.
+    */
+    static void checkOperation (Violation type) noexcept
+    {
+        if (numActiveGuards.load (std::memory_order_relaxed) != 0)
+            checkOperationOnCurrentThread (type);
+    }
+
+    //==============================================================================
+    /** Temporarily turns off checking on the calling thread while this object exists. */
+    class JUCE_API  ScopedSuspension
+    {
+    public:
+        ScopedSuspension() noexcept;
+        ~ScopedSuspension() noexcept;
+
+    private:
+        int previousDepth;
+
+        JUCE_DECLARE_NON_COPYABLE (ScopedSuspension)
+    };
+
+private:
+    static std::atomic<int> numActiveGuards;
+    static void checkOperationOnCurrentThread (Violation) noexcept;
+
+    JUCE_DECLARE_NON_COPYABLE (RealtimeSafetyGuard)
+};
+
+} // namespace juce
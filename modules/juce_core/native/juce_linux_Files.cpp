@@ -233,4 +233,299 @@ void File::revealToUser() const
         getParentDirectory().startAsProcess();
 }
 
+//==============================================================================
+#if JUCE_USE_IO_URING
+struct AsyncFileIO::KernelQueue  : private Thread
+{
+    static std::unique_ptr<KernelQueue> create (AsyncFileIO& owner, int maxRequestsInFlight)
+    {
+        std::unique_ptr<KernelQueue> q (new KernelQueue (owner, maxRequestsInFlight));
+
+        if (q->sqes == nullptr)
+            return {};
+
+        q->startThread();
+        return q;
+    }
+
+    ~KernelQueue() override
+    {
+        if (isThreadRunning())
+        {
+            signalThreadShouldExit();
+
+            const uint64 value = 1;
+            ignoreUnused (::write (wakeFD, &value, sizeof (value)));
+
+            stopThread (-1);
+        }
+
+        if (sqes != nullptr)                        munmap (sqes, sqesSize);
+        if (cqRing != nullptr && cqRing != sqRing)  munmap (cqRing, cqRingSize);
+        if (sqRing != nullptr)                      munmap (sqRing, sqRingSize);
+        if (ringFD >= 0)                            close (ringFD);
+        if (wakeFD >= 0)                            close (wakeFD);
+    }
+
+    void submit (Request* r)
+    {
+        Array<Request*> rejected;
+
+        {
+            const ScopedLock sl (lock);
+
+            if (submissionFailed)
+            {
+                rejected.add (r);
+            }
+            else if (freeSlots.isEmpty())
+            {
+                waiting.add (r);
+                return;
+            }
+            else
+            {
+                auto slot = freeSlots.removeAndReturn (freeSlots.size() - 1);
+                slots.getReference (slot).request = r;
+                startTransfer (slot, rejected);
+            }
+        }
+
+        for (auto* request : rejected)
+            owner.addToWorkerQueue (request);
+    }
+
+private:
+    struct Slot
+    {
+        Request* request = nullptr;
+        iovec buffer;
+    };
+
+    AsyncFileIO& owner;
+    CriticalSection lock;
+    Array<Slot> slots;
+    Array<int> freeSlots;
+    Array<Request*> waiting;
+
+    int ringFD = -1, wakeFD = -1;
+    bool submissionFailed = false;
+    void* sqRing = nullptr;
+    void* cqRing = nullptr;
+    io_uring_sqe* sqes = nullptr;
+    io_uring_cqe* cqes = nullptr;
+    size_t sqRingSize = 0, cqRingSize = 0, sqesSize = 0;
+    unsigned* sqHead = nullptr;
+    unsigned* sqTail = nullptr;
+    unsigned* sqMask = nullptr;
+    unsigned* sqArray = nullptr;
+    unsigned* cqHead = nullptr;
+    unsigned* cqTail = nullptr;
+    unsigned* cqMask = nullptr;
+
+    KernelQueue (AsyncFileIO& o, int maxRequestsInFlight)
+        : Thread ("AsyncFileIO completions"), owner (o)
+    {
+        io_uring_params params;
+        zerostruct (params);
+
+        ringFD = (int) syscall (__NR_io_uring_setup, (unsigned) jlimit (4, 4096, maxRequestsInFlight), &params);
+
+        if (ringFD < 0)
+            return;
+
+        sqRingSize = params.sq_off.array + params.sq_entries * sizeof (unsigned);
+        cqRingSize = params.cq_off.cqes  + params.cq_entries * sizeof (io_uring_cqe);
+        sqesSize   = params.sq_entries * sizeof (io_uring_sqe);
+
+        auto singleMap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+
+        if (singleMap)
+            sqRingSize = cqRingSize = jmax (sqRingSize, cqRingSize);
+
+        sqRing = mapRegion (sqRingSize, IORING_OFF_SQ_RING);
+        cqRing = singleMap ? sqRing : mapRegion (cqRingSize, IORING_OFF_CQ_RING);
+
+        if (sqRing == nullptr || cqRing == nullptr)
+            return;
+
+        auto* sqBase = static_cast<char*> (sqRing);
+        auto* cqBase = static_cast<char*> (cqRing);
+
+        sqHead  = reinterpret_cast<unsigned*> (sqBase + params.sq_off.head);
+        sqTail  = reinterpret_cast<unsigned*> (sqBase + params.sq_off.tail);
+        sqMask  = reinterpret_cast<unsigned*> (sqBase + params.sq_off.ring_mask);
+        sqArray = reinterpret_cast<unsigned*> (sqBase + params.sq_off.array);
+        cqHead  = reinterpret_cast<unsigned*> (cqBase + params.cq_off.head);
+        cqTail  = reinterpret_cast<unsigned*> (cqBase + params.cq_off.tail);
+        cqMask  = reinterpret_cast<unsigned*> (cqBase + params.cq_off.ring_mask);
+        cqes    = reinterpret_cast<io_uring_cqe*> (cqBase + params.cq_off.cqes);
+
+        // The completion queue is at least as big as the submission queue, so limiting
+        // the number of requests in flight to this means that it can never overflow.
+        slots.resize ((int) params.sq_entries);
+
+        for (int i = slots.size(); --i >= 0;)
+            freeSlots.add (i);
+
+        // This is used to wake the completion thread when it's time to stop
+        wakeFD = eventfd (0, EFD_CLOEXEC);
+
+        if (wakeFD >= 0)
+            sqes = static_cast<io_uring_sqe*> (mapRegion (sqesSize, IORING_OFF_SQES));
+    }
+
+    void* mapRegion (size_t size, uint64 offset) const
+    {
+        auto* m = mmap (nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFD, (off_t) offset);
+        return m != MAP_FAILED ? m : nullptr;
+    }
+
+    io_uring_sqe& getNextSQE() noexcept
+    {
+        // Must be called with the lock held, as this is the only place that moves the tail
+        auto tail = *sqTail;
+        auto index = tail & *sqMask;
+        auto& sqe = sqes[index];
+        zerostruct (sqe);
+        sqArray[index] = index;
+        __atomic_store_n (sqTail, tail + 1, __ATOMIC_RELEASE);
+        return sqe;
+    }
+
+    void prepareSQE (int slotIndex) noexcept
+    {
+        auto& slot = slots.getReference (slotIndex);
+        auto& r = *slot.request;
+
+        slot.buffer.iov_base = r.data + r.numDone;
+        slot.buffer.iov_len = r.numBytes - r.numDone;
+
+        auto& sqe = getNextSQE();
+        sqe.opcode = r.isWrite ? IORING_OP_WRITEV : IORING_OP_READV;
+        sqe.fd = getFD (r.file->fileHandle);
+        sqe.off = (uint64) (r.position + (int64) r.numDone);
+        sqe.addr = (uint64) (pointer_sized_uint) &slot.buffer;
+        sqe.len = 1;
+        sqe.user_data = (uint64) slotIndex + 1;
+    }
+
+    bool submitSQEs (unsigned num) noexcept
+    {
+        while (syscall (__NR_io_uring_enter, ringFD, num, 0, 0, nullptr, 0) < 0)
+            if (errno != EINTR && errno != EAGAIN)
+                return false;
+
+        return true;
+    }
+
+    // Must be called with the lock held. If the kernel won't accept the request, the queue
+    // stops using the kernel, and this request and any that are waiting are added to the
+    // rejected list, so that the caller can give them to the worker threads once it has
+    // released the lock.
+    void startTransfer (int slotIndex, Array<Request*>& rejected)
+    {
+        prepareSQE (slotIndex);
+
+        if (submitSQEs (1))
+            return;
+
+        auto& slot = slots.getReference (slotIndex);
+        rejected.add (slot.request);
+        rejected.addArray (waiting);
+        waiting.clear();
+        slot.request = nullptr;
+        submissionFailed = true;
+
+        // If the kernel didn't take the entry off the ring, it can be withdrawn, but if it
+        // did, a completion could still turn up for it, so the slot is never used again.
+        auto tail = *sqTail;
+
+        if (__atomic_load_n (sqHead, __ATOMIC_ACQUIRE) != tail)
+        {
+            __atomic_store_n (sqTail, tail - 1, __ATOMIC_RELEASE);
+            freeSlots.add (slotIndex);
+        }
+    }
+
+    void run() override
+    {
+        pollfd fds[] = { { ringFD, POLLIN, 0 }, { wakeFD, POLLIN, 0 } };
+
+        while (! threadShouldExit())
+        {
+            if (poll (fds, 2, -1) < 0 && errno != EINTR)
+            {
+                jassertfalse;
+                break;
+            }
+
+            auto head = *cqHead;
+            auto tail = __atomic_load_n (cqTail, __ATOMIC_ACQUIRE);
+
+            while (head != tail)
+            {
+                auto& cqe = cqes[head & *cqMask];
+                auto userData = cqe.user_data;
+                auto result = cqe.res;
+
+                __atomic_store_n (cqHead, ++head, __ATOMIC_RELEASE);
+
+                if (userData != 0)
+                    handleCompletion ((int) userData - 1, result);
+            }
+        }
+    }
+
+    void handleCompletion (int slotIndex, int result)
+    {
+        Request* finished = nullptr;
+        Array<Request*> rejected;
+
+        {
+            const ScopedLock sl (lock);
+            auto& slot = slots.getReference (slotIndex);
+            auto* r = slot.request;
+
+            // The request in this slot has already been given to the worker threads
+            if (r == nullptr)
+                return;
+
+            if (result > 0)
+                r->numDone += (size_t) result;
+
+            if (result > 0 && r->numDone < r->numBytes)
+            {
+                // A partial transfer, so carry on from where it got to
+                startTransfer (slotIndex, rejected);
+            }
+            else
+            {
+                finished = r;
+                slot.request = nullptr;
+
+                if (waiting.isEmpty())
+                {
+                    freeSlots.add (slotIndex);
+                }
+                else
+                {
+                    slot.request = waiting.removeAndReturn (0);
+                    startTransfer (slotIndex, rejected);
+                }
+            }
+        }
+
+        if (finished != nullptr)
+            owner.finishRequest (finished, result < 0 ? Result::fail (String (strerror (-result)))
+                                                      : Result::ok());
+
+        for (auto* request : rejected)
+            owner.addToWorkerQueue (request);
+    }
+
+    JUCE_DECLARE_NON_COPYABLE (KernelQueue)
+};
+#endif
+
 } // namespace juce
@@ -59,4 +59,104 @@ static bool swapUserAndEffectiveUser()
 JUCE_API void JUCE_CALLTYPE Process::raisePrivilege()  { if (geteuid() != 0 && getuid() == 0) swapUserAndEffectiveUser(); }
 JUCE_API void JUCE_CALLTYPE Process::lowerPrivilege()  { if (geteuid() == 0 && getuid() != 0) swapUserAndEffectiveUser(); }
 
+//==============================================================================
+#ifndef SCHED_DEADLINE
+ #define SCHED_DEADLINE 6
+#endif
+
+namespace LinuxScheduling
+{
+    // glibc doesn't provide a wrapper for sched_setattr, so this mirrors the kernel's struct sched_attr
+    struct Attributes
+    {
+        uint32 size, policy;
+        uint64 flags;
+        int32 nice;
+        uint32 priority;
+        uint64 runtime, deadline, period;
+    };
+}
+
+bool RealtimeWorkerGroup::setCurrentThreadDeadline (double runtimeMs, double periodMs)
+{
+   #ifdef SYS_sched_setattr
+    LinuxScheduling::Attributes attr {};
+    attr.size = (uint32) sizeof (attr);
+    attr.policy = SCHED_DEADLINE;
+    attr.period = (uint64) (periodMs * 1.0e6);
+    attr.deadline = attr.period;
+    attr.runtime = jlimit ((uint64) 1024, attr.deadline, (uint64) (runtimeMs * 1.0e6));
+
+    return syscall (SYS_sched_setattr, 0, &attr, 0) == 0;
+   #else
+    ignoreUnused (runtimeMs, periodMs);
+    return false;
+   #endif
+}
+
+bool RealtimeWorkerGroup::setCurrentThreadScheduling (int nativePolicy, int nativePriority)
+{
+    struct sched_param param;
+    param.sched_priority = nativePriority;
+    return pthread_setschedparam (pthread_self(), nativePolicy, &param) == 0;
+}
+
+bool RealtimeWorkerGroup::getCurrentThreadScheduling (int& nativePolicy, int& nativePriority)
+{
+    struct sched_param param;
+
+    if (pthread_getschedparam (pthread_self(), &nativePolicy, &param) != 0)
+        return false;
+
+    nativePriority = param.sched_priority;
+    return true;
+}
+
+RealtimeWorkerGroup::SchedulingPolicy RealtimeWorkerGroup::toSchedulingPolicy (int nativePolicy)
+{
+    switch (nativePolicy)
+    {
+        case SCHED_RR:          return SchedulingPolicy::roundRobin;
+        case SCHED_FIFO:        return SchedulingPolicy::fifo;
+        case SCHED_DEADLINE:    return SchedulingPolicy::deadline;
+        default:                return SchedulingPolicy::normal;
+    }
+}
+
+bool RealtimeWorkerGroup::pinCurrentThreadToCore (int core)
+{
+    if (! isPositiveAndBelow (core, CPU_SETSIZE))
+        return false;
+
+    cpu_set_t cores;
+    CPU_ZERO (&cores);
+    CPU_SET ((size_t) core, &cores);
+
+    return pthread_setaffinity_np (pthread_self(), sizeof (cores), &cores) == 0;
+}
+
+Array<int> RealtimeWorkerGroup::getIsolatedCores()
+{
+    // This holds a list of ranges such as "2-3,6"
+    auto list = File ("/sys/devices/system/cpu/isolated").loadFileAsString();
+    Array<int> cores;
+
+    for (auto range : StringTokeniser (list, ",\n"))
+    {
+        range = range.trim();
+
+        if (range.isEmpty())
+            continue;
+
+        auto first = range.upToFirstOccurrenceOf ("-", false, false).getIntValue();
+        auto last = range.contains ("-") ? range.fromFirstOccurrenceOf ("-", false, false).getIntValue()
+                                         : first;
+
+        for (int i = first; i <= jmin (last, first + 4095); ++i)
+            cores.add (i);
+    }
+
+    return cores;
+}
+
 } // namespace juce
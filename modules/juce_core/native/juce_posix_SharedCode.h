@@ -36,7 +36,7 @@ CriticalSection::CriticalSection() noexcept
 }
 
 CriticalSection::~CriticalSection() noexcept        { pthread_mutex_destroy (&lock); }
-void CriticalSection::enter() const noexcept        { pthread_mutex_lock (&lock); }
+void CriticalSection::enter() const noexcept        { RealtimeSafetyGuard::checkOperation (RealtimeSafetyGuard::Violation::lock); pthread_mutex_lock (&lock); }
 bool CriticalSection::tryEnter() const noexcept     { return pthread_mutex_trylock (&lock) == 0; }
 void CriticalSection::exit() const noexcept         { pthread_mutex_unlock (&lock); }
 
@@ -447,6 +447,51 @@ size_t FileInputStream::readInternal (void* buffer, size_t numBytes)
     return (size_t) result;
 }
 
+size_t FileInputStream::readInternal (void* const* destBuffers, const size_t* bufferSizes, int numBuffers)
+{
+    if (fileHandle == nullptr)
+        return 0;
+
+    size_t totalRead = 0, offsetInBuffer = 0;
+    int bufferIndex = 0;
+
+    while (bufferIndex < numBuffers)
+    {
+        iovec chunks[64];
+        int numChunks = 0;
+
+        for (int i = bufferIndex; i < numBuffers && numChunks < numElementsInArray (chunks); ++i)
+        {
+            auto offset = (i == bufferIndex ? offsetInBuffer : (size_t) 0);
+            chunks[numChunks].iov_base = static_cast<char*> (destBuffers[i]) + offset;
+            chunks[numChunks].iov_len  = bufferSizes[i] - offset;
+            ++numChunks;
+        }
+
+        auto result = ::readv (getFD (fileHandle), chunks, numChunks);
+
+        if (result < 0)
+        {
+            if (errno == EINTR)
+                continue;
+
+            status = getResultForErrno();
+            break;
+        }
+
+        if (result == 0)
+            break;
+
+        totalRead += (size_t) result;
+        offsetInBuffer += (size_t) result;
+
+        while (bufferIndex < numBuffers && offsetInBuffer >= bufferSizes[bufferIndex])
+            offsetInBuffer -= bufferSizes[bufferIndex++];
+    }
+
+    return totalRead;
+}
+
 //==============================================================================
 void FileOutputStream::openHandle()
 {
@@ -523,6 +568,147 @@ Result FileOutputStream::truncate()
     return getResultForReturnValue (ftruncate (getFD (fileHandle), (off_t) currentPosition));
 }
 
+Result FileOutputStream::preallocate (int64 totalNumBytes)
+{
+    if (fileHandle == nullptr)
+        return status;
+
+   #if JUCE_LINUX || JUCE_ANDROID
+    return getResultForReturnValue (fallocate (getFD (fileHandle), FALLOC_FL_KEEP_SIZE, 0, (off_t) totalNumBytes));
+   #elif JUCE_MAC || JUCE_IOS
+    fstore_t store = { F_ALLOCATECONTIG, F_PEOFPOSMODE, 0, (off_t) totalNumBytes, 0 };
+
+    if (fcntl (getFD (fileHandle), F_PREALLOCATE, &store) == -1)
+    {
+        // If there isn't a contiguous space, then just reserve whatever's available
+        store.fst_flags = F_ALLOCATEALL;
+        return getResultForReturnValue (fcntl (getFD (fileHandle), F_PREALLOCATE, &store));
+    }
+
+    return Result::ok();
+   #else
+    ignoreUnused (totalNumBytes);
+    return Result::fail ("Not supported");
+   #endif
+}
+
+bool FileOutputStream::setSystemCacheBypassed (bool shouldBypass)
+{
+    if (fileHandle == nullptr)
+        return false;
+
+   #if JUCE_LINUX || JUCE_ANDROID
+    auto flags = fcntl (getFD (fileHandle), F_GETFL);
+
+    return flags != -1
+            && fcntl (getFD (fileHandle), F_SETFL, shouldBypass ? (flags | O_DIRECT) : (flags & ~O_DIRECT)) != -1;
+   #elif JUCE_MAC || JUCE_IOS
+    return fcntl (getFD (fileHandle), F_NOCACHE, shouldBypass ? 1 : 0) != -1;
+   #else
+    ignoreUnused (shouldBypass);
+    return false;
+   #endif
+}
+
+Result FileOutputStream::writeInternalAt (int64 position, const char* data, size_t numBytes) const
+{
+    while (numBytes > 0)
+    {
+        auto result = ::pwrite (getFD (fileHandle), data, numBytes, (off_t) position);
+
+        if (result < 0)
+        {
+            if (errno == EINTR)
+                continue;
+
+           #if JUCE_LINUX || JUCE_ANDROID
+            if (errno == EINVAL)
+            {
+                auto flags = fcntl (getFD (fileHandle), F_GETFL);
+
+                if (flags != -1 && (flags & O_DIRECT) != 0)
+                {
+                    // Direct writes must be aligned to the file-system's blocks, so anything
+                    // that isn't (e.g. the end of the file) has to go through the cache
+                    fcntl (getFD (fileHandle), F_SETFL, flags & ~O_DIRECT);
+                    result = ::pwrite (getFD (fileHandle), data, numBytes, (off_t) position);
+                    auto error = errno;
+                    fcntl (getFD (fileHandle), F_SETFL, flags);
+                    errno = error;
+                }
+                else
+                {
+                    errno = EINVAL;
+                }
+            }
+           #endif
+
+            if (result < 0)
+                return getResultForErrno();
+        }
+
+        data += result;
+        position += (int64) result;
+        numBytes -= (size_t) result;
+    }
+
+    return Result::ok();
+}
+
+//==============================================================================
+void AsyncFileIO::OpenFile::openHandle (bool forWriting)
+{
+    auto f = forWriting ? open (file.getFullPathName().toUTF8(), O_RDWR | O_CREAT, 00644)
+                        : open (file.getFullPathName().toUTF8(), O_RDONLY);
+
+    if (f != -1)
+        fileHandle = fdToVoidPointer (f);
+    else
+        status = getResultForErrno();
+}
+
+void AsyncFileIO::OpenFile::closeHandle()
+{
+    if (fileHandle != nullptr)
+        close (getFD (fileHandle));
+}
+
+int64 AsyncFileIO::OpenFile::getSize() const
+{
+    struct stat info;
+
+    if (fileHandle != nullptr && fstat (getFD (fileHandle), &info) == 0)
+        return (int64) info.st_size;
+
+    return 0;
+}
+
+Result AsyncFileIO::OpenFile::transfer (bool isWrite, int64 position, char* data, size_t numBytes, size_t& numDone) const
+{
+    while (numDone < numBytes)
+    {
+        auto offset = (off_t) (position + (int64) numDone);
+
+        auto result = isWrite ? ::pwrite (getFD (fileHandle), data + numDone, numBytes - numDone, offset)
+                              : ::pread  (getFD (fileHandle), data + numDone, numBytes - numDone, offset);
+
+        if (result < 0)
+        {
+            if (errno == EINTR)
+                continue;
+
+            return getResultForErrno();
+        }
+
+        if (result == 0)
+            break;
+
+        numDone += (size_t) result;
+    }
+
+    return Result::ok();
+}
+
 //==============================================================================
 String SystemStats::getEnvironmentVariable (const String& name, const String& defaultValue)
 {
@@ -316,6 +316,23 @@ size_t FileInputStream::readInternal (void* buffer, size_t numBytes)
     return 0;
 }
 
+size_t FileInputStream::readInternal (void* const* destBuffers, const size_t* bufferSizes, int numBuffers)
+{
+    // (ReadFileScatter only works with unbuffered, overlapped handles, so this just reads each buffer in turn)
+    size_t totalRead = 0;
+
+    for (int i = 0; i < numBuffers; ++i)
+    {
+        auto numRead = readInternal (destBuffers[i], bufferSizes[i]);
+        totalRead += numRead;
+
+        if (numRead < bufferSizes[i])
+            break;
+    }
+
+    return totalRead;
+}
+
 //==============================================================================
 void FileOutputStream::openHandle()
 {
@@ -373,6 +390,113 @@ Result FileOutputStream::truncate()
                                               : WindowsFileHelpers::getResultForLastError();
 }
 
+Result FileOutputStream::preallocate (int64 totalNumBytes)
+{
+    if (fileHandle == nullptr)
+        return status;
+
+    FILE_ALLOCATION_INFO info;
+    info.AllocationSize.QuadPart = totalNumBytes;
+
+    return SetFileInformationByHandle ((HANDLE) fileHandle, FileAllocationInfo, &info, sizeof (info))
+             ? Result::ok() : WindowsFileHelpers::getResultForLastError();
+}
+
+bool FileOutputStream::setSystemCacheBypassed (bool)
+{
+    // FILE_FLAG_NO_BUFFERING can only be chosen when the file is opened
+    return false;
+}
+
+Result FileOutputStream::writeInternalAt (int64 position, const char* data, size_t numBytes) const
+{
+    while (numBytes > 0)
+    {
+        OVERLAPPED overlapped = {};
+        ULARGE_INTEGER offset;
+        offset.QuadPart = (ULONGLONG) position;
+        overlapped.Offset = offset.LowPart;
+        overlapped.OffsetHigh = offset.HighPart;
+
+        auto numToWrite = (DWORD) jmin ((size_t) 0x40000000, numBytes);
+        DWORD actualNum = 0;
+
+        if (! WriteFile ((HANDLE) fileHandle, data, numToWrite, &actualNum, &overlapped))
+            return WindowsFileHelpers::getResultForLastError();
+
+        data += actualNum;
+        position += (int64) actualNum;
+        numBytes -= (size_t) actualNum;
+    }
+
+    return Result::ok();
+}
+
+//==============================================================================
+void AsyncFileIO::OpenFile::openHandle (bool forWriting)
+{
+    auto h = CreateFile (file.getFullPathName().toWideCharPointer(),
+                         forWriting ? (GENERIC_READ | GENERIC_WRITE) : GENERIC_READ,
+                         FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr,
+                         forWriting ? OPEN_ALWAYS : OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+
+    if (h != INVALID_HANDLE_VALUE)
+        fileHandle = (void*) h;
+    else
+        status = WindowsFileHelpers::getResultForLastError();
+}
+
+void AsyncFileIO::OpenFile::closeHandle()
+{
+    if (fileHandle != nullptr)
+        CloseHandle ((HANDLE) fileHandle);
+}
+
+int64 AsyncFileIO::OpenFile::getSize() const
+{
+    LARGE_INTEGER size;
+
+    if (fileHandle != nullptr && GetFileSizeEx ((HANDLE) fileHandle, &size))
+        return (int64) size.QuadPart;
+
+    return 0;
+}
+
+Result AsyncFileIO::OpenFile::transfer (bool isWrite, int64 position, char* data, size_t numBytes, size_t& numDone) const
+{
+    while (numDone < numBytes)
+    {
+        // Giving an OVERLAPPED with an offset to a synchronous handle makes the call
+        // use that position, without relying on the handle's shared file pointer
+        OVERLAPPED overlapped = {};
+        ULARGE_INTEGER offset;
+        offset.QuadPart = (ULONGLONG) (position + (int64) numDone);
+        overlapped.Offset = offset.LowPart;
+        overlapped.OffsetHigh = offset.HighPart;
+
+        auto numToDo = (DWORD) jmin ((size_t) 0x40000000, numBytes - numDone);
+        DWORD actualNum = 0;
+
+        auto ok = isWrite ? WriteFile ((HANDLE) fileHandle, data + numDone, numToDo, &actualNum, &overlapped)
+                          : ReadFile  ((HANDLE) fileHandle, data + numDone, numToDo, &actualNum, &overlapped);
+
+        if (! ok)
+        {
+            if (GetLastError() == ERROR_HANDLE_EOF)
+                break;
+
+            return WindowsFileHelpers::getResultForLastError();
+        }
+
+        if (actualNum == 0)
+            break;
+
+        numDone += (size_t) actualNum;
+    }
+
+    return Result::ok();
+}
+
 //==============================================================================
 void MemoryMappedFile::openInternal (const File& file, AccessMode mode, bool exclusive)
 {
@@ -43,7 +43,7 @@ CriticalSection::CriticalSection() noexcept
 }
 
 CriticalSection::~CriticalSection() noexcept        { DeleteCriticalSection ((CRITICAL_SECTION*) lock); }
-void CriticalSection::enter() const noexcept        { EnterCriticalSection ((CRITICAL_SECTION*) lock); }
+void CriticalSection::enter() const noexcept        { RealtimeSafetyGuard::checkOperation (RealtimeSafetyGuard::Violation::lock); EnterCriticalSection ((CRITICAL_SECTION*) lock); }
 bool CriticalSection::tryEnter() const noexcept     { return TryEnterCriticalSection ((CRITICAL_SECTION*) lock) != FALSE; }
 void CriticalSection::exit() const noexcept         { LeaveCriticalSection ((CRITICAL_SECTION*) lock); }
 
@@ -145,7 +145,7 @@ int BufferedInputStream::read (void* destBuffer, int maxBytesToRead)
         return maxBytesToRead;
     }
 
-    if (position < bufferStart || position >= lastReadPos)
+    if ((position < bufferStart || position >= lastReadPos) && maxBytesToRead < bufferSize)
         if (! ensureBuffered())
             return 0;
 
@@ -153,22 +153,41 @@ int BufferedInputStream::read (void* destBuffer, int maxBytesToRead)
 
     while (maxBytesToRead > 0)
     {
-        auto numToRead = jmin (maxBytesToRead, (int) (lastReadPos - position));
-
-        if (numToRead > 0)
+        if (position >= bufferStart && position < lastReadPos)
         {
+            auto numToRead = jmin (maxBytesToRead, (int) (lastReadPos - position));
+
             memcpy (destBuffer, buffer + (int) (position - bufferStart), (size_t) numToRead);
             maxBytesToRead -= numToRead;
             bytesRead += numToRead;
             position += numToRead;
             destBuffer = static_cast<char*> (destBuffer) + numToRead;
+
+            if (maxBytesToRead == 0)
+                break;
         }
 
-        auto oldLastReadPos = lastReadPos;
+        if (maxBytesToRead >= bufferSize)
+        {
+            // The rest of this read won't fit in the buffer, so it's quicker to read it
+            // straight into the destination than to copy it through the buffer
+            if (source->setPosition (position))
+            {
+                auto numRead = source->read (destBuffer, maxBytesToRead);
+
+                if (numRead > 0)
+                {
+                    bytesRead += numRead;
+                    position += numRead;
+                }
+            }
+
+            // The source has moved on, so the buffer has to be refilled before it's used again
+            bufferStart = lastReadPos = position;
+            break;
+        }
 
-        if (! ensureBuffered()
-             || oldLastReadPos == lastReadPos
-             || isExhausted())
+        if (! ensureBuffered() || position >= lastReadPos)
             break;
     }
 
@@ -268,6 +287,40 @@ struct BufferedInputStreamTests   : public UnitTest
         expectEquals (stream.getPosition(), (int64) data.getSize());
         expectEquals (stream.getNumBytesRemaining(), (int64) 0);
         expect (stream.isExhausted());
+
+        beginTest ("Reads larger than the buffer");
+
+        MemoryBlock largeData (5000);
+
+        for (size_t i = 0; i < largeData.getSize(); ++i)
+            largeData[i] = (char) (i * 7);
+
+        MemoryInputStream largeSource (largeData, false);
+        BufferedInputStream smallBuffer (largeSource, 256);
+        MemoryBlock largeRead (largeData.getSize());
+
+        expectEquals (smallBuffer.read (largeRead.getData(), 10), 10);
+        expectEquals (smallBuffer.read (addBytesToPointer (largeRead.getData(), 10), 3000), 3000);
+        expectEquals (smallBuffer.getPosition(), (int64) 3010);
+        expectEquals (smallBuffer.peekByte(), largeData[3010]);
+        expectEquals (smallBuffer.read (addBytesToPointer (largeRead.getData(), 3010), 5000), 1990);
+        expect (smallBuffer.isExhausted());
+        expect (largeRead == largeData);
+
+        smallBuffer.setPosition (5);
+        expectEquals (smallBuffer.read (largeRead.getData(), 1000), 1000);
+        expect (memcmp (largeRead.getData(), addBytesToPointer (largeData.getData(), 5), 1000) == 0);
+
+        beginTest ("Seeking backwards near the end");
+
+        smallBuffer.setPosition (4900);
+        expectEquals (smallBuffer.read (largeRead.getData(), 50), 50);
+        smallBuffer.setPosition (4800);
+        expectEquals (smallBuffer.read (largeRead.getData(), 10), 10);
+        expect (memcmp (largeRead.getData(), addBytesToPointer (largeData.getData(), 4800), 10) == 0);
+        expectEquals (smallBuffer.read (largeRead.getData(), 500), 190);
+        expect (memcmp (largeRead.getData(), addBytesToPointer (largeData.getData(), 4810), 190) == 0);
+        expect (smallBuffer.isExhausted());
     }
 };
 
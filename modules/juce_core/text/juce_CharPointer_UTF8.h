@@ -237,10 +237,18 @@ public:
     size_t length() const noexcept
     {
         auto* d = data;
+        auto* end = d + strlen (d);
         size_t count = 0;
 
         for (;;)
         {
+            // whole words of ASCII can be counted without decoding them
+            while (end - d >= (int) sizeof (uint64) && isASCII (readWord (d)))
+            {
+                d += sizeof (uint64);
+                count += sizeof (uint64);
+            }
+
             auto n = (uint32) (uint8) *d++;
 
             if ((n & 0x80) != 0)
@@ -266,7 +274,25 @@ public:
     /** Returns the number of characters in this string, or up to the given end pointer, whichever is lower. */
     size_t lengthUpTo (const CharPointer_UTF8 end) const noexcept
     {
-        return CharacterFunctions::lengthUpTo (*this, end);
+        CharPointer_UTF8 p (data);
+        size_t count = 0;
+
+        while (p.data < end.data)
+        {
+            if (end.data - p.data >= (int) sizeof (uint64) && isASCIIWithoutNull (readWord (p.data)))
+            {
+                p.data += sizeof (uint64);
+                count += sizeof (uint64);
+                continue;
+            }
+
+            if (p.getAndAdvance() == 0)
+                break;
+
+            ++count;
+        }
+
+        return count;
     }
 
     /** Returns the number of bytes that are used to represent this string.
@@ -399,6 +425,43 @@ public:
         return CharacterFunctions::compare (*this, other);
     }
 
+    /** Compares this string with another one. */
+    int compare (const CharPointer_UTF8 other) const noexcept
+    {
+        auto* s1 = data;
+        auto* s2 = other.data;
+
+        if (s1 == s2)
+            return 0;
+
+        // skip any identical runs of ASCII a word at a time, and then let the
+        // normal character-by-character comparison deal with what's left. The
+        // strings are measured in blocks that start small and get bigger, so that
+        // a difference near the start doesn't mean scanning both of them to the end.
+        size_t i = 0;
+
+        for (size_t blockSize = 64;; blockSize = jmin ((size_t) 4096, blockSize * 2))
+        {
+            auto numBytes = jmin (strnlen (s1 + i, blockSize), strnlen (s2 + i, blockSize));
+            auto numWords = numBytes / sizeof (uint64);
+
+            for (size_t word = 0; word < numWords; ++word)
+            {
+                auto w = readWord (s1 + i);
+
+                if (w != readWord (s2 + i) || ! isASCII (w))
+                    return CharacterFunctions::compare (CharPointer_UTF8 (s1 + i), CharPointer_UTF8 (s2 + i));
+
+                i += sizeof (uint64);
+            }
+
+            if (numBytes < blockSize)
+                break;
+        }
+
+        return CharacterFunctions::compare (CharPointer_UTF8 (s1 + i), CharPointer_UTF8 (s2 + i));
+    }
+
     /** Compares this string with another one, up to a specified number of characters. */
     template <typename CharPointer>
     int compareUpTo (const CharPointer other, const int maxChars) const noexcept
@@ -433,9 +496,46 @@ public:
         return CharacterFunctions::indexOf (*this, stringToFind);
     }
 
+    /** Returns the character index of a substring, or -1 if it isn't found. */
+    int indexOf (const CharPointer_UTF8 stringToFind) const noexcept
+    {
+        auto found = find (stringToFind);
+
+        if (found.isEmpty() && stringToFind.isNotEmpty())
+            return -1;
+
+        return (int) lengthUpTo (found);
+    }
+
+    /** Returns a pointer to the first occurrence of a substring in this string, or
+        to this string's null terminator if it isn't found.
+    */
+    CharPointer_UTF8 find (const CharPointer_UTF8 stringToFind) const noexcept
+    {
+        // An ASCII byte can never be part of a multi-byte sequence, so an ASCII
+        // substring can be searched for byte-wise.
+        if (isASCII (stringToFind.data))
+        {
+            if (auto* found = strstr (data, stringToFind.data))
+                return CharPointer_UTF8 (found);
+
+            return findTerminatingNull();
+        }
+
+        return CharacterFunctions::find (*this, stringToFind);
+    }
+
     /** Returns the character index of a unicode character, or -1 if it isn't found. */
     int indexOf (const juce_wchar charToFind) const noexcept
     {
+        if (charToFind > 0 && charToFind < 0x80)
+        {
+            if (auto* found = strchr (data, (int) charToFind))
+                return (int) lengthUpTo (CharPointer_UTF8 (found));
+
+            return -1;
+        }
+
         return CharacterFunctions::indexOfChar (*this, charToFind);
     }
 
@@ -443,7 +543,7 @@ public:
     int indexOf (const juce_wchar charToFind, const bool ignoreCase) const noexcept
     {
         return ignoreCase ? CharacterFunctions::indexOfCharIgnoreCase (*this, charToFind)
-                          : CharacterFunctions::indexOfChar (*this, charToFind);
+                          : indexOf (charToFind);
     }
 
     /** Returns true if the first character of this string is whitespace. */
@@ -559,6 +659,39 @@ public:
 
 private:
     CharType* data;
+
+    // callers only read words that they've already found to lie before the
+    // terminating null, but GCC can't always follow that when a short literal
+    // gets inlined into one of them
+    JUCE_BEGIN_IGNORE_WARNINGS_GCC_LIKE ("-Warray-bounds")
+
+    static uint64 readWord (const CharType* p) noexcept
+    {
+        uint64 w;
+        memcpy (&w, p, sizeof (w));
+        return w;
+    }
+
+    JUCE_END_IGNORE_WARNINGS_GCC_LIKE
+
+    static bool isASCII (uint64 w) noexcept
+    {
+        return (w & 0x8080808080808080ull) == 0;
+    }
+
+    static bool isASCIIWithoutNull (uint64 w) noexcept
+    {
+        return ((w | (w - 0x0101010101010101ull)) & 0x8080808080808080ull) == 0;
+    }
+
+    static bool isASCII (const CharType* s) noexcept
+    {
+        for (; *s != 0; ++s)
+            if ((*s & 0x80) != 0)
+                return false;
+
+        return true;
+    }
 };
 
 } // namespace juce
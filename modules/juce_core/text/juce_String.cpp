@@ -68,7 +68,18 @@ public:
     static CharPointerType createUninitialisedBytes (size_t numBytes)
     {
         numBytes = (numBytes + 3) & ~(size_t) 3;
-        auto s = unalignedPointerCast<StringHolder*> (new char [sizeof (StringHolder) - sizeof (CharType) + numBytes]);
+        StringHolder* s = nullptr;
+
+        if (numBytes <= BlockCache::largeBlockBytes)
+        {
+            numBytes = numBytes <= BlockCache::smallBlockBytes ? BlockCache::smallBlockBytes
+                                                               : BlockCache::largeBlockBytes;
+            s = BlockCache::take (numBytes);
+        }
+
+        if (s == nullptr)
+            s = unalignedPointerCast<StringHolder*> (new char [sizeof (StringHolder) - sizeof (CharType) + numBytes]);
+
         s->refCount.value = 0;
         s->allocatedNumBytes = numBytes;
         return CharPointerType (s->text);
@@ -161,7 +172,8 @@ public:
     {
         if (! isEmptyString (b))
             if (--(b->refCount) == -1)
-                delete[] reinterpret_cast<char*> (b);
+                if (! BlockCache::give (b))
+                    delete[] reinterpret_cast<char*> (b);
     }
 
     static void release (const CharPointerType text) noexcept
@@ -201,6 +213,100 @@ public:
         return bufferFromText (text)->allocatedNumBytes;
     }
 
+    //==============================================================================
+    /*  Most strings are short, so rather than going back to the heap every time one of
+        them is created or destroyed, each thread keeps a small stack of recently freed
+        blocks of the two most common sizes, and re-uses them for new strings.
+    */
+    struct BlockCache
+    {
+        enum
+        {
+            smallBlockBytes = 16,
+            largeBlockBytes = 48,
+            maxBlocksPerSize = 32
+        };
+
+        static StringHolder* take (size_t numBytes) noexcept
+        {
+            auto& blocks = getBlocks();
+            auto index = numBytes == smallBlockBytes ? 0 : 1;
+
+            if (blocks.numFree[index] > 0)
+                return blocks.free[index][--blocks.numFree[index]];
+
+            return nullptr;
+        }
+
+        static bool give (StringHolder* b) noexcept
+        {
+            if (b->allocatedNumBytes != smallBlockBytes && b->allocatedNumBytes != largeBlockBytes)
+                return false;
+
+            auto& blocks = getBlocks();
+
+            if (blocks.state != Blocks::active)
+            {
+                if (blocks.state == Blocks::threadFinished)
+                    return false;
+
+                // this makes sure the cleaner gets constructed, so that whatever we cache
+                // is deleted when the thread exits
+                getCleaner().blocks = &blocks;
+                blocks.state = Blocks::active;
+            }
+
+            auto index = b->allocatedNumBytes == smallBlockBytes ? 0 : 1;
+
+            if (blocks.numFree[index] >= maxBlocksPerSize)
+                return false;
+
+            blocks.free[index][blocks.numFree[index]++] = b;
+            return true;
+        }
+
+    private:
+        // This is trivially destructible, so it stays usable while other thread-local
+        // and static objects that contain strings are being destroyed.
+        struct Blocks
+        {
+            enum State { unused, active, threadFinished };
+
+            StringHolder* free[2][maxBlocksPerSize];
+            int numFree[2];
+            State state;
+        };
+
+        struct Cleaner
+        {
+            ~Cleaner()
+            {
+                if (blocks != nullptr)
+                {
+                    blocks->state = Blocks::threadFinished;
+
+                    for (auto index : { 0, 1 })
+                        while (blocks->numFree[index] > 0)
+                            delete[] reinterpret_cast<char*> (blocks->free[index][--blocks->numFree[index]]);
+                }
+            }
+
+            Blocks* blocks = nullptr;
+        };
+
+        static Blocks& getBlocks() noexcept
+        {
+            thread_local Blocks blocks {};
+            return blocks;
+        }
+
+        static Cleaner& getCleaner() noexcept
+        {
+            thread_local Cleaner cleaner;
+            return cleaner;
+        }
+    };
+
     //==============================================================================
     Atomic<int> refCount;
     size_t allocatedNumBytes;
@@ -1285,21 +1391,71 @@ String String::replaceSection (int index, int numCharsToReplace, StringRef strin
     return result;
 }
 
+template <typename CharPointer>
+static CharPointer findSubstring (CharPointer textToSearch, CharPointer substringToFind) noexcept
+{
+    return CharacterFunctions::find (textToSearch, substringToFind);
+}
+
+static CharPointer_UTF8 findSubstring (CharPointer_UTF8 textToSearch, CharPointer_UTF8 substringToFind) noexcept
+{
+    return textToSearch.find (substringToFind);
+}
+
 String String::replace (StringRef stringToReplace, StringRef stringToInsert, const bool ignoreCase) const
 {
-    auto stringToReplaceLen = stringToReplace.length();
-    auto stringToInsertLen = stringToInsert.length();
+    if (ignoreCase)
+    {
+        auto stringToReplaceLen = stringToReplace.length();
+        auto stringToInsertLen = stringToInsert.length();
 
-    int i = 0;
-    String result (*this);
+        int i = 0;
+        String result (*this);
 
-    while ((i = (ignoreCase ? result.indexOfIgnoreCase (i, stringToReplace)
-                            : result.indexOf (i, stringToReplace))) >= 0)
+        while ((i = result.indexOfIgnoreCase (i, stringToReplace)) >= 0)
+        {
+            result = result.replaceSection (i, stringToReplaceLen, stringToInsert);
+            i += stringToInsertLen;
+        }
+
+        return result;
+    }
+
+    if (stringToReplace.isEmpty())
+        return *this;
+
+    // Count the matches first, so that the result can be built in a single allocation
+    auto bytesToReplace = findByteOffsetOfEnd (stringToReplace.text);
+    auto bytesToInsert  = findByteOffsetOfEnd (stringToInsert.text);
+    size_t numMatches = 0;
+
+    for (auto t = findSubstring (text, stringToReplace.text); ! t.isEmpty();
+              t = findSubstring (CharPointerType (addBytesToPointer (t.getAddress(), bytesToReplace)), stringToReplace.text))
+        ++numMatches;
+
+    if (numMatches == 0)
+        return *this;
+
+    auto newTotalBytes = findByteOffsetOfEnd (text) + numMatches * bytesToInsert - numMatches * bytesToReplace;
+
+    if (newTotalBytes == 0)
+        return {};
+
+    String result (PreallocationBytes ((size_t) newTotalBytes));
+    auto* dest = (char*) result.text.getAddress();
+    auto source = text;
+
+    for (auto t = findSubstring (source, stringToReplace.text); ! t.isEmpty(); t = findSubstring (source, stringToReplace.text))
     {
-        result = result.replaceSection (i, stringToReplaceLen, stringToInsert);
-        i += stringToInsertLen;
+        auto bytesBefore = (size_t) (((char*) t.getAddress()) - (char*) source.getAddress());
+        memcpy (dest, source.getAddress(), bytesBefore);
+        dest += bytesBefore;
+        memcpy (dest, stringToInsert.text.getAddress(), bytesToInsert);
+        dest += bytesToInsert;
+        source = CharPointerType (addBytesToPointer (t.getAddress(), bytesToReplace));
     }
 
+    memcpy (dest, source.getAddress(), findByteOffsetOfEnd (source) + sizeof (CharPointerType::CharType));
     return result;
 }
 
@@ -1462,8 +1618,74 @@ bool String::endsWithIgnoreCase (StringRef other) const noexcept
 }
 
 //==============================================================================
+template <typename CharPointer>
+static bool changeCaseOfASCII (CharPointer, String&, bool) noexcept
+{
+    return false;
+}
+
+static bool changeCaseOfASCII (CharPointer_UTF8 source, String& result, bool toUpper)
+{
+    auto* src = source.getAddress();
+    auto numBytes = strlen (src);
+
+    if (numBytes == 0)
+        return true;
+
+    const uint64 highBits = 0x8080808080808080ull;
+    const uint64 ones = 0x0101010101010101ull;
+    size_t i = 0;
+
+    for (; i + sizeof (uint64) <= numBytes; i += sizeof (uint64))
+    {
+        uint64 w;
+        memcpy (&w, src + i, sizeof (w));
+
+        if ((w & highBits) != 0)
+            return false;
+    }
+
+    for (size_t j = i; j < numBytes; ++j)
+        if ((src[j] & 0x80) != 0)
+            return false;
+
+    result.preallocateBytes (numBytes);
+    auto* dest = result.getCharPointer().getAddress();
+
+    // For bytes below 0x80, adding (0x80 - x) sets the top bit exactly when the byte is >= x,
+    // without carrying into the next byte, so a whole word can be case-flipped in one go.
+    const auto first = (uint64) (toUpper ? 'a' : 'A');
+    const auto last  = (uint64) (toUpper ? 'z' : 'Z');
+
+    for (i = 0; i + sizeof (uint64) <= numBytes; i += sizeof (uint64))
+    {
+        uint64 w;
+        memcpy (&w, src + i, sizeof (w));
+
+        auto isAtLeastFirst = w + ones * (0x80 - first);
+        auto isAfterLast    = w + ones * (0x80 - last - 1);
+        w ^= ((isAtLeastFirst & ~isAfterLast) & highBits) >> 2;
+
+        memcpy (dest + i, &w, sizeof (w));
+    }
+
+    for (; i < numBytes; ++i)
+    {
+        auto c = src[i];
+        dest[i] = (c >= (char) first && c <= (char) last) ? (char) (c ^ 0x20) : c;
+    }
+
+    dest[numBytes] = 0;
+    return true;
+}
+
 String String::toUpperCase() const
 {
+    String result;
+
+    if (changeCaseOfASCII (text, result, true))
+        return result;
+
     StringCreationHelper builder (text);
 
     for (;;)
@@ -1482,6 +1704,11 @@ String String::toUpperCase() const
 
 String String::toLowerCase() const
 {
+    String result;
+
+    if (changeCaseOfASCII (text, result, false))
+        return result;
+
     StringCreationHelper builder (text);
 
     for (;;)
@@ -2950,6 +3177,46 @@ public:
             for (auto c : str)
                 expectEquals (c, parts[index++]);
         }
+
+        {
+            beginTest ("ASCII fast paths");
+
+            const String ascii ("the quick brown fox jumps over the lazy dog, THE QUICK BROWN FOX");
+            const String mixed (CharPointer_UTF8 ("the quick brown f\xc3\xb6x jumps over the lazy dog \xe2\x82\xac fox"));
+
+            expectEquals (ascii.length(), 64);
+            expectEquals (mixed.length(), 49);
+            expectEquals (mixed.indexOfChar ('j'), 20);
+            expectEquals (mixed.indexOfChar (0x20ac), 44);
+            expectEquals (mixed.indexOf ("fox"), 46);
+            expectEquals (mixed.indexOf (CharPointer_UTF8 ("f\xc3\xb6x")), 16);
+            expectEquals (mixed.indexOf ("cat"), -1);
+            expect (mixed.containsChar ('z'));
+            expect (! mixed.containsChar ('Q'));
+            expectEquals (mixed.getCharPointer().lengthUpTo (mixed.getCharPointer().find (CharPointer_UTF8 ("lazy"))), (size_t) 35);
+
+            expect (ascii.compare (ascii + "!") < 0);
+            expect (String (ascii + "!").compare (ascii) > 0);
+            expect (ascii.compare (ascii.replace ("lazy", "lazz")) < 0);
+            expect (mixed.compare (mixed.replace (CharPointer_UTF8 ("\xe2\x82\xac"), CharPointer_UTF8 ("\xc2\xa3"))) > 0);
+            expect (String (ascii) == ascii.substring (0));
+
+            expectEquals (ascii.toUpperCase(), String ("THE QUICK BROWN FOX JUMPS OVER THE LAZY DOG, THE QUICK BROWN FOX"));
+            expectEquals (ascii.toLowerCase(), String ("the quick brown fox jumps over the lazy dog, the quick brown fox"));
+            expectEquals (String ("@AZ[`az{").toUpperCase(), String ("@AZ[`AZ{"));
+            expectEquals (String ("@AZ[`az{").toLowerCase(), String ("@az[`az{"));
+            expect (mixed.toUpperCase().startsWith ("THE QUICK BROWN F"));
+            expect (mixed.toUpperCase().endsWith (CharPointer_UTF8 ("X JUMPS OVER THE LAZY DOG \xe2\x82\xac FOX")));
+            expect (String().toUpperCase().isEmpty());
+
+            expectEquals (ascii.replace ("fox", "cat"), String ("the quick brown cat jumps over the lazy dog, THE QUICK BROWN FOX"));
+            expectEquals (ascii.replace ("o", ""), String ("the quick brwn fx jumps ver the lazy dg, THE QUICK BROWN FOX"));
+            expectEquals (String ("aaaa").replace ("aa", "a"), String ("aa"));
+            expectEquals (String ("aaa").replace ("a", "aa"), String ("aaaaaa"));
+            expectEquals (String ("abab").replace ("abab", ""), String());
+            expectEquals (ascii.replace ("", "x"), ascii);
+            expectEquals (mixed.replace (CharPointer_UTF8 ("\xc3\xb6"), "o"), String ("the quick brown fox jumps over the lazy dog ") + String (CharPointer_UTF8 ("\xe2\x82\xac")) + " fox");
+        }
     }
 };
 
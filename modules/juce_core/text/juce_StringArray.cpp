@@ -334,21 +334,10 @@ int StringArray::addTokens (StringRef text, StringRef breakCharacters, StringRef
 {
     int num = 0;
 
-    if (text.isNotEmpty())
+    for (auto token : StringTokeniser (text, breakCharacters, quoteCharacters))
     {
-        for (auto t = text.text;;)
-        {
-            auto tokenEnd = CharacterFunctions::findEndOfToken (t,
-                                                                breakCharacters.text,
-                                                                quoteCharacters.text);
-            strings.add (String (t, tokenEnd));
-            ++num;
-
-            if (tokenEnd.isEmpty())
-                break;
-
-            t = ++tokenEnd;
-        }
+        strings.add (token.toString());
+        ++num;
     }
 
     return num;
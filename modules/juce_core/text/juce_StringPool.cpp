@@ -26,10 +26,6 @@ namespace juce
 static const int minNumberOfStringsForGarbageCollection = 300;
 static const uint32 garbageCollectionInterval = 30000;
 
-
-StringPool::StringPool() noexcept  : lastGarbageCollectionTime (0) {}
-StringPool::~StringPool() {}
-
 struct StartEndString
 {
     StartEndString (String::CharPointerType s, String::CharPointerType e) noexcept : start (s), end (e) {}
@@ -38,7 +34,6 @@ struct StartEndString
     String::CharPointerType start, end;
 };
 
-static int compareStrings (const String& s1, const String& s2) noexcept     { return s1.compare (s2); }
 static int compareStrings (CharPointer_UTF8 s1, const String& s2) noexcept  { return s1.compare (s2.getCharPointer()); }
 
 static int compareStrings (const StartEndString& string1, const String& string2) noexcept
@@ -58,44 +53,240 @@ static int compareStrings (const StartEndString& string1, const String& string2)
     return 0;
 }
 
-template <typename NewStringType>
-static String addPooledString (Array<String>& strings, const NewStringType& newString)
+template <typename StringType>
+static bool matchesPooledString (const StringType& s, const String& pooled) noexcept
+{
+    return compareStrings (s, pooled) == 0;
+}
+
+static bool matchesPooledString (const String& s, const String& pooled) noexcept
+{
+    return s.getCharPointer() == pooled.getCharPointer() || s == pooled;
+}
+
+static uint32 addToStringHash (uint32 hash, juce_wchar c) noexcept
+{
+    return (hash ^ (uint32) c) * 16777619u;
+}
+
+template <typename CharPointer>
+static uint32 hashPooledString (CharPointer s) noexcept
+{
+    uint32 hash = 2166136261u;
+
+    while (auto c = s.getAndAdvance())
+        hash = addToStringHash (hash, c);
+
+    return hash;
+}
+
+static uint32 hashPooledString (const String& s) noexcept
+{
+    return hashPooledString (s.getCharPointer());
+}
+
+static uint32 hashPooledString (const StartEndString& s) noexcept
 {
-    int start = 0;
-    int end = strings.size();
+    uint32 hash = 2166136261u;
 
-    while (start < end)
+    for (auto p = s.start; p < s.end;)
     {
-        const String& startString = strings.getReference (start);
-        const int startComp = compareStrings (newString, startString);
+        auto c = p.getAndAdvance();
 
-        if (startComp == 0)
-            return startString;
+        if (c == 0)
+            break;
+
+        hash = addToStringHash (hash, c);
+    }
+
+    return hash;
+}
+
+//==============================================================================
+struct StringPool::Entry
+{
+    Entry (String s, uint32 h)  : text (std::move (s)), hash (h) {}
+
+    const String text;
+    const uint32 hash;
+};
 
-        const int halfway = (start + end) / 2;
+/*  An open-addressed hash table of entries. The slots can be searched by any thread at
+    any time, but are only modified while holding the pool's lock. A removed entry leaves
+    a marker behind so that searches for the entries that follow it still work.
+*/
+struct StringPool::Table
+{
+    explicit Table (int numSlotsToUse)
+        : slots (new std::atomic<Entry*>[(size_t) numSlotsToUse]()),
+          numSlots (numSlotsToUse)
+    {
+        jassert (isPowerOfTwo (numSlots));
+    }
+
+    static Entry* getRemovedMarker() noexcept
+    {
+        static char marker;
+        return reinterpret_cast<Entry*> (&marker);
+    }
+
+    template <typename StringType>
+    Entry* find (const StringType& s, uint32 hash) const noexcept
+    {
+        auto mask = (uint32) numSlots - 1;
 
-        if (halfway == start)
+        for (auto i = hash & mask;; i = (i + 1) & mask)
         {
-            if (startComp > 0)
-                ++start;
+            auto* e = slots[i].load (std::memory_order_acquire);
 
-            break;
+            if (e == nullptr)
+                return nullptr;
+
+            if (e != getRemovedMarker() && e->hash == hash && matchesPooledString (s, e->text))
+                return e;
+        }
+    }
+
+    void add (Entry* newEntry) noexcept
+    {
+        auto mask = (uint32) numSlots - 1;
+
+        for (auto i = newEntry->hash & mask;; i = (i + 1) & mask)
+        {
+            auto* e = slots[i].load (std::memory_order_relaxed);
+
+            if (e == nullptr || e == getRemovedMarker())
+            {
+                if (e == nullptr)
+                    ++numUsedSlots;
+
+                slots[i].store (newEntry, std::memory_order_release);
+                return;
+            }
         }
+    }
+
+    bool isFullEnoughToResize (int numToAdd) const noexcept
+    {
+        return (numUsedSlots + numToAdd) * 4 > numSlots * 3;
+    }
+
+    std::unique_ptr<std::atomic<Entry*>[]> slots;
+    const int numSlots;
+    int numUsedSlots = 0;
+};
+
+//==============================================================================
+StringPool::StringPool() noexcept  : lastGarbageCollectionTime (0)
+{
+    numActiveReaders[0] = 0;
+    numActiveReaders[1] = 0;
+}
 
-        const String& halfwayString = strings.getReference (halfway);
-        const int halfwayComp = compareStrings (newString, halfwayString);
+StringPool::~StringPool()
+{
+    if (auto* t = table.load())
+    {
+        for (size_t i = 0; i < (size_t) t->numSlots; ++i)
+        {
+            auto* e = t->slots[i].load();
 
-        if (halfwayComp == 0)
-            return halfwayString;
+            if (e != nullptr && e != Table::getRemovedMarker())
+                delete e;
+        }
 
-        if (halfwayComp > 0)
-            start = halfway;
-        else
-            end = halfway;
+        delete t;
     }
+}
+
+template <typename StringType>
+String StringPool::findWithoutLocking (const StringType& s, uint32 hash) noexcept
+{
+    for (;;)
+    {
+        auto epoch = readerEpoch.load();
+        auto& readers = numActiveReaders[epoch & 1];
+        ++readers;
+
+        // If a writer has moved on to the next epoch since we read it, it may not be
+        // waiting for our counter, so we need to start again with the new one.
+        if (readerEpoch.load() == epoch)
+        {
+            String result;
 
-    strings.insert (start, newString);
-    return strings.getReference (start);
+            if (auto* t = table.load())
+                if (auto* e = t->find (s, hash))
+                    result = e->text;
+
+            --readers;
+            return result;
+        }
+
+        --readers;
+    }
+}
+
+void StringPool::waitForReaders() noexcept
+{
+    // Moves any new readers onto the other counter, and waits for all the ones
+    // that started before this point to finish
+    auto& readers = numActiveReaders[(readerEpoch++) & 1];
+
+    while (readers.load() != 0)
+        Thread::yield();
+}
+
+void StringPool::resizeTable (int newNumSlots)
+{
+    auto* oldTable = table.load();
+    auto* newTable = new Table (newNumSlots);
+
+    if (oldTable != nullptr)
+    {
+        for (size_t i = 0; i < (size_t) oldTable->numSlots; ++i)
+        {
+            auto* e = oldTable->slots[i].load();
+
+            if (e != nullptr && e != Table::getRemovedMarker())
+                newTable->add (e);
+        }
+    }
+
+    table = newTable;
+    waitForReaders();
+    delete oldTable;
+}
+
+void StringPool::insert (Entry* newEntry)
+{
+    auto* t = table.load();
+
+    if (t == nullptr || t->isFullEnoughToResize (1))
+        resizeTable (jmax (64, nextPowerOfTwo ((numStrings + 1) * 2)));
+
+    table.load()->add (newEntry);
+    ++numStrings;
+}
+
+template <typename StringType>
+String StringPool::getPooledStringFor (const StringType& newString)
+{
+    auto hash = hashPooledString (newString);
+    auto existing = findWithoutLocking (newString, hash);
+
+    if (existing.isNotEmpty())
+        return existing;
+
+    const ScopedLock sl (lock);
+    garbageCollectIfNeeded();
+
+    if (auto* t = table.load())
+        if (auto* e = t->find (newString, hash))
+            return e->text;
+
+    auto* newEntry = new Entry (String (newString), hash);
+    insert (newEntry);
+    return newEntry->text;
 }
 
 String StringPool::getPooledString (const char* const newString)
@@ -103,9 +294,7 @@ String StringPool::getPooledString (const char* const newString)
     if (newString == nullptr || *newString == 0)
         return {};
 
-    const ScopedLock sl (lock);
-    garbageCollectIfNeeded();
-    return addPooledString (strings, CharPointer_UTF8 (newString));
+    return getPooledStringFor (CharPointer_UTF8 (newString));
 }
 
 String StringPool::getPooledString (String::CharPointerType start, String::CharPointerType end)
@@ -113,9 +302,7 @@ String StringPool::getPooledString (String::CharPointerType start, String::CharP
     if (start.isEmpty() || start == end)
         return {};
 
-    const ScopedLock sl (lock);
-    garbageCollectIfNeeded();
-    return addPooledString (strings, StartEndString (start, end));
+    return getPooledStringFor (StartEndString (start, end));
 }
 
 String StringPool::getPooledString (StringRef newString)
@@ -123,9 +310,7 @@ String StringPool::getPooledString (StringRef newString)
     if (newString.isEmpty())
         return {};
 
-    const ScopedLock sl (lock);
-    garbageCollectIfNeeded();
-    return addPooledString (strings, newString.text);
+    return getPooledStringFor (newString.text);
 }
 
 String StringPool::getPooledString (const String& newString)
@@ -133,14 +318,12 @@ String StringPool::getPooledString (const String& newString)
     if (newString.isEmpty())
         return {};
 
-    const ScopedLock sl (lock);
-    garbageCollectIfNeeded();
-    return addPooledString (strings, newString);
+    return getPooledStringFor (newString);
 }
 
 void StringPool::garbageCollectIfNeeded()
 {
-    if (strings.size() > minNumberOfStringsForGarbageCollection
+    if (numStrings > minNumberOfStringsForGarbageCollection
          && Time::getApproximateMillisecondCounter() > lastGarbageCollectionTime + garbageCollectionInterval)
         garbageCollect();
 }
@@ -149,9 +332,41 @@ void StringPool::garbageCollect()
 {
     const ScopedLock sl (lock);
 
-    for (int i = strings.size(); --i >= 0;)
-        if (strings.getReference(i).getReferenceCount() == 1)
-            strings.remove (i);
+    if (auto* t = table.load())
+    {
+        Array<Entry*> unusedEntries;
+
+        for (size_t i = 0; i < (size_t) t->numSlots; ++i)
+        {
+            auto* e = t->slots[i].load();
+
+            if (e != nullptr && e != Table::getRemovedMarker() && e->text.getReferenceCount() == 1)
+            {
+                t->slots[i] = Table::getRemovedMarker();
+                unusedEntries.add (e);
+            }
+        }
+
+        if (! unusedEntries.isEmpty())
+        {
+            // A reader may have found one of these entries just before it was removed,
+            // so they can only be deleted once those readers have taken their copies.
+            waitForReaders();
+
+            for (auto* e : unusedEntries)
+            {
+                if (e->text.getReferenceCount() == 1)
+                {
+                    delete e;
+                    --numStrings;
+                }
+                else
+                {
+                    t->add (e);
+                }
+            }
+        }
+    }
 
     lastGarbageCollectionTime = Time::getApproximateMillisecondCounter();
 }
@@ -162,4 +377,103 @@ StringPool& StringPool::getGlobalPool() noexcept
     return pool;
 }
 
+
+//==============================================================================
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class StringPoolTests  : public UnitTest
+{
+public:
+    StringPoolTests()
+        : UnitTest ("StringPool", UnitTestCategories::text)
+    {}
+
+    void runTest() override
+    {
+        beginTest ("Pooled strings are shared");
+        {
+            StringPool pool;
+            auto s1 = pool.getPooledString ("hello");
+            auto s2 = pool.getPooledString (String ("hel") + "lo");
+            auto s3 = pool.getPooledString (StringRef ("hello"));
+            String source ("xhellox");
+            auto s4 = pool.getPooledString (source.getCharPointer() + 1, source.getCharPointer() + 6);
+
+            expect (s1.getCharPointer() == s2.getCharPointer());
+            expect (s1.getCharPointer() == s3.getCharPointer());
+            expect (s1.getCharPointer() == s4.getCharPointer());
+            expect (pool.getPooledString ("").isEmpty());
+
+            for (int i = 0; i < 1000; ++i)
+                pool.getPooledString ("name" + String (i));
+
+            expect (pool.getPooledString ("hello").getCharPointer() == s1.getCharPointer());
+            expectEquals (pool.getPooledString ("name500"), String ("name500"));
+        }
+
+        beginTest ("Garbage collection");
+        {
+            StringPool pool;
+            auto kept = pool.getPooledString ("kept");
+            auto* keptText = kept.getCharPointer().getAddress();
+            pool.getPooledString ("discarded");
+            pool.garbageCollect();
+
+            expectEquals (pool.getPooledString ("discarded"), String ("discarded"));
+            expect (pool.getPooledString ("kept").getCharPointer().getAddress() == keptText);
+        }
+
+        beginTest ("Concurrent lookups");
+        {
+            StringPool pool;
+            Array<String> first;
+
+            for (int i = 0; i < 100; ++i)
+                first.add (pool.getPooledString ("item" + String (i)));
+
+            std::atomic<bool> failed { false };
+
+            struct LookupThread  : public Thread
+            {
+                LookupThread (StringPool& p, const Array<String>& s, std::atomic<bool>& f)
+                    : Thread ("StringPool test"), pool (p), strings (s), failed (f) {}
+
+                void run() override
+                {
+                    for (int n = 0; n < 200; ++n)
+                    {
+                        for (int i = 0; i < strings.size(); ++i)
+                            if (pool.getPooledString ("item" + String (i)).getCharPointer() != strings.getReference (i).getCharPointer())
+                                failed = true;
+
+                        pool.getPooledString ("temp" + String (n));
+                    }
+                }
+
+                StringPool& pool;
+                const Array<String>& strings;
+                std::atomic<bool>& failed;
+            };
+
+            OwnedArray<LookupThread> threads;
+
+            for (int i = 0; i < 4; ++i)
+                threads.add (new LookupThread (pool, first, failed))->startThread();
+
+            for (int i = 0; i < 50; ++i)
+                pool.garbageCollect();
+
+            for (auto* t : threads)
+                t->stopThread (-1);
+
+            expect (! failed);
+        }
+    }
+};
+
+static StringPoolTests stringPoolTests;
+
+#endif
+
 } // namespace juce
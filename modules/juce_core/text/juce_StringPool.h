@@ -34,6 +34,11 @@ namespace juce
     compare two pooled strings for equality, as you can simply compare their pointers. It
     also cuts down on storage if you're using many copies of the same string.
 
+    The strings are kept in a hash table which can be searched without taking a lock,
+    so looking up a string that's already in the pool (e.g. when creating an Identifier
+    that has been used before) is cheap even when many threads are doing it at once.
+    Only adding a new string, or removing unused ones, needs to lock the pool.
+
     @tags{Core}
 */
 class JUCE_API  StringPool
@@ -78,10 +83,21 @@ public:
     static StringPool& getGlobalPool() noexcept;
 
 private:
-    Array<String> strings;
+    struct Entry;
+    struct Table;
+
+    std::atomic<Table*> table { nullptr };
+    std::atomic<uint32> readerEpoch { 0 };
+    std::atomic<int> numActiveReaders[2];
     CriticalSection lock;
     uint32 lastGarbageCollectionTime;
+    int numStrings = 0;
 
+    template <typename StringType> String getPooledStringFor (const StringType&);
+    template <typename StringType> String findWithoutLocking (const StringType&, uint32 hash) noexcept;
+    void insert (Entry*);
+    void resizeTable (int newNumSlots);
+    void waitForReaders() noexcept;
     void garbageCollectIfNeeded();
 
     JUCE_DECLARE_NON_COPYABLE (StringPool)
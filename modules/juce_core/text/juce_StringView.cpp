@@ -0,0 +1,572 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2020 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   To use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+static const StringView::CharPointerType::CharType emptyStringViewText[1] = {};
+
+StringView::StringView() noexcept
+    : start (emptyStringViewText), end (emptyStringViewText)
+{
+}
+
+StringView::StringView (CharPointerType s, CharPointerType e) noexcept
+    : start (s), end (e)
+{
+    jassert (start <= end);
+}
+
+StringView::StringView (StringRef text) noexcept
+    : start (text.text), end (text.text.findTerminatingNull())
+{
+}
+
+StringView::StringView (CharPointerType text) noexcept
+    : start (text), end (text.findTerminatingNull())
+{
+}
+
+StringView::StringView (const String& text) noexcept
+    : start (text.getCharPointer()), end (start.findTerminatingNull())
+{
+}
+
+StringView::StringView (const char* text) noexcept
+    : StringView (StringRef (text))
+{
+}
+
+int StringView::length() const noexcept
+{
+    return (int) start.lengthUpTo (end);
+}
+
+size_t StringView::getNumBytes() const noexcept
+{
+    return (size_t) (reinterpret_cast<const char*> (end.getAddress())
+                      - reinterpret_cast<const char*> (start.getAddress()));
+}
+
+String StringView::toString() const
+{
+    return String (start, end);
+}
+
+//==============================================================================
+bool StringView::operator== (StringView other) const noexcept
+{
+    auto numBytes = getNumBytes();
+
+    return numBytes == other.getNumBytes()
+            && memcmp (start.getAddress(), other.start.getAddress(), numBytes) == 0;
+}
+
+static bool startsWithIgnoreCase (StringView::CharPointerType text, StringView::CharPointerType end, StringView other) noexcept
+{
+    for (auto o = other.getStart(); o < other.getEnd();)
+    {
+        if (text >= end)
+            return false;
+
+        if (CharacterFunctions::toLowerCase (text.getAndAdvance()) != CharacterFunctions::toLowerCase (o.getAndAdvance()))
+            return false;
+    }
+
+    return true;
+}
+
+bool StringView::equalsIgnoreCase (StringView other) const noexcept
+{
+    return other.length() == length()
+            && startsWithIgnoreCase (start, end, other);
+}
+
+bool StringView::startsWith (StringView text) const noexcept
+{
+    auto numBytes = text.getNumBytes();
+
+    return numBytes <= getNumBytes()
+            && memcmp (start.getAddress(), text.start.getAddress(), numBytes) == 0;
+}
+
+bool StringView::endsWith (StringView text) const noexcept
+{
+    auto numBytes = text.getNumBytes();
+
+    return numBytes <= getNumBytes()
+            && memcmp (reinterpret_cast<const char*> (end.getAddress()) - numBytes,
+                       text.start.getAddress(), numBytes) == 0;
+}
+
+//==============================================================================
+StringView::CharPointerType StringView::find (StringView textToFind, bool ignoreCase) const noexcept
+{
+    if (textToFind.isEmpty())
+        return start;
+
+    auto numBytesToFind = textToFind.getNumBytes();
+
+    for (auto p = start; p < end; ++p)
+    {
+        if (ignoreCase)
+        {
+            if (startsWithIgnoreCase (p, end, textToFind))
+                return p;
+        }
+        else
+        {
+            if (StringView (p, end).getNumBytes() < numBytesToFind)
+                break;
+
+            if (memcmp (p.getAddress(), textToFind.start.getAddress(), numBytesToFind) == 0)
+                return p;
+        }
+    }
+
+    return end;
+}
+
+int StringView::indexOfChar (juce_wchar characterToLookFor) const noexcept
+{
+    int index = 0;
+
+    for (auto p = start; p < end; ++index)
+        if (p.getAndAdvance() == characterToLookFor)
+            return index;
+
+    return -1;
+}
+
+int StringView::indexOf (StringView textToLookFor, bool ignoreCase) const noexcept
+{
+    auto found = find (textToLookFor, ignoreCase);
+
+    if (found == end && textToLookFor.isNotEmpty())
+        return -1;
+
+    return (int) start.lengthUpTo (found);
+}
+
+bool StringView::contains (StringView textToLookFor, bool ignoreCase) const noexcept
+{
+    return textToLookFor.isEmpty() || find (textToLookFor, ignoreCase) != end;
+}
+
+//==============================================================================
+StringView StringView::substring (int startIndex, int endIndex) const noexcept
+{
+    if (startIndex < 0)
+        startIndex = 0;
+
+    if (endIndex <= startIndex)
+        return {};
+
+    auto t1 = start;
+
+    for (int i = 0; i < startIndex; ++i)
+    {
+        if (t1 >= end)
+            return {};
+
+        ++t1;
+    }
+
+    auto t2 = t1;
+
+    for (int i = startIndex; i < endIndex && t2 < end; ++i)
+        ++t2;
+
+    return { t1, jmin (t2, end) };
+}
+
+StringView StringView::substring (int startIndex) const noexcept
+{
+    return substring (startIndex, std::numeric_limits<int>::max());
+}
+
+StringView StringView::upToFirstOccurrenceOf (StringView sub, bool includeSubString, bool ignoreCase) const noexcept
+{
+    auto found = find (sub, ignoreCase);
+
+    if (found == end && sub.isNotEmpty())
+        return *this;
+
+    if (includeSubString)
+        found = ignoreCase ? found + sub.length()
+                           : CharPointerType (addBytesToPointer (found.getAddress(), sub.getNumBytes()));
+
+    return { start, found };
+}
+
+StringView StringView::fromFirstOccurrenceOf (StringView sub, bool includeSubString, bool ignoreCase) const noexcept
+{
+    auto found = find (sub, ignoreCase);
+
+    if (found == end && sub.isNotEmpty())
+        return {};
+
+    if (! includeSubString)
+        found = ignoreCase ? found + sub.length()
+                           : CharPointerType (addBytesToPointer (found.getAddress(), sub.getNumBytes()));
+
+    return { found, end };
+}
+
+StringView StringView::trim() const noexcept
+{
+    return trimStart().trimEnd();
+}
+
+StringView StringView::trimStart() const noexcept
+{
+    auto s = start;
+
+    while (s < end && s.isWhitespace())
+        ++s;
+
+    return { s, end };
+}
+
+StringView StringView::trimEnd() const noexcept
+{
+    auto e = end;
+
+    while (e > start)
+    {
+        if (! (--e).isWhitespace())
+        {
+            ++e;
+            break;
+        }
+    }
+
+    return { start, e };
+}
+
+static bool isQuoteCharacterInView (juce_wchar c) noexcept
+{
+    return c == '"' || c == '\'';
+}
+
+StringView StringView::unquoted() const noexcept
+{
+    if (isEmpty() || ! isQuoteCharacterInView (*start))
+        return *this;
+
+    auto s = start + 1;
+    auto e = end;
+
+    if (e > s && isQuoteCharacterInView (*(e - 1)))
+        --e;
+
+    return { s, jmax (s, e) };
+}
+
+//==============================================================================
+template <typename IntType>
+static IntType parseIntegerInView (StringView::CharPointerType s, StringView::CharPointerType end) noexcept
+{
+    using UIntType = typename std::make_unsigned<IntType>::type;
+
+    while (s < end && s.isWhitespace())
+        ++s;
+
+    const bool isNeg = s < end && *s == '-';
+
+    if (isNeg)
+        ++s;
+
+    UIntType v = 0;
+
+    while (s < end)
+    {
+        auto c = s.getAndAdvance();
+
+        if (c >= '0' && c <= '9')
+            v = v * 10 + (UIntType) (c - '0');
+        else
+            break;
+    }
+
+    return isNeg ? - (IntType) v : (IntType) v;
+}
+
+int StringView::getIntValue() const noexcept
+{
+    return parseIntegerInView<int> (start, end);
+}
+
+int64 StringView::getLargeIntValue() const noexcept
+{
+    return parseIntegerInView<int64> (start, end);
+}
+
+double StringView::getDoubleValue() const noexcept
+{
+    // The double parser needs a null-terminated string, so the text gets copied into a
+    // local buffer. A number that's too long to fit is rare enough to do the slow way.
+    char buffer[64];
+    size_t numBytes = 0;
+
+    for (auto p = start; p < end;)
+    {
+        auto c = p.getAndAdvance();
+
+        if (c <= 0 || c >= 0x80)
+            break;
+
+        if (numBytes == sizeof (buffer) - 1)
+            return toString().getDoubleValue();
+
+        buffer[numBytes++] = (char) c;
+    }
+
+    buffer[numBytes] = 0;
+    return CharacterFunctions::getDoubleValue (CharPointer_ASCII (buffer));
+}
+
+//==============================================================================
+StringTokeniser::StringTokeniser (StringView text, StringRef breakCharacters, StringRef quoteCharacters) noexcept
+    : current (text.getStart()), textEnd (text.getEnd()),
+      breakChars (breakCharacters), quoteChars (quoteCharacters),
+      finished (text.isEmpty())
+{
+}
+
+StringTokeniser::CharacterSet::CharacterSet (StringRef characters) noexcept
+    : chars (characters)
+{
+    // Membership of ASCII characters is tested with a bitmap rather than
+    // searching the string for every character of the text
+    for (auto t = chars.text; ! t.isEmpty();)
+    {
+        auto c = (uint32) t.getAndAdvance();
+
+        if (c < 128)
+            asciiBits[c >> 5] |= 1u << (c & 31);
+        else
+            hasNonASCII = true;
+    }
+}
+
+bool StringTokeniser::CharacterSet::contains (juce_wchar c) const noexcept
+{
+    if ((uint32) c < 128)
+        return (asciiBits[(uint32) c >> 5] & (1u << ((uint32) c & 31))) != 0;
+
+    return hasNonASCII && chars.text.indexOf (c) >= 0;
+}
+
+StringView::CharPointerType StringTokeniser::findEndOfToken (StringView::CharPointerType t) const noexcept
+{
+    juce_wchar currentQuoteChar = 0;
+
+    while (t < textEnd)
+    {
+        auto tokenEnd = t;
+        auto c = t.getAndAdvance();
+
+        if (currentQuoteChar == 0 && breakChars.contains (c))
+            return tokenEnd;
+
+        if (quoteChars.contains (c))
+        {
+            if (currentQuoteChar == 0)
+                currentQuoteChar = c;
+            else if (currentQuoteChar == c)
+                currentQuoteChar = 0;
+        }
+    }
+
+    return textEnd;
+}
+
+bool StringTokeniser::next (StringView& token) noexcept
+{
+    if (finished)
+        return false;
+
+    auto tokenEnd = findEndOfToken (current);
+    token = StringView (current, tokenEnd);
+
+    if (tokenEnd < textEnd)
+        current = tokenEnd + 1;
+    else
+        finished = true;
+
+    return true;
+}
+
+int StringTokeniser::countRemainingTokens() const noexcept
+{
+    auto copy = *this;
+    int num = 0;
+
+    for (StringView token; copy.next (token);)
+        ++num;
+
+    return num;
+}
+
+//==============================================================================
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class StringViewTests  : public UnitTest
+{
+public:
+    StringViewTests()
+        : UnitTest ("StringView", UnitTestCategories::text)
+    {}
+
+    void runTest() override
+    {
+        beginTest ("Views");
+        {
+            const String text ("  first, \"second, part\" ,third  ");
+            StringView view (text);
+
+            expectEquals (view.length(), text.length());
+            expect (view.toString() == text);
+            expect (view.trim() == "first, \"second, part\" ,third");
+            expect (view.trimStart().startsWith ("first"));
+            expect (view.trimEnd().endsWith ("third"));
+            expect (StringView().isEmpty());
+            expect (StringView ("  \t ").trim().isEmpty());
+
+            expectEquals (view.indexOfChar (','), 7);
+            expectEquals (view.indexOf ("second"), 10);
+            expectEquals (view.indexOf ("SECOND", true), 10);
+            expectEquals (view.indexOf ("fourth"), -1);
+            expectEquals (view.indexOf (""), 0);
+            expect (view.contains ("part"));
+            expect (! view.contains ("PART"));
+
+            expect (view.substring (2, 7) == "first");
+            expect (view.substring (28) == "rd  ");
+            expect (view.substring (5, 2).isEmpty());
+            expect (view.substring (100).isEmpty());
+            expect (view.upToFirstOccurrenceOf (",", false, false) == "  first");
+            expect (view.upToFirstOccurrenceOf (",", true, false) == "  first,");
+            expect (view.upToFirstOccurrenceOf ("xyz", false, false) == view);
+            expect (view.fromFirstOccurrenceOf ("PART\"", false, true) == " ,third  ");
+            expect (view.fromFirstOccurrenceOf ("xyz", true, false).isEmpty());
+
+            expect (StringView ("\"quoted\"").unquoted() == "quoted");
+            expect (StringView ("'half").unquoted() == "half");
+            expect (StringView ("\"").unquoted().isEmpty());
+            expect (StringView ("ABC").equalsIgnoreCase ("abc"));
+            expect (! StringView ("ABC").equalsIgnoreCase ("abcd"));
+
+            const String unicode (CharPointer_UTF8 ("caf\xc3\xa9 cr\xc3\xa8me"));
+            StringView u (unicode);
+            expectEquals (u.length(), 10);
+            expectEquals (u.indexOf (CharPointer_UTF8 ("cr\xc3\xa8")), 5);
+            expect (u.substring (3, 6).toString() == unicode.substring (3, 6));
+        }
+
+        beginTest ("Numbers");
+        {
+            const String text ("12345678901234,-42,  3.5e2,abc,0.25");
+            StringTokeniser tokeniser (text, ",");
+            StringView token;
+
+            expect (tokeniser.next (token));
+            expectEquals (token.getLargeIntValue(), (int64) 12345678901234);
+            expect (tokeniser.next (token));
+            expectEquals (token.getIntValue(), -42);
+            expect (tokeniser.next (token));
+            expectEquals (token.getDoubleValue(), 350.0);
+            expect (tokeniser.next (token));
+            expectEquals (token.getIntValue(), 0);
+            expect (tokeniser.next (token));
+            expectEquals (token.getFloatValue(), 0.25f);
+            expect (! tokeniser.next (token));
+
+            // The number parsers mustn't read beyond the end of a view
+            const String digits ("123456");
+            StringView d (digits);
+            expectEquals (d.substring (0, 3).getIntValue(), 123);
+            expectEquals (d.substring (1, 4).getDoubleValue(), 234.0);
+        }
+
+        beginTest ("Tokeniser");
+        {
+            struct Example
+            {
+                const char* text;
+                const char* breaks;
+                const char* quotes;
+                StringArray expected;
+            };
+
+            const Example examples[] =
+            {
+                { "",                           ",",    "",     {} },
+                { "a",                          ",",    "",     { "a" } },
+                { ",",                          ",",    "",     { "", "" } },
+                { "a,b,,c,",                    ",",    "",     { "a", "b", "", "c", "" } },
+                { "one two three",              ",",    "",     { "one two three" } },
+                { "one two three",              " \t",  "",     { "one", "two", "three" } },
+                { " a  b\t\"c d\" ",            " \t",  "\"",   { "", "a", "", "b", "\"c d\"", "" } },
+                { " a  b\t\"c d\" ",            " \t",  "",     { "", "a", "", "b", "\"c", "d\"", "" } },
+                { "\"unterminated, quote",      ",",    "\"",   { "\"unterminated, quote" } },
+                { "\"unterminated, quote",      ",",    "",     { "\"unterminated", " quote" } },
+                { "x,'y,z',\"w\"",              ",",    "\"'",  { "x", "'y,z'", "\"w\"" } },
+                { "x,'y,z',\"w\"",              ",",    "\"",   { "x", "'y", "z'", "\"w\"" } },
+                { "x,'y,z',\"w\"",              ",'",   "\"'",  { "x", "", "y", "z", "", "\"w\"" } },
+                { "\"a,'b\",c'd,e'",            ",",    "\"'",  { "\"a,'b\"", "c'd,e'" } }
+            };
+
+            for (auto& example : examples)
+            {
+                StringArray actual;
+
+                for (auto token : StringTokeniser (example.text, example.breaks, example.quotes))
+                    actual.add (token.toString());
+
+                expect (actual == example.expected, "Tokenising: " + String (example.text).quoted());
+                expectEquals (StringTokeniser (example.text, example.breaks, example.quotes).countRemainingTokens(),
+                              example.expected.size());
+            }
+
+            const String line ("a;b;c");
+            StringTokeniser tokeniser (StringView (line).substring (0, 3), ";");
+            int count = 0;
+
+            for (auto token : tokeniser)
+            {
+                expect (token == "a" || token == "b");
+                ++count;
+            }
+
+            expectEquals (count, 2);
+        }
+    }
+};
+
+static StringViewTests stringViewTests;
+
+#endif
+
+} // namespace juce
@@ -0,0 +1,279 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2020 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   To use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    A non-owning reference to a range of characters inside a string.
+
+    Like a StringRef, a StringView doesn't allocate any memory or take ownership of
+    the text it refers to, but unlike a StringRef it has an explicit end, so it can
+    refer to a section in the middle of a larger string. That means that a string can
+    be split up and its pieces examined, compared and parsed without having to create
+    a new String for each of them.
+
+    @code
+    for (auto field : StringTokeniser (csvLine, ",", "\""))
+    {
+        if (field.trim().unquoted() == "total")
+            ...
+
+        auto value = field.getDoubleValue();    // no String is created here
+    }
+    @endcode
+
+    You must make sure that the text a StringView refers to isn't modified or deleted
+    while the view is still in use. In particular, be careful not to create one from a
+    temporary String object. Call toString() when you need to keep a copy of the text.
+
+    @see StringTokeniser, StringRef, String
+
+    @tags{Core}
+*/
+class JUCE_API  StringView  final
+{
+public:
+    using CharPointerType = String::CharPointerType;
+
+    //==============================================================================
+    /** Creates an empty view. */
+    StringView() noexcept;
+
+    /** Creates a view of the characters between two pointers into the same string. */
+    StringView (CharPointerType start, CharPointerType end) noexcept;
+
+    /** Creates a view of the whole of a null-terminated string. */
+    StringView (StringRef text) noexcept;
+
+    /** Creates a view of the whole of a null-terminated string. */
+    StringView (CharPointerType text) noexcept;
+
+    /** Creates a view of the whole of a String. */
+    StringView (const String& text) noexcept;
+
+    /** Creates a view of the whole of a null-terminated string literal. */
+    StringView (const char* text) noexcept;
+
+    //==============================================================================
+    /** Returns a pointer to the first character in the view. */
+    CharPointerType getStart() const noexcept                   { return start; }
+
+    /** Returns a pointer to the position just after the last character in the view.
+        Note that this is not necessarily a null character.
+    */
+    CharPointerType getEnd() const noexcept                     { return end; }
+
+    /** Returns true if the view contains no characters. */
+    bool isEmpty() const noexcept                               { return start == end; }
+
+    /** Returns true if the view contains some characters. */
+    bool isNotEmpty() const noexcept                            { return start != end; }
+
+    /** Returns the number of characters in the view. */
+    int length() const noexcept;
+
+    /** Returns the number of bytes that the characters in the view occupy. */
+    size_t getNumBytes() const noexcept;
+
+    /** Creates a String containing a copy of these characters. */
+    String toString() const;
+
+    //==============================================================================
+    /** Case-sensitive comparison of two views. */
+    bool operator== (StringView other) const noexcept;
+
+    /** Case-sensitive comparison of two views. */
+    bool operator!= (StringView other) const noexcept          { return ! operator== (other); }
+
+    /** Case-insensitive comparison of two views. */
+    bool equalsIgnoreCase (StringView other) const noexcept;
+
+    /** Returns true if the view begins with the given text. */
+    bool startsWith (StringView text) const noexcept;
+
+    /** Returns true if the view ends with the given text. */
+    bool endsWith (StringView text) const noexcept;
+
+    //==============================================================================
+    /** Returns the index of the first occurrence of a character, or -1 if it isn't found. */
+    int indexOfChar (juce_wchar characterToLookFor) const noexcept;
+
+    /** Returns the index of the first occurrence of some text, or -1 if it isn't found.
+        If the text to look for is empty, this returns 0.
+    */
+    int indexOf (StringView textToLookFor, bool ignoreCase = false) const noexcept;
+
+    /** Returns true if the view contains the given text. */
+    bool contains (StringView textToLookFor, bool ignoreCase = false) const noexcept;
+
+    //==============================================================================
+    /** Returns a section of the view, in the same way as String::substring(). */
+    StringView substring (int startIndex, int endIndex) const noexcept;
+
+    /** Returns a section of the view, in the same way as String::substring(). */
+    StringView substring (int startIndex) const noexcept;
+
+    /** Returns the part of the view that comes before the first occurrence of a
+        substring, in the same way as String::upToFirstOccurrenceOf().
+    */
+    StringView upToFirstOccurrenceOf (StringView substringToEndWith,
+                                      bool includeSubStringInResult,
+                                      bool ignoreCase) const noexcept;
+
+    /** Returns the part of the view that comes after the first occurrence of a
+        substring, in the same way as String::fromFirstOccurrenceOf().
+    */
+    StringView fromFirstOccurrenceOf (StringView substringToStartFrom,
+                                      bool includeSubStringInResult,
+                                      bool ignoreCase) const noexcept;
+
+    /** Returns a view with any whitespace removed from its start and end. */
+    StringView trim() const noexcept;
+
+    /** Returns a view with any whitespace removed from its start. */
+    StringView trimStart() const noexcept;
+
+    /** Returns a view with any whitespace removed from its end. */
+    StringView trimEnd() const noexcept;
+
+    /** Removes a pair of quotation marks from around the text, in the same way as
+        String::unquoted().
+    */
+    StringView unquoted() const noexcept;
+
+    //==============================================================================
+    /** Reads the value of the text as a decimal integer, in the same way as
+        String::getIntValue(), but without reading beyond the end of the view.
+    */
+    int getIntValue() const noexcept;
+
+    /** Reads the value of the text as a decimal 64-bit integer, in the same way as
+        String::getLargeIntValue(), but without reading beyond the end of the view.
+    */
+    int64 getLargeIntValue() const noexcept;
+
+    /** Reads the value of the text as a double, in the same way as
+        String::getDoubleValue(), but without reading beyond the end of the view.
+    */
+    double getDoubleValue() const noexcept;
+
+    /** Reads the value of the text as a float, in the same way as
+        String::getFloatValue(), but without reading beyond the end of the view.
+    */
+    float getFloatValue() const noexcept                        { return (float) getDoubleValue(); }
+
+private:
+    //==============================================================================
+    CharPointerType start, end;
+
+    CharPointerType find (StringView, bool ignoreCase) const noexcept;
+};
+
+//==============================================================================
+/**
+    Splits a string into tokens, returning each one as a StringView.
+
+    This breaks up the text in exactly the same way as StringArray::addTokens(),
+    but doesn't create a String for each token, so it's much faster when you only
+    need to look at the tokens rather than keep them.
+
+    You can either call next() repeatedly, or use it in a range-based for loop:
+    @code
+    for (auto token : StringTokeniser (line, ",", "\""))
+        total += token.getIntValue();
+    @endcode
+
+    As with StringView, the text that is being tokenised and the strings of break
+    and quote characters must stay valid and unmodified while the tokeniser and its
+    tokens are in use.
+
+    @see StringView, StringArray::addTokens
+
+    @tags{Core}
+*/
+class JUCE_API  StringTokeniser  final
+{
+public:
+    //==============================================================================
+    /** Creates a tokeniser for some text.
+
+        @param textToTokenise       the text to split up
+        @param breakCharacters      a string of characters, any of which will be considered
+                                    to be a token delimiter.
+        @param quoteCharacters      if this string isn't empty, it defines a set of characters
+                                    which are treated as quotes. Any text occurring
+                                    between quotes is not broken up into tokens.
+    */
+    StringTokeniser (StringView textToTokenise,
+                     StringRef breakCharacters,
+                     StringRef quoteCharacters = {}) noexcept;
+
+    /** Moves on to the next token.
+        If there is another token, this sets the view to refer to it and returns true,
+        otherwise it returns false.
+    */
+    bool next (StringView& token) noexcept;
+
+    /** Returns the number of tokens that remain, without moving on. */
+    int countRemainingTokens() const noexcept;
+
+    //==============================================================================
+    /** @internal */
+    struct Iterator
+    {
+        Iterator& operator++() noexcept                     { valid = owner->next (token); return *this; }
+        StringView operator*() const noexcept               { return token; }
+        bool operator!= (const Iterator& other) const noexcept  { return valid != other.valid; }
+
+        StringTokeniser* owner;
+        StringView token;
+        bool valid;
+    };
+
+    /** Begins iterating the tokens. Note that this moves the tokeniser on to its first token. */
+    Iterator begin() noexcept                               { Iterator i { this, {}, false }; return ++i; }
+
+    /** Marks the end of the tokens. */
+    Iterator end() noexcept                                 { return { this, {}, false }; }
+
+private:
+    //==============================================================================
+    struct CharacterSet
+    {
+        CharacterSet (StringRef) noexcept;
+        bool contains (juce_wchar) const noexcept;
+
+        StringRef chars;
+        uint32 asciiBits[4] = {};
+        bool hasNonASCII = false;
+    };
+
+    StringView::CharPointerType current, textEnd;
+    CharacterSet breakChars, quoteChars;
+    bool finished;
+
+    StringView::CharPointerType findEndOfToken (StringView::CharPointerType) const noexcept;
+};
+
+} // namespace juce
@@ -0,0 +1,364 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2020 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   To use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+struct RealtimeWorkerGroup::Worker  : public Thread
+{
+    Worker (RealtimeWorkerGroup& g, int coreToUse, double runtime)
+        : Thread ("Realtime worker"), owner (g), requestedCore (coreToUse), runtimeMs (runtime)
+    {
+    }
+
+    void run() override
+    {
+        // Linux won't give SCHED_DEADLINE to a thread whose affinity is narrower than its
+        // root domain, so a thread is only pinned if it couldn't get deadline scheduling
+        if (runtimeMs > 0 && setCurrentThreadDeadline (runtimeMs, owner.periodMs))
+        {
+            policy = (int) SchedulingPolicy::deadline;
+        }
+        else
+        {
+            if (runtimeMs > 0)
+            {
+                DBG ("RealtimeWorkerGroup: SCHED_DEADLINE isn't available, so falling back to the audio thread's policy");
+            }
+
+            if (requestedCore >= 0 && pinCurrentThreadToCore (requestedCore))
+                core = requestedCore;
+
+            updatePolicy();
+        }
+
+        int appliedGeneration = 0;
+
+        while (! threadShouldExit())
+        {
+            wakeUp.wait (-1);
+
+            if (threadShouldExit())
+                break;
+
+            if (policy != (int) SchedulingPolicy::deadline)
+            {
+                auto generation = owner.callerSchedulingGeneration.load();
+
+                if (generation != appliedGeneration)
+                {
+                    appliedGeneration = generation;
+
+                    if (setCurrentThreadScheduling (owner.callerPolicy, owner.callerPriority))
+                        updatePolicy();
+                }
+            }
+
+            int64 cycleStart = 0;
+
+            if (owner.runJobs (cycleStart) > 0)
+            {
+                auto elapsed = Time::getHighResolutionTicks() - cycleStart;
+
+                ++numCycles;
+
+                if (elapsed > owner.periodTicks)
+                    ++numOverruns;
+
+                if (elapsed > longestCycleTicks)
+                    longestCycleTicks = elapsed;
+            }
+        }
+    }
+
+    void updatePolicy()
+    {
+        int nativePolicy = 0, nativePriority = 0;
+
+        if (getCurrentThreadScheduling (nativePolicy, nativePriority))
+            policy = (int) toSchedulingPolicy (nativePolicy);
+    }
+
+    RealtimeWorkerGroup& owner;
+    const int requestedCore;
+    const double runtimeMs;
+    WaitableEvent wakeUp;
+
+    std::atomic<int> policy { (int) SchedulingPolicy::normal }, core { -1 };
+    std::atomic<int64> numCycles { 0 }, numOverruns { 0 }, longestCycleTicks { 0 };
+
+    JUCE_DECLARE_NON_COPYABLE (Worker)
+};
+
+//==============================================================================
+RealtimeWorkerGroup::RealtimeWorkerGroup (int numWorkers, const Options& options)
+{
+    jassert (options.sampleRate > 0 && options.blockSize > 0);
+
+    periodMs = 1000.0 * jmax (1, options.blockSize) / jmax (1.0, options.sampleRate);
+    periodTicks = (int64) (periodMs * 0.001 * (double) Time::getHighResolutionTicksPerSecond());
+
+    auto cores = options.cores;
+
+    if (cores.isEmpty() && options.pinToIsolatedCores)
+        cores = getIsolatedCores();
+
+    auto runtimeMs = options.useDeadlineScheduling ? periodMs * jlimit (0.01, 1.0, options.cpuProportion) : 0.0;
+
+    for (int i = 0; i < numWorkers; ++i)
+        workers.add (new Worker (*this, cores.isEmpty() ? -1 : cores[i % cores.size()], runtimeMs));
+
+    for (auto* w : workers)
+        w->startThread (Thread::realtimeAudioPriority);
+}
+
+RealtimeWorkerGroup::~RealtimeWorkerGroup()
+{
+    // Don't delete the group while it's in the middle of a call to performInParallel()!
+    jassert (! isPerformingJobs);
+
+    for (auto* w : workers)
+    {
+        w->signalThreadShouldExit();
+        w->wakeUp.signal();
+    }
+
+    for (auto* w : workers)
+        w->waitForThreadToExit (-1);
+}
+
+int RealtimeWorkerGroup::getNumWorkers() const noexcept
+{
+    return workers.size();
+}
+
+//==============================================================================
+void RealtimeWorkerGroup::captureCallerScheduling() noexcept
+{
+    int policy = 0, priority = 0;
+
+    if (getCurrentThreadScheduling (policy, priority)
+         && (policy != callerPolicy || priority != callerPriority))
+    {
+        callerPolicy = policy;
+        callerPriority = priority;
+        ++callerSchedulingGeneration;
+    }
+}
+
+int RealtimeWorkerGroup::runJobs (int64& cycleStart) noexcept
+{
+    int numRun = 0;
+    auto counter = jobCounter.load();
+
+    for (;;)
+    {
+        auto index = (int) (counter & 0xffffffff);
+
+        if (index >= numJobsInCycle)
+            return numRun;
+
+        // This fails if another thread has taken the job, or if a worker that woke up late
+        // is looking at a cycle that has already finished, in which case the counter is
+        // reloaded and checked again.
+        if (! jobCounter.compare_exchange_weak (counter, counter + 1))
+            continue;
+
+        ++counter;
+
+        if (numRun++ == 0)
+            cycleStart = cycleStartTicks;
+
+        currentJobCallback (currentJobFunction, index);
+        ++numJobsCompleted;
+    }
+}
+
+void RealtimeWorkerGroup::performJobs (int numJobs, void* function, JobCallback callback)
+{
+    // Only one thread can call this at a time!
+    jassert (! isPerformingJobs);
+
+    if (numJobs <= 0)
+        return;
+
+    if (numJobs == 1 || workers.isEmpty())
+    {
+        for (int i = 0; i < numJobs; ++i)
+            callback (function, i);
+
+        return;
+    }
+
+    isPerformingJobs = true;
+    captureCallerScheduling();
+
+    currentJobFunction = function;
+    currentJobCallback = callback;
+    cycleStartTicks = Time::getHighResolutionTicks();
+    numJobsCompleted = 0;
+    numJobsInCycle = numJobs;
+    jobCounter = ((jobCounter.load() >> 32) + 1) << 32;
+
+    for (int i = 0; i < jmin (workers.size(), numJobs - 1); ++i)
+        workers.getUnchecked (i)->wakeUp.signal();
+
+    int64 cycleStart = 0;
+    runJobs (cycleStart);
+
+    // The workers may be sharing a core with this thread at the same priority,
+    // so after a short spin, this needs to yield to let them finish their jobs.
+    // Any workers that haven't woken up by then will find nothing left to do.
+    for (int spins = 0; numJobsCompleted.load() < numJobs; ++spins)
+        if (spins > 64)
+            Thread::yield();
+
+    isPerformingJobs = false;
+}
+
+//==============================================================================
+RealtimeWorkerGroup::WorkerStatistics RealtimeWorkerGroup::getWorkerStatistics (int workerIndex) const
+{
+    WorkerStatistics stats;
+
+    if (auto* w = workers[workerIndex])
+    {
+        stats.policy = (SchedulingPolicy) w->policy.load();
+        stats.core = w->core;
+        stats.numCycles = w->numCycles;
+        stats.numOverruns = w->numOverruns;
+        stats.longestCycleMs = Time::highResolutionTicksToSeconds (w->longestCycleTicks) * 1000.0;
+    }
+
+    return stats;
+}
+
+void RealtimeWorkerGroup::resetStatistics()
+{
+    for (auto* w : workers)
+    {
+        w->numCycles = 0;
+        w->numOverruns = 0;
+        w->longestCycleTicks = 0;
+    }
+}
+
+//==============================================================================
+#if ! JUCE_LINUX
+Array<int> RealtimeWorkerGroup::getIsolatedCores()                                  { return {}; }
+bool RealtimeWorkerGroup::setCurrentThreadDeadline (double, double)                 { return false; }
+bool RealtimeWorkerGroup::setCurrentThreadScheduling (int, int)                     { return false; }
+bool RealtimeWorkerGroup::getCurrentThreadScheduling (int&, int&)                   { return false; }
+RealtimeWorkerGroup::SchedulingPolicy RealtimeWorkerGroup::toSchedulingPolicy (int) { return SchedulingPolicy::normal; }
+bool RealtimeWorkerGroup::pinCurrentThreadToCore (int)                              { return false; }
+#endif
+
+
+//==============================================================================
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class RealtimeWorkerGroupTests  : public UnitTest
+{
+public:
+    RealtimeWorkerGroupTests()
+        : UnitTest ("RealtimeWorkerGroup", UnitTestCategories::threads)
+    {}
+
+    void runTest() override
+    {
+        RealtimeWorkerGroup::Options options;
+        options.sampleRate = 48000.0;
+        options.blockSize = 480;
+
+        beginTest ("Jobs");
+        {
+            RealtimeWorkerGroup group (3, options);
+            expectEquals (group.getNumWorkers(), 3);
+            expectWithinAbsoluteError (group.getPeriodMs(), 10.0, 0.001);
+
+            for (int numJobs : { 0, 1, 2, 7, 100 })
+            {
+                Array<int> counts;
+                counts.insertMultiple (0, 0, numJobs);
+
+                for (int cycle = 0; cycle < 50; ++cycle)
+                    group.performInParallel (numJobs, [&counts] (int index) { counts.getReference (index)++; });
+
+                for (auto c : counts)
+                    expectEquals (c, 50);
+            }
+
+            // The calling thread also runs jobs, so with jobs as short as the ones above it
+            // may well have done them all before any of the workers woke up
+            group.performInParallel (12, [] (int) { Thread::sleep (2); });
+
+            int64 totalCycles = 0;
+
+            for (int i = 0; i < group.getNumWorkers(); ++i)
+            {
+                auto stats = group.getWorkerStatistics (i);
+                totalCycles += stats.numCycles;
+                expect (stats.numOverruns <= stats.numCycles);
+            }
+
+            expect (totalCycles > 0);
+
+            group.resetStatistics();
+            expectEquals (group.getWorkerStatistics (0).numCycles, (int64) 0);
+        }
+
+        beginTest ("Callables");
+        {
+            RealtimeWorkerGroup group (2, options);
+            std::atomic<int> total { 0 };
+
+            const int64 a = 1, b = 2, c = 3;
+            group.performInParallel (10, [&total, a, b, c] (int index) { total += (int) (a + b + c) * index; });
+            expectEquals (total.load(), 6 * 45);
+
+            const std::function<void (int)> function = [&total] (int) { ++total; };
+            group.performInParallel (10, function);
+            expectEquals (total.load(), 6 * 45 + 10);
+        }
+
+        beginTest ("Overruns");
+        {
+            options.blockSize = 48;
+            RealtimeWorkerGroup group (1, options);
+
+            for (int cycle = 0; cycle < 3; ++cycle)
+                group.performInParallel (2, [] (int) { Thread::sleep (5); });
+
+            auto stats = group.getWorkerStatistics (0);
+            expectEquals (stats.numCycles, (int64) 3);
+            expectEquals (stats.numOverruns, (int64) 3);
+            expect (stats.longestCycleMs >= 1.0);
+        }
+    }
+};
+
+static RealtimeWorkerGroupTests realtimeWorkerGroupTests;
+
+#endif
+
+} // namespace juce
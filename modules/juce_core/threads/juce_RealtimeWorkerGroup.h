@@ -0,0 +1,197 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2020 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   To use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    A set of real-time worker threads that help an audio callback to get its work done.
+
+    If an audio callback wants to split its processing across several cores, the
+    threads doing that work need to be scheduled just as strictly as the callback's
+    own thread, otherwise one late helper will make the whole callback miss its
+    deadline. This class creates a group of such threads and lets the callback hand
+    them jobs.
+
+    The workers are given a scheduling policy that's derived from the audio settings:
+    on Linux they'll try to use SCHED_DEADLINE, with a period that matches the length
+    of an audio block. If that isn't allowed (it usually needs extra privileges, and
+    can't be combined with pinning the threads to particular cores), they'll use the
+    same real-time policy and priority as the thread that calls performInParallel(),
+    i.e. the audio device's callback thread. Workers that aren't using deadline
+    scheduling can also be pinned to a set of cores, and by default will use any cores
+    that the kernel has isolated from the general scheduler (with the isolcpus boot
+    option). Use getWorkerStatistics() to find out which policy each worker ended up
+    with.
+
+    @code
+    void audioDeviceAboutToStart (AudioIODevice* device) override
+    {
+        RealtimeWorkerGroup::Options options;
+        options.sampleRate = device->getCurrentSampleRate();
+        options.blockSize  = device->getCurrentBufferSizeSamples();
+
+        workers = std::make_unique<RealtimeWorkerGroup> (3, options);
+    }
+
+    void audioDeviceIOCallback (...) override
+    {
+        workers->performInParallel (voices.size(), [this] (int index) { voices[index]->render(); });
+    }
+    @endcode
+
+    On other platforms, the workers just run with Thread::realtimeAudioPriority.
+
+    @tags{Core}
+*/
+class JUCE_API  RealtimeWorkerGroup
+{
+public:
+    //==============================================================================
+    /** Describes how the worker threads should be scheduled. */
+    struct Options
+    {
+        /** The sample rate of the audio callback that the workers will be helping. */
+        double sampleRate = 44100.0;
+
+        /** The number of samples in each block of the audio callback. */
+        int blockSize = 512;
+
+        /** When using deadline scheduling, the proportion of each block's period
+            that each worker will reserve for itself.
+        */
+        double cpuProportion = 0.5;
+
+        /** If true, the workers will attempt to use SCHED_DEADLINE on Linux. */
+        bool useDeadlineScheduling = true;
+
+        /** The indexes of the cores that the workers should be pinned to.
+            Workers are assigned to these in turn. If this is empty and pinToIsolatedCores
+            is true, the isolated cores will be used.
+
+            Linux doesn't allow a deadline-scheduled thread to be restricted to some of
+            the cores, so this only applies to workers that couldn't get SCHED_DEADLINE,
+            or when useDeadlineScheduling is false.
+        */
+        Array<int> cores;
+
+        /** If true and no cores have been given, the workers are pinned to any cores
+            that the kernel has isolated.
+        */
+        bool pinToIsolatedCores = true;
+    };
+
+    /** The scheduling policies that a worker can end up with. */
+    enum class SchedulingPolicy
+    {
+        normal,
+        roundRobin,
+        fifo,
+        deadline
+    };
+
+    /** Some measurements of a worker's behaviour. */
+    struct WorkerStatistics
+    {
+        SchedulingPolicy policy = SchedulingPolicy::normal; /**< The policy the worker got, which won't be deadline if that wasn't allowed. */
+        int core = -1;                  /**< The core the worker is pinned to, or -1 if it can run anywhere. */
+        int64 numCycles = 0;            /**< The number of performInParallel() calls the worker took part in. */
+        int64 numOverruns = 0;          /**< The number of those where it finished after the end of the block's period. */
+        double longestCycleMs = 0;      /**< The longest time from the start of a cycle until the worker finished. */
+    };
+
+    //==============================================================================
+    /** Creates and starts a group of worker threads. */
+    RealtimeWorkerGroup (int numWorkers, const Options& options);
+
+    /** Destructor. This stops the workers, so mustn't be called during performInParallel(). */
+    ~RealtimeWorkerGroup();
+
+    //==============================================================================
+    /** Calls a function for each index from 0 to numJobs - 1, sharing the jobs out between
+        the workers and the calling thread, and returns when they've all been completed.
+
+        The job can be any callable object that takes an int. It's called through a
+        pointer rather than being copied, so this doesn't allocate any memory or take any
+        locks, and can be called from an audio callback. Only one thread can call it at
+        a time.
+    */
+    template <typename JobFunction>
+    void performInParallel (int numJobs, JobFunction&& job)
+    {
+        using FunctionType = typename std::remove_reference<JobFunction>::type;
+
+        performJobs (numJobs, (void*) std::addressof (job),
+                     [] (void* function, int jobIndex) { (*static_cast<FunctionType*> (function)) (jobIndex); });
+    }
+
+    /** Returns the number of worker threads. */
+    int getNumWorkers() const noexcept;
+
+    /** Returns the length of an audio block, i.e. the deadline for each cycle. */
+    double getPeriodMs() const noexcept             { return periodMs; }
+
+    /** Returns some statistics about one of the workers. */
+    WorkerStatistics getWorkerStatistics (int workerIndex) const;
+
+    /** Resets the workers' cycle and overrun counters. */
+    void resetStatistics();
+
+    //==============================================================================
+    /** Returns the cores that have been isolated from the kernel's general scheduler.
+        This is only implemented on Linux, and returns an empty array elsewhere.
+    */
+    static Array<int> getIsolatedCores();
+
+private:
+    //==============================================================================
+    struct Worker;
+    OwnedArray<Worker> workers;
+    double periodMs;
+    int64 periodTicks;
+
+    using JobCallback = void (*) (void*, int);
+
+    void* currentJobFunction = nullptr;
+    JobCallback currentJobCallback = nullptr;
+    int64 cycleStartTicks = 0;
+    std::atomic<uint64> jobCounter { 0 };   // the cycle number in the top 32 bits, the next job index in the bottom 32
+    std::atomic<int> numJobsInCycle { 0 }, numJobsCompleted { 0 };
+    std::atomic<bool> isPerformingJobs { false };
+
+    std::atomic<int> callerPolicy { -1 }, callerPriority { 0 }, callerSchedulingGeneration { 0 };
+
+    void performJobs (int numJobs, void* function, JobCallback);
+    void captureCallerScheduling() noexcept;
+    int runJobs (int64& cycleStart) noexcept;
+
+    static bool setCurrentThreadDeadline (double runtimeMs, double periodMs);
+    static bool setCurrentThreadScheduling (int nativePolicy, int nativePriority);
+    static bool getCurrentThreadScheduling (int& nativePolicy, int& nativePriority);
+    static SchedulingPolicy toSchedulingPolicy (int nativePolicy);
+    static bool pinCurrentThreadToCore (int core);
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (RealtimeWorkerGroup)
+};
+
+} // namespace juce
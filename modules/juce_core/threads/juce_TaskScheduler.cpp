@@ -0,0 +1,622 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2020 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   To use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+class TaskScheduler::Task  : public ReferenceCountedObject
+{
+public:
+    using Ptr = ReferenceCountedObjectPtr<Task>;
+
+    Task (TaskScheduler& s, std::function<void()>&& f)  : owner (s), function (std::move (f)) {}
+
+    TaskScheduler& owner;
+    std::function<void()> function;
+
+    // This starts at 1 so that the task can't be scheduled until all of its
+    // dependencies have been added.
+    std::atomic<int> numUnfinishedDependencies { 1 };
+    std::atomic<bool> finished { false };
+
+    SpinLock dependentsLock;
+    Array<Ptr> dependents;
+
+    JUCE_DECLARE_NON_COPYABLE (Task)
+};
+
+//==============================================================================
+struct TaskScheduler::Worker  : public Thread
+{
+    Worker (TaskScheduler& s, int workerIndex)
+        : Thread ("Task scheduler worker"), owner (s), index (workerIndex)
+    {
+    }
+
+    void run() override
+    {
+        getCurrentWorkerForThread() = this;
+        owner.workerLoop (*this);
+        getCurrentWorkerForThread() = nullptr;
+    }
+
+    static Worker*& getCurrentWorkerForThread() noexcept
+    {
+        thread_local Worker* current = nullptr;
+        return current;
+    }
+
+    // The owning worker pushes and pops at the back of its queue, and other
+    // workers steal from the front, so they only meet when the queue is nearly empty.
+    void pushBack (Task* task)
+    {
+        task->incReferenceCount();
+
+        const SpinLock::ScopedLockType sl (queueLock);
+        queue.add (task);
+    }
+
+    Task::Ptr popBack()
+    {
+        Task* task = nullptr;
+
+        {
+            const SpinLock::ScopedLockType sl (queueLock);
+
+            if (queue.size() <= head)
+                return {};
+
+            task = queue.removeAndReturn (queue.size() - 1);
+            resetIfEmpty();
+        }
+
+        return adopt (task);
+    }
+
+    Task::Ptr popFront()
+    {
+        Task* task = nullptr;
+
+        {
+            const SpinLock::ScopedLockType sl (queueLock);
+
+            if (queue.size() <= head)
+                return {};
+
+            task = queue.getUnchecked (head++);
+
+            if (! resetIfEmpty() && head > 64 && head > queue.size() / 2)
+            {
+                queue.removeRange (0, head);
+                head = 0;
+            }
+        }
+
+        return adopt (task);
+    }
+
+    TaskScheduler& owner;
+    const int index;
+    WaitableEvent wakeUp;
+    std::atomic<bool> sleeping { false };
+
+private:
+    SpinLock queueLock;
+    Array<Task*> queue;
+    int head = 0;
+
+    bool resetIfEmpty() noexcept
+    {
+        if (head < queue.size())
+            return false;
+
+        queue.clearQuick();
+        head = 0;
+        return true;
+    }
+
+    Task::Ptr adopt (Task* task) noexcept
+    {
+        --owner.numQueuedTasks;
+        Task::Ptr p (task);
+        task->decReferenceCountWithoutDeleting();
+        return p;
+    }
+
+    JUCE_DECLARE_NON_COPYABLE (Worker)
+};
+
+//==============================================================================
+TaskScheduler::TaskHandle::TaskHandle() noexcept {}
+TaskScheduler::TaskHandle::~TaskHandle() {}
+TaskScheduler::TaskHandle::TaskHandle (const TaskHandle& other) noexcept : task (other.task) {}
+TaskScheduler::TaskHandle::TaskHandle (TaskHandle&& other) noexcept : task (std::move (other.task)) {}
+
+TaskScheduler::TaskHandle& TaskScheduler::TaskHandle::operator= (const TaskHandle& other) noexcept
+{
+    task = other.task;
+    return *this;
+}
+
+TaskScheduler::TaskHandle& TaskScheduler::TaskHandle::operator= (TaskHandle&& other) noexcept
+{
+    task = std::move (other.task);
+    return *this;
+}
+
+bool TaskScheduler::TaskHandle::isValid() const noexcept     { return task != nullptr; }
+bool TaskScheduler::TaskHandle::isFinished() const noexcept  { return task == nullptr || task->finished; }
+
+void TaskScheduler::TaskHandle::wait() const
+{
+    if (task != nullptr && ! task->finished)
+    {
+        auto t = task;
+        t->owner.runTasksUntil ([t] { return t->finished.load(); });
+    }
+}
+
+//==============================================================================
+TaskScheduler::TaskScheduler (int numberOfThreads, size_t threadStackSize)
+{
+    jassert (numberOfThreads > 0); // not much point having a scheduler without any threads!
+
+    for (int i = 0; i < jmax (1, numberOfThreads); ++i)
+        workers.add (new Worker (*this, i));
+
+    for (auto* w : workers)
+        w->startThread (threadStackSize);
+}
+
+TaskScheduler::~TaskScheduler()
+{
+    waitForAll();
+
+    for (auto* w : workers)
+    {
+        w->signalThreadShouldExit();
+        w->wakeUp.signal();
+    }
+
+    for (auto* w : workers)
+        w->waitForThreadToExit (-1);
+}
+
+int TaskScheduler::getNumThreads() const noexcept            { return workers.size(); }
+int TaskScheduler::getNumUnfinishedTasks() const noexcept    { return numUnfinishedTasks; }
+
+//==============================================================================
+TaskScheduler::TaskHandle TaskScheduler::run (std::function<void()> function)
+{
+    return run (std::move (function), Array<TaskHandle>());
+}
+
+TaskScheduler::TaskHandle TaskScheduler::run (std::function<void()> function, std::initializer_list<TaskHandle> dependencies)
+{
+    return run (std::move (function), Array<TaskHandle> (dependencies));
+}
+
+TaskScheduler::TaskHandle TaskScheduler::run (std::function<void()> function, const Array<TaskHandle>& dependencies)
+{
+    TaskHandle handle;
+    handle.task = new Task (*this, std::move (function));
+    ++numUnfinishedTasks;
+
+    for (auto& d : dependencies)
+        addDependency (*handle.task, d);
+
+    dependencyFinished (handle.task.get());
+    return handle;
+}
+
+void TaskScheduler::addDependency (Task& task, const TaskHandle& dependency)
+{
+    if (auto* d = dependency.task.get())
+    {
+        // A task can only depend on tasks that belong to the same scheduler
+        jassert (&d->owner == this);
+
+        const SpinLock::ScopedLockType sl (d->dependentsLock);
+
+        if (! d->finished)
+        {
+            ++task.numUnfinishedDependencies;
+            d->dependents.add (&task);
+        }
+    }
+}
+
+void TaskScheduler::dependencyFinished (Task* task)
+{
+    if (--(task->numUnfinishedDependencies) == 0)
+        schedule (task);
+}
+
+//==============================================================================
+TaskScheduler::Worker* TaskScheduler::getCurrentWorker() const noexcept
+{
+    auto* w = Worker::getCurrentWorkerForThread();
+    return w != nullptr && &w->owner == this ? w : nullptr;
+}
+
+void TaskScheduler::schedule (Task* task)
+{
+    auto* worker = getCurrentWorker();
+
+    if (worker == nullptr)
+        worker = workers.getUnchecked ((int) ((unsigned int) nextWorkerIndex++ % (unsigned int) workers.size()));
+
+    worker->pushBack (task);
+    ++numQueuedTasks;
+    wakeSleepingWorker();
+
+    // Threads that are waiting for something can help out with this task
+    if (numWaitingThreads > 0)
+        notifyWaitingThreads();
+}
+
+void TaskScheduler::notifyWaitingThreads()
+{
+    const std::lock_guard<std::mutex> lock (waitingLock);
+    waitingThreadsCondition.notify_all();
+}
+
+void TaskScheduler::wakeSleepingWorker()
+{
+    if (numSleepingWorkers > 0)
+    {
+        for (auto* w : workers)
+        {
+            if (w->sleeping.exchange (false))
+            {
+                w->wakeUp.signal();
+                return;
+            }
+        }
+    }
+}
+
+TaskScheduler::Task::Ptr TaskScheduler::findTask (Worker* self)
+{
+    if (self != nullptr)
+        if (auto task = self->popBack())
+            return task;
+
+    if (numQueuedTasks <= 0)
+        return {};
+
+    auto numWorkers = workers.size();
+    auto start = self != nullptr ? self->index + 1 : 0;
+
+    for (int i = 0; i < numWorkers; ++i)
+    {
+        auto* victim = workers.getUnchecked ((start + i) % numWorkers);
+
+        if (victim != self)
+            if (auto task = victim->popFront())
+                return task;
+    }
+
+    return {};
+}
+
+void TaskScheduler::execute (Task* task)
+{
+    // If there's more work about, get another worker going before starting on this one
+    if (numQueuedTasks > 0)
+        wakeSleepingWorker();
+
+    task->function();
+    task->function = nullptr;
+
+    Array<Task::Ptr> dependents;
+
+    {
+        const SpinLock::ScopedLockType sl (task->dependentsLock);
+        task->finished = true;
+        dependents.swapWith (task->dependents);
+    }
+
+    for (auto& d : dependents)
+        dependencyFinished (d.get());
+
+    if (--numUnfinishedTasks == 0 || numWaitingThreads > 0)
+        notifyWaitingThreads();
+}
+
+void TaskScheduler::runTasksUntil (const std::function<bool()>& isDone)
+{
+    auto* self = getCurrentWorker();
+
+    while (! isDone())
+    {
+        if (auto task = findTask (self))
+        {
+            execute (task.get());
+            continue;
+        }
+
+        // Once numWaitingThreads has been incremented, any task that finishes or gets
+        // queued will notify us, so nothing can slip in between the check and the wait
+        ++numWaitingThreads;
+
+        {
+            std::unique_lock<std::mutex> lock (waitingLock);
+            waitingThreadsCondition.wait (lock, [this, &isDone] { return numQueuedTasks > 0 || isDone(); });
+        }
+
+        --numWaitingThreads;
+    }
+}
+
+void TaskScheduler::waitForAll()
+{
+    runTasksUntil ([this] { return numUnfinishedTasks.load() == 0; });
+}
+
+void TaskScheduler::workerLoop (Worker& worker)
+{
+    while (! worker.threadShouldExit())
+    {
+        if (auto task = findTask (&worker))
+        {
+            execute (task.get());
+            continue;
+        }
+
+        // If a task gets queued after this check, schedule() will see that we're
+        // sleeping and signal us, and the event will stay signalled until we wait on it
+        worker.sleeping = true;
+        ++numSleepingWorkers;
+
+        if (numQueuedTasks.load() <= 0 && ! worker.threadShouldExit())
+            worker.wakeUp.wait();
+
+        worker.sleeping = false;
+        --numSleepingWorkers;
+    }
+}
+
+//==============================================================================
+void TaskScheduler::parallelFor (int startIndex, int endIndex,
+                                 const std::function<void (int, int)>& body,
+                                 int grainSize)
+{
+    auto total = endIndex - startIndex;
+
+    if (total <= 0)
+        return;
+
+    if (grainSize <= 0)
+        grainSize = jmax (1, total / (workers.size() * 4));
+
+    if (grainSize >= total)
+    {
+        body (startIndex, endIndex);
+        return;
+    }
+
+    Array<TaskHandle> chunks;
+    chunks.ensureStorageAllocated ((total + grainSize - 1) / grainSize);
+
+    for (int chunkStart = startIndex; chunkStart < endIndex;)
+    {
+        auto chunkEnd = chunkStart + jmin (grainSize, endIndex - chunkStart);
+        chunks.add (run ([&body, chunkStart, chunkEnd] { body (chunkStart, chunkEnd); }));
+        chunkStart = chunkEnd;
+    }
+
+    runTasksUntil ([&chunks]
+    {
+        for (auto& c : chunks)
+            if (! c.isFinished())
+                return false;
+
+        return true;
+    });
+}
+
+
+//==============================================================================
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class TaskSchedulerTests  : public UnitTest
+{
+public:
+    TaskSchedulerTests()
+        : UnitTest ("TaskScheduler", UnitTestCategories::threads)
+    {}
+
+    using TaskHandle = TaskScheduler::TaskHandle;
+
+    void runTest() override
+    {
+        beginTest ("Independent tasks");
+        {
+            TaskScheduler scheduler (4);
+            std::atomic<int> count { 0 };
+
+            for (int i = 0; i < 10000; ++i)
+                scheduler.run ([&count] { ++count; });
+
+            scheduler.waitForAll();
+            expectEquals (count.load(), 10000);
+            expectEquals (scheduler.getNumUnfinishedTasks(), 0);
+        }
+
+        beginTest ("Dependencies");
+        {
+            TaskScheduler scheduler (4);
+
+            for (int repeat = 0; repeat < 50; ++repeat)
+            {
+                std::atomic<int> stage { 0 };
+                std::atomic<bool> orderWasCorrect { true };
+
+                auto check = [&] (int expectedStage, int newStage)
+                {
+                    return [&stage, &orderWasCorrect, expectedStage, newStage]
+                    {
+                        if (stage.load() < expectedStage)
+                            orderWasCorrect = false;
+
+                        Thread::yield();
+                        stage = jmax (stage.load(), newStage);
+                    };
+                };
+
+                auto a = scheduler.run (check (0, 1));
+                auto b = scheduler.run (check (1, 2), { a });
+                auto c = scheduler.run (check (1, 2), { a });
+                auto d = scheduler.run (check (2, 3), { b, c });
+                d.wait();
+
+                expect (a.isFinished() && b.isFinished() && c.isFinished() && d.isFinished());
+                expect (orderWasCorrect.load());
+                expectEquals (stage.load(), 3);
+            }
+        }
+
+        beginTest ("Dependency on a finished task");
+        {
+            TaskScheduler scheduler (2);
+            auto a = scheduler.run ([] {});
+            a.wait();
+
+            bool ran = false;
+            scheduler.run ([&ran] { ran = true; }, { a, TaskHandle() }).wait();
+            expect (ran);
+        }
+
+        beginTest ("Nested tasks");
+        {
+            TaskScheduler scheduler (3);
+            std::atomic<int> count { 0 };
+
+            scheduler.run ([&]
+            {
+                Array<TaskHandle> children;
+
+                for (int i = 0; i < 100; ++i)
+                    children.add (scheduler.run ([&]
+                    {
+                        for (int j = 0; j < 10; ++j)
+                            scheduler.run ([&count] { ++count; });
+                    }));
+
+                for (auto& c : children)
+                    c.wait();
+            }).wait();
+
+            scheduler.waitForAll();
+            expectEquals (count.load(), 1000);
+        }
+
+        beginTest ("Futures");
+        {
+            TaskScheduler scheduler (2);
+
+            auto f1 = scheduler.async ([] { return 6 * 7; });
+            auto f2 = scheduler.async ([] { return String ("forty-two"); });
+
+            expectEquals (f1.get(), 42);
+            expectEquals (f2.get(), String ("forty-two"));
+            expect (f1.isReady());
+
+            auto sum = scheduler.async ([f1] { return f1.get() + 1; });
+            expectEquals (sum.get(), 43);
+
+            std::atomic<int> numCalls { 0 };
+            auto f3 = scheduler.async ([&numCalls] { ++numCalls; });
+            f3.get();
+            expect (f3.isReady());
+
+            scheduler.run ([&numCalls] { ++numCalls; }, { f3.getTask() }).wait();
+            expectEquals (numCalls.load(), 2);
+        }
+
+        beginTest ("parallelFor");
+        {
+            TaskScheduler scheduler (4);
+            Array<int> values;
+            values.resize (100000);
+
+            scheduler.parallelFor (0, values.size(), [&values] (int start, int end)
+            {
+                for (int i = start; i < end; ++i)
+                    values.setUnchecked (i, i);
+            });
+
+            int64 total = 0;
+
+            for (auto v : values)
+                total += v;
+
+            expectEquals (total, (int64) 99999 * 100000 / 2);
+
+            std::atomic<int> numCalls { 0 };
+            scheduler.parallelFor (5, 5, [&numCalls] (int, int) { ++numCalls; });
+            expectEquals (numCalls.load(), 0);
+
+            scheduler.parallelFor (0, 10, [&numCalls] (int start, int end) { numCalls += end - start; }, 3);
+            expectEquals (numCalls.load(), 10);
+        }
+
+        beginTest ("Submitting from many threads");
+        {
+            TaskScheduler scheduler (4);
+            std::atomic<int> count { 0 };
+
+            struct Submitter  : public Thread
+            {
+                Submitter (TaskScheduler& s, std::atomic<int>& c)  : Thread ("submitter"), scheduler (s), counter (c) {}
+
+                void run() override
+                {
+                    for (int i = 0; i < 2000; ++i)
+                        scheduler.run ([this] { ++counter; });
+                }
+
+                TaskScheduler& scheduler;
+                std::atomic<int>& counter;
+            };
+
+            OwnedArray<Submitter> submitters;
+
+            for (int i = 0; i < 4; ++i)
+                submitters.add (new Submitter (scheduler, count))->startThread();
+
+            for (auto* s : submitters)
+                s->waitForThreadToExit (-1);
+
+            scheduler.waitForAll();
+            expectEquals (count.load(), 8000);
+        }
+    }
+};
+
+static TaskSchedulerTests taskSchedulerTests;
+
+#endif
+
+} // namespace juce
@@ -0,0 +1,256 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2020 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   To use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+#ifndef DOXYGEN
+namespace TaskSchedulerHelpers
+{
+    /*  Holds the value returned by a function that was run with TaskScheduler::async().
+        Functions that return void don't have anything to keep.
+    */
+    template <typename ResultType>
+    struct FutureResult
+    {
+        using ReturnType = const ResultType&;
+
+        template <typename Function>
+        void call (Function& function)          { value.reset (new ResultType (function())); }
+        ReturnType get() const noexcept         { return *value; }
+
+        std::unique_ptr<ResultType> value;
+    };
+
+    template <>
+    struct FutureResult<void>
+    {
+        using ReturnType = void;
+
+        template <typename Function>
+        void call (Function& function)          { function(); }
+        void get() const noexcept               {}
+    };
+}
+#endif
+
+//==============================================================================
+/**
+    Runs small tasks on a set of worker threads, using work-stealing.
+
+    Unlike a ThreadPool, which keeps all of its jobs in one shared list, each worker
+    thread has its own queue of tasks. New tasks that are created by a running task go
+    onto the end of its own worker's queue, and a worker that runs out of tasks takes
+    some from the front of another worker's queue, so the threads rarely need to
+    touch the same data.
+
+    Tasks are just functions. A task can be made to wait until some other tasks have
+    finished before it's started, which lets you build graphs of dependent work:
+    @code
+    TaskScheduler scheduler;
+
+    auto load     = scheduler.run ([&] { loadFile(); });
+    auto analyse  = scheduler.run ([&] { analyse(); }, { load });
+    auto preview  = scheduler.run ([&] { makePreview(); }, { load });
+    auto finished = scheduler.run ([&] { writeReport(); }, { analyse, preview });
+
+    finished.wait();
+    @endcode
+
+    There's also a parallelFor() for splitting up loops, and async(), which returns a
+    Future for a task's result.
+
+    When a task waits for another one, or a thread calls parallelFor(), it will run
+    other queued tasks while it's waiting, rather than blocking a worker.
+
+    @see ThreadPool
+
+    @tags{Core}
+*/
+class JUCE_API  TaskScheduler
+{
+public:
+    //==============================================================================
+    /** Creates a scheduler.
+
+        @param numberOfThreads  the number of worker threads to run. These will be started
+                                immediately, and will run until the scheduler is deleted.
+        @param threadStackSize  the size of the stack of each thread. If this value
+                                is zero then the default stack size of the OS will
+                                be used.
+    */
+    explicit TaskScheduler (int numberOfThreads = SystemStats::getNumCpus(),
+                            size_t threadStackSize = 0);
+
+    /** Destructor.
+        This will wait for all the outstanding tasks to finish before returning.
+    */
+    ~TaskScheduler();
+
+    //==============================================================================
+    class Task;
+
+    /** Refers to a task that has been given to a TaskScheduler.
+        It's a lightweight reference-counted pointer, so can be copied around freely.
+    */
+    class JUCE_API  TaskHandle
+    {
+    public:
+        /** Creates an invalid handle. */
+        TaskHandle() noexcept;
+        /** Destructor. */
+        ~TaskHandle();
+        /** Creates a copy of another handle. */
+        TaskHandle (const TaskHandle&) noexcept;
+        /** Makes this refer to the same task as another handle. */
+        TaskHandle& operator= (const TaskHandle&) noexcept;
+        /** Move constructor. */
+        TaskHandle (TaskHandle&&) noexcept;
+        /** Move assignment. */
+        TaskHandle& operator= (TaskHandle&&) noexcept;
+
+        /** Returns true if this refers to a task. */
+        bool isValid() const noexcept;
+
+        /** Returns true if the task has finished running. An invalid handle counts as finished. */
+        bool isFinished() const noexcept;
+
+        /** Waits until the task has finished.
+            While it's waiting, the calling thread will run any other tasks that are queued.
+        */
+        void wait() const;
+
+    private:
+        friend class TaskScheduler;
+        ReferenceCountedObjectPtr<Task> task;
+    };
+
+    /** Holds the result of a task that was started with async().
+        If the task's function returns void, get() just waits for it to finish.
+    */
+    template <typename ResultType>
+    class Future
+    {
+    public:
+        /** Creates an invalid future. */
+        Future() = default;
+
+        /** Returns true if the result is available. */
+        bool isReady() const noexcept               { return task.isValid() && task.isFinished(); }
+
+        /** Returns the result, waiting for the task to finish if necessary.
+            While it's waiting, the calling thread will run any other tasks that are queued.
+        */
+        typename TaskSchedulerHelpers::FutureResult<ResultType>::ReturnType get() const
+        {
+            jassert (task.isValid());
+            task.wait();
+            return result->get();
+        }
+
+        /** Returns the task that produces this result, e.g. so that it can be used as
+            a dependency of another task.
+        */
+        const TaskHandle& getTask() const noexcept  { return task; }
+
+    private:
+        friend class TaskScheduler;
+
+        TaskHandle task;
+        std::shared_ptr<TaskSchedulerHelpers::FutureResult<ResultType>> result;
+    };
+
+    //==============================================================================
+    /** Adds a task to be run as soon as a worker is free. */
+    TaskHandle run (std::function<void()> function);
+
+    /** Adds a task that will be run when all of the given tasks have finished. */
+    TaskHandle run (std::function<void()> function, std::initializer_list<TaskHandle> dependencies);
+
+    /** Adds a task that will be run when all of the given tasks have finished. */
+    TaskHandle run (std::function<void()> function, const Array<TaskHandle>& dependencies);
+
+    /** Runs a function as a task, and returns a Future that will hold its result. */
+    template <typename Function>
+    auto async (Function function) -> Future<typename std::decay<decltype (function())>::type>
+    {
+        using ResultType = typename std::decay<decltype (function())>::type;
+
+        Future<ResultType> future;
+        auto result = std::make_shared<TaskSchedulerHelpers::FutureResult<ResultType>>();
+        future.result = result;
+        future.task = run ([result, function]() mutable { result->call (function); });
+        return future;
+    }
+
+    /** Calls a function for each of a range of indexes, splitting the range up into chunks
+        that are run in parallel.
+
+        The body function is called with the start and end (exclusive) of each chunk.
+        If grainSize is zero, a chunk size is chosen which gives each worker a few chunks.
+        This doesn't return until the whole range has been processed, and the calling thread
+        will run some of the chunks itself.
+    */
+    void parallelFor (int startIndex, int endIndex,
+                      const std::function<void (int chunkStart, int chunkEnd)>& body,
+                      int grainSize = 0);
+
+    /** Waits until all the tasks that have been added have finished.
+        While it's waiting, the calling thread will run any tasks that are queued.
+    */
+    void waitForAll();
+
+    /** Returns the number of worker threads. */
+    int getNumThreads() const noexcept;
+
+    /** Returns the number of tasks that have been added but haven't finished yet. */
+    int getNumUnfinishedTasks() const noexcept;
+
+private:
+    //==============================================================================
+    struct Worker;
+    friend struct Worker;
+
+    OwnedArray<Worker> workers;
+    std::atomic<int> numQueuedTasks { 0 }, numUnfinishedTasks { 0 }, numSleepingWorkers { 0 },
+                     numWaitingThreads { 0 }, nextWorkerIndex { 0 };
+
+    // Threads that are waiting in runTasksUntil() are notified whenever a task
+    // finishes or is queued
+    std::mutex waitingLock;
+    std::condition_variable waitingThreadsCondition;
+
+    void addDependency (Task&, const TaskHandle&);
+    void schedule (Task*);
+    void execute (Task*);
+    void dependencyFinished (Task*);
+    ReferenceCountedObjectPtr<Task> findTask (Worker*);
+    Worker* getCurrentWorker() const noexcept;
+    void wakeSleepingWorker();
+    void notifyWaitingThreads();
+    void runTasksUntil (const std::function<bool()>& isDone);
+    void workerLoop (Worker&);
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (TaskScheduler)
+};
+
+} // namespace juce
@@ -381,6 +381,7 @@ bool ThreadPool::runNextJob (ThreadPoolThread& thread)
 
         try
         {
+            JUCE_TRACE_SCOPE ("ThreadPoolJob::runJob");
             result = job->runJob();
         }
         catch (...)
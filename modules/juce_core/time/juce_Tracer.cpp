@@ -0,0 +1,607 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2020 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   To use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+enum class Tracer::EventType : uint8
+{
+    begin,
+    end,
+    instant,
+    counter,
+    flowStart,
+    flowStep,
+    flowEnd
+};
+
+struct Tracer::Event
+{
+    const char* name;
+    int64 time;
+    double value;
+    uint64 id;
+    EventType type;
+};
+
+struct Tracer::ThreadBuffer  : public ReferenceCountedObject
+{
+    using Ptr = ReferenceCountedObjectPtr<ThreadBuffer>;
+
+    explicit ThreadBuffer (int capacityToUse)
+        : capacity ((uint64) nextPowerOfTwo (jmax (16, capacityToUse))),
+          slots (new Slot[capacity])
+    {
+        if (auto* t = Thread::getCurrentThread())
+            threadName = t->getThreadName();
+    }
+
+    void add (const Event& e) noexcept
+    {
+        auto n = numWritten.load (std::memory_order_relaxed);
+
+        // This has to be visible to anyone who sees any part of the new event
+        numStarted.store (n + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence (std::memory_order_release);
+
+        slots[n & (capacity - 1)].store (e);
+        numWritten.store (n + 1, std::memory_order_release);
+    }
+
+    // Reads an event that has been written, returning false if the thread may have
+    // started overwriting it with a newer one while it was being read.
+    bool read (uint64 index, Event& result) const noexcept
+    {
+        result = slots[index & (capacity - 1)].load();
+        std::atomic_thread_fence (std::memory_order_acquire);
+        return numStarted.load (std::memory_order_relaxed) <= index + capacity;
+    }
+
+    // The fields are atomics so that a slot can be read while its thread is writing
+    // to it. That's cheap, as they're only ever loaded and stored with relaxed ordering.
+    struct Slot
+    {
+        std::atomic<const char*> name;
+        std::atomic<int64> time;
+        std::atomic<double> value;
+        std::atomic<uint64> id;
+        std::atomic<EventType> type;
+
+        void store (const Event& e) noexcept
+        {
+            name.store (e.name, std::memory_order_relaxed);
+            time.store (e.time, std::memory_order_relaxed);
+            value.store (e.value, std::memory_order_relaxed);
+            id.store (e.id, std::memory_order_relaxed);
+            type.store (e.type, std::memory_order_relaxed);
+        }
+
+        Event load() const noexcept
+        {
+            return { name.load (std::memory_order_relaxed),
+                     time.load (std::memory_order_relaxed),
+                     value.load (std::memory_order_relaxed),
+                     id.load (std::memory_order_relaxed),
+                     type.load (std::memory_order_relaxed) };
+        }
+    };
+
+    const uint64 capacity;
+    std::unique_ptr<Slot[]> slots;
+    std::atomic<uint64> numWritten { 0 }, numStarted { 0 }, firstToRead { 0 };
+    std::atomic<bool> threadHasFinished { false };
+    int threadIndex = 0;
+    String threadName;
+
+    JUCE_DECLARE_NON_COPYABLE (ThreadBuffer)
+};
+
+struct Tracer::State
+{
+    CriticalSection lock;
+    ReferenceCountedArray<ThreadBuffer> buffers;
+    StringArray persistentNames;
+    int nextThreadIndex = 1;
+    std::atomic<int> eventsPerThread { 65536 };
+    std::atomic<uint64> nextFlowId { 1 };
+
+    static State& get()
+    {
+        static State state;
+        return state;
+    }
+
+    static ThreadBuffer& getBufferForCurrentThread()
+    {
+        // Lets the buffer know when its thread has gone, so that clear() can delete it
+        struct ThreadBufferHolder
+        {
+            ~ThreadBufferHolder()
+            {
+                if (buffer != nullptr)
+                    buffer->threadHasFinished = true;
+            }
+
+            ThreadBuffer* buffer = nullptr;
+        };
+
+        thread_local ThreadBufferHolder holder;
+
+        if (holder.buffer == nullptr)
+            holder.buffer = get().addBufferForCurrentThread();
+
+        return *holder.buffer;
+    }
+
+    ThreadBuffer* addBufferForCurrentThread()
+    {
+        const RealtimeSafetyGuard::ScopedSuspension suspension;
+
+        // The buffer's memory is allocated before taking the lock, as it may be quite large
+        ThreadBuffer::Ptr buffer (new ThreadBuffer (eventsPerThread));
+
+        const ScopedLock sl (lock);
+        buffer->threadIndex = nextThreadIndex++;
+
+        if (buffer->threadName.isEmpty())
+            buffer->threadName = "Thread " + String (buffer->threadIndex);
+
+        buffers.add (buffer);
+        return buffer.get();
+    }
+};
+
+std::atomic<bool> Tracer::recording { false };
+
+//==============================================================================
+void Tracer::start (int maxEventsPerThread)
+{
+    State::get().eventsPerThread = maxEventsPerThread;
+    recording = true;
+}
+
+void Tracer::stop() noexcept
+{
+    recording = false;
+}
+
+void Tracer::clear()
+{
+    auto& state = State::get();
+    const ScopedLock sl (state.lock);
+
+    for (int i = state.buffers.size(); --i >= 0;)
+    {
+        auto* b = state.buffers.getObjectPointerUnchecked (i);
+
+        if (b->threadHasFinished)
+            state.buffers.remove (i);
+        else
+            b->firstToRead = b->numWritten.load();
+    }
+}
+
+void Tracer::prepareThread()
+{
+    State::getBufferForCurrentThread();
+}
+
+void Tracer::record (EventType type, const char* name, double value, uint64 id) noexcept
+{
+    State::getBufferForCurrentThread().add ({ name, Time::getHighResolutionTicks(), value, id, type });
+}
+
+void Tracer::beginZone (const char* name) noexcept                  { record (EventType::begin, name, 0, 0); }
+void Tracer::endZone (const char* name) noexcept                    { record (EventType::end, name, 0, 0); }
+void Tracer::instant (const char* name) noexcept                    { record (EventType::instant, name, 0, 0); }
+void Tracer::counter (const char* name, double value) noexcept      { record (EventType::counter, name, value, 0); }
+void Tracer::flowStart (const char* name, uint64 flowId) noexcept   { record (EventType::flowStart, name, 0, flowId); }
+void Tracer::flowStep (const char* name, uint64 flowId) noexcept    { record (EventType::flowStep, name, 0, flowId); }
+void Tracer::flowEnd (const char* name, uint64 flowId) noexcept     { record (EventType::flowEnd, name, 0, flowId); }
+
+uint64 Tracer::createFlowId() noexcept
+{
+    return State::get().nextFlowId++;
+}
+
+const char* Tracer::getPersistentName (const String& name)
+{
+    auto& state = State::get();
+    const ScopedLock sl (state.lock);
+
+    auto index = state.persistentNames.indexOf (name);
+
+    if (index < 0)
+    {
+        index = state.persistentNames.size();
+        state.persistentNames.add (name);
+    }
+
+    // The strings are never removed from the array, so their text stays where it is
+    return state.persistentNames.getReference (index).toRawUTF8();
+}
+
+//==============================================================================
+void Tracer::writeChromeTrace (OutputStream& output)
+{
+    auto& state = State::get();
+    ReferenceCountedArray<ThreadBuffer> buffers;
+
+    // The lock is only held while taking a copy of the list, as writing to the stream
+    // could take a while, and a thread that records its first event needs the lock.
+    {
+        const ScopedLock sl (state.lock);
+        buffers = state.buffers;
+    }
+
+    auto ticksToMicroseconds = 1.0e6 / (double) Time::getHighResolutionTicksPerSecond();
+
+    JSONStreamWriter writer (output, true, 3);
+    writer.startObject();
+    writer.writeName ("traceEvents");
+    writer.startArray();
+
+    auto startEvent = [&] (const char* phase, int tid)
+    {
+        writer.startObject();
+        writer.writeName ("ph");    writer.writeString (phase);
+        writer.writeName ("pid");   writer.writeInt (1);
+        writer.writeName ("tid");   writer.writeInt (tid);
+    };
+
+    for (auto* b : buffers)
+    {
+        startEvent ("M", b->threadIndex);
+        writer.writeName ("name");
+        writer.writeString ("thread_name");
+        writer.writeName ("args");
+        writer.startObject();
+        writer.writeName ("name");
+        writer.writeString (b->threadName);
+        writer.endObject();
+        writer.endObject();
+
+        auto end = b->numWritten.load (std::memory_order_acquire);
+        auto start = jmax (b->firstToRead.load(), end > b->capacity ? end - b->capacity : (uint64) 0);
+
+        for (auto i = start; i < end; ++i)
+        {
+            Event e;
+
+            if (! b->read (i, e))
+                continue;
+
+            const char* phase = "i";
+
+            switch (e.type)
+            {
+                case EventType::begin:      phase = "B"; break;
+                case EventType::end:        phase = "E"; break;
+                case EventType::instant:    phase = "i"; break;
+                case EventType::counter:    phase = "C"; break;
+                case EventType::flowStart:  phase = "s"; break;
+                case EventType::flowStep:   phase = "t"; break;
+                case EventType::flowEnd:    phase = "f"; break;
+            }
+
+            startEvent (phase, b->threadIndex);
+            writer.writeName ("name");
+            writer.writeString (e.name);
+            writer.writeName ("ts");
+            writer.writeDouble ((double) e.time * ticksToMicroseconds);
+
+            switch (e.type)
+            {
+                case EventType::instant:
+                    writer.writeName ("s");
+                    writer.writeString ("t");
+                    break;
+
+                case EventType::counter:
+                    writer.writeName ("args");
+                    writer.startObject();
+                    writer.writeName ("value");
+                    writer.writeDouble (e.value);
+                    writer.endObject();
+                    break;
+
+                case EventType::flowEnd:
+                    writer.writeName ("bp");
+                    writer.writeString ("e");
+                    JUCE_FALLTHROUGH
+                case EventType::flowStart:
+                case EventType::flowStep:
+                    writer.writeName ("cat");
+                    writer.writeString ("flow");
+                    writer.writeName ("id");
+                    writer.writeInt ((int64) e.id);
+                    break;
+
+                case EventType::begin:
+                case EventType::end:
+                    break;
+            }
+
+            writer.endObject();
+        }
+    }
+
+    writer.endArray();
+    writer.writeName ("displayTimeUnit");
+    writer.writeString ("ms");
+    writer.endObject();
+}
+
+bool Tracer::writeChromeTrace (const File& file)
+{
+    FileOutputStream out (file);
+
+    if (! out.openedOk())
+        return false;
+
+    out.setPosition (0);
+    out.truncate();
+    writeChromeTrace (out);
+    out.flush();
+    return out.getStatus().wasOk();
+}
+
+
+//==============================================================================
+//==============================================================================
+#if JUCE_UNIT_TESTS && JUCE_ENABLE_TRACING
+
+class TracerTests  : public UnitTest
+{
+public:
+    TracerTests()
+        : UnitTest ("Tracer", UnitTestCategories::time)
+    {}
+
+    static var getTrace()
+    {
+        MemoryOutputStream out;
+        Tracer::writeChromeTrace (out);
+        return JSON::parse (out.toString());
+    }
+
+    static int countEvents (const var& trace, const String& name, const String& phase)
+    {
+        int num = 0;
+
+        if (auto* events = trace["traceEvents"].getArray())
+            for (auto& e : *events)
+                if (e["name"].toString() == name && e["ph"].toString() == phase)
+                    ++num;
+
+        return num;
+    }
+
+    void runTest() override
+    {
+        beginTest ("Recording");
+        {
+            Tracer::clear();
+            Tracer::start();
+            expect (Tracer::isRecording());
+
+            {
+                JUCE_TRACE_SCOPE ("outer zone");
+                JUCE_TRACE_INSTANT ("an instant");
+
+                for (int i = 0; i < 3; ++i)
+                {
+                    JUCE_TRACE_SCOPE ("inner zone");
+                    JUCE_TRACE_COUNTER ("a counter", i);
+                }
+            }
+
+            Tracer::stop();
+
+            {
+                JUCE_TRACE_SCOPE ("not recorded");
+            }
+
+            auto trace = getTrace();
+            expect (trace["traceEvents"].isArray());
+            expectEquals (countEvents (trace, "outer zone", "B"), 1);
+            expectEquals (countEvents (trace, "outer zone", "E"), 1);
+            expectEquals (countEvents (trace, "inner zone", "B"), 3);
+            expectEquals (countEvents (trace, "inner zone", "E"), 3);
+            expectEquals (countEvents (trace, "a counter", "C"), 3);
+            expectEquals (countEvents (trace, "an instant", "i"), 1);
+            expectEquals (countEvents (trace, "not recorded", "B"), 0);
+
+            Tracer::clear();
+            expectEquals (countEvents (getTrace(), "outer zone", "B"), 0);
+        }
+
+        beginTest ("Flows between threads");
+        {
+            Tracer::start();
+
+            auto flowId = Tracer::createFlowId();
+            auto threadZoneName = String ("consumer ") + String (1);
+            auto* persistentName = Tracer::getPersistentName (threadZoneName);
+            expect (persistentName == Tracer::getPersistentName (threadZoneName));
+
+            {
+                JUCE_TRACE_SCOPE ("producer");
+                JUCE_TRACE_FLOW_START ("work", flowId);
+            }
+
+            WaitableEvent finished;
+
+            Thread::launch ([&]
+            {
+                {
+                    JUCE_TRACE_SCOPE (persistentName);
+                    JUCE_TRACE_FLOW_END ("work", flowId);
+                }
+
+                finished.signal();
+            });
+
+            finished.wait (10000);
+            Tracer::stop();
+
+            auto trace = getTrace();
+            expectEquals (countEvents (trace, "work", "s"), 1);
+            expectEquals (countEvents (trace, "work", "f"), 1);
+            expectEquals (countEvents (trace, "consumer 1", "B"), 1);
+            expect (countEvents (trace, "thread_name", "M") >= 2);
+
+            Tracer::clear();
+        }
+
+        beginTest ("Ring buffer wraps");
+        {
+            WaitableEvent finished;
+
+            Tracer::start (16);
+
+            Thread::launch ([&]
+            {
+                for (int i = 0; i < 100; ++i)
+                    JUCE_TRACE_INSTANT ("wrapping");
+
+                finished.signal();
+            });
+
+            finished.wait (10000);
+            Tracer::stop();
+
+            expectEquals (countEvents (getTrace(), "wrapping", "i"), 16);
+            Tracer::clear();
+        }
+
+        beginTest ("Recording on a new thread while writing");
+        {
+            // A stream that holds up the writing until another thread has recorded its first event
+            struct BlockingStream  : public MemoryOutputStream
+            {
+                bool write (const void* data, size_t numBytes) override
+                {
+                    if (! hasStarted)
+                    {
+                        hasStarted = true;
+                        writingHasStarted.signal();
+                        otherThreadRecorded = eventRecorded.wait (5000);
+                    }
+
+                    return MemoryOutputStream::write (data, numBytes);
+                }
+
+                WaitableEvent writingHasStarted, eventRecorded;
+                bool hasStarted = false, otherThreadRecorded = false;
+            };
+
+            BlockingStream stream;
+            WaitableEvent finished;
+
+            Tracer::start();
+
+            Thread::launch ([&]
+            {
+                stream.writingHasStarted.wait (5000);
+                JUCE_TRACE_INSTANT ("first event");
+                stream.eventRecorded.signal();
+                finished.signal();
+            });
+
+            Tracer::writeChromeTrace (stream);
+            expect (stream.otherThreadRecorded);
+
+            finished.wait (10000);
+            Tracer::stop();
+            Tracer::clear();
+        }
+
+        beginTest ("Preparing a thread");
+        {
+            WaitableEvent finished;
+            auto numThreadsBefore = countEvents (getTrace(), "thread_name", "M");
+
+            Thread::launch ([&]
+            {
+                Tracer::prepareThread();
+                finished.signal();
+            });
+
+            finished.wait (10000);
+
+            // The thread's buffer exists before anything has been recorded on it
+            expectEquals (countEvents (getTrace(), "thread_name", "M"), numThreadsBefore + 1);
+            Tracer::clear();
+        }
+
+        beginTest ("Writing while recording");
+        {
+            std::atomic<bool> shouldStop { false };
+            WaitableEvent finished;
+
+            Tracer::start (16);
+
+            Thread::launch ([&]
+            {
+                for (int i = 0; ! shouldStop; ++i)
+                    JUCE_TRACE_COUNTER ("racing", i);
+
+                finished.signal();
+            });
+
+            for (int i = 0; i < 50; ++i)
+            {
+                // If a half-overwritten event got through, the values would be out of order
+                auto trace = getTrace();
+                double lastValue = -1.0;
+                bool valuesAreInOrder = true;
+
+                if (auto* events = trace["traceEvents"].getArray())
+                {
+                    for (auto& e : *events)
+                    {
+                        if (e["name"].toString() == "racing")
+                        {
+                            auto value = (double) e["args"]["value"];
+                            valuesAreInOrder = valuesAreInOrder && value > lastValue;
+                            lastValue = value;
+                        }
+                    }
+                }
+
+                expect (valuesAreInOrder);
+            }
+
+            shouldStop = true;
+            finished.wait (10000);
+            Tracer::stop();
+            Tracer::clear();
+        }
+    }
+};
+
+static TracerTests tracerTests;
+
+#endif
+
+} // namespace juce
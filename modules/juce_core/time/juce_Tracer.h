@@ -0,0 +1,212 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2020 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   To use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    Records timed events from any thread, and writes them out in the Chrome trace
+    event format, so that they can be viewed with chrome://tracing or Perfetto.
+
+    Each thread records its events into its own fixed-size ring buffer, so recording
+    an event doesn't take a lock or allocate, except for the first event on each
+    thread, which creates its buffer. Each event takes 40 bytes, so a buffer of the
+    default size is about 2.6MB. To keep that out of a real-time thread, call
+    prepareThread() on it before it starts its time-critical work. When recording is
+    stopped, the cost of each tracing macro is just a check of an atomic flag, and if
+    JUCE_ENABLE_TRACING is turned off, the macros are removed entirely.
+
+    The easiest way to add events is with the macros:
+    @code
+    void MyProcessor::processBlock (AudioBuffer<float>& buffer, MidiBuffer&)
+    {
+        JUCE_TRACE_SCOPE ("MyProcessor::processBlock");     // records the time spent in this block
+        JUCE_TRACE_COUNTER ("numVoices", voices.size());
+        ...
+    }
+
+    Tracer::start();
+    ...
+    Tracer::stop();
+    Tracer::writeChromeTrace (File ("~/trace.json"));
+    @endcode
+
+    The names of events must be string literals, or at least strings that will
+    remain valid until the trace has been written. To use a name that's built at
+    run-time, call getPersistentName() to get a copy that will never be deleted.
+
+    JUCE adds its own zones to things like the audio device callback, the nodes of
+    an AudioProcessorGraph, component painting, message dispatch and ThreadPool jobs.
+
+    @see PerformanceCounter
+
+    @tags{Core}
+*/
+class JUCE_API  Tracer
+{
+public:
+    //==============================================================================
+    /** Starts recording events.
+
+        Each thread's buffer will hold the given number of its most recent events,
+        although buffers that were created before this is called keep their old size.
+    */
+    static void start (int maxEventsPerThread = 65536);
+
+    /** Stops recording events. The events that have been recorded are kept until
+        clear() is called.
+    */
+    static void stop() noexcept;
+
+    /** Returns true if events are being recorded. */
+    static bool isRecording() noexcept          { return recording.load (std::memory_order_relaxed); }
+
+    /** Discards all the events that have been recorded so far. */
+    static void clear();
+
+    //==============================================================================
+    /** Writes all the recorded events as a JSON document in the Chrome trace event format.
+        If recording is still going on, the events that are added while this is writing
+        may or may not be included, and any that get overwritten in a thread's buffer while
+        they're being read will be left out.
+    */
+    static void writeChromeTrace (OutputStream& output);
+
+    /** Writes all the recorded events to a file in the Chrome trace event format. */
+    static bool writeChromeTrace (const File& file);
+
+    //==============================================================================
+    /** Creates the calling thread's event buffer, if it doesn't already have one.
+
+        Otherwise, the buffer is created when the thread records its first event, which
+        means allocating memory and taking a lock. Call this at the start of a real-time
+        thread to make sure that doesn't happen during its time-critical work. The buffer
+        will hold the number of events that was last passed to start().
+    */
+    static void prepareThread();
+
+    //==============================================================================
+    /** Records the start of a zone on the calling thread. Each of these must be matched by a
+        call to endZone() on the same thread. It's easier to use JUCE_TRACE_SCOPE than to call
+        this directly.
+    */
+    static void beginZone (const char* name) noexcept;
+
+    /** Records the end of a zone that was started with beginZone(). */
+    static void endZone (const char* name) noexcept;
+
+    /** Records an instantaneous event. */
+    static void instant (const char* name) noexcept;
+
+    /** Records the value of a counter, which will be shown as a graph. */
+    static void counter (const char* name, double value) noexcept;
+
+    /** Returns a new identifier for a flow. */
+    static uint64 createFlowId() noexcept;
+
+    /** Records the start of a flow, which links the current zone to later zones that are
+        marked with flowStep() or flowEnd() using the same id, possibly on other threads.
+    */
+    static void flowStart (const char* name, uint64 flowId) noexcept;
+
+    /** Records an intermediate step of a flow. */
+    static void flowStep (const char* name, uint64 flowId) noexcept;
+
+    /** Records the end of a flow. */
+    static void flowEnd (const char* name, uint64 flowId) noexcept;
+
+    /** Returns a copy of a string that will stay valid for the lifetime of the program,
+        so that it can be used as the name of an event. Repeated calls with the same string
+        return the same pointer. This takes a lock, so don't call it on a real-time thread.
+    */
+    static const char* getPersistentName (const String& name);
+
+    //==============================================================================
+    /** Records a zone that lasts for the lifetime of this object.
+        @see JUCE_TRACE_SCOPE
+    */
+    class ScopedZone
+    {
+    public:
+        explicit ScopedZone (const char* zoneName) noexcept
+            : name (isRecording() ? zoneName : nullptr)
+        {
+            if (name != nullptr)
+                beginZone (name);
+        }
+
+        ~ScopedZone() noexcept
+        {
+            if (name != nullptr)
+                endZone (name);
+        }
+
+    private:
+        const char* const name;
+
+        JUCE_DECLARE_NON_COPYABLE (ScopedZone)
+    };
+
+private:
+    //==============================================================================
+    enum class EventType : uint8;
+    struct Event;
+    struct ThreadBuffer;
+    struct State;
+
+    static std::atomic<bool> recording;
+
+    static void record (EventType, const char* name, double value, uint64 id) noexcept;
+
+    Tracer() = delete;
+};
+
+//==============================================================================
+#if JUCE_ENABLE_TRACING || DOXYGEN
+ /** Records a zone from this point until the end of the enclosing scope.
+
+     The first event that any of these macros records on a thread will allocate that
+     thread's buffer, unless Tracer::prepareThread() has already been called on it.
+ */
+ #define JUCE_TRACE_SCOPE(name)                 const juce::Tracer::ScopedZone JUCE_JOIN_MACRO (juceTraceZone_, __LINE__) (name)
+
+ /** Records an instantaneous event. @see JUCE_TRACE_SCOPE, Tracer::prepareThread */
+ #define JUCE_TRACE_INSTANT(name)               JUCE_BLOCK_WITH_FORCED_SEMICOLON (if (juce::Tracer::isRecording()) juce::Tracer::instant (name);)
+
+ /** Records the value of a counter. @see JUCE_TRACE_SCOPE, Tracer::prepareThread */
+ #define JUCE_TRACE_COUNTER(name, value)        JUCE_BLOCK_WITH_FORCED_SEMICOLON (if (juce::Tracer::isRecording()) juce::Tracer::counter (name, (double) (value));)
+
+ /** Records the start, a step, or the end of a flow between zones. @see JUCE_TRACE_SCOPE, Tracer::prepareThread */
+ #define JUCE_TRACE_FLOW_START(name, flowId)    JUCE_BLOCK_WITH_FORCED_SEMICOLON (if (juce::Tracer::isRecording()) juce::Tracer::flowStart (name, flowId);)
+ #define JUCE_TRACE_FLOW_STEP(name, flowId)     JUCE_BLOCK_WITH_FORCED_SEMICOLON (if (juce::Tracer::isRecording()) juce::Tracer::flowStep (name, flowId);)
+ #define JUCE_TRACE_FLOW_END(name, flowId)      JUCE_BLOCK_WITH_FORCED_SEMICOLON (if (juce::Tracer::isRecording()) juce::Tracer::flowEnd (name, flowId);)
+#else
+ #define JUCE_TRACE_SCOPE(name)
+ #define JUCE_TRACE_INSTANT(name)
+ #define JUCE_TRACE_COUNTER(name, value)
+ #define JUCE_TRACE_FLOW_START(name, flowId)
+ #define JUCE_TRACE_FLOW_STEP(name, flowId)
+ #define JUCE_TRACE_FLOW_END(name, flowId)
+#endif
+
+} // namespace juce
@@ -33,10 +33,12 @@ namespace UnitTestCategories
     static const String containers                 { "Containers" };
     static const String cryptography               { "Cryptography" };
     static const String dsp                        { "DSP" };
+    static const String events                     { "Events" };
     static const String files                      { "Files" };
     static const String function                   { "Function" };
     static const String graphics                   { "Graphics" };
     static const String gui                        { "GUI" };
+    static const String javascript                 { "Javascript" };
     static const String json                       { "JSON" };
     static const String maths                      { "Maths" };
     static const String midi                       { "MIDI" };
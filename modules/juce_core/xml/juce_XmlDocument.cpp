@@ -38,6 +38,16 @@ std::unique_ptr<XmlElement> XmlDocument::parse (const String& textToParse)
     return XmlDocument (textToParse).getDocumentElement();
 }
 
+std::unique_ptr<XmlElement> XmlDocument::parse (InputStream& xmlData)
+{
+    XmlStreamReader reader (xmlData);
+
+    if (reader.next() == XmlStreamReader::Event::startElement)
+        return reader.readElement();
+
+    return {};
+}
+
 std::unique_ptr<XmlElement> parseXML (const String& textToParse)
 {
     return XmlDocument (textToParse).getDocumentElement();
@@ -68,6 +78,11 @@ void XmlDocument::setEmptyTextElementsIgnored (bool shouldBeIgnored) noexcept
     ignoreEmptyTextElements = shouldBeIgnored;
 }
 
+void XmlDocument::setMemoryArena (MemoryArena::Ptr arenaToUse) noexcept
+{
+    memoryArena = std::move (arenaToUse);
+}
+
 namespace XmlIdentifierChars
 {
     static bool isIdentifierCharSlow (juce_wchar c) noexcept
@@ -216,6 +231,10 @@ std::unique_ptr<XmlElement> XmlDocument::parseDocumentElement (String::CharPoint
     else
     {
         lastError.clear();
+
+        const MemoryArena::ScopedUse arenaScope (memoryArena != nullptr ? memoryArena.get()
+                                                                         : MemoryArena::getCurrentArena());
+
         std::unique_ptr<XmlElement> result (readNextElement (! onlyReadOuterDocumentElement));
 
         if (! errorOccurred)
@@ -56,7 +56,10 @@ namespace juce
     }
     @endcode
 
-    @see XmlElement
+    If you're loading a very large document, have a look at the XmlStreamReader class,
+    which can read it without holding the whole text or tree in memory.
+
+    @see XmlElement, XmlStreamReader
 
     @tags{Core}
 */
@@ -131,6 +134,17 @@ public:
     */
     void setEmptyTextElementsIgnored (bool shouldBeIgnored) noexcept;
 
+    /** Makes the parser allocate the elements that it creates from a MemoryArena.
+
+        Building a large document this way is much quicker than allocating each element
+        and attribute separately, and so is deleting it again, as the arena's memory is
+        all released in one go when the last of its elements has been deleted. Pass a
+        nullptr to go back to using the normal heap.
+
+        @see MemoryArena
+    */
+    void setMemoryArena (MemoryArena::Ptr arenaToUse) noexcept;
+
     //==============================================================================
     /** A handy static method that parses a file.
         This is a shortcut for creating an XmlDocument object and calling getDocumentElement() on it.
@@ -146,6 +160,17 @@ public:
     */
     static std::unique_ptr<XmlElement> parse (const String& xmlData);
 
+    /** Parses the document element from a stream, without first loading all of its text into memory.
+
+        This uses an XmlStreamReader, so it's much more economical than the other methods
+        for large documents, but note that it can't expand any entities that are defined
+        in a DTD.
+
+        @returns    a new XmlElement, or nullptr if there was an error.
+        @see XmlStreamReader
+    */
+    static std::unique_ptr<XmlElement> parse (InputStream& xmlData);
+
 
     //==============================================================================
 private:
@@ -156,6 +181,7 @@ private:
     StringArray tokenisedDTD;
     bool needToLoadDTD = false, ignoreEmptyTextElements = true;
     std::unique_ptr<InputSource> inputSource;
+    MemoryArena::Ptr memoryArena;
 
     std::unique_ptr<XmlElement> parseDocumentElement (String::CharPointerType, bool outer);
     void setLastError (const String&, bool carryOn);
@@ -1030,6 +1030,89 @@ public:
                 expectEquals (element->getStringAttribute (number), test.second);
             }
         }
+
+        {
+            beginTest ("Stream reader");
+
+            const char* documents[] =
+            {
+                "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<!DOCTYPE test [ <!ELEMENT test ANY> ]>\n<!-- c -->"
+                  "<ROOT a=\"1\" b='two' c=\"&lt;&amp;&gt;&quot;&apos;&#65;&#x42;\">"
+                  "  <CHILD/><CHILD x=\"y\" />\r\n text &amp; more <!-- comment --> text\r\n"
+                  "  <![CDATA[ <raw> ]] ]]><?pi stuff?><EMPTY></EMPTY>"
+                  "  <NESTED><A><B>\xc3\xa9</B></A></NESTED>"
+                  "</ROOT>",
+
+                "<a><b/><c>1 &#32; 2</c>   </a>",
+
+                "< spaced x = \"1\"\n/>"
+            };
+
+            for (auto* doc : documents)
+            {
+                auto text = String::fromUTF8 (doc);
+                auto expected = parseXML (text);
+                expect (expected != nullptr);
+
+                for (auto bufferSize : { 64, 100, 16384 })
+                {
+                    MemoryInputStream in (doc, strlen (doc), false);
+                    XmlStreamReader reader (in, bufferSize);
+                    expect (reader.next() == XmlStreamReader::Event::startElement);
+                    auto parsed = reader.readElement();
+
+                    expect (parsed != nullptr && parsed->isEquivalentTo (expected.get(), false));
+                    expect (reader.next() == XmlStreamReader::Event::endOfDocument);
+                }
+            }
+
+            {
+                using Event = XmlStreamReader::Event;
+
+                MemoryInputStream in ("<a x=\"1\"><b/>hello<c><d/></c></a>", 34, false);
+                XmlStreamReader reader (in);
+
+                expect (reader.next() == Event::startElement && reader.getName() == Identifier ("a") && reader.getDepth() == 1);
+                expect (reader.next() == Event::attribute && reader.getName() == Identifier ("x") && reader.getText() == "1");
+                expect (reader.next() == Event::startElement && reader.getName() == Identifier ("b"));
+                expect (reader.next() == Event::endElement && reader.getName() == Identifier ("b"));
+                expect (reader.next() == Event::text && reader.getText() == "hello");
+                expect (reader.next() == Event::startElement && reader.getName() == Identifier ("c"));
+                reader.skipElement();
+                expect (reader.getCurrentEvent() == Event::endElement && reader.getName() == Identifier ("c"));
+                expect (reader.next() == Event::endElement && reader.getName() == Identifier ("a") && reader.getDepth() == 0);
+                expect (reader.next() == Event::endOfDocument);
+            }
+
+            for (auto* badDoc : { "<a><b></a>", "<a x=\"1></a>", "<a x></a>", "", "<a><![CDATA[ </a>" })
+            {
+                MemoryInputStream in (badDoc, strlen (badDoc), false);
+                expect (XmlDocument::parse (in) == nullptr);
+            }
+        }
+
+        {
+            beginTest ("Memory arena");
+
+            const char* text = "<ROOT a=\"1\"><CHILD b=\"2\" c=\"3\"/>text<CHILD><X/></CHILD></ROOT>";
+            auto expected = parseXML (text);
+
+            MemoryArena::Ptr arena (new MemoryArena (1024));
+            XmlDocument doc (text);
+            doc.setMemoryArena (arena);
+            auto parsed = doc.getDocumentElement();
+
+            expect (parsed != nullptr && parsed->isEquivalentTo (expected.get(), false));
+            expect (arena->getReferenceCount() > 2);
+
+            // elements created outside the parser still come from the heap..
+            parsed->addChildElement (new XmlElement ("EXTRA"));
+            parsed->getChildElement (0)->removeAttribute ("b");
+            expect (parsed->getChildElement (0)->getNumAttributes() == 1);
+
+            parsed.reset();
+            expectEquals (arena->getReferenceCount(), 2);  // (one is held by the XmlDocument)
+        }
     }
 };
 
@@ -168,6 +168,11 @@ public:
     /** Deleting an XmlElement will also delete all of its child elements. */
     ~XmlElement() noexcept;
 
+    /** XmlElements (and their attributes) are allocated from the current thread's
+        MemoryArena, if there is one. See MemoryArena and XmlDocument::setMemoryArena().
+    */
+    JUCE_ARENA_ALLOCATABLE
+
     //==============================================================================
     /** Compares two XmlElements to see if they contain the same text and attributes.
 
@@ -725,6 +730,8 @@ private:
         XmlAttributeNode (const Identifier&, const String&) noexcept;
         XmlAttributeNode (String::CharPointerType, String::CharPointerType);
 
+        JUCE_ARENA_ALLOCATABLE
+
         LinkedListPointer<XmlAttributeNode> nextListItem;
         Identifier name;
         String value;
@@ -734,6 +741,7 @@ private:
     };
 
     friend class XmlDocument;
+    friend class XmlStreamReader;
     friend class LinkedListPointer<XmlAttributeNode>;
     friend class LinkedListPointer<XmlElement>;
     friend class LinkedListPointer<XmlElement>::Appender;
@@ -0,0 +1,693 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2020 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   To use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+XmlStreamReader::XmlStreamReader (InputStream& source, int sizeOfBuffer)
+    : input (source), bufferSize (jmax (64, sizeOfBuffer))
+{
+    buffer.malloc ((size_t) bufferSize);
+    appendToToken ("", 0);
+
+    // skip any UTF-8 byte-order-mark
+    if (ensureAvailable (3)
+         && (uint8) buffer[0] == 0xef && (uint8) buffer[1] == 0xbb && (uint8) buffer[2] == 0xbf)
+        skip (3);
+}
+
+XmlStreamReader::~XmlStreamReader() = default;
+
+void XmlStreamReader::setEmptyTextElementsIgnored (bool shouldBeIgnored) noexcept
+{
+    ignoreEmptyTextElements = shouldBeIgnored;
+}
+
+//==============================================================================
+XmlStreamReader::Event XmlStreamReader::next()
+{
+    if (currentEvent == Event::error || currentEvent == Event::endOfDocument)
+        return currentEvent;
+
+    try
+    {
+        currentEvent = parseNext();
+    }
+    catch (const ParseError&)
+    {
+        currentEvent = Event::error;
+    }
+
+    return currentEvent;
+}
+
+Identifier XmlStreamReader::getName() const
+{
+    return currentName;
+}
+
+String XmlStreamReader::getText() const
+{
+    return String::fromUTF8 (token, (int) tokenLength);
+}
+
+std::unique_ptr<XmlElement> XmlStreamReader::readElement()
+{
+    // This must be called when the reader has just returned a startElement event!
+    jassert (currentEvent == Event::startElement);
+
+    if (currentEvent != Event::startElement)
+        return {};
+
+    std::unique_ptr<XmlElement> element (new XmlElement (currentName));
+    LinkedListPointer<XmlElement::XmlAttributeNode>::Appender attributeAppender (element->attributes);
+    LinkedListPointer<XmlElement>::Appender childAppender (element->firstChildElement);
+
+    for (;;)
+    {
+        switch (next())
+        {
+            case Event::attribute:
+                attributeAppender.append (new XmlElement::XmlAttributeNode (currentName, getText()));
+                break;
+
+            case Event::text:
+                childAppender.append (XmlElement::createTextElement (getText()));
+                break;
+
+            case Event::startElement:
+            {
+                auto child = readElement();
+
+                if (child == nullptr)
+                    return {};
+
+                childAppender.append (child.release());
+                break;
+            }
+
+            case Event::endElement:
+                return element;
+
+            case Event::endOfDocument:
+            case Event::error:
+            default:
+                return {};
+        }
+    }
+}
+
+void XmlStreamReader::skipElement()
+{
+    // This must be called when the reader is inside an element's start-tag!
+    jassert (currentEvent == Event::startElement || currentEvent == Event::attribute);
+
+    if (currentEvent != Event::startElement && currentEvent != Event::attribute)
+        return;
+
+    auto targetDepth = getDepth() - 1;
+
+    while (! (currentEvent == Event::endElement && getDepth() == targetDepth))
+    {
+        auto event = next();
+
+        if (event == Event::error || event == Event::endOfDocument)
+            return;
+    }
+}
+
+//==============================================================================
+bool XmlStreamReader::ensureAvailable (int numBytes)
+{
+    if (bufferEnd - bufferPos >= numBytes)
+        return true;
+
+    if (inputExhausted)
+        return false;
+
+    // move any unread data to the start of the buffer, and fill up the rest
+    auto numLeft = bufferEnd - bufferPos;
+    memmove (buffer, buffer + bufferPos, (size_t) numLeft);
+    bufferPos = 0;
+    bufferEnd = numLeft;
+
+    while (bufferEnd < numBytes)
+    {
+        auto numRead = input.read (buffer + bufferEnd, bufferSize - bufferEnd);
+
+        if (numRead <= 0)
+        {
+            inputExhausted = true;
+            break;
+        }
+
+        bufferEnd += numRead;
+    }
+
+    return bufferEnd >= numBytes;
+}
+
+int XmlStreamReader::peek (int offset)
+{
+    return ensureAvailable (offset + 1) ? (uint8) buffer[bufferPos + offset] : -1;
+}
+
+bool XmlStreamReader::matches (const char* text)
+{
+    auto length = (int) strlen (text);
+    return ensureAvailable (length) && memcmp (buffer + bufferPos, text, (size_t) length) == 0;
+}
+
+static bool isXmlWhitespace (int c) noexcept
+{
+    return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+}
+
+static bool isXmlNameByte (int c) noexcept
+{
+    // (any bytes of multi-byte UTF-8 characters are accepted as part of a name)
+    return c >= 0x80 || XmlIdentifierChars::isIdentifierChar ((juce_wchar) c);
+}
+
+void XmlStreamReader::skipWhitespace()
+{
+    do
+    {
+        while (bufferPos < bufferEnd && isXmlWhitespace (buffer[bufferPos]))
+            ++bufferPos;
+    }
+    while (bufferPos == bufferEnd && ensureAvailable (1));
+}
+
+void XmlStreamReader::skipPast (const char* terminator, const char* errorMessage)
+{
+    auto length = (int) strlen (terminator);
+
+    for (;;)
+    {
+        if (! ensureAvailable (length))
+            throwError (errorMessage);
+
+        auto* start = buffer + bufferPos;
+        auto* found = static_cast<char*> (memchr (start, terminator[0], (size_t) (bufferEnd - bufferPos - (length - 1))));
+
+        if (found == nullptr)
+        {
+            bufferPos = bufferEnd - (length - 1);
+            continue;
+        }
+
+        bufferPos = (int) (found - buffer);
+
+        if (memcmp (found, terminator, (size_t) length) == 0)
+        {
+            skip (length);
+            return;
+        }
+
+        skip (1);
+    }
+}
+
+void XmlStreamReader::skipDoctype()
+{
+    for (int depth = 1; depth > 0;)
+    {
+        auto c = peek();
+
+        if (c < 0)
+            throwError ("malformed DTD");
+
+        skip (1);
+
+        if (c == '<')       ++depth;
+        else if (c == '>')  --depth;
+    }
+}
+
+void XmlStreamReader::throwError (const String& message)
+{
+    lastError = message;
+    throw ParseError();
+}
+
+//==============================================================================
+void XmlStreamReader::appendToToken (const char* data, size_t numBytes)
+{
+    auto spaceNeeded = tokenLength + numBytes + 1;
+
+    if (spaceNeeded > tokenSpace)
+    {
+        tokenSpace = jmax ((size_t) 256, tokenSpace * 2, spaceNeeded);
+        token.realloc (tokenSpace);
+    }
+
+    memcpy (token + tokenLength, data, numBytes);
+    tokenLength += numBytes;
+    token[tokenLength] = 0;
+}
+
+void XmlStreamReader::appendCharToToken (juce_wchar c)
+{
+    char utf8[8];
+    CharPointer_UTF8 dest (utf8);
+    dest.write (c);
+    appendToToken (utf8, (size_t) (dest.getAddress() - utf8));
+}
+
+Identifier XmlStreamReader::readName()
+{
+    tokenLength = 0;
+
+    for (;;)
+    {
+        if (! ensureAvailable (1))
+            break;
+
+        auto* start = buffer + bufferPos;
+        auto* end = buffer + bufferEnd;
+        auto* p = start;
+
+        while (p < end && isXmlNameByte ((uint8) *p))
+            ++p;
+
+        appendToToken (start, (size_t) (p - start));
+        bufferPos += (int) (p - start);
+
+        if (p < end)
+            break;
+    }
+
+    if (tokenLength == 0)
+        return {};
+
+   #if JUCE_STRING_UTF_TYPE == 8
+    // Documents tend to use the same few tag and attribute names over and over again, so keeping
+    // a small cache of them avoids a StringPool lookup for most names
+    uint32 hash = 0;
+
+    for (size_t i = 0; i < tokenLength; ++i)
+        hash = hash * 31 + (uint8) token[i];
+
+    auto& cached = nameCache[hash & (uint32) (numElementsInArray (nameCache) - 1)];
+    auto* cachedText = cached.getCharPointer().getAddress();
+
+    if (strncmp (cachedText, token, tokenLength) == 0 && cachedText[tokenLength] == 0)
+        return cached;
+
+    cached = Identifier (String::CharPointerType (token), String::CharPointerType (token + tokenLength));
+    return cached;
+   #else
+    return Identifier (String::fromUTF8 (token, (int) tokenLength));
+   #endif
+}
+
+void XmlStreamReader::readEntity()
+{
+    skip (1); // the ampersand
+
+    char name[16];
+    int length = 0;
+
+    for (;;)
+    {
+        auto c = peek();
+
+        if (c == ';')
+        {
+            skip (1);
+            break;
+        }
+
+        // if this doesn't look like an entity, just treat the ampersand as text
+        if (c < 0 || length >= (int) sizeof (name) - 1 || c == '<' || c == '&'
+             || c == '"' || c == '\'' || isXmlWhitespace (c))
+        {
+            appendToToken ("&", 1);
+            appendToToken (name, (size_t) length);
+            return;
+        }
+
+        name[length++] = (char) c;
+        skip (1);
+    }
+
+    name[length] = 0;
+    CharPointer_ASCII entity (name);
+
+    if      (entity.compareIgnoreCase (CharPointer_ASCII ("amp")) == 0)   appendToToken ("&", 1);
+    else if (entity.compareIgnoreCase (CharPointer_ASCII ("quot")) == 0)  appendToToken ("\"", 1);
+    else if (entity.compareIgnoreCase (CharPointer_ASCII ("apos")) == 0)  appendToToken ("'", 1);
+    else if (entity.compareIgnoreCase (CharPointer_ASCII ("lt")) == 0)    appendToToken ("<", 1);
+    else if (entity.compareIgnoreCase (CharPointer_ASCII ("gt")) == 0)    appendToToken (">", 1);
+    else if (name[0] == '#' && length > 1)
+    {
+        auto isHex = (name[1] == 'x' || name[1] == 'X');
+        auto* digits = name + (isHex ? 2 : 1);
+        uint32 charCode = 0;
+        bool isValid = (*digits != 0);
+
+        for (auto* d = digits; *d != 0 && isValid; ++d)
+        {
+            auto digitValue = isHex ? CharacterFunctions::getHexDigitValue ((juce_wchar) *d)
+                                    : (isPositiveAndBelow (*d - '0', 10) ? *d - '0' : -1);
+
+            isValid = (digitValue >= 0 && charCode <= 0x10ffff);
+            charCode = charCode * (isHex ? 16u : 10u) + (uint32) digitValue;
+        }
+
+        if (isValid && charCode > 0 && charCode <= 0x10ffff)
+        {
+            appendCharToToken ((juce_wchar) charCode);
+        }
+        else
+        {
+            appendToToken ("&", 1);
+            appendToToken (name, (size_t) length);
+            appendToToken (";", 1);
+        }
+    }
+    else
+    {
+        // entities that are defined in a DTD aren't supported, so are left as they are
+        appendToToken ("&", 1);
+        appendToToken (name, (size_t) length);
+        appendToToken (";", 1);
+    }
+}
+
+void XmlStreamReader::readAttributeValue()
+{
+    auto quote = (char) peek();
+    skip (1);
+    tokenLength = 0;
+
+    for (;;)
+    {
+        if (! ensureAvailable (1))
+            throwError ("unmatched quotes");
+
+        auto* start = buffer + bufferPos;
+        auto* end = buffer + bufferEnd;
+        auto* p = start;
+
+        while (p < end && *p != quote && *p != '&')
+            ++p;
+
+        appendToToken (start, (size_t) (p - start));
+        bufferPos += (int) (p - start);
+
+        if (p == end)
+            continue;
+
+        if (*p == quote)
+        {
+            skip (1);
+            return;
+        }
+
+        readEntity();
+    }
+}
+
+bool XmlStreamReader::readText()
+{
+    tokenLength = 0;
+    bool hasContent = ! ignoreEmptyTextElements;
+
+    auto checkForContent = [&] (size_t startIndex)
+    {
+        for (auto i = startIndex; i < tokenLength && ! hasContent; ++i)
+            hasContent = ! isXmlWhitespace (token[i]);
+    };
+
+    for (;;)
+    {
+        if (! ensureAvailable (1))
+            throwError ("unmatched tags");
+
+        auto* start = buffer + bufferPos;
+        auto* end = buffer + bufferEnd;
+        auto* p = start;
+
+        while (p < end && *p != '<' && *p != '&' && *p != '\r')
+            ++p;
+
+        auto oldLength = tokenLength;
+        appendToToken (start, (size_t) (p - start));
+        bufferPos += (int) (p - start);
+        checkForContent (oldLength);
+
+        if (p == end)
+            continue;
+
+        if (*p == '\r')
+        {
+            skip (1);
+
+            if (peek() != '\n')
+                appendToToken ("\n", 1);
+
+            continue;
+        }
+
+        if (*p == '&')
+        {
+            oldLength = tokenLength;
+            readEntity();
+            checkForContent (oldLength);
+            continue;
+        }
+
+        // (comments are skipped, and the text on either side of them is joined together)
+        if (matches ("<!--"))
+        {
+            skip (4);
+            skipPast ("-->", "unterminated comment");
+            continue;
+        }
+
+        return hasContent;
+    }
+}
+
+void XmlStreamReader::readCData()
+{
+    tokenLength = 0;
+
+    for (;;)
+    {
+        if (! ensureAvailable (3))
+            throwError ("unterminated CDATA section");
+
+        auto* start = buffer + bufferPos;
+        auto* found = static_cast<char*> (memchr (start, ']', (size_t) (bufferEnd - bufferPos - 2)));
+
+        if (found == nullptr)
+        {
+            auto numBytes = bufferEnd - bufferPos - 2;
+            appendToToken (start, (size_t) numBytes);
+            skip (numBytes);
+            continue;
+        }
+
+        appendToToken (start, (size_t) (found - start));
+        bufferPos = (int) (found - buffer);
+
+        if (matches ("]]>"))
+        {
+            skip (3);
+            return;
+        }
+
+        appendToToken ("]", 1);
+        skip (1);
+    }
+}
+
+//==============================================================================
+XmlStreamReader::Event XmlStreamReader::readStartTag()
+{
+    // (allow for a gap after the '<', as XmlDocument does)
+    skipWhitespace();
+    auto name = readName();
+
+    if (name.isNull())
+        throwError ("tag name missing");
+
+    openElements.add (name);
+    currentName = name;
+    state = State::startTag;
+    return Event::startElement;
+}
+
+XmlStreamReader::Event XmlStreamReader::readEndTag()
+{
+    skipPast (">", "unmatched tags");
+    return closeElement();
+}
+
+XmlStreamReader::Event XmlStreamReader::closeElement()
+{
+    currentName = openElements.getLast();
+    openElements.removeLast();
+    state = openElements.isEmpty() ? State::finished : State::content;
+    return Event::endElement;
+}
+
+XmlStreamReader::Event XmlStreamReader::parseNext()
+{
+    for (;;)
+    {
+        switch (state)
+        {
+            case State::prolog:
+            {
+                skipWhitespace();
+
+                if (! ensureAvailable (1))
+                    throwError ("not enough input");
+
+                if (matches ("<?"))
+                {
+                    skip (2);
+                    skipPast ("?>", "malformed header");
+                    continue;
+                }
+
+                if (matches ("<!--"))
+                {
+                    skip (4);
+                    skipPast ("-->", "unterminated comment");
+                    continue;
+                }
+
+                if (matches ("<!DOCTYPE"))
+                {
+                    skip (9);
+                    skipDoctype();
+                    continue;
+                }
+
+                if (peek() != '<')
+                    throwError ("expected an element");
+
+                skip (1);
+                return readStartTag();
+            }
+
+            case State::startTag:
+            {
+                skipWhitespace();
+                auto c = peek();
+
+                if (c == '/' && peek (1) == '>')
+                {
+                    skip (2);
+                    return closeElement();
+                }
+
+                if (c == '>')
+                {
+                    skip (1);
+                    state = State::content;
+                    continue;
+                }
+
+                if (c < 0)
+                    throwError ("unmatched tags");
+
+                if (! isXmlNameByte (c))
+                    throwError ("illegal character found in " + openElements.getLast().toString()
+                                  + ": '" + String::charToString ((juce_wchar) c) + "'");
+
+                currentName = readName();
+                skipWhitespace();
+
+                if (peek() != '=')
+                    throwError ("expected '=' after attribute '" + currentName.toString() + "'");
+
+                skip (1);
+                skipWhitespace();
+                c = peek();
+
+                if (c != '"' && c != '\'')
+                    throwError ("expected a quoted value for attribute '" + currentName.toString() + "'");
+
+                readAttributeValue();
+                return Event::attribute;
+            }
+
+            case State::content:
+            {
+                if (peek() == '<')
+                {
+                    auto c1 = peek (1);
+
+                    if (c1 == '/')
+                    {
+                        skip (2);
+                        return readEndTag();
+                    }
+
+                    if (c1 == '?')
+                    {
+                        skip (2);
+                        skipPast ("?>", "unterminated processing instruction");
+                        continue;
+                    }
+
+                    if (c1 == '!')
+                    {
+                        if (matches ("<!--"))
+                        {
+                            skip (4);
+                            skipPast ("-->", "unterminated comment");
+                            continue;
+                        }
+
+                        if (matches ("<![CDATA["))
+                        {
+                            skip (9);
+                            readCData();
+                            return Event::text;
+                        }
+                    }
+
+                    skip (1);
+                    return readStartTag();
+                }
+
+                if (readText())
+                    return Event::text;
+
+                continue;
+            }
+
+            case State::finished:
+            default:
+                return Event::endOfDocument;
+        }
+    }
+}
+
+} // namespace juce
@@ -0,0 +1,176 @@
+/*
+  ==============================================================================
+
+   This file is part of the JUCE library.
+   Copyright (c) 2020 - Raw Material Software Limited
+
+   JUCE is an open source library subject to commercial or open-source
+   licensing.
+
+   The code included in this file is provided under the terms of the ISC license
+   http://www.isc.org/downloads/software-support-policy/isc-license. Permission
+   To use, copy, modify, and/or distribute this software for any purpose with or
+   without fee is hereby granted provided that the above copyright notice and
+   this permission notice appear in all copies.
+
+   JUCE IS PROVIDED "AS IS" WITHOUT ANY WARRANTY, AND ALL WARRANTIES, WHETHER
+   EXPRESSED OR IMPLIED, INCLUDING MERCHANTABILITY AND FITNESS FOR PURPOSE, ARE
+   DISCLAIMED.
+
+  ==============================================================================
+*/
+
+namespace juce
+{
+
+//==============================================================================
+/**
+    Reads XML incrementally from a stream, as a sequence of events.
+
+    Whereas XmlDocument loads all of its input into memory and builds a complete
+    XmlElement tree from it, this class only keeps a small buffer of the input and
+    the names of the currently-open elements in memory, and reports each part of
+    the document as it's encountered. This makes it possible to scan or load very
+    large files without ever holding the whole document.
+
+    Call next() repeatedly to move through the document, e.g.
+
+    @code
+    XmlStreamReader reader (inputStream);
+
+    for (auto event = reader.next(); event != XmlStreamReader::Event::endOfDocument; event = reader.next())
+    {
+        if (event == XmlStreamReader::Event::error)
+        {
+            DBG (reader.getLastParseError());
+            break;
+        }
+
+        if (event == XmlStreamReader::Event::startElement && reader.getName() == Identifier ("PLUGIN"))
+            if (auto plugin = reader.readElement())     // builds an XmlElement for just this element
+                addPlugin (*plugin);
+    }
+    @endcode
+
+    The input must be UTF-8 encoded (a leading byte-order-mark is skipped). Comments,
+    processing instructions and DTDs are skipped over, and the standard character
+    entities are expanded, but entities defined in a DTD aren't supported, and will
+    be left unexpanded in the text.
+
+    @see XmlDocument, XmlElement, ValueTree::fromXml
+
+    @tags{Core}
+*/
+class JUCE_API  XmlStreamReader
+{
+public:
+    //==============================================================================
+    /** Creates a reader for the given stream.
+        The stream is not owned by the reader, so it must stay alive for as long as
+        the reader is being used. It will be read in blocks of the given size.
+    */
+    explicit XmlStreamReader (InputStream& source, int bufferSize = 16384);
+
+    /** Destructor. */
+    ~XmlStreamReader();
+
+    //==============================================================================
+    /** The types of item that next() can return. */
+    enum class Event
+    {
+        startElement,   /**< An element's start-tag was read. Use getName() to find out its tag name. The element's attributes will follow. */
+        attribute,      /**< One of the current element's attributes was read. Use getName() and getText() to find out its name and value. */
+        text,           /**< A block of text or CDATA was read. Use getText() to find out what it was. */
+        endElement,     /**< The end of an element was reached. Use getName() to find out its tag name. */
+        endOfDocument,  /**< The end of the document element was reached. */
+        error           /**< The input is malformed. Use getLastParseError() to find out what the problem was. */
+    };
+
+    /** Reads the next item from the stream.
+        Once this has returned endOfDocument or error, it'll keep on returning the same value.
+    */
+    Event next();
+
+    /** Returns the event that was last returned by next(). */
+    Event getCurrentEvent() const noexcept              { return currentEvent; }
+
+    /** Returns the tag name of the current element, or the name of the current attribute. */
+    Identifier getName() const;
+
+    /** Returns the value of the current attribute, or the current block of text. */
+    String getText() const;
+
+    /** Returns the number of elements that enclose the current position.
+        When the current event is a startElement, this includes the new element.
+    */
+    int getDepth() const noexcept                       { return openElements.size(); }
+
+    /** If next() has returned an error, this describes the problem. */
+    const String& getLastParseError() const noexcept    { return lastError; }
+
+    /** Sets a flag to change the treatment of empty text elements.
+        If this is true (the default state), then blocks of text that contain only
+        whitespace characters will be skipped, as XmlDocument does.
+    */
+    void setEmptyTextElementsIgnored (bool shouldBeIgnored) noexcept;
+
+    //==============================================================================
+    /** Reads the whole of the element that has just been started as an XmlElement.
+
+        This must be called when the current event is a startElement. It reads the rest
+        of the element, including its attributes and children, and leaves the reader
+        positioned on its endElement. If there's an error, it returns nullptr.
+    */
+    std::unique_ptr<XmlElement> readElement();
+
+    /** Skips the rest of the element that has just been started.
+        This must be called when the current event is a startElement or attribute. It
+        leaves the reader positioned on the element's endElement.
+    */
+    void skipElement();
+
+private:
+    //==============================================================================
+    enum class State { prolog, startTag, content, finished };
+
+    struct ParseError {};
+
+    InputStream& input;
+    HeapBlock<char> buffer;
+    int bufferSize, bufferPos = 0, bufferEnd = 0;
+    bool inputExhausted = false, ignoreEmptyTextElements = true, isSelfClosingTag = false;
+
+    State state = State::prolog;
+    Event currentEvent = Event::text;
+    Array<Identifier> openElements;
+    Identifier currentName;
+    Identifier nameCache[64];
+
+    HeapBlock<char> token;
+    size_t tokenLength = 0, tokenSpace = 0;
+    String lastError;
+
+    bool ensureAvailable (int numBytes);
+    int peek (int offset = 0);
+    bool matches (const char*);
+    void skip (int numBytes) noexcept                   { bufferPos += numBytes; }
+    void skipWhitespace();
+    void skipPast (const char* terminator, const char* errorMessage);
+    void skipDoctype();
+    Identifier readName();
+    void readAttributeValue();
+    bool readText();
+    void readCData();
+    void readEntity();
+    void appendToToken (const char*, size_t);
+    void appendCharToToken (juce_wchar);
+    Event parseNext();
+    Event readStartTag();
+    Event readEndTag();
+    Event closeElement();
+    [[noreturn]] void throwError (const String&);
+
+    JUCE_DECLARE_NON_COPYABLE (XmlStreamReader)
+};
+
+} // namespace juce
@@ -31,6 +31,8 @@ class ValueTree::SharedObject  : public ReferenceCountedObject
 public:
     using Ptr = ReferenceCountedObjectPtr<SharedObject>;
 
+    JUCE_ARENA_ALLOCATABLE
+
     explicit SharedObject (const Identifier& t) noexcept  : type (t) {}
 
     SharedObject (const SharedObject& other)
@@ -50,6 +52,8 @@ public:
     {
         jassert (parent == nullptr); // this should never happen unless something isn't obeying the ref-counting!
 
+        lookupIndex.reset();
+
         for (auto i = children.size(); --i >= 0;)
         {
             const Ptr c (children.getObjectPointerUnchecked (i));
@@ -134,7 +138,7 @@ public:
     {
         if (undoManager == nullptr)
         {
-            if (properties.set (name, newValue))
+            if (changeProperty (name, [&] { return properties.set (name, newValue); }))
                 sendPropertyChangeMessage (name, listenerToExclude);
         }
         else
@@ -162,7 +166,7 @@ public:
     {
         if (undoManager == nullptr)
         {
-            if (properties.remove (name))
+            if (changeProperty (name, [&] { return properties.remove (name); }))
                 sendPropertyChangeMessage (name);
         }
         else
@@ -179,7 +183,7 @@ public:
             while (properties.size() > 0)
             {
                 auto name = properties.getName (properties.size() - 1);
-                properties.remove (name);
+                changeProperty (name, [&] { return properties.remove (name); });
                 sendPropertyChangeMessage (name);
             }
         }
@@ -201,20 +205,30 @@ public:
             setProperty (source.properties.getName (i), source.properties.getValueAt (i), undoManager);
     }
 
-    ValueTree getChildWithName (const Identifier& typeToMatch) const
+    SharedObject* findChildWithType (const Identifier& typeToMatch) const
     {
+        if (lookupIndex != nullptr)
+            return lookupIndex->findChildWithType (*this, typeToMatch);
+
         for (auto* s : children)
             if (s->type == typeToMatch)
-                return ValueTree (*s);
+                return s;
+
+        return nullptr;
+    }
+
+    ValueTree getChildWithName (const Identifier& typeToMatch) const
+    {
+        if (auto* s = findChildWithType (typeToMatch))
+            return ValueTree (*s);
 
         return {};
     }
 
     ValueTree getOrCreateChildWithName (const Identifier& typeToMatch, UndoManager* undoManager)
     {
-        for (auto* s : children)
-            if (s->type == typeToMatch)
-                return ValueTree (*s);
+        if (auto* s = findChildWithType (typeToMatch))
+            return ValueTree (*s);
 
         auto newObject = new SharedObject (typeToMatch);
         addChild (newObject, -1, undoManager);
@@ -223,6 +237,12 @@ public:
 
     ValueTree getChildWithProperty (const Identifier& propertyName, const var& propertyValue) const
     {
+        SharedObject* indexedChild = nullptr;
+
+        if (lookupIndex != nullptr
+             && lookupIndex->findChildWithProperty (*this, propertyName, propertyValue, indexedChild))
+            return indexedChild != nullptr ? ValueTree (*indexedChild) : ValueTree();
+
         for (auto* s : children)
             if (s->properties[propertyName] == propertyValue)
                 return ValueTree (*s);
@@ -265,6 +285,10 @@ public:
                 {
                     children.insert (index, child);
                     child->parent = this;
+
+                    if (lookupIndex != nullptr)
+                        lookupIndex->childAdded (*this, *child);
+
                     sendChildAddedMessage (ValueTree (*child));
                     child->sendParentChangeMessage();
                 }
@@ -291,6 +315,9 @@ public:
         {
             if (undoManager == nullptr)
             {
+                if (lookupIndex != nullptr)
+                    lookupIndex->childRemoved (*child);
+
                 children.remove (childIndex);
                 child->parent = nullptr;
                 sendChildRemovedMessage (ValueTree (child), childIndex);
@@ -320,6 +347,10 @@ public:
             if (undoManager == nullptr)
             {
                 children.move (currentIndex, newIndex);
+
+                if (lookupIndex != nullptr)
+                    lookupIndex->childrenReordered();
+
                 sendChildOrderChangedMessage (currentIndex, newIndex);
             }
             else
@@ -564,12 +595,207 @@ public:
         JUCE_DECLARE_NON_COPYABLE (MoveChildAction)
     };
 
+    //==============================================================================
+    // An optional index of the children by type, and by the values of some chosen
+    // properties. Each list is kept in the same order as the children, and any change
+    // that can't be applied cheaply just marks the index for rebuilding the next
+    // time that it's used.
+    struct ChildIndex
+    {
+        using ChildList = Array<SharedObject*>;
+        using ChildMap = HashMap<String, ChildList>;
+
+        struct PropertyIndex
+        {
+            explicit PropertyIndex (const Identifier& n) : name (n) {}
+
+            const Identifier name;
+            ChildMap children;
+            int numUnhashableValues = 0;
+        };
+
+        explicit ChildIndex (const Array<Identifier>& propertiesToIndex)
+        {
+            for (auto& p : propertiesToIndex)
+                properties.add (new PropertyIndex (p));
+        }
+
+        PropertyIndex* getPropertyIndex (const Identifier& name) const noexcept
+        {
+            for (auto* p : properties)
+                if (p->name == name)
+                    return p;
+
+            return nullptr;
+        }
+
+        SharedObject* findChildWithType (const SharedObject& owner, const Identifier& typeToMatch)
+        {
+            update (owner);
+            return findFirst (types, typeToMatch.toString());
+        }
+
+        // Returns false if the index can't be used for this search
+        bool findChildWithProperty (const SharedObject& owner, const Identifier& name,
+                                    const var& value, SharedObject*& result)
+        {
+            auto* p = getPropertyIndex (name);
+
+            if (p == nullptr || ! isHashable (value))
+                return false;
+
+            update (owner);
+
+            if (p->numUnhashableValues > 0)
+                return false;
+
+            result = findFirst (p->children, value.toString());
+            return true;
+        }
+
+        void childAdded (const SharedObject& owner, SharedObject& child)
+        {
+            if (owner.children.getObjectPointerUnchecked (owner.children.size() - 1) == &child)
+                append (child);
+            else
+                needsRebuilding = true;
+        }
+
+        void childRemoved (SharedObject& child)
+        {
+            if (! needsRebuilding)
+            {
+                removeFromList (types, child.type.toString(), child);
+
+                for (auto* p : properties)
+                    removeValue (*p, child, child.properties[p->name]);
+            }
+        }
+
+        void childrenReordered() noexcept
+        {
+            needsRebuilding = true;
+        }
+
+        void propertyChanged (SharedObject& child, PropertyIndex& p, const var& oldValue)
+        {
+            if (! needsRebuilding)
+            {
+                removeValue (p, child, oldValue);
+
+                auto& newValue = child.properties[p.name];
+
+                // (if other children have this value, we'd need to search for its position in their list)
+                if (isHashable (newValue) && p.children.contains (newValue.toString()))
+                    needsRebuilding = true;
+                else
+                    addValue (p, child, newValue);
+            }
+        }
+
+    private:
+        ChildMap types;
+        OwnedArray<PropertyIndex> properties;
+        bool needsRebuilding = true;
+
+        // Between strings and integers, var's loose equality is the same as comparing their
+        // string forms, so only these types can be found with a hash of the string.
+        static bool isHashable (const var& v) noexcept    { return v.isString() || v.isInt() || v.isInt64(); }
+
+        static SharedObject* findFirst (ChildMap& map, const String& key)
+        {
+            return map.contains (key) ? map.getReference (key).getFirst() : nullptr;
+        }
+
+        static void removeFromList (ChildMap& map, const String& key, SharedObject& child)
+        {
+            if (map.contains (key))
+            {
+                auto& list = map.getReference (key);
+                list.removeFirstMatchingValue (&child);
+
+                if (list.isEmpty())
+                    map.remove (key);
+            }
+        }
+
+        static void addValue (PropertyIndex& p, SharedObject& child, const var& value)
+        {
+            if (isHashable (value))
+                p.children.getReference (value.toString()).add (&child);
+            else if (! (value.isVoid() || value.isUndefined()))
+                ++p.numUnhashableValues;
+        }
+
+        static void removeValue (PropertyIndex& p, SharedObject& child, const var& value)
+        {
+            if (isHashable (value))
+                removeFromList (p.children, value.toString(), child);
+            else if (! (value.isVoid() || value.isUndefined()))
+                --p.numUnhashableValues;
+        }
+
+        void append (SharedObject& child)
+        {
+            if (! needsRebuilding)
+            {
+                types.getReference (child.type.toString()).add (&child);
+
+                for (auto* p : properties)
+                    addValue (*p, child, child.properties[p->name]);
+            }
+        }
+
+        void update (const SharedObject& owner)
+        {
+            if (needsRebuilding)
+            {
+                types.clear();
+
+                for (auto* p : properties)
+                {
+                    p->children.clear();
+                    p->numUnhashableValues = 0;
+                }
+
+                needsRebuilding = false;
+
+                for (auto* c : owner.children)
+                    append (*c);
+            }
+        }
+
+        JUCE_DECLARE_NON_COPYABLE (ChildIndex)
+    };
+
+    // Makes a change to one of the properties, keeping the parent's index up to date
+    template <typename ChangeFunction>
+    bool changeProperty (const Identifier& name, ChangeFunction&& change)
+    {
+        if (parent != nullptr && parent->lookupIndex != nullptr)
+        {
+            if (auto* index = parent->lookupIndex->getPropertyIndex (name))
+            {
+                auto oldValue = properties[name];
+
+                if (! change())
+                    return false;
+
+                parent->lookupIndex->propertyChanged (*this, *index, oldValue);
+                return true;
+            }
+        }
+
+        return change();
+    }
+
     //==============================================================================
     const Identifier type;
     NamedValueSet properties;
     ReferenceCountedArray<SharedObject> children;
     SortedSet<ValueTree*> valueTreesWithListeners;
     SharedObject* parent = nullptr;
+    std::unique_ptr<ChildIndex> lookupIndex;
 
     JUCE_LEAK_DETECTOR (SharedObject)
 };
@@ -899,6 +1125,19 @@ ValueTree ValueTree::getChildWithProperty (const Identifier& propertyName, const
     return object != nullptr ? object->getChildWithProperty (propertyName, propertyValue) : ValueTree();
 }
 
+void ValueTree::setChildLookupIndexed (bool shouldBeIndexed, const Array<Identifier>& propertiesToIndex)
+{
+    jassert (object != nullptr); // Trying to index the children of an invalid tree!
+
+    if (object != nullptr)
+        object->lookupIndex.reset (shouldBeIndexed ? new SharedObject::ChildIndex (propertiesToIndex) : nullptr);
+}
+
+bool ValueTree::isChildLookupIndexed() const noexcept
+{
+    return object != nullptr && object->lookupIndex != nullptr;
+}
+
 bool ValueTree::isAChildOf (const ValueTree& possibleParent) const noexcept
 {
     return object != nullptr && object->isAChildOf (possibleParent.object.get());
@@ -1022,6 +1261,69 @@ ValueTree ValueTree::fromXml (const String& xmlText)
     return {};
 }
 
+ValueTree ValueTree::fromXml (XmlStreamReader& reader)
+{
+    using Event = XmlStreamReader::Event;
+
+    while (reader.getCurrentEvent() != Event::startElement)
+    {
+        auto event = reader.next();
+
+        if (event == Event::error || event == Event::endOfDocument)
+            return {};
+    }
+
+    ValueTree v (reader.getName());
+    auto& properties = v.object->properties;
+
+    for (;;)
+    {
+        switch (reader.next())
+        {
+            case Event::attribute:
+            {
+                auto name = reader.getName().toString();
+
+                if (name.startsWith ("base64:"))
+                {
+                    MemoryBlock mb;
+
+                    if (mb.fromBase64Encoding (reader.getText()))
+                    {
+                        properties.set (name.substring (7), var (mb));
+                        break;
+                    }
+                }
+
+                properties.set (reader.getName(), reader.getText());
+                break;
+            }
+
+            case Event::startElement:
+            {
+                auto child = fromXml (reader);
+
+                if (! child.isValid())
+                    return {};
+
+                v.appendChild (child, nullptr);
+                break;
+            }
+
+            case Event::text:
+                break; // ValueTrees don't have any equivalent to XML text elements
+
+            case Event::endElement:
+                return v;
+
+            case Event::endOfDocument:
+            case Event::error:
+            default:
+                return {};
+        }
+    }
+}
+
 String ValueTree::toXmlString (const XmlElement::TextFormat& format) const
 {
     if (auto xml = createXml())
@@ -1080,6 +1382,13 @@ ValueTree ValueTree::readFromStream (InputStream& input)
     return v;
 }
 
+ValueTree ValueTree::readFromStream (InputStream& input, MemoryArena::Ptr arenaToUse)
+{
+    jassert (arenaToUse != nullptr);
+    const MemoryArena::ScopedUse arenaScope (arenaToUse.get());
+    return readFromStream (input);
+}
+
 ValueTree ValueTree::readFromData (const void* data, size_t numBytes)
 {
     MemoryInputStream in (data, numBytes, false);
@@ -1199,7 +1508,89 @@ public:
 
                 auto v4 = v2.createCopy();
                 expect (v1.isEquivalentTo (v4));
+
+                auto xmlText = v1.toXmlString();
+                MemoryInputStream xmlIn (xmlText.toRawUTF8(), xmlText.getNumBytesAsUTF8(), false);
+                XmlStreamReader xmlReader (xmlIn, 64 + r.nextInt (256));
+                expect (ValueTree::fromXml (xmlReader).isEquivalentTo (ValueTree::fromXml (xmlText)));
+
+                MemoryArena::Ptr arena (new MemoryArena (2048));
+                MemoryInputStream arenaIn (mo.getData(), mo.getDataSize(), false);
+                auto v5 = ValueTree::readFromStream (arenaIn, arena);
+                expect (v1.isEquivalentTo (v5));
+                expect (arena->getReferenceCount() > 1);
+                v5 = {};
+                expectEquals (arena->getReferenceCount(), 1);
+            }
+        }
+
+        {
+            beginTest ("Child lookup index");
+
+            auto r = getRandom();
+            const Identifier types[] = { "A", "B", "C" }, idProperty ("id"), nameProperty ("name");
+
+            ValueTree plain ("Root"), indexed ("Root");
+            indexed.setChildLookupIndexed (true, { idProperty, nameProperty });
+            expect (indexed.isChildLookupIndexed() && ! plain.isChildLookupIndexed());
+
+            auto applyToBoth = [&] (std::function<void (ValueTree&)> change)
+            {
+                change (plain);
+                change (indexed);
+            };
+
+            for (int i = 0; i < 2000; ++i)
+            {
+                auto numChildren = plain.getNumChildren();
+                auto index = r.nextInt (jmax (1, numChildren));
+                auto action = numChildren < 5 ? 0 : r.nextInt (6);
+
+                if (action == 0)
+                {
+                    ValueTree child (types[r.nextInt (3)]);
+                    child.setProperty (idProperty, r.nextInt (20), nullptr);
+
+                    if (r.nextBool())
+                        child.setProperty (nameProperty, "n" + String (r.nextInt (10)), nullptr);
+
+                    auto position = r.nextBool() ? -1 : r.nextInt (numChildren + 1);
+                    applyToBoth ([&] (ValueTree& v) { v.addChild (child.createCopy(), position, nullptr); });
+                }
+                else if (action == 1)
+                {
+                    applyToBoth ([&] (ValueTree& v) { v.removeChild (index, nullptr); });
+                }
+                else if (action == 2)
+                {
+                    auto newIndex = r.nextInt (numChildren);
+                    applyToBoth ([&] (ValueTree& v) { v.moveChild (index, newIndex, nullptr); });
+                }
+                else if (action == 3)
+                {
+                    var newID (r.nextInt (20));
+                    applyToBoth ([&] (ValueTree& v) { v.getChild (index).setProperty (idProperty, newID, nullptr); });
+                }
+                else if (action == 4)
+                {
+                    applyToBoth ([&] (ValueTree& v) { v.getChild (index).removeProperty (nameProperty, nullptr); });
+                }
+                else
+                {
+                    var newName (r.nextInt (4) == 0 ? var (1.5) : var ("n" + String (r.nextInt (10))));
+                    applyToBoth ([&] (ValueTree& v) { v.getChild (index).setProperty (nameProperty, newName, nullptr); });
+                }
+
+                auto type = types[r.nextInt (3)];
+                var idToFind (r.nextBool() ? var (r.nextInt (20)) : var (String (r.nextInt (20))));
+                var nameToFind ("n" + String (r.nextInt (10)));
+
+                expectEquals (indexed.indexOf (indexed.getChildWithName (type)), plain.indexOf (plain.getChildWithName (type)));
+                expectEquals (indexed.indexOf (indexed.getChildWithProperty (idProperty, idToFind)), plain.indexOf (plain.getChildWithProperty (idProperty, idToFind)));
+                expectEquals (indexed.indexOf (indexed.getChildWithProperty (nameProperty, nameToFind)), plain.indexOf (plain.getChildWithProperty (nameProperty, nameToFind)));
             }
+
+            expect (indexed.isEquivalentTo (plain));
         }
 
         {
@@ -313,6 +313,25 @@ public:
     */
     ValueTree getChildWithProperty (const Identifier& propertyName, const var& propertyValue) const;
 
+    /** Makes this tree keep an index of its children, to speed up getChildWithName() and
+        getChildWithProperty() when it has a lot of them.
+
+        Without an index, those methods have to check each child in turn, but with one they
+        can go straight to the first match. getChildWithProperty() can only use the index
+        for the properties that are listed here, and when the value being searched for is
+        a string or an integer.
+
+        The index is kept up to date as children are added, removed or have their indexed
+        properties changed, so it adds a little work to each of those operations. It
+        belongs to this node, so it isn't copied by createCopy().
+
+        @see getChildWithName, getChildWithProperty
+    */
+    void setChildLookupIndexed (bool shouldBeIndexed, const Array<Identifier>& propertiesToIndex = {});
+
+    /** Returns true if setChildLookupIndexed() has been used to index this tree's children. */
+    bool isChildLookupIndexed() const noexcept;
+
     /** Adds a child to this tree.
         Make sure that the child being added has first been removed from any former parent before
         calling this, or else you'll hit an assertion.
@@ -442,6 +461,16 @@ public:
     */
     static ValueTree fromXml (const String& xmlText);
 
+    /** Tries to recreate a tree from XML that's being read by an XmlStreamReader.
+
+        This builds the tree directly from the reader's events, so it never needs to hold
+        the XML text or an XmlElement tree in memory. If the reader has just returned a
+        startElement event, that element is read, otherwise the reader is advanced to
+        the next element. As with the other fromXml() methods, this should only be fed
+        XML that was created by the createXml() method.
+    */
+    static ValueTree fromXml (XmlStreamReader& xmlReader);
+
     /** This returns a string containing an XML representation of the tree.
         This is quite handy for debugging purposes, as it provides a quick way to view a tree.
         @see createXml()
@@ -461,6 +490,17 @@ public:
     /** Reloads a tree from a stream that was written with writeToStream(). */
     static ValueTree readFromStream (InputStream& input);
 
+    /** Reloads a tree from a stream that was written with writeToStream(), allocating
+        all of its nodes from the given MemoryArena.
+
+        This is a quicker way to load a large tree, and to delete it again afterwards, as
+        the arena's memory is all released together when the last of the nodes has gone.
+        The nodes keep the arena alive, so it must be a heap-allocated object that's
+        managed by a MemoryArena::Ptr.
+        @see MemoryArena
+    */
+    static ValueTree readFromStream (InputStream& input, MemoryArena::Ptr arenaToUse);
+
     /** Reloads a tree from a data block that was written with writeToStream(). */
     static ValueTree readFromData (const void* data, size_t numBytes);
 
@@ -615,6 +655,7 @@ private:
     //==============================================================================
     JUCE_PUBLIC_IN_DLL_BUILD (class SharedObject)
     friend class SharedObject;
+    friend class ValueTreeSynchroniser;
 
     ReferenceCountedObjectPtr<SharedObject> object;
     ListenerList<Listener> listeners;
@@ -35,7 +35,9 @@ namespace ValueTreeSynchroniserHelpers
         childAdded       = 3,
         childRemoved     = 4,
         childMoved       = 5,
-        propertyRemoved  = 6
+        propertyRemoved  = 6,
+        changeBatch      = 7,
+        compressedSync   = 8
     };
 
     static void getValueTreePath (ValueTree v, const ValueTree& topLevelTree, Array<int>& path)
@@ -90,8 +92,441 @@ namespace ValueTreeSynchroniserHelpers
 
         return v;
     }
+
+    static bool removeChild (ValueTree& v, int index, UndoManager* undoManager)
+    {
+        if (isPositiveAndBelow (index, v.getNumChildren()))
+        {
+            v.removeChild (index, undoManager);
+            return true;
+        }
+
+        jassertfalse; // Either received some corrupt data, or the trees have drifted out of sync
+        return false;
+    }
+
+    static bool moveChild (ValueTree& v, int oldIndex, int newIndex, UndoManager* undoManager)
+    {
+        if (isPositiveAndBelow (oldIndex, v.getNumChildren())
+             && isPositiveAndBelow (newIndex, v.getNumChildren()))
+        {
+            v.moveChild (oldIndex, newIndex, undoManager);
+            return true;
+        }
+
+        jassertfalse; // Either received some corrupt data, or the trees have drifted out of sync
+        return false;
+    }
+
+    //==============================================================================
+    // The compact encoding that's used for batches of changes and compressed snapshots.
+    // Identifiers are only written out in full the first time they're used in a message,
+    // each path only stores the levels that differ from the previous one, and integers
+    // are written as variable-length 7-bit groups.
+    static void writeVarInt (OutputStream& out, uint64 value)
+    {
+        while (value >= 0x80)
+        {
+            out.writeByte ((char) ((value & 0x7f) | 0x80));
+            value >>= 7;
+        }
+
+        out.writeByte ((char) value);
+    }
+
+    static uint64 readVarInt (InputStream& in)
+    {
+        uint64 result = 0;
+
+        for (int shift = 0; shift < 64; shift += 7)
+        {
+            auto byte = (uint8) in.readByte();
+            result |= (uint64) (byte & 0x7f) << shift;
+
+            if ((byte & 0x80) == 0)
+                break;
+        }
+
+        return result;
+    }
+
+    static uint64 zigZagEncode (int64 n) noexcept    { return ((uint64) n << 1) ^ (uint64) (n >> 63); }
+    static int64 zigZagDecode (uint64 n) noexcept    { return (int64) (n >> 1) ^ -(int64) (n & 1); }
+
+    enum ValueTag
+    {
+        voidValue, intValue, int64Value, trueValue, falseValue, doubleValue, stringValue, otherValue
+    };
+
+    struct CompactWriter
+    {
+        explicit CompactWriter (OutputStream& o) : out (o) {}
+
+        void writeChangeHeader (ChangeType type, const ValueTree& v, const ValueTree& root)
+        {
+            out.writeByte ((char) type);
+
+            Array<int> reversedPath;
+            getValueTreePath (v, root, reversedPath);
+
+            auto numLevels = reversedPath.size();
+            int numShared = 0;
+
+            while (numShared < numLevels && numShared < lastPath.size()
+                    && reversedPath.getUnchecked (numLevels - 1 - numShared) == lastPath.getUnchecked (numShared))
+                ++numShared;
+
+            lastPath.removeRange (numShared, lastPath.size());
+
+            writeVarInt (out, (uint64) numShared);
+            writeVarInt (out, (uint64) (numLevels - numShared));
+
+            for (int i = numShared; i < numLevels; ++i)
+            {
+                auto index = reversedPath.getUnchecked (numLevels - 1 - i);
+                writeVarInt (out, (uint64) index);
+                lastPath.add (index);
+            }
+        }
+
+        void writeIdentifier (const Identifier& name)
+        {
+            auto* key = static_cast<const void*> (name.getCharPointer().getAddress());
+
+            if (identifierIndexes.contains (key))
+            {
+                writeVarInt (out, (uint64) identifierIndexes[key] + 1);
+            }
+            else
+            {
+                identifierIndexes.set (key, identifiers.size());
+                identifiers.add (name);  // (keeps the pooled string alive while its address is in use)
+                writeVarInt (out, 0);
+                writeString (name.toString());
+            }
+        }
+
+        void writeString (const String& text)
+        {
+            auto numBytes = text.getNumBytesAsUTF8();
+            writeVarInt (out, (uint64) numBytes);
+            out.write (text.toRawUTF8(), numBytes);
+        }
+
+        void writeValue (const var& value)
+        {
+            if (value.isVoid())
+            {
+                out.writeByte ((char) voidValue);
+            }
+            else if (value.isInt() || value.isInt64())
+            {
+                out.writeByte ((char) (value.isInt() ? intValue : int64Value));
+                writeVarInt (out, zigZagEncode ((int64) value));
+            }
+            else if (value.isBool())
+            {
+                out.writeByte ((char) (static_cast<bool> (value) ? trueValue : falseValue));
+            }
+            else if (value.isDouble())
+            {
+                out.writeByte ((char) doubleValue);
+                out.writeDouble (static_cast<double> (value));
+            }
+            else if (value.isString())
+            {
+                out.writeByte ((char) stringValue);
+                writeString (value.toString());
+            }
+            else
+            {
+                out.writeByte ((char) otherValue);
+                value.writeToStream (out);
+            }
+        }
+
+        void writeTree (const ValueTree& tree)
+        {
+            writeIdentifier (tree.getType());
+            writeVarInt (out, (uint64) tree.getNumProperties());
+
+            for (int i = 0; i < tree.getNumProperties(); ++i)
+            {
+                auto name = tree.getPropertyName (i);
+                writeIdentifier (name);
+                writeValue (tree[name]);
+            }
+
+            writeVarInt (out, (uint64) tree.getNumChildren());
+
+            for (const auto& child : tree)
+                writeTree (child);
+        }
+
+        OutputStream& out;
+        HashMap<const void*, int> identifierIndexes;
+        Array<Identifier> identifiers;
+        Array<int> lastPath;
+    };
+
+    struct CompactReader
+    {
+        explicit CompactReader (MemoryInputStream& i) : in (i) {}
+
+        int readInt()
+        {
+            auto n = readVarInt (in);
+
+            if (n > (uint64) std::numeric_limits<int>::max())
+                failed = true;
+
+            return (int) n;
+        }
+
+        // Reads a number of items that are about to follow, which can't be more than the number of bytes left
+        int readCount()
+        {
+            auto n = readVarInt (in);
+
+            if (n > (uint64) in.getNumBytesRemaining())
+            {
+                failed = true;
+                return 0;
+            }
+
+            return (int) n;
+        }
+
+        ValueTree readLocation (const ValueTree& root)
+        {
+            auto numShared = readInt(); // (this refers back to the previous path, not to data that follows)
+            auto numNewLevels = readCount();
+
+            if (failed || numShared > lastPath.size())
+                return {};
+
+            lastPath.removeRange (numShared, lastPath.size());
+
+            for (int i = 0; i < numNewLevels; ++i)
+                lastPath.add (readInt());
+
+            auto v = root;
+
+            for (auto index : lastPath)
+            {
+                if (! isPositiveAndBelow (index, v.getNumChildren()))
+                    return {};
+
+                v = v.getChild (index);
+            }
+
+            return v;
+        }
+
+        String readString()
+        {
+            auto numBytes = readCount();
+            auto* data = static_cast<const char*> (in.getData()) + in.getPosition();
+            in.skipNextBytes (numBytes);
+            return String::fromUTF8 (data, numBytes);
+        }
+
+        Identifier readIdentifier()
+        {
+            auto n = readVarInt (in);
+
+            if (n == 0)
+            {
+                auto name = readString();
+
+                if (name.isNotEmpty())
+                {
+                    identifiers.add (name);
+                    return identifiers.getReference (identifiers.size() - 1);
+                }
+            }
+            else if (n <= (uint64) identifiers.size())
+            {
+                return identifiers.getReference ((int) n - 1);
+            }
+
+            failed = true;
+            return {};
+        }
+
+        var readValue()
+        {
+            switch (in.readByte())
+            {
+                case voidValue:     return {};
+                case intValue:      return (int) zigZagDecode (readVarInt (in));
+                case int64Value:    return (int64) zigZagDecode (readVarInt (in));
+                case trueValue:     return true;
+                case falseValue:    return false;
+                case doubleValue:   return in.readDouble();
+                case stringValue:   return readString();
+                case otherValue:    return var::readFromStream (in);
+                default:            break;
+            }
+
+            failed = true;
+            return {};
+        }
+
+        ValueTree readTree()
+        {
+            auto type = readIdentifier();
+
+            if (failed)
+                return {};
+
+            ValueTree v (type);
+
+            for (int i = readCount(); --i >= 0 && ! failed;)
+            {
+                auto name = readIdentifier();
+                auto value = readValue();
+
+                if (! failed)
+                    v.setProperty (name, value, nullptr);
+            }
+
+            for (int i = readCount(); --i >= 0 && ! failed;)
+            {
+                auto child = readTree();
+
+                if (child.isValid())
+                    v.appendChild (child, nullptr);
+            }
+
+            return failed ? ValueTree() : v;
+        }
+
+        bool applyNextChange (ValueTree& root, UndoManager* undoManager)
+        {
+            auto type = (ChangeType) in.readByte();
+            auto v = readLocation (root);
+
+            if (! v.isValid())
+                return false;
+
+            switch (type)
+            {
+                case propertyChanged:
+                {
+                    auto property = readIdentifier();
+                    auto value = readValue();
+
+                    if (failed)
+                        return false;
+
+                    v.setProperty (property, value, undoManager);
+                    return true;
+                }
+
+                case propertyRemoved:
+                {
+                    auto property = readIdentifier();
+
+                    if (failed)
+                        return false;
+
+                    v.removeProperty (property, undoManager);
+                    return true;
+                }
+
+                case childAdded:
+                {
+                    auto index = readInt();
+                    auto child = readTree();
+
+                    if (failed)
+                        return false;
+
+                    v.addChild (child, index, undoManager);
+                    return true;
+                }
+
+                case childRemoved:
+                    return removeChild (v, readInt(), undoManager);
+
+                case childMoved:
+                {
+                    auto oldIndex = readInt();
+                    return moveChild (v, oldIndex, readInt(), undoManager);
+                }
+
+                case fullSync:
+                case changeBatch:
+                case compressedSync:
+                default:
+                    jassertfalse; // Seem to have received some corrupt data?
+                    break;
+            }
+
+            return false;
+        }
+
+        MemoryInputStream& in;
+        Array<Identifier> identifiers;
+        Array<int> lastPath;
+        bool failed = false;
+    };
 }
 
+//==============================================================================
+struct ValueTreeSynchroniser::PendingChanges
+{
+    // Property changes are written at the end of the batch, so that each one only
+    // has to be sent once, with its latest value and its tree's final position.
+    void addPropertyChange (const ValueTree& tree, const Identifier& property)
+    {
+        auto& properties = changedProperties.getReference (tree.object.get());
+
+        if (properties.isEmpty())
+            changedTrees.add (tree);
+
+        properties.addIfNotAlreadyThere (property);
+    }
+
+    void writePropertyChanges (const ValueTree& root)
+    {
+        using namespace ValueTreeSynchroniserHelpers;
+
+        for (auto& tree : changedTrees)
+        {
+            if (tree != root && ! tree.isAChildOf (root))
+                continue;
+
+            for (auto& property : changedProperties.getReference (tree.object.get()))
+            {
+                if (auto* value = tree.getPropertyPointer (property))
+                {
+                    writer.writeChangeHeader (propertyChanged, tree, root);
+                    writer.writeIdentifier (property);
+                    writer.writeValue (*value);
+                }
+                else
+                {
+                    writer.writeChangeHeader (propertyRemoved, tree, root);
+                    writer.writeIdentifier (property);
+                }
+            }
+        }
+    }
+
+    bool isEmpty() const noexcept
+    {
+        return changedTrees.isEmpty() && data.getDataSize() <= 1;
+    }
+
+    MemoryOutputStream data;
+    ValueTreeSynchroniserHelpers::CompactWriter writer { data };
+    Array<ValueTree> changedTrees;
+    HashMap<const void*, Array<Identifier>> changedProperties;
+};
+
+//==============================================================================
 ValueTreeSynchroniser::ValueTreeSynchroniser (const ValueTree& tree)  : valueTree (tree)
 {
     valueTree.addListener (this);
@@ -104,14 +539,65 @@ ValueTreeSynchroniser::~ValueTreeSynchroniser()
 
 void ValueTreeSynchroniser::sendFullSyncCallback()
 {
+    if (pendingChanges != nullptr)
+        setChangeBatchingEnabled (true); // (discards any pending changes, as they're included in the full state)
+
     MemoryOutputStream m;
-    writeHeader (m, ValueTreeSynchroniserHelpers::fullSync);
-    valueTree.writeToStream (m);
+
+    if (compressFullSync)
+    {
+        writeHeader (m, ValueTreeSynchroniserHelpers::compressedSync);
+
+        GZIPCompressorOutputStream compressed (m);
+        ValueTreeSynchroniserHelpers::CompactWriter (compressed).writeTree (valueTree);
+    }
+    else
+    {
+        writeHeader (m, ValueTreeSynchroniserHelpers::fullSync);
+        valueTree.writeToStream (m);
+    }
+
     stateChanged (m.getData(), m.getDataSize());
 }
 
+void ValueTreeSynchroniser::setChangeBatchingEnabled (bool shouldBatchChanges)
+{
+    if (! shouldBatchChanges)
+        flushPendingChanges();
+
+    cancelPendingUpdate();
+    pendingChanges.reset (shouldBatchChanges ? new PendingChanges() : nullptr);
+
+    if (pendingChanges != nullptr)
+        writeHeader (pendingChanges->data, ValueTreeSynchroniserHelpers::changeBatch);
+}
+
+void ValueTreeSynchroniser::flushPendingChanges()
+{
+    if (pendingChanges == nullptr || pendingChanges->isEmpty())
+        return;
+
+    std::unique_ptr<PendingChanges> changes (pendingChanges.release());
+    setChangeBatchingEnabled (true);
+
+    changes->writePropertyChanges (valueTree);
+    stateChanged (changes->data.getData(), changes->data.getDataSize());
+}
+
+void ValueTreeSynchroniser::handleAsyncUpdate()
+{
+    flushPendingChanges();
+}
+
 void ValueTreeSynchroniser::valueTreePropertyChanged (ValueTree& vt, const Identifier& property)
 {
+    if (pendingChanges != nullptr)
+    {
+        pendingChanges->addPropertyChange (vt, property);
+        triggerAsyncUpdate();
+        return;
+    }
+
     MemoryOutputStream m;
 
     if (auto* value = vt.getPropertyPointer (property))
@@ -134,6 +620,16 @@ void ValueTreeSynchroniser::valueTreeChildAdded (ValueTree& parentTree, ValueTre
     const int index = parentTree.indexOf (childTree);
     jassert (index >= 0);
 
+    if (pendingChanges != nullptr)
+    {
+        auto& writer = pendingChanges->writer;
+        writer.writeChangeHeader (ValueTreeSynchroniserHelpers::childAdded, parentTree, valueTree);
+        ValueTreeSynchroniserHelpers::writeVarInt (writer.out, (uint64) index);
+        writer.writeTree (childTree);
+        triggerAsyncUpdate();
+        return;
+    }
+
     MemoryOutputStream m;
     ValueTreeSynchroniserHelpers::writeHeader (*this, m, ValueTreeSynchroniserHelpers::childAdded, parentTree);
     m.writeCompressedInt (index);
@@ -143,6 +639,15 @@ void ValueTreeSynchroniser::valueTreeChildAdded (ValueTree& parentTree, ValueTre
 
 void ValueTreeSynchroniser::valueTreeChildRemoved (ValueTree& parentTree, ValueTree&, int oldIndex)
 {
+    if (pendingChanges != nullptr)
+    {
+        auto& writer = pendingChanges->writer;
+        writer.writeChangeHeader (ValueTreeSynchroniserHelpers::childRemoved, parentTree, valueTree);
+        ValueTreeSynchroniserHelpers::writeVarInt (writer.out, (uint64) oldIndex);
+        triggerAsyncUpdate();
+        return;
+    }
+
     MemoryOutputStream m;
     ValueTreeSynchroniserHelpers::writeHeader (*this, m, ValueTreeSynchroniserHelpers::childRemoved, parentTree);
     m.writeCompressedInt (oldIndex);
@@ -151,6 +656,16 @@ void ValueTreeSynchroniser::valueTreeChildRemoved (ValueTree& parentTree, ValueT
 
 void ValueTreeSynchroniser::valueTreeChildOrderChanged (ValueTree& parent, int oldIndex, int newIndex)
 {
+    if (pendingChanges != nullptr)
+    {
+        auto& writer = pendingChanges->writer;
+        writer.writeChangeHeader (ValueTreeSynchroniserHelpers::childMoved, parent, valueTree);
+        ValueTreeSynchroniserHelpers::writeVarInt (writer.out, (uint64) oldIndex);
+        ValueTreeSynchroniserHelpers::writeVarInt (writer.out, (uint64) newIndex);
+        triggerAsyncUpdate();
+        return;
+    }
+
     MemoryOutputStream m;
     ValueTreeSynchroniserHelpers::writeHeader (*this, m, ValueTreeSynchroniserHelpers::childMoved, parent);
     m.writeCompressedInt (oldIndex);
@@ -170,6 +685,32 @@ bool ValueTreeSynchroniser::applyChange (ValueTree& root, const void* data, size
         return true;
     }
 
+    if (type == ValueTreeSynchroniserHelpers::compressedSync)
+    {
+        MemoryBlock uncompressed;
+        GZIPDecompressorInputStream (input).readIntoMemoryBlock (uncompressed);
+
+        MemoryInputStream treeData (uncompressed, false);
+        auto newTree = ValueTreeSynchroniserHelpers::CompactReader (treeData).readTree();
+
+        if (! newTree.isValid())
+            return false;
+
+        root = newTree;
+        return true;
+    }
+
+    if (type == ValueTreeSynchroniserHelpers::changeBatch)
+    {
+        ValueTreeSynchroniserHelpers::CompactReader reader (input);
+
+        while (! input.isExhausted())
+            if (! reader.applyNextChange (root, undoManager))
+                return false;
+
+        return true;
+    }
+
     ValueTree v (ValueTreeSynchroniserHelpers::readSubTreeLocation (input, root));
 
     if (! v.isValid())
@@ -199,36 +740,18 @@ bool ValueTreeSynchroniser::applyChange (ValueTree& root, const void* data, size
         }
 
         case ValueTreeSynchroniserHelpers::childRemoved:
-        {
-            const int index = input.readCompressedInt();
-
-            if (isPositiveAndBelow (index, v.getNumChildren()))
-            {
-                v.removeChild (index, undoManager);
-                return true;
-            }
-
-            jassertfalse; // Either received some corrupt data, or the trees have drifted out of sync
-            break;
-        }
+            return ValueTreeSynchroniserHelpers::removeChild (v, input.readCompressedInt(), undoManager);
 
         case ValueTreeSynchroniserHelpers::childMoved:
         {
             const int oldIndex = input.readCompressedInt();
             const int newIndex = input.readCompressedInt();
-
-            if (isPositiveAndBelow (oldIndex, v.getNumChildren())
-                 && isPositiveAndBelow (newIndex, v.getNumChildren()))
-            {
-                v.moveChild (oldIndex, newIndex, undoManager);
-                return true;
-            }
-
-            jassertfalse; // Either received some corrupt data, or the trees have drifted out of sync
-            break;
+            return ValueTreeSynchroniserHelpers::moveChild (v, oldIndex, newIndex, undoManager);
         }
 
         case ValueTreeSynchroniserHelpers::fullSync:
+        case ValueTreeSynchroniserHelpers::changeBatch:
+        case ValueTreeSynchroniserHelpers::compressedSync:
             break;
 
         default:
@@ -239,4 +762,150 @@ bool ValueTreeSynchroniser::applyChange (ValueTree& root, const void* data, size
     return false;
 }
 
+//==============================================================================
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class ValueTreeSynchroniserTests  : public UnitTest
+{
+public:
+    ValueTreeSynchroniserTests()
+        : UnitTest ("ValueTreeSynchroniser", UnitTestCategories::values)
+    {}
+
+    struct TestSynchroniser  : public ValueTreeSynchroniser
+    {
+        TestSynchroniser (const ValueTree& source, ValueTree& dest)
+            : ValueTreeSynchroniser (source), target (dest)
+        {}
+
+        void stateChanged (const void* data, size_t size) override
+        {
+            ++numMessages;
+            numBytes += size;
+
+            if (! applyChange (target, data, size, nullptr))
+                allChangesApplied = false;
+        }
+
+        ValueTree& target;
+        int numMessages = 0;
+        size_t numBytes = 0;
+        bool allChangesApplied = true;
+    };
+
+    static void makeRandomChange (ValueTree v, Random& r)
+    {
+        while (v.getNumChildren() > 0 && r.nextInt (3) != 0)
+            v = v.getChild (r.nextInt (v.getNumChildren()));
+
+        Identifier property ("p" + String (r.nextInt (5)));
+        auto numChildren = v.getNumChildren();
+
+        switch (r.nextInt (6))
+        {
+            case 0:   v.setProperty (property, r.nextInt (100), nullptr); break;
+            case 1:   v.setProperty (property, r.nextBool() ? var (r.nextDouble()) : var ("text" + String (r.nextInt (10))), nullptr); break;
+            case 2:   v.removeProperty (property, nullptr); break;
+            case 3:   v.addChild (ValueTree ("Node", { { "id", r.nextInt() } }, { ValueTree ("Sub") }), r.nextInt (numChildren + 1), nullptr); break;
+            case 4:   if (numChildren > 0) v.removeChild (r.nextInt (numChildren), nullptr); break;
+            default:  if (numChildren > 1) v.moveChild (r.nextInt (numChildren), r.nextInt (numChildren), nullptr); break;
+        }
+    }
+
+    void runTest() override
+    {
+        auto r = getRandom();
+
+        for (auto batched : { false, true })
+        {
+            beginTest (batched ? "Batched changes" : "Individual changes");
+
+            ValueTree source ("Root"), target;
+            TestSynchroniser sync (source, target);
+            sync.setChangeBatchingEnabled (batched);
+            sync.sendFullSyncCallback();
+
+            for (int i = 0; i < 50; ++i)
+            {
+                for (int j = r.nextInt (40); --j >= 0;)
+                    makeRandomChange (source, r);
+
+                sync.flushPendingChanges();
+                expect (target.isEquivalentTo (source));
+            }
+
+            expect (sync.allChangesApplied);
+        }
+
+        beginTest ("Coalescing");
+        {
+            ValueTree source ("Root", {}, { ValueTree ("Child") }), target;
+            TestSynchroniser sync (source, target);
+            sync.sendFullSyncCallback();
+            sync.setChangeBatchingEnabled (true);
+
+            auto bytesBefore = sync.numBytes;
+
+            for (int i = 0; i < 1000; ++i)
+                source.getChild (0).setProperty ("value", i, nullptr);
+
+            sync.flushPendingChanges();
+            sync.flushPendingChanges();
+
+            expectEquals (sync.numMessages, 2);
+            expect (sync.numBytes - bytesBefore < 16);
+            expect (target.isEquivalentTo (source));
+        }
+
+        beginTest ("Deep paths at the end of a batch");
+        {
+            ValueTree source ("Root"), target;
+            auto leaf = source;
+
+            for (int i = 0; i < 8; ++i)
+            {
+                leaf.appendChild (ValueTree ("Node"), nullptr);
+                leaf = leaf.getChild (0);
+            }
+
+            TestSynchroniser sync (source, target);
+            sync.sendFullSyncCallback();
+            sync.setChangeBatchingEnabled (true);
+
+            // The second change shares the whole of the first one's path, which is
+            // more levels than there are bytes left in the message after it
+            leaf.setProperty ("a", 1, nullptr);
+            leaf.setProperty ("b", 2, nullptr);
+            sync.flushPendingChanges();
+
+            expect (sync.allChangesApplied);
+            expect (target.isEquivalentTo (source));
+        }
+
+        beginTest ("Compressed full sync");
+        {
+            ValueTree source ("Root"), target;
+
+            for (int i = 0; i < 200; ++i)
+                source.appendChild (ValueTree ("Node", { { "id", i }, { "name", "node" + String (i) } }), nullptr);
+
+            TestSynchroniser sync (source, target);
+            sync.sendFullSyncCallback();
+            auto uncompressedSize = sync.numBytes;
+
+            target = {};
+            sync.setFullSyncCompressionEnabled (true);
+            sync.sendFullSyncCallback();
+
+            expect (sync.allChangesApplied && target.isEquivalentTo (source));
+            expect (sync.numBytes - uncompressedSize < uncompressedSize / 4);
+        }
+    }
+};
+
+static ValueTreeSynchroniserTests valueTreeSynchroniserTests;
+
+#endif
+
 } // namespace juce
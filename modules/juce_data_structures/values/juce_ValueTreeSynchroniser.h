@@ -40,9 +40,14 @@ namespace juce
     via a network or other means) to a remote destination, where it can be
     applied to a target tree.
 
+    By default, stateChanged() is called for every single change to the tree. If the
+    tree changes a lot, you can use setChangeBatchingEnabled() to collect the changes
+    together and send them as one compact message on the next message loop callback.
+
     @tags{DataStructures}
 */
-class JUCE_API  ValueTreeSynchroniser  : private ValueTree::Listener
+class JUCE_API  ValueTreeSynchroniser  : private ValueTree::Listener,
+                                         private AsyncUpdater
 {
 public:
     /** Creates a ValueTreeSynchroniser that watches the given tree.
@@ -70,6 +75,30 @@ public:
     */
     void sendFullSyncCallback();
 
+    /** Makes the synchroniser collect changes together instead of sending each one
+        separately.
+
+        When this is enabled, the changes that are made to the tree are gathered up and
+        sent in a single stateChanged() call on the next message loop callback, or when
+        flushPendingChanges() is called. Several changes to the same property within a
+        batch are merged, so only its latest value is sent, and the batch uses a much
+        more compact encoding than the individual messages.
+
+        Any changes that are still pending when the synchroniser is deleted are discarded.
+    */
+    void setChangeBatchingEnabled (bool shouldBatchChanges);
+
+    /** If change batching is enabled, this immediately sends any changes that have been
+        collected so far.
+        @see setChangeBatchingEnabled
+    */
+    void flushPendingChanges();
+
+    /** Makes sendFullSyncCallback() compress the data that it sends.
+        This takes more time, but will make the message for a large tree much smaller.
+    */
+    void setFullSyncCompressionEnabled (bool shouldCompress) noexcept    { compressFullSync = shouldCompress; }
+
     /** Applies an encoded change to the given destination tree.
 
         When you implement a receiver for changes that were sent by the stateChanged()
@@ -84,8 +113,13 @@ public:
     const ValueTree& getRoot() noexcept       { return valueTree; }
 
 private:
+    struct PendingChanges;
+
     ValueTree valueTree;
+    std::unique_ptr<PendingChanges> pendingChanges;
+    bool compressFullSync = false;
 
+    void handleAsyncUpdate() override;
     void valueTreePropertyChanged (ValueTree&, const Identifier&) override;
     void valueTreeChildAdded (ValueTree&, ValueTree&) override;
     void valueTreeChildRemoved (ValueTree&, ValueTree&, int) override;
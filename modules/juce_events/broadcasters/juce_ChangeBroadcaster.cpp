@@ -23,13 +23,102 @@
 namespace juce
 {
 
+//==============================================================================
+/*  Delivers the pending changes of all the broadcasters in the app with a single
+    message, rather than each broadcaster posting one of its own.
+*/
+class ChangeBroadcaster::PendingChangeDispatcher  : private AsyncUpdater,
+                                                   private DeletedAtShutdown
+{
+public:
+    PendingChangeDispatcher() = default;
+
+    ~PendingChangeDispatcher() override
+    {
+        clearSingletonInstance();
+    }
+
+    void add (ChangeBroadcaster& b)
+    {
+        {
+            const SpinLock::ScopedLockType sl (lock);
+
+            if (b.isQueued)
+                return;
+
+            b.isQueued = true;
+            queue.add (&b);
+        }
+
+        triggerAsyncUpdate();
+    }
+
+    void remove (ChangeBroadcaster& b)
+    {
+        const SpinLock::ScopedLockType sl (lock);
+
+        if (b.isQueued)
+        {
+            b.isQueued = false;
+            queue.removeFirstMatchingValue (&b);
+            beingDelivered.removeFirstMatchingValue (&b);
+        }
+    }
+
+    JUCE_DECLARE_SINGLETON (PendingChangeDispatcher, false)
+
+private:
+    SpinLock lock;
+    Array<ChangeBroadcaster*> queue, beingDelivered;
+
+    void handleAsyncUpdate() override
+    {
+        {
+            const SpinLock::ScopedLockType sl (lock);
+            jassert (beingDelivered.isEmpty());
+
+            // Anything that's triggered while these are being delivered goes into the
+            // queue, and will be delivered by the next message.
+            beingDelivered.swapWith (queue);
+            std::reverse (beingDelivered.begin(), beingDelivered.end());
+        }
+
+        for (;;)
+        {
+            ChangeBroadcaster* b = nullptr;
+
+            {
+                const SpinLock::ScopedLockType sl (lock);
+
+                if (beingDelivered.isEmpty())
+                    break;
+
+                b = beingDelivered.removeAndReturn (beingDelivered.size() - 1);
+                b->isQueued = false;
+            }
+
+            // One broadcaster's listeners may delete other broadcasters, so this
+            // relies on their destructors taking them out of the list.
+            if (b->changePending.exchange (false))
+                b->callListeners();
+        }
+    }
+
+    JUCE_DECLARE_NON_COPYABLE (PendingChangeDispatcher)
+};
+
+JUCE_IMPLEMENT_SINGLETON (ChangeBroadcaster::PendingChangeDispatcher)
+
+//==============================================================================
 ChangeBroadcaster::ChangeBroadcaster() noexcept
 {
-    broadcastCallback.owner = this;
 }
 
 ChangeBroadcaster::~ChangeBroadcaster()
 {
+    if (isQueued)
+        if (auto* dispatcher = PendingChangeDispatcher::getInstanceWithoutCreating())
+            dispatcher->remove (*this);
 }
 
 void ChangeBroadcaster::addChangeListener (ChangeListener* const listener)
@@ -64,8 +153,8 @@ void ChangeBroadcaster::removeAllChangeListeners()
 
 void ChangeBroadcaster::sendChangeMessage()
 {
-    if (anyListeners)
-        broadcastCallback.triggerAsyncUpdate();
+    if (anyListeners && ! changePending.exchange (true))
+        PendingChangeDispatcher::getInstance()->add (*this);
 }
 
 void ChangeBroadcaster::sendSynchronousChangeMessage()
@@ -73,13 +162,17 @@ void ChangeBroadcaster::sendSynchronousChangeMessage()
     // This can only be called by the event thread.
     JUCE_ASSERT_MESSAGE_MANAGER_IS_LOCKED
 
-    broadcastCallback.cancelPendingUpdate();
+    changePending = false;
     callListeners();
 }
 
 void ChangeBroadcaster::dispatchPendingMessages()
 {
-    broadcastCallback.handleUpdateNowIfNeeded();
+    // This can only be called by the event thread.
+    JUCE_ASSERT_MESSAGE_MANAGER_IS_LOCKED
+
+    if (changePending.exchange (false))
+        callListeners();
 }
 
 void ChangeBroadcaster::callListeners()
@@ -87,16 +180,4 @@ void ChangeBroadcaster::callListeners()
     changeListeners.call ([this] (ChangeListener& l) { l.changeListenerCallback (this); });
 }
 
-//==============================================================================
-ChangeBroadcaster::ChangeBroadcasterCallback::ChangeBroadcasterCallback()
-    : owner (nullptr)
-{
-}
-
-void ChangeBroadcaster::ChangeBroadcasterCallback::handleAsyncUpdate()
-{
-    jassert (owner != nullptr);
-    owner->callListeners();
-}
-
 } // namespace juce
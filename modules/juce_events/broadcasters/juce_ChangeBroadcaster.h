@@ -61,6 +61,11 @@ public:
         The message will be delivered asynchronously by the main message thread, so this
         method will return immediately. To call the listeners synchronously use
         sendSynchronousChangeMessage().
+
+        Rather than each broadcaster posting its own message, all the broadcasters that
+        have a change pending are delivered together, by a single message that works
+        through them in the order in which they were triggered. Calling this again before
+        the change has been delivered has no effect.
     */
     void sendChangeMessage();
 
@@ -82,20 +87,12 @@ public:
 
 private:
     //==============================================================================
-    class ChangeBroadcasterCallback  : public AsyncUpdater
-    {
-    public:
-        ChangeBroadcasterCallback();
-        void handleAsyncUpdate() override;
-
-        ChangeBroadcaster* owner;
-    };
+    class PendingChangeDispatcher;
+    friend class PendingChangeDispatcher;
 
-    friend class ChangeBroadcasterCallback;
-    ChangeBroadcasterCallback broadcastCallback;
     ListenerList <ChangeListener> changeListeners;
 
-    std::atomic<bool> anyListeners { false };
+    std::atomic<bool> anyListeners { false }, changePending { false }, isQueued { false };
 
     void callListeners();
 
@@ -51,6 +51,7 @@
 
 #elif JUCE_LINUX
  #include <unistd.h>
+ #include <sys/eventfd.h>
 #endif
 
 //==============================================================================
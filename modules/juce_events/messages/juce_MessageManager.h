@@ -189,6 +189,15 @@ public:
 
         using Ptr = ReferenceCountedObjectPtr<MessageBase>;
 
+    private:
+       #if JUCE_LINUX
+        // The Linux message queue links the messages together directly
+        friend class InternalMessageQueue;
+        std::atomic<MessageBase*> nextInQueue { nullptr };
+        std::atomic<bool> isInQueue { false };
+        int64 timePosted = 0;
+       #endif
+
         JUCE_DECLARE_NON_COPYABLE (MessageBase)
     };
 
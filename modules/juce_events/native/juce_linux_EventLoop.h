@@ -45,6 +45,27 @@ namespace LinuxEventLoop
         @see registerFdCallback
     */
     void unregisterFdCallback (int fd);
+
+    /** Some figures describing the traffic through the message queue.
+        @see getMessageQueueStatistics
+    */
+    struct MessageQueueStatistics
+    {
+        int numPendingMessages = 0;         /**< The number of messages currently waiting to be delivered. */
+        int maxPendingMessages = 0;         /**< The largest number of messages that have been waiting at once. */
+        int64 numMessagesDelivered = 0;     /**< The number of messages that have been delivered. */
+        double averageLatencySeconds = 0;   /**< The average time between a message being posted and delivered. */
+        double maxLatencySeconds = 0;       /**< The longest time between a message being posted and delivered. */
+    };
+
+    /** Returns some statistics about the messages that have been posted to the message thread.
+        Apart from numPendingMessages, these are accumulated since the queue was created or
+        resetMessageQueueStatistics() was last called.
+    */
+    MessageQueueStatistics getMessageQueueStatistics();
+
+    /** Resets the figures returned by getMessageQueueStatistics(). */
+    void resetMessageQueueStatistics();
 }
 
 } // namespace juce
@@ -24,35 +24,40 @@ namespace juce
 {
 
 //==============================================================================
+/*  The message queue is a lock-free linked list that any number of threads can
+    push messages onto, and only the message thread takes them off.
+
+    The messages are linked together directly, so posting one doesn't allocate. The
+    same MessageBase can legitimately be posted again while it's still in the queue
+    (the Timer thread does this if its message seems to have got lost), so in that
+    case the second post is carried by a small message that forwards the callback.
+
+    The message thread is woken with an eventfd, which is only written to when the
+    queue goes from idle to having something in it, so a burst of posts costs a single
+    system call, and each wake-up only delivers a limited number of messages before
+    returning to the event loop so that other file descriptors don't get starved.
+*/
 class InternalMessageQueue
 {
 public:
     InternalMessageQueue()
     {
-        auto err = ::socketpair (AF_LOCAL, SOCK_STREAM, 0, msgpipe);
-        jassert (err == 0);
-        ignoreUnused (err);
-
-        LinuxEventLoop::registerFdCallback (getReadHandle(),
-                                            [this] (int fd)
-                                            {
-                                                while (auto msg = popNextMessage (fd))
-                                                {
-                                                    JUCE_TRY
-                                                    {
-                                                        msg->messageCallback();
-                                                    }
-                                                    JUCE_CATCH_EXCEPTION
-                                                }
-                                            });
+        head = &stub;
+        tail = &stub;
+
+        wakeupFd = eventfd (0, EFD_NONBLOCK | EFD_CLOEXEC);
+        jassert (wakeupFd >= 0);
+
+        LinuxEventLoop::registerFdCallback (wakeupFd, [this] (int) { deliverMessages(); });
     }
 
     ~InternalMessageQueue()
     {
-        LinuxEventLoop::unregisterFdCallback (getReadHandle());
+        LinuxEventLoop::unregisterFdCallback (wakeupFd);
+        close (wakeupFd);
 
-        close (getReadHandle());
-        close (getWriteHandle());
+        while (popMessage() != nullptr)
+        {}
 
         clearSingletonInstance();
     }
@@ -60,49 +65,183 @@ public:
     //==============================================================================
     void postMessage (MessageManager::MessageBase* const msg) noexcept
     {
-        ScopedLock sl (lock);
-        queue.add (msg);
+        auto* message = msg->isInQueue.exchange (true) ? new RepeatedMessage (msg) : msg;
 
-        if (bytesInSocket < maxBytesInSocketQueue)
-        {
-            bytesInSocket++;
+        // The queue keeps a reference to each message until it's been delivered
+        message->incReferenceCount();
+        message->nextInQueue.store (nullptr, std::memory_order_relaxed);
+        message->timePosted = Time::getHighResolutionTicks();
 
-            ScopedUnlock ul (lock);
-            unsigned char x = 0xff;
-            auto numBytes = write (getWriteHandle(), &x, 1);
-            ignoreUnused (numBytes);
-        }
+        updateMaximum (maxPendingMessages, ++numPendingMessages);
+
+        auto* previous = tail.exchange (message);
+        previous->nextInQueue.store (message);
+
+        if (! wakeupPending.exchange (true))
+            signalWakeup();
+    }
+
+    LinuxEventLoop::MessageQueueStatistics getStatistics() const noexcept
+    {
+        LinuxEventLoop::MessageQueueStatistics stats;
+        stats.numPendingMessages   = numPendingMessages.load (std::memory_order_relaxed);
+        stats.maxPendingMessages   = maxPendingMessages.load (std::memory_order_relaxed);
+        stats.numMessagesDelivered = numMessagesDelivered.load (std::memory_order_relaxed);
+        stats.maxLatencySeconds    = Time::highResolutionTicksToSeconds (maxLatencyTicks.load (std::memory_order_relaxed));
+        stats.averageLatencySeconds = stats.numMessagesDelivered > 0
+                                        ? Time::highResolutionTicksToSeconds (totalLatencyTicks.load (std::memory_order_relaxed))
+                                            / (double) stats.numMessagesDelivered
+                                        : 0.0;
+        return stats;
+    }
+
+    void resetStatistics() noexcept
+    {
+        maxPendingMessages.store (numPendingMessages.load (std::memory_order_relaxed), std::memory_order_relaxed);
+        numMessagesDelivered.store (0, std::memory_order_relaxed);
+        totalLatencyTicks.store (0, std::memory_order_relaxed);
+        maxLatencyTicks.store (0, std::memory_order_relaxed);
     }
 
+    static constexpr int maxMessagesPerWakeup = 128;
+
     //==============================================================================
     JUCE_DECLARE_SINGLETON (InternalMessageQueue, false)
 
 private:
-    CriticalSection lock;
-    ReferenceCountedArray <MessageManager::MessageBase> queue;
+    using MessageBase = MessageManager::MessageBase;
 
-    int msgpipe[2];
-    int bytesInSocket = 0;
-    static constexpr int maxBytesInSocketQueue = 128;
+    struct StubMessage  : public MessageBase
+    {
+        void messageCallback() override {}
+    };
 
-    int getWriteHandle() const noexcept  { return msgpipe[0]; }
-    int getReadHandle() const noexcept   { return msgpipe[1]; }
+    struct RepeatedMessage  : public MessageBase
+    {
+        explicit RepeatedMessage (MessageBase::Ptr m)  : original (std::move (m)) {}
+        void messageCallback() override    { original->messageCallback(); }
+
+        MessageBase::Ptr original;
+    };
+
+    StubMessage stub;
+    std::atomic<MessageBase*> tail;
+    MessageBase* head;     // only used by the message thread
+
+    int wakeupFd = -1;
+    std::atomic<bool> wakeupPending { false };
 
-    MessageManager::MessageBase::Ptr popNextMessage (int fd) noexcept
+    std::atomic<int> numPendingMessages { 0 }, maxPendingMessages { 0 };
+    std::atomic<int64> numMessagesDelivered { 0 }, totalLatencyTicks { 0 }, maxLatencyTicks { 0 };
+
+    template <typename Type>
+    static void updateMaximum (std::atomic<Type>& maximum, Type value) noexcept
     {
-        const ScopedLock sl (lock);
+        auto current = maximum.load (std::memory_order_relaxed);
+
+        while (value > current && ! maximum.compare_exchange_weak (current, value, std::memory_order_relaxed))
+        {}
+    }
+
+    void signalWakeup() noexcept
+    {
+        uint64_t one = 1;
+        auto numBytes = write (wakeupFd, &one, sizeof (one));
+        ignoreUnused (numBytes);
+    }
+
+    void deliverMessages()
+    {
+        uint64_t count;
+        auto numBytes = read (wakeupFd, &count, sizeof (count));
+        ignoreUnused (numBytes);
+
+        // This must be cleared before looking at the queue, so that anything that gets
+        // posted from now on will trigger another wake-up.
+        wakeupPending.store (false);
+
+        for (int i = 0; i < maxMessagesPerWakeup; ++i)
+        {
+            auto message = popMessage();
+
+            if (message == nullptr)
+                break;
+
+            auto latency = Time::getHighResolutionTicks() - message->timePosted;
+            totalLatencyTicks.fetch_add (latency, std::memory_order_relaxed);
+            numMessagesDelivered.fetch_add (1, std::memory_order_relaxed);
+            updateMaximum (maxLatencyTicks, latency);
+
+            JUCE_TRY
+            {
+                JUCE_TRACE_SCOPE ("MessageManager::dispatch");
+                message->messageCallback();
+            }
+            JUCE_CATCH_EXCEPTION
+        }
 
-        if (bytesInSocket > 0)
+        // If there's anything left (including a message that a producer is half-way
+        // through adding), make sure we come back for it.
+        if (tail.load() != head && ! wakeupPending.exchange (true))
+            signalWakeup();
+    }
+
+    // Only called on the message thread. Returns nullptr if the queue is empty, or if
+    // the next message is still being linked in by another thread.
+    MessageBase::Ptr popMessage() noexcept
+    {
+        auto* message = popLink();
+
+        if (message == nullptr)
+            return nullptr;
+
+        // The queue's reference is handed over to the caller, and now that the message has
+        // been unlinked, it can be posted again without needing a RepeatedMessage.
+        MessageBase::Ptr result (message);
+        message->decReferenceCount();
+        message->isInQueue.store (false);
+        --numPendingMessages;
+        return result;
+    }
+
+    MessageBase* popLink() noexcept
+    {
+        auto* first = head;
+        auto* next = first->nextInQueue.load();
+
+        if (first == &stub)
         {
-            --bytesInSocket;
+            if (next == nullptr)
+                return nullptr;
 
-            ScopedUnlock ul (lock);
-            unsigned char x;
-            auto numBytes = read (fd, &x, 1);
-            ignoreUnused (numBytes);
+            head = first = next;
+            next = next->nextInQueue.load();
         }
 
-        return queue.removeAndReturn (0);
+        if (next != nullptr)
+        {
+            head = next;
+            return first;
+        }
+
+        if (first != tail.load())
+            return nullptr;
+
+        // The last real message can only be removed once the stub has been put back
+        // behind it, so that the list is never empty.
+        stub.nextInQueue.store (nullptr);
+        auto* previous = tail.exchange (&stub);
+        previous->nextInQueue.store (&stub);
+
+        next = first->nextInQueue.load();
+
+        if (next != nullptr)
+        {
+            head = next;
+            return first;
+        }
+
+        return nullptr;
     }
 };
 
@@ -271,6 +410,20 @@ void MessageManager::doPlatformSpecificShutdown()
     InternalRunLoop::deleteInstance();
 }
 
+LinuxEventLoop::MessageQueueStatistics LinuxEventLoop::getMessageQueueStatistics()
+{
+    if (auto* queue = InternalMessageQueue::getInstanceWithoutCreating())
+        return queue->getStatistics();
+
+    return {};
+}
+
+void LinuxEventLoop::resetMessageQueueStatistics()
+{
+    if (auto* queue = InternalMessageQueue::getInstanceWithoutCreating())
+        queue->resetStatistics();
+}
+
 bool MessageManager::postMessageToSystemQueue (MessageManager::MessageBase* const message)
 {
     if (auto* queue = InternalMessageQueue::getInstanceWithoutCreating())
@@ -323,6 +476,153 @@ void LinuxEventLoop::unregisterFdCallback (int fd)
         runLoop->unregisterFdCallback (fd);
 }
 
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class LinuxMessageQueueTests  : public UnitTest
+{
+public:
+    LinuxMessageQueueTests()
+        : UnitTest ("Linux message queue", UnitTestCategories::events)
+    {}
+
+    struct CountingMessage  : public MessageManager::MessageBase
+    {
+        void messageCallback() override     { ++numCallbacks; }
+        int numCallbacks = 0;
+    };
+
+    // Delivers messages on this thread until the condition is true, or it times out
+    template <typename Condition>
+    static bool dispatchUntil (Condition&& condition)
+    {
+        auto timeout = Time::getMillisecondCounter() + 30000;
+
+        while (! condition())
+        {
+            if (Time::getMillisecondCounter() > timeout)
+                return false;
+
+            auto* runLoop = InternalRunLoop::getInstanceWithoutCreating();
+
+            if (! runLoop->dispatchPendingEvents())
+                runLoop->sleepUntilNextEvent (10);
+        }
+
+        return true;
+    }
+
+    static void dispatchAllPendingMessages()
+    {
+        while (InternalRunLoop::getInstanceWithoutCreating()->dispatchPendingEvents())
+        {}
+    }
+
+    void runTest() override
+    {
+        const bool hadMessageManager = MessageManager::getInstanceWithoutCreating() != nullptr;
+
+        // The messages have to be delivered on this thread
+        if (! MessageManager::getInstance()->isThisTheMessageThread())
+            return;
+
+        dispatchAllPendingMessages();
+
+        beginTest ("Posting from several threads");
+        {
+            constexpr int numProducers = 8, messagesPerProducer = 20000;
+
+            LinuxEventLoop::resetMessageQueueStatistics();
+
+            int lastSequenceNumbers[numProducers];
+            std::fill (std::begin (lastSequenceNumbers), std::end (lastSequenceNumbers), -1);
+            int numDelivered = 0, numOutOfOrder = 0;
+
+            OwnedArray<Thread> producers;
+
+            for (int p = 0; p < numProducers; ++p)
+            {
+                struct Producer  : public Thread
+                {
+                    Producer (std::function<void()> f)  : Thread ("producer"), function (std::move (f)) {}
+                    void run() override     { function(); }
+                    std::function<void()> function;
+                };
+
+                producers.add (new Producer ([&, p]
+                {
+                    // Messages from one thread must arrive in the order they were posted
+                    for (int i = 0; i < messagesPerProducer; ++i)
+                    {
+                        MessageManager::callAsync ([&, p, i]
+                        {
+                            if (i != lastSequenceNumbers[p] + 1)
+                                ++numOutOfOrder;
+
+                            lastSequenceNumbers[p] = i;
+                            ++numDelivered;
+                        });
+                    }
+                }));
+            }
+
+            for (auto* p : producers)
+                p->startThread();
+
+            expect (dispatchUntil ([&] { return numDelivered == numProducers * messagesPerProducer; }));
+
+            for (auto* p : producers)
+                p->stopThread (-1);
+
+            expectEquals (numOutOfOrder, 0);
+
+            auto stats = LinuxEventLoop::getMessageQueueStatistics();
+            expectEquals (stats.numPendingMessages, 0);
+            expect (stats.numMessagesDelivered >= numProducers * messagesPerProducer);
+            expect (stats.maxPendingMessages >= 1);
+            expect (stats.maxLatencySeconds >= stats.averageLatencySeconds);
+        }
+
+        beginTest ("Messages per wake-up");
+        {
+            constexpr int numMessages = 1000;
+            int numDelivered = 0;
+
+            for (int i = 0; i < numMessages; ++i)
+                MessageManager::callAsync ([&] { ++numDelivered; });
+
+            // Each wake-up only delivers a limited number, so that other events get a look in
+            InternalRunLoop::getInstanceWithoutCreating()->dispatchPendingEvents();
+            expect (numDelivered > 0 && numDelivered <= InternalMessageQueue::maxMessagesPerWakeup);
+
+            expect (dispatchUntil ([&] { return numDelivered == numMessages; }));
+        }
+
+        beginTest ("Posting a message that's already in the queue");
+        {
+            MessageManager::MessageBase::Ptr message (new CountingMessage());
+            auto& counter = static_cast<CountingMessage&> (*message);
+
+            message->post();
+            message->post();
+            dispatchAllPendingMessages();
+            expectEquals (counter.numCallbacks, 2);
+
+            message->post();
+            dispatchAllPendingMessages();
+            expectEquals (counter.numCallbacks, 3);
+            expectEquals (message->getReferenceCount(), 1);
+        }
+
+        if (! hadMessageManager)
+            MessageManager::deleteInstance();
+    }
+};
+
+static LinuxMessageQueueTests linuxMessageQueueTests;
+
+#endif
+
 } // namespace juce
 
 JUCE_API std::vector<std::pair<int, std::function<void (int)>>> getFdReadCallbacks()
@@ -79,6 +79,7 @@ private:
         {
             JUCE_TRY
             {
+                JUCE_TRACE_SCOPE ("MessageManager::dispatch");
                 nextMessage->messageCallback();
             }
             JUCE_CATCH_EXCEPTION
@@ -195,6 +195,7 @@ private:
     {
         JUCE_TRY
         {
+            JUCE_TRACE_SCOPE ("MessageManager::dispatch");
             message->messageCallback();
         }
         JUCE_CATCH_EXCEPTION
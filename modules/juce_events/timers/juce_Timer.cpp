@@ -23,6 +23,236 @@
 namespace juce
 {
 
+/*  The active timers are kept in a hierarchical timing wheel, like the one described
+    by Varghese and Lauck, so that starting, stopping or resetting a timer is O(1) no
+    matter how many timers there are.
+
+    The first level has a slot for each of the next 256 milliseconds, and each of the
+    higher levels has 64 slots that each cover a whole revolution of the level below.
+    Each slot is a linked list of timers, and when the first level wraps around, the
+    timers in the next slot of the level above are spread out into it. All the timers
+    that have become due are moved to a single list, which is delivered in one go by a
+    single message to the message thread.
+
+    The wheel doesn't read the clock itself, it's just told what the time is.
+*/
+class TimerWheel
+{
+public:
+    TimerWheel()
+    {
+        nodes.reserve (32);
+    }
+
+    bool isEmpty() const noexcept                       { return numActiveTimers == 0; }
+
+    /** Returns the timer that was added at the given index, or nullptr if there isn't one. */
+    Timer* getTimer (size_t index) const noexcept       { return index < nodes.size() ? nodes[index].timer : nullptr; }
+
+    int64 getDueTime (int index) const noexcept         { return nodes[(size_t) index].dueTime; }
+    bool isDue (int index) const noexcept               { return nodes[(size_t) index].list == dueList; }
+
+    /** Returns the index of the first timer in the list of ones that are due, or -1. */
+    int getFirstDueTimer() const noexcept               { return lists[dueList].head; }
+
+    /** Adds a timer, returning the index that it's been given. */
+    int add (Timer* timer, int64 dueTime)
+    {
+        int index;
+
+        if (firstFreeNode >= 0)
+        {
+            index = firstFreeNode;
+            firstFreeNode = nodes[(size_t) index].next;
+        }
+        else
+        {
+            index = (int) nodes.size();
+            nodes.push_back ({});
+        }
+
+        nodes[(size_t) index].timer = timer;
+        schedule (index, dueTime);
+        ++numActiveTimers;
+        return index;
+    }
+
+    void remove (int index) noexcept
+    {
+        unlink (index);
+
+        auto& node = nodes[(size_t) index];
+        node.timer = nullptr;
+        node.next = firstFreeNode;
+        firstFreeNode = index;
+        --numActiveTimers;
+    }
+
+    void reschedule (int index, int64 dueTime) noexcept
+    {
+        unlink (index);
+        schedule (index, dueTime);
+    }
+
+    /** Moves the wheel on to the given time, putting any timers that are due into the due list. */
+    void advanceTo (int64 time) noexcept
+    {
+        // (when it's empty, the wheel can just jump straight to the current time)
+        if (numActiveTimers == 0)
+            wheelTime = time + 1;
+
+        while (wheelTime <= time)
+        {
+            auto slot = (int) (wheelTime & (firstLevelSize - 1));
+
+            if (slot == 0)
+            {
+                for (int level = 1; level < numLevels; ++level)
+                {
+                    auto shift = firstLevelBits + (level - 1) * upperLevelBits;
+                    auto upperSlot = (int) ((wheelTime >> shift) & (upperLevelSize - 1));
+                    auto& list = lists[firstLevelSize + (level - 1) * upperLevelSize + upperSlot];
+
+                    while (list.head >= 0)
+                    {
+                        auto index = list.head;
+                        unlink (index);
+                        schedule (index, nodes[(size_t) index].dueTime);
+                    }
+
+                    if (upperSlot != 0)
+                        break;
+                }
+            }
+
+            // If the first level is empty, there's nothing to do until its next revolution,
+            // which saves going round a ms at a time when a long interval has passed
+            if (numInFirstLevel == 0)
+            {
+                wheelTime = jmin (time + 1, (wheelTime | (firstLevelSize - 1)) + 1);
+                continue;
+            }
+
+            while (lists[slot].head >= 0)
+            {
+                auto index = lists[slot].head;
+                unlink (index);
+                link (index, dueList);
+            }
+
+            ++wheelTime;
+        }
+    }
+
+    /** Returns the number of milliseconds after the given time at which advanceTo() will next
+        have something to do. This assumes that the wheel has already been advanced to that time.
+    */
+    int getTimeUntilNextCheck (int64 time) const noexcept
+    {
+        if (lists[dueList].head >= 0)
+            return 0;
+
+        // Anything due in the next revolution of the first level will be in one of its slots,
+        // otherwise we just need to wake up in time to redistribute the level above.
+        for (auto t = wheelTime; t < wheelTime + firstLevelSize; ++t)
+            if (lists[t & (firstLevelSize - 1)].head >= 0 || (t & (firstLevelSize - 1)) == 0)
+                return (int) (t - time);
+
+        return (int) (wheelTime + firstLevelSize - time);
+    }
+
+private:
+    //==============================================================================
+    struct Node
+    {
+        Timer* timer;
+        int64 dueTime;
+        int previous, next, list;
+    };
+
+    struct List
+    {
+        int head = -1, tail = -1;
+    };
+
+    enum
+    {
+        firstLevelBits = 8,
+        firstLevelSize = 1 << firstLevelBits,
+        upperLevelBits = 6,
+        upperLevelSize = 1 << upperLevelBits,
+        numLevels = 5,
+        dueList = firstLevelSize + (numLevels - 1) * upperLevelSize,
+        numLists
+    };
+
+    std::vector<Node> nodes;
+    int firstFreeNode = -1, numActiveTimers = 0, numInFirstLevel = 0;
+    List lists[numLists];
+    int64 wheelTime = 0;
+
+    void link (int index, int listIndex) noexcept
+    {
+        auto& node = nodes[(size_t) index];
+        auto& list = lists[listIndex];
+
+        node.list = listIndex;
+        node.next = -1;
+        node.previous = list.tail;
+
+        if (list.tail >= 0)
+            nodes[(size_t) list.tail].next = index;
+        else
+            list.head = index;
+
+        list.tail = index;
+
+        if (listIndex < firstLevelSize)
+            ++numInFirstLevel;
+    }
+
+    void unlink (int index) noexcept
+    {
+        auto& node = nodes[(size_t) index];
+        auto& list = lists[node.list];
+
+        if (node.previous >= 0)
+            nodes[(size_t) node.previous].next = node.next;
+        else
+            list.head = node.next;
+
+        if (node.next >= 0)
+            nodes[(size_t) node.next].previous = node.previous;
+        else
+            list.tail = node.previous;
+
+        if (node.list < firstLevelSize)
+            --numInFirstLevel;
+    }
+
+    void schedule (int index, int64 dueTime) noexcept
+    {
+        nodes[(size_t) index].dueTime = dueTime;
+        auto delta = dueTime - wheelTime;
+
+        // (anything that's already overdue goes into the next slot to be processed)
+        if (delta < firstLevelSize)
+            return link (index, (int) (jmax (dueTime, wheelTime) & (firstLevelSize - 1)));
+
+        for (int level = 1;; ++level)
+        {
+            auto shift = firstLevelBits + (level - 1) * upperLevelBits;
+
+            if (level == numLevels - 1 || delta < ((int64) 1 << (shift + upperLevelBits)))
+                return link (index, firstLevelSize + (level - 1) * upperLevelSize
+                                      + (int) ((dueTime >> shift) & (upperLevelSize - 1)));
+        }
+    }
+
+    JUCE_DECLARE_NON_COPYABLE (TimerWheel)
+};
+
+//==============================================================================
 class Timer::TimerThread  : private Thread,
                             private DeletedAtShutdown,
                             private AsyncUpdater
@@ -32,7 +262,7 @@ public:
 
     TimerThread()  : Thread ("JUCE Timer")
     {
-        timers.reserve (32);
+        lastMillisecondCounter = Time::getMillisecondCounter();
         triggerAsyncUpdate();
     }
 
@@ -49,17 +279,11 @@ public:
 
     void run() override
     {
-        auto lastTime = Time::getMillisecondCounter();
         ReferenceCountedObjectPtr<CallTimersMessage> messageToSend (new CallTimersMessage());
 
         while (! threadShouldExit())
         {
-            auto now = Time::getMillisecondCounter();
-            auto elapsed = (int) (now >= lastTime ? (now - lastTime)
-                                                  : (std::numeric_limits<uint32>::max() - (lastTime - now)));
-            lastTime = now;
-
-            auto timeUntilFirstTimer = getTimeUntilFirstTimer (elapsed);
+            auto timeUntilFirstTimer = getTimeUntilFirstTimer();
 
             if (timeUntilFirstTimer <= 0)
             {
@@ -95,16 +319,18 @@ public:
 
         const LockType::ScopedLockType sl (lock);
 
-        while (! timers.empty())
+        updateClock();
+        wheel.advanceTo (currentTimeMs);
+
+        for (;;)
         {
-            auto& first = timers.front();
+            auto index = wheel.getFirstDueTimer();
 
-            if (first.countdownMs > 0)
+            if (index < 0)
                 break;
 
-            auto* timer = first.timer;
-            first.countdownMs = timer->timerPeriodMs;
-            shuffleTimerBackInQueue (0);
+            auto* timer = wheel.getTimer ((size_t) index);
+            wheel.reschedule (index, currentTimeMs + timer->timerPeriodMs);
             notify();
 
             const LockType::ScopedUnlockType ul (lock);
@@ -160,13 +386,12 @@ public:
     static LockType lock;
 
 private:
-    struct TimerCountdown
-    {
-        Timer* timer;
-        int countdownMs;
-    };
+    //==============================================================================
+    // A timer's positionInQueue is its index in the wheel
+    TimerWheel wheel;
 
-    std::vector<TimerCountdown> timers;
+    int64 currentTimeMs = 0;
+    uint32 lastMillisecondCounter = 0;
 
     WaitableEvent callbackArrived;
 
@@ -186,118 +411,55 @@ private:
     {
         // Trying to add a timer that's already here - shouldn't get to this point,
         // so if you get this assertion, let me know!
-        jassert (std::find_if (timers.begin(), timers.end(),
-                               [t] (TimerCountdown i) { return i.timer == t; }) == timers.end());
-
-        auto pos = timers.size();
+        jassert (wheel.getTimer (t->positionInQueue) != t);
 
-        timers.push_back ({ t, t->timerPeriodMs });
-        t->positionInQueue = pos;
-        shuffleTimerForwardInQueue (pos);
+        updateClock();
+        wheel.advanceTo (currentTimeMs);
+        t->positionInQueue = (size_t) wheel.add (t, currentTimeMs + t->timerPeriodMs);
         notify();
     }
 
     void removeTimer (Timer* t)
     {
-        auto pos = t->positionInQueue;
-        auto lastIndex = timers.size() - 1;
-
-        jassert (pos <= lastIndex);
-        jassert (timers[pos].timer == t);
+        jassert (wheel.getTimer (t->positionInQueue) == t);
 
-        for (auto i = pos; i < lastIndex; ++i)
-        {
-            timers[i] = timers[i + 1];
-            timers[i].timer->positionInQueue = i;
-        }
-
-        timers.pop_back();
+        wheel.remove ((int) t->positionInQueue);
+        t->positionInQueue = (size_t) -1;
     }
 
     void resetTimerCounter (Timer* t) noexcept
     {
-        auto pos = t->positionInQueue;
-
-        jassert (pos < timers.size());
-        jassert (timers[pos].timer == t);
+        auto index = (int) t->positionInQueue;
+        jassert (wheel.getTimer (t->positionInQueue) == t);
 
-        auto lastCountdown = timers[pos].countdownMs;
-        auto newCountdown = t->timerPeriodMs;
+        updateClock();
+        auto newDueTime = currentTimeMs + t->timerPeriodMs;
 
-        if (newCountdown != lastCountdown)
+        if (wheel.getDueTime (index) != newDueTime)
         {
-            timers[pos].countdownMs = newCountdown;
-
-            if (newCountdown > lastCountdown)
-                shuffleTimerBackInQueue (pos);
-            else
-                shuffleTimerForwardInQueue (pos);
-
+            wheel.reschedule (index, newDueTime);
             notify();
         }
     }
 
-    void shuffleTimerBackInQueue (size_t pos)
+    //==============================================================================
+    void updateClock() noexcept
     {
-        auto numTimers = timers.size();
-
-        if (pos < numTimers - 1)
-        {
-            auto t = timers[pos];
-
-            for (;;)
-            {
-                auto next = pos + 1;
-
-                if (next == numTimers || timers[next].countdownMs >= t.countdownMs)
-                    break;
-
-                timers[pos] = timers[next];
-                timers[pos].timer->positionInQueue = pos;
-
-                ++pos;
-            }
-
-            timers[pos] = t;
-            t.timer->positionInQueue = pos;
-        }
+        auto now = Time::getMillisecondCounter();
+        currentTimeMs += (int64) (uint32) (now - lastMillisecondCounter);
+        lastMillisecondCounter = now;
     }
 
-    void shuffleTimerForwardInQueue (size_t pos)
-    {
-        if (pos > 0)
-        {
-            auto t = timers[pos];
-
-            while (pos > 0)
-            {
-                auto& prev = timers[(size_t) pos - 1];
-
-                if (prev.countdownMs <= t.countdownMs)
-                    break;
-
-                timers[pos] = prev;
-                timers[pos].timer->positionInQueue = pos;
-
-                --pos;
-            }
-
-            timers[pos] = t;
-            t.timer->positionInQueue = pos;
-        }
-    }
-
-    int getTimeUntilFirstTimer (int numMillisecsElapsed)
+    int getTimeUntilFirstTimer()
     {
         const LockType::ScopedLockType sl (lock);
 
-        if (timers.empty())
+        if (wheel.isEmpty())
             return 1000;
 
-        for (auto& t : timers)
-            t.countdownMs -= numMillisecsElapsed;
-
-        return timers.front().countdownMs;
+        updateClock();
+        wheel.advanceTo (currentTimeMs);
+        return wheel.getTimeUntilNextCheck (currentTimeMs);
     }
 
     void handleAsyncUpdate() override
@@ -386,4 +548,183 @@ void JUCE_CALLTYPE Timer::callAfterDelay (int milliseconds, std::function<void()
     new LambdaInvoker (milliseconds, f);
 }
 
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class TimerTests  : public UnitTest
+{
+public:
+    TimerTests()
+        : UnitTest ("Timer", UnitTestCategories::events)
+    {}
+
+    struct TestTimer  : public Timer
+    {
+        void timerCallback() override
+        {
+            ++numCallbacks;
+
+            if (onCallback != nullptr)
+                onCallback();
+        }
+
+        std::function<void()> onCallback;
+        int numCallbacks = 0;
+    };
+
+    // Adds a timer for each of the given delays (which must be in ascending order), and
+    // checks that each one becomes due at exactly the right time and not a millisecond before
+    void checkDueTimes (int64 startTime, std::initializer_list<int64> delays)
+    {
+        TimerWheel wheel;
+        TestTimer timer; // (never started, it's just something for the wheel to point at)
+        Array<int> indexes;
+
+        wheel.advanceTo (startTime);
+
+        for (auto delay : delays)
+            indexes.add (wheel.add (&timer, startTime + delay));
+
+        for (auto index : indexes)
+        {
+            auto dueTime = wheel.getDueTime (index);
+            auto description = "start " + String (startTime) + ", due " + String (dueTime);
+
+            wheel.advanceTo (dueTime - 1);
+            expect (! wheel.isDue (index), "Timer was early: " + description);
+
+            wheel.advanceTo (dueTime);
+            expect (wheel.isDue (index), "Timer was late: " + description);
+            expect (wheel.getTimer ((size_t) wheel.getFirstDueTimer()) == &timer);
+
+            wheel.remove (index);
+            expectEquals (wheel.getFirstDueTimer(), -1);
+        }
+
+        expect (wheel.isEmpty());
+    }
+
+    void runTest() override
+    {
+        beginTest ("Cascade boundaries");
+        {
+            const int64 level1 = 1 << 8, level2 = 1 << 14, level3 = 1 << 20;
+
+            for (auto start : { (int64) 0, (int64) 1, level1 - 1, level1, (int64) 300,
+                                level2 - 1, level2, level3 + 17, (int64) 1 << 40 })
+            {
+                checkDueTimes (start, { 1, 2, level1 - 1, level1, level1 + 1, 2 * level1 - 1,
+                                        level2 - 1, level2, level2 + 1, level2 + level1,
+                                        level3 - 1, level3, level3 + 1 });
+            }
+        }
+
+        beginTest ("Long intervals");
+        {
+            // Anything beyond the range of the third level is clamped into the top one
+            const int64 level4 = 1 << 26;
+
+            checkDueTimes (0,    { level4 - 1, level4, level4 + 1, 3 * level4 + 12345,
+                                   std::numeric_limits<int>::max() });
+            checkDueTimes (4321, { level4 - 1, level4, level4 + 1, 3 * level4 + 12345,
+                                   std::numeric_limits<int>::max() });
+        }
+
+        beginTest ("Rescheduling");
+        {
+            TimerWheel wheel;
+            TestTimer timer;
+
+            auto first  = wheel.add (&timer, 100);
+            auto second = wheel.add (&timer, 200000);
+
+            wheel.reschedule (first, 50000);
+            wheel.reschedule (second, 20);
+
+            wheel.advanceTo (20);
+            expect (wheel.isDue (second));
+            expect (! wheel.isDue (first));
+            wheel.remove (second);
+
+            wheel.advanceTo (49999);
+            expect (! wheel.isDue (first));
+            wheel.advanceTo (50000);
+            expect (wheel.isDue (first));
+
+            // a timer that's rescheduled into the past is due straight away
+            wheel.reschedule (first, 1000);
+            wheel.advanceTo (50001);
+            expect (wheel.isDue (first));
+            wheel.remove (first);
+
+            // a freed index gets reused
+            expectEquals (wheel.add (&timer, 60000), first);
+        }
+
+        beginTest ("Removing and re-adding inside callbacks");
+        {
+            const bool hadMessageManager = MessageManager::getInstanceWithoutCreating() != nullptr;
+            MessageManager::getInstance();
+
+            auto callTimers = []
+            {
+                Thread::sleep (20);
+                Timer::callPendingTimersSynchronously();
+            };
+
+            {
+                TestTimer a, b, c;
+
+                // a and b will both be due in the same batch, so whichever goes
+                // first must stop the other one from being called
+                a.onCallback = [&] { a.stopTimer(); b.stopTimer(); c.startTimer (1); };
+                b.onCallback = [&] { a.stopTimer(); b.stopTimer(); c.startTimer (1); };
+                a.startTimer (1);
+                b.startTimer (1);
+
+                callTimers();
+                expectEquals (a.numCallbacks + b.numCallbacks, 1);
+                expect (! a.isTimerRunning() && ! b.isTimerRunning());
+                expect (c.isTimerRunning());
+
+                // c was started from inside a callback, and restarts itself with a
+                // longer interval from its own callback
+                c.onCallback = [&] { c.startTimer (100000); };
+
+                callTimers();
+                expectEquals (c.numCallbacks, 1);
+                expectEquals (c.getTimerInterval(), 100000);
+
+                callTimers();
+                expectEquals (c.numCallbacks, 1);
+
+                // a timer that stops and restarts itself every time keeps going
+                a.onCallback = [&] { a.stopTimer(); a.startTimer (1); };
+                a.numCallbacks = 0;
+                a.startTimer (1);
+
+                for (int i = 1; i <= 3; ++i)
+                {
+                    callTimers();
+                    expectEquals (a.numCallbacks, i);
+                }
+
+                // a timer that deletes itself from its callback
+                bool called = false;
+                Timer::callAfterDelay (1, [&called] { called = true; });
+
+                callTimers();
+                expect (called);
+            }
+
+            if (! hadMessageManager)
+                MessageManager::deleteInstance();
+        }
+    }
+};
+
+static TimerTests timerTests;
+
+#endif
+
 } // namespace juce
@@ -44,10 +44,183 @@ namespace
     }
 }
 
+//==============================================================================
+/** Holds a set of recently-used text layouts, so that the text-drawing methods
+    don't have to re-run the typeface lookups and glyph layout each time the same
+    string gets repainted.
+
+    The arrangements are all laid out relative to the origin, and are translated
+    into place when they're drawn, so that moving a piece of text around doesn't
+    invalidate its entry.
+*/
+class GlyphArrangementCache  : private DeletedAtShutdown
+{
+public:
+    GlyphArrangementCache()
+    {
+        entries.insertMultiple (0, {}, numEntries);
+    }
+
+    ~GlyphArrangementCache() override
+    {
+        clearSingletonInstance();
+    }
+
+    JUCE_DECLARE_SINGLETON (GlyphArrangementCache, false)
+
+    enum class LayoutType
+    {
+        singleLine,
+        multiLine,
+        curtailedLine,
+        fitted
+    };
+
+    struct Key
+    {
+        LayoutType type;
+        String text;
+        Font font;
+        float width, height;
+        int justification, maximumLines;
+        float extra; // leading or minimum horizontal scale, depending on the type
+        bool useEllipses;
+
+        bool operator== (const Key& other) const noexcept
+        {
+            return type == other.type
+                && width == other.width
+                && height == other.height
+                && justification == other.justification
+                && maximumLines == other.maximumLines
+                && extra == other.extra
+                && useEllipses == other.useEllipses
+                && font == other.font
+                && text == other.text;
+        }
+
+        uint32 getHash() const noexcept
+        {
+            auto h = (uint32) text.hashCode();
+            h = h * 31 + (uint32) font.getTypefaceName().hashCode();
+            h = h * 31 + (uint32) roundToInt (font.getHeight() * 64.0f);
+            h = h * 31 + (uint32) font.getStyleFlags();
+            h = h * 31 + (uint32) roundToInt (width * 16.0f);
+            h = h * 31 + (uint32) roundToInt (height * 16.0f);
+            return h * 31 + (uint32) justification;
+        }
+    };
+
+    struct CachedArrangement  : public ReferenceCountedObject
+    {
+        using Ptr = ReferenceCountedObjectPtr<CachedArrangement>;
+
+        CachedArrangement (const Key& k, uint32 h)  : key (k), hash (h) {}
+
+        const Key key;
+        const uint32 hash;
+        GlyphArrangement glyphs;
+        uint32 lastAccessCount = 0;
+    };
+
+    /** Returns the laid-out arrangement for this key, calling the layout function
+        to create it if there's no matching entry in the cache.
+    */
+    template <typename LayoutFunction>
+    CachedArrangement::Ptr findOrCreate (const Key& key, LayoutFunction&& createLayout)
+    {
+        auto hash = key.getHash();
+
+        {
+            const ScopedLock sl (lock);
+
+            for (auto& e : entries)
+            {
+                if (e != nullptr && e->hash == hash && e->key == key)
+                {
+                    e->lastAccessCount = ++accessCounter;
+                    return e;
+                }
+            }
+        }
+
+        CachedArrangement::Ptr newEntry (new CachedArrangement (key, hash));
+        createLayout (newEntry->glyphs);
+
+        // very long strings aren't worth keeping, as they're unlikely to be redrawn
+        // unchanged, and would just push all the shorter entries out of the cache
+        if (newEntry->glyphs.getNumGlyphs() <= maxGlyphsPerEntry)
+        {
+            const ScopedLock sl (lock);
+            newEntry->lastAccessCount = ++accessCounter;
+            entries.set (findLeastRecentlyUsedIndex(), newEntry);
+        }
+
+        return newEntry;
+    }
+
+    void clear()
+    {
+        const ScopedLock sl (lock);
+
+        for (auto& e : entries)
+            e = nullptr;
+    }
+
+private:
+    enum { numEntries = 256, maxGlyphsPerEntry = 512 };
+
+    Array<CachedArrangement::Ptr> entries;
+    uint32 accessCounter = 0;
+    CriticalSection lock;
+
+    int findLeastRecentlyUsedIndex() const noexcept
+    {
+        int oldestIndex = 0;
+        auto oldestCounter = std::numeric_limits<uint32>::max();
+
+        for (int i = 0; i < entries.size(); ++i)
+        {
+            auto* e = entries.getReference (i).get();
+
+            if (e == nullptr)
+                return i;
+
+            if (e->lastAccessCount < oldestCounter)
+            {
+                oldestCounter = e->lastAccessCount;
+                oldestIndex = i;
+            }
+        }
+
+        return oldestIndex;
+    }
+
+    JUCE_DECLARE_NON_COPYABLE (GlyphArrangementCache)
+};
+
+JUCE_IMPLEMENT_SINGLETON (GlyphArrangementCache)
+
+void RenderingHelpers::clearGlyphArrangementCache()
+{
+    if (auto* cache = GlyphArrangementCache::getInstanceWithoutCreating())
+        cache->clear();
+}
+
 //==============================================================================
 LowLevelGraphicsContext::LowLevelGraphicsContext() {}
 LowLevelGraphicsContext::~LowLevelGraphicsContext() {}
 
+void LowLevelGraphicsContext::strokePath (const Path& path, const PathStrokeType& strokeType,
+                                          const AffineTransform& transform)
+{
+    Path stroke;
+    strokeType.createStrokedPath (stroke, path, transform, getPhysicalPixelScaleFactor());
+
+    if (! (isClipEmpty() || stroke.isEmpty()))
+        fillPath (stroke, {});
+}
+
 //==============================================================================
 Graphics::Graphics (const Image& imageToDrawOnto)
     : contextHolder (imageToDrawOnto.createLowLevelContext()),
@@ -252,22 +425,25 @@ void Graphics::drawSingleLineText (const String& text, const int startX, const i
         if (flags == Justification::left && startX > context.getClipBounds().getRight())
             return;
 
-        GlyphArrangement arr;
-        arr.addLineOfText (context.getFont(), text, (float) startX, (float) baselineY);
+        const GlyphArrangementCache::Key key { GlyphArrangementCache::LayoutType::singleLine, text, context.getFont(),
+                                               0.0f, 0.0f, flags, 1, 0.0f, false };
 
-        if (flags != Justification::left)
+        auto cached = GlyphArrangementCache::getInstance()->findOrCreate (key, [&] (GlyphArrangement& arr)
         {
-            auto w = arr.getBoundingBox (0, -1, true).getWidth();
+            arr.addLineOfText (context.getFont(), text, 0.0f, 0.0f);
 
-            if ((flags & (Justification::horizontallyCentred | Justification::horizontallyJustified)) != 0)
-                w /= 2.0f;
+            if (flags != Justification::left)
+            {
+                auto w = arr.getBoundingBox (0, -1, true).getWidth();
 
-            arr.draw (*this, AffineTransform::translation (-w, 0));
-        }
-        else
-        {
-            arr.draw (*this);
-        }
+                if ((flags & (Justification::horizontallyCentred | Justification::horizontallyJustified)) != 0)
+                    w /= 2.0f;
+
+                arr.moveRangeOfGlyphs (0, -1, -w, 0.0f);
+            }
+        });
+
+        cached->glyphs.draw (*this, AffineTransform::translation ((float) startX, (float) baselineY));
     }
 }
 
@@ -278,11 +454,16 @@ void Graphics::drawMultiLineText (const String& text, const int startX,
     if (text.isNotEmpty()
          && startX < context.getClipBounds().getRight())
     {
-        GlyphArrangement arr;
-        arr.addJustifiedText (context.getFont(), text,
-                              (float) startX, (float) baselineY, (float) maximumLineWidth,
-                              justification, leading);
-        arr.draw (*this);
+        const GlyphArrangementCache::Key key { GlyphArrangementCache::LayoutType::multiLine, text, context.getFont(),
+                                               (float) maximumLineWidth, 0.0f, justification.getFlags(), 0, leading, false };
+
+        auto cached = GlyphArrangementCache::getInstance()->findOrCreate (key, [&] (GlyphArrangement& arr)
+        {
+            arr.addJustifiedText (context.getFont(), text, 0.0f, 0.0f, (float) maximumLineWidth,
+                                  justification, leading);
+        });
+
+        cached->glyphs.draw (*this, AffineTransform::translation ((float) startX, (float) baselineY));
     }
 }
 
@@ -291,14 +472,21 @@ void Graphics::drawText (const String& text, Rectangle<float> area,
 {
     if (text.isNotEmpty() && context.clipRegionIntersects (area.getSmallestIntegerContainer()))
     {
-        GlyphArrangement arr;
-        arr.addCurtailedLineOfText (context.getFont(), text, 0.0f, 0.0f,
-                                    area.getWidth(), useEllipsesIfTooBig);
-
-        arr.justifyGlyphs (0, arr.getNumGlyphs(),
-                           area.getX(), area.getY(), area.getWidth(), area.getHeight(),
-                           justificationType);
-        arr.draw (*this);
+        const GlyphArrangementCache::Key key { GlyphArrangementCache::LayoutType::curtailedLine, text, context.getFont(),
+                                               area.getWidth(), area.getHeight(), justificationType.getFlags(),
+                                               1, 0.0f, useEllipsesIfTooBig };
+
+        auto cached = GlyphArrangementCache::getInstance()->findOrCreate (key, [&] (GlyphArrangement& arr)
+        {
+            arr.addCurtailedLineOfText (context.getFont(), text, 0.0f, 0.0f,
+                                        area.getWidth(), useEllipsesIfTooBig);
+
+            arr.justifyGlyphs (0, arr.getNumGlyphs(),
+                               0.0f, 0.0f, area.getWidth(), area.getHeight(),
+                               justificationType);
+        });
+
+        cached->glyphs.draw (*this, AffineTransform::translation (area.getX(), area.getY()));
     }
 }
 
@@ -321,15 +509,21 @@ void Graphics::drawFittedText (const String& text, Rectangle<int> area,
 {
     if (text.isNotEmpty() && (! area.isEmpty()) && context.clipRegionIntersects (area))
     {
-        GlyphArrangement arr;
-        arr.addFittedText (context.getFont(), text,
-                           (float) area.getX(), (float) area.getY(),
-                           (float) area.getWidth(), (float) area.getHeight(),
-                           justification,
-                           maximumNumberOfLines,
-                           minimumHorizontalScale);
-
-        arr.draw (*this);
+        const GlyphArrangementCache::Key key { GlyphArrangementCache::LayoutType::fitted, text, context.getFont(),
+                                               (float) area.getWidth(), (float) area.getHeight(), justification.getFlags(),
+                                               maximumNumberOfLines, minimumHorizontalScale, false };
+
+        auto cached = GlyphArrangementCache::getInstance()->findOrCreate (key, [&] (GlyphArrangement& arr)
+        {
+            arr.addFittedText (context.getFont(), text,
+                               0.0f, 0.0f,
+                               (float) area.getWidth(), (float) area.getHeight(),
+                               justification,
+                               maximumNumberOfLines,
+                               minimumHorizontalScale);
+        });
+
+        cached->glyphs.draw (*this, AffineTransform::translation ((float) area.getX(), (float) area.getY()));
     }
 }
 
@@ -410,9 +604,8 @@ void Graphics::strokePath (const Path& path,
                            const PathStrokeType& strokeType,
                            const AffineTransform& transform) const
 {
-    Path stroke;
-    strokeType.createStrokedPath (stroke, path, transform, context.getPhysicalPixelScaleFactor());
-    fillPath (stroke);
+    if (! (context.isClipEmpty() || path.isEmpty()))
+        context.strokePath (path, strokeType, transform);
 }
 
 //==============================================================================
@@ -41,4 +41,212 @@ LowLevelGraphicsSoftwareRenderer::LowLevelGraphicsSoftwareRenderer (const Image&
 
 LowLevelGraphicsSoftwareRenderer::~LowLevelGraphicsSoftwareRenderer() {}
 
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class PathEdgeTableCacheTests  : public UnitTest
+{
+public:
+    PathEdgeTableCacheTests()
+        : UnitTest ("PathEdgeTableCache", UnitTestCategories::graphics)
+    {}
+
+    void runTest() override
+    {
+        using Cache = RenderingHelpers::PathEdgeTableCache;
+        auto r = getRandom();
+
+        beginTest ("Cached fills match uncached ones at integer translations");
+        {
+            for (int i = 0; i < 10; ++i)
+            {
+                auto path = createRandomShape (r);
+                auto transform = createRandomTransform (r);
+
+                expect (primeCache ([&] { return Cache::getInstance().getFilledPath (path, transform); }));
+
+                for (auto offset : { Point<int> (10, 10), Point<int> (11, 10), Point<int> (3, 13), Point<int> (33, -1) })
+                {
+                    auto translated = transform.translated (offset);
+
+                    expectRenderingsMatch ([&] (Graphics& g) { g.fillPath (path, translated); },
+                                           EdgeTable (tableBounds - offset, path, transform), offset);
+                }
+            }
+        }
+
+        beginTest ("Cached strokes match uncached ones at integer translations");
+        {
+            for (int i = 0; i < 10; ++i)
+            {
+                auto path = createRandomShape (r);
+                auto transform = createRandomTransform (r);
+                PathStrokeType stroke (0.5f + r.nextFloat() * 4.0f, PathStrokeType::curved, PathStrokeType::rounded);
+
+                expect (primeCache ([&] { return Cache::getInstance().getStrokedPath (path, stroke, {}, transform,
+                                                                                     transform.getScaleFactor()); }));
+
+                for (auto offset : { Point<int> (10, 10), Point<int> (11, 10), Point<int> (3, 13), Point<int> (33, -1) })
+                {
+                    auto translated = transform.translated (offset);
+
+                    Path outline;
+                    stroke.createStrokedPath (outline, path, {}, transform.getScaleFactor());
+
+                    expectRenderingsMatch ([&] (Graphics& g)
+                                           {
+                                               g.addTransform (translated);
+                                               g.strokePath (path, stroke);
+                                           },
+                                           EdgeTable (tableBounds - offset, outline, transform), offset);
+                }
+            }
+        }
+
+        beginTest ("Sub-pixel and scale changes miss the cache");
+        {
+            auto path = createRandomShape (r);
+            auto transform = createRandomTransform (r);
+            PathStrokeType stroke (2.0f, PathStrokeType::curved);
+
+            auto cachedFill = primeCache ([&] { return Cache::getInstance().getFilledPath (path, transform); });
+            auto cachedStroke = primeCache ([&] { return Cache::getInstance().getStrokedPath (path, stroke, {}, transform, 1.0f); });
+
+            expect (cachedFill != nullptr && cachedStroke != nullptr);
+            expect (Cache::getInstance().getFilledPath (path, transform) == cachedFill);
+            expect (Cache::getInstance().getStrokedPath (path, stroke, {}, transform, 1.0f) == cachedStroke);
+
+            const AffineTransform changedTransforms[] = { transform.translated (0.25f, 0.0f),
+                                                          transform.translated (0.0f, 0.5f),
+                                                          transform.scaled (1.5f),
+                                                          transform.scaled (1.0f, 1.01f) };
+
+            for (auto& changed : changedTransforms)
+            {
+                expectMisses ([&] { return Cache::getInstance().getFilledPath (path, changed); }, cachedFill, changed);
+                expectMisses ([&] { return Cache::getInstance().getStrokedPath (path, stroke, {}, changed, 1.0f); }, cachedStroke, changed);
+
+                expectRenderingsMatch ([&] (Graphics& g) { g.fillPath (path, changed); },
+                                       EdgeTable (tableBounds, path, changed), {});
+            }
+
+            expectMisses ([&] { return Cache::getInstance().getStrokedPath (path, stroke, AffineTransform::scale (1.5f), transform, 1.0f); },
+                          cachedStroke, transform);
+            expectMisses ([&] { return Cache::getInstance().getStrokedPath (path, PathStrokeType (2.5f, PathStrokeType::curved), {}, transform, 1.0f); },
+                          cachedStroke, transform);
+        }
+    }
+
+private:
+    using CachedEdgeTablePtr = RenderingHelpers::PathEdgeTableCache::CachedEdgeTable::Ptr;
+
+    // Lets the tests fill an edge-table directly, bypassing the cache
+    struct TestRenderer  : public LowLevelGraphicsSoftwareRenderer
+    {
+        using LowLevelGraphicsSoftwareRenderer::LowLevelGraphicsSoftwareRenderer;
+
+        void fillEdgeTable (const EdgeTable& edgeTable)
+        {
+            stack->fillShape (*new RenderingHelpers::SoftwareRendererSavedState::EdgeTableRegionType (edgeTable), false);
+        }
+    };
+
+    const Rectangle<int> imageBounds { 0, 0, 200, 200 };
+
+    // The uncached tables are made bigger than the image, so that like the cached ones,
+    // they only get clipped when they're drawn
+    const Rectangle<int> tableBounds { imageBounds.expanded (100) };
+
+    // (The coordinates and offsets are kept to multiples of 1/16, so that moving a shape
+    // by a whole number of pixels doesn't lose any precision)
+    static Path createRandomShape (Random& r)
+    {
+        auto randomCoord = [&r] { return (float) r.nextInt (16 * 40) / 16.0f; };
+
+        Path path;
+        path.addEllipse (randomCoord(), randomCoord(), 4.0f + randomCoord(), 4.0f + randomCoord());
+        path.startNewSubPath (randomCoord(), randomCoord());
+        path.quadraticTo (randomCoord(), randomCoord(), randomCoord(), randomCoord());
+        path.lineTo (randomCoord(), randomCoord());
+        path.closeSubPath();
+        return path;
+    }
+
+    // These only have a sub-pixel translation, like the transforms that the cache is searched for
+    static AffineTransform createRandomTransform (Random& r)
+    {
+        auto randomOffset = [&r] { return (float) r.nextInt (16) / 16.0f; };
+
+        return AffineTransform::scale (r.nextBool() ? 1.0f : 1.25f).translated (randomOffset(), randomOffset());
+    }
+
+    // Shapes are only cached once they've been drawn twice
+    static CachedEdgeTablePtr primeCache (std::function<CachedEdgeTablePtr()> getEntry)
+    {
+        if (auto entry = getEntry())
+            return entry;
+
+        return getEntry();
+    }
+
+    void expectMisses (std::function<CachedEdgeTablePtr()> getEntry, const CachedEdgeTablePtr& original,
+                       const AffineTransform& expectedTransform)
+    {
+        expect (getEntry() == nullptr);
+
+        auto newEntry = getEntry();
+        expect (newEntry != nullptr && newEntry != original);
+        expect (newEntry != nullptr && newEntry->transform == expectedTransform);
+    }
+
+    // Compares a drawing with an uncached edge-table that's moved by a whole number of pixels.
+    // (It isn't rendered at its final position, because flattening a curve at a different
+    // position can round differently)
+    void expectRenderingsMatch (std::function<void (Graphics&)> draw, EdgeTable uncached, Point<int> offset)
+    {
+        uncached.translate ((float) offset.x, offset.y);
+
+        Image cachedImage (Image::SingleChannel, imageBounds.getWidth(), imageBounds.getHeight(), true, SoftwareImageType());
+        Image uncachedImage (cachedImage.createCopy());
+
+        {
+            LowLevelGraphicsSoftwareRenderer renderer (cachedImage);
+            Graphics g (renderer);
+            g.setColour (Colours::white);
+            draw (g);
+        }
+
+        {
+            TestRenderer renderer (uncachedImage);
+            Graphics g (renderer);
+            g.setColour (Colours::white);
+            renderer.fillEdgeTable (uncached);
+        }
+
+        const Image::BitmapData cachedData (cachedImage, Image::BitmapData::readOnly);
+        const Image::BitmapData uncachedData (uncachedImage, Image::BitmapData::readOnly);
+        int numDifferentPixels = 0;
+        bool anyPixelsSet = false;
+
+        for (int y = 0; y < cachedData.height; ++y)
+        {
+            for (int x = 0; x < cachedData.width; ++x)
+            {
+                if (*cachedData.getPixelPointer (x, y) != *uncachedData.getPixelPointer (x, y))
+                    ++numDifferentPixels;
+
+                anyPixelsSet = anyPixelsSet || *cachedData.getPixelPointer (x, y) != 0;
+            }
+        }
+
+        expect (anyPixelsSet);
+        expectEquals (numDifferentPixels, 0);
+    }
+};
+
+static PathEdgeTableCacheTests pathEdgeTableCacheTests;
+
+#endif
+
+
 } // namespace juce
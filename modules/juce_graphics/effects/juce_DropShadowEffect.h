@@ -74,9 +74,10 @@ struct JUCE_API  DropShadow
     shadow based on what gets drawn inside it. The shadow will also
     be applied to the component's children.
 
-    For speed, this doesn't use a proper gaussian blur, but cheats by
-    using a simple bilinear filter. If you need a really high-quality
-    shadow, check out ImageConvolutionKernel::createGaussianBlur()
+    For speed, this doesn't use a proper gaussian blur, but approximates
+    one with a few box filters (see ImageConvolutionKernel::applyGaussianBlur()).
+    If you need a really high-quality shadow, check out
+    ImageConvolutionKernel::createGaussianBlur()
 
     @see Component::setComponentEffect
 
@@ -171,6 +171,7 @@ void Typeface::clearTypefaceCache()
 {
     TypefaceCache::getInstance()->clear();
 
+    RenderingHelpers::clearGlyphArrangementCache();
     RenderingHelpers::SoftwareRendererSavedState::clearGlyphCache();
 
     if (clearOpenGLGlyphCache != nullptr)
@@ -47,63 +47,355 @@ EdgeTable::EdgeTable (Rectangle<int> area, const Path& path, const AffineTransfo
         t += lineStrideElements;
     }
 
-    auto leftLimit   = bounds.getX() * 256;
-    auto topLimit    = bounds.getY() * 256;
-    auto rightLimit  = bounds.getRight() * 256;
-    auto heightLimit = bounds.getHeight() * 256;
-
     PathFlatteningIterator iter (path, transform);
 
     while (iter.next())
+        addLine (iter.x1, iter.y1, iter.x2, iter.y2);
+
+    sanitiseLevels (path.isUsingNonZeroWinding());
+}
+
+void EdgeTable::addLine (float lineX1, float lineY1, float lineX2, float lineY2)
+{
+    auto y1 = roundToInt (lineY1 * 256.0f);
+    auto y2 = roundToInt (lineY2 * 256.0f);
+
+    if (y1 != y2)
     {
-        auto y1 = roundToInt (iter.y1 * 256.0f);
-        auto y2 = roundToInt (iter.y2 * 256.0f);
+        auto leftLimit   = bounds.getX() * 256;
+        auto topLimit    = bounds.getY() * 256;
+        auto rightLimit  = bounds.getRight() * 256;
+        auto heightLimit = bounds.getHeight() * 256;
 
-        if (y1 != y2)
+        y1 -= topLimit;
+        y2 -= topLimit;
+
+        auto startY = y1;
+        int direction = -1;
+
+        if (y1 > y2)
         {
-            y1 -= topLimit;
-            y2 -= topLimit;
+            std::swap (y1, y2);
+            direction = 1;
+        }
 
-            auto startY = y1;
-            int direction = -1;
+        if (y1 < 0)
+            y1 = 0;
+
+        if (y2 > heightLimit)
+            y2 = heightLimit;
+
+        if (y1 < y2)
+        {
+            const double startX = 256.0f * lineX1;
+            const double multiplier = (lineX2 - lineX1) / (lineY2 - lineY1);
+            auto stepSize = jlimit (1, 256, 256 / (1 + (int) std::abs (multiplier)));
 
-            if (y1 > y2)
+            do
             {
-                std::swap (y1, y2);
-                direction = 1;
+                auto step = jmin (stepSize, y2 - y1, 256 - (y1 & 255));
+                auto x = roundToInt (startX + multiplier * ((y1 + (step >> 1)) - startY));
+
+                if (x < leftLimit)
+                    x = leftLimit;
+                else if (x >= rightLimit)
+                    x = rightLimit - 1;
+
+                addEdgePoint (x, y1 >> 8, direction * step);
+                y1 += step;
             }
+            while (y1 < y2);
+        }
+    }
+}
+
+//==============================================================================
+struct EdgeTable::PolylineStroker
+{
+    PolylineStroker (EdgeTable& et, float thickness, bool useMiteredJoints) noexcept
+        : table (et),
+          halfWidth (thickness * 0.5f),
+          maxMiterExtensionSquared (9.0f * thickness * thickness),
+          mitered (useMiteredJoints)
+    {
+    }
+
+    void startNewSubPath (Point<float> p)
+    {
+        finishSubPath();
+        subPathStart = lastPoint = p;
+    }
 
-            if (y1 < 0)
-                y1 = 0;
+    void lineTo (Point<float> p)
+    {
+        auto delta = p - lastPoint;
+        auto length = delta.getDistanceFromOrigin();
+
+        if (length <= 0.0f)
+            return;
+
+        Segment next { lastPoint, p, delta, Point<float> (-delta.y, delta.x) * (halfWidth / length) };
+        next.setButtStart();
+        next.setButtEnd();
 
-            if (y2 > heightLimit)
-                y2 = heightLimit;
+        // Each segment is only added once both of its ends are known, and the first one
+        // waits until the end of the sub-path, in case it gets closed.
+        if (numSegments > 0)
+        {
+            addJoint (lastSegment, next);
+
+            if (numSegments == 1)
+                firstSegment = lastSegment;
+            else
+                addSegment (lastSegment);
+        }
 
-            if (y1 < y2)
+        lastSegment = next;
+        lastPoint = p;
+        ++numSegments;
+    }
+
+    void closeSubPath()
+    {
+        if (numSegments > 0)
+        {
+            lineTo (subPathStart);
+
+            if (numSegments > 1)
             {
-                const double startX = 256.0f * iter.x1;
-                const double multiplier = (iter.x2 - iter.x1) / (iter.y2 - iter.y1);
-                auto stepSize = jlimit (1, 256, 256 / (1 + (int) std::abs (multiplier)));
+                addJoint (lastSegment, firstSegment);
+                addSegment (firstSegment);
+                addSegment (lastSegment);
+                numSegments = 0;
+            }
+        }
 
-                do
-                {
-                    auto step = jmin (stepSize, y2 - y1, 256 - (y1 & 255));
-                    auto x = roundToInt (startX + multiplier * ((y1 + (step >> 1)) - startY));
+        startNewSubPath (subPathStart);
+    }
 
-                    if (x < leftLimit)
-                        x = leftLimit;
-                    else if (x >= rightLimit)
-                        x = rightLimit - 1;
+    void finishSubPath()
+    {
+        if (numSegments > 1)
+            addSegment (firstSegment);
 
-                    addEdgePoint (x, y1 >> 8, direction * step);
-                    y1 += step;
-                }
-                while (y1 < y2);
+        if (numSegments > 0)
+            addSegment (lastSegment);
+
+        numSegments = 0;
+    }
+
+private:
+    // The outline across each end of a segment, which runs from the -normal side to the
+    // +normal side at its start, and back the other way at its end.
+    struct Segment
+    {
+        Point<float> start, end, delta, normal;
+        Point<float> startPoints[3], endPoints[3];
+        int numStartPoints, numEndPoints;
+
+        void setButtStart() noexcept    { setStart ({ start - normal, start + normal }); }
+        void setButtEnd() noexcept      { setEnd ({ end + normal, end - normal }); }
+
+        void setStart (std::initializer_list<Point<float>> points) noexcept
+        {
+            numStartPoints = 0;
+
+            for (auto& p : points)
+                startPoints[numStartPoints++] = p;
+        }
+
+        void setEnd (std::initializer_list<Point<float>> points) noexcept
+        {
+            numEndPoints = 0;
+
+            for (auto& p : points)
+                endPoints[numEndPoints++] = p;
+        }
+    };
+
+    EdgeTable& table;
+    const float halfWidth, maxMiterExtensionSquared;
+    const bool mitered;
+    Point<float> subPathStart, lastPoint;
+    Segment firstSegment, lastSegment;
+    int numSegments = 0;
+
+    static float crossProduct (Point<float> a, Point<float> b) noexcept    { return a.x * b.y - a.y * b.x; }
+
+    void addSegment (const Segment& segment)
+    {
+        Point<float> points[6];
+        int numPoints = 0;
+
+        for (int i = 0; i < segment.numStartPoints; ++i)
+            points[numPoints++] = segment.startPoints[i];
+
+        for (int i = 0; i < segment.numEndPoints; ++i)
+            points[numPoints++] = segment.endPoints[i];
+
+        addPolygon (points, numPoints);
+    }
+
+    // Where possible, the corner between two segments is split along the bisector of its
+    // angle, so that the segments' pieces meet without overlapping. That matters because
+    // the edge table adds up the coverage of overlapping pieces within a pixel, which would
+    // make the inside of the corner look too dark. If the corner is too sharp for the
+    // segments' lengths, their ends are left square, and the outside of the corner is
+    // filled with a separate piece.
+    void addJoint (Segment& s1, Segment& s2)
+    {
+        auto divisor = crossProduct (s1.delta, s2.delta);
+
+        if (divisor == 0.0f)
+            return; // (they're either in a straight line, or doubling back on themselves)
+
+        auto centre = s1.end;
+        auto side = divisor > 0.0f ? -1.0f : 1.0f;
+        auto a = centre + s1.normal * side;
+        auto b = centre + s2.normal * side;
+
+        // the inner edges cross at innerCorner, which is s1.delta * along1 from the end of s1, and
+        // s2.delta * along2 from the start of s2
+        auto innerStart1 = centre - s1.normal * side;
+        auto innerStart2 = centre - s2.normal * side;
+        auto along1 = crossProduct (innerStart2 - innerStart1, s2.delta) / divisor;
+        auto along2 = crossProduct (innerStart2 - innerStart1, s1.delta) / divisor;
+
+        Point<float> miter;
+        bool useMiter = false;
+
+        if (mitered)
+        {
+            auto along = crossProduct (b - a, s2.delta) / divisor;
+            auto extensionSquared = along * along * (s1.delta.x * s1.delta.x + s1.delta.y * s1.delta.y);
+
+            if (along > 0.0f && extensionSquared < maxMiterExtensionSquared)
+            {
+                miter = a + s1.delta * along;
+                useMiter = true;
             }
         }
+
+        if (along1 < -0.5f || along1 > 0.0f || along2 < 0.0f || along2 > 0.5f)
+        {
+            if (useMiter)
+            {
+                const Point<float> corner[] = { centre, a, miter, b };
+                addPolygon (corner, 4);
+            }
+            else
+            {
+                const Point<float> bevel[] = { centre, a, b };
+                addPolygon (bevel, 3);
+            }
+
+            return;
+        }
+
+        auto inner = innerStart1 + s1.delta * along1;
+
+        if (useMiter)
+        {
+            s1.setEnd (side > 0 ? std::initializer_list<Point<float>> { miter, inner } : std::initializer_list<Point<float>> { inner, miter });
+            s2.setStart (side > 0 ? std::initializer_list<Point<float>> { inner, miter } : std::initializer_list<Point<float>> { miter, inner });
+        }
+        else
+        {
+            auto mid = (a + b) * 0.5f;
+            s1.setEnd (side > 0 ? std::initializer_list<Point<float>> { a, mid, inner } : std::initializer_list<Point<float>> { inner, mid, a });
+            s2.setStart (side > 0 ? std::initializer_list<Point<float>> { inner, mid, b } : std::initializer_list<Point<float>> { b, mid, inner });
+        }
     }
 
-    sanitiseLevels (path.isUsingNonZeroWinding());
+    // All the pieces are added with the same winding direction, so that where they
+    // overlap, the non-zero fill rule joins them together rather than cancelling out.
+    void addPolygon (const Point<float>* points, int numPoints)
+    {
+        float area = 0;
+
+        for (int i = 0; i < numPoints; ++i)
+        {
+            auto& p1 = points[i];
+            auto& p2 = points[(i + 1) % numPoints];
+            area += p1.x * p2.y - p2.x * p1.y;
+        }
+
+        if (area == 0.0f)
+            return;
+
+        for (int i = 0; i < numPoints; ++i)
+        {
+            auto& p1 = points[area > 0 ? i : (numPoints - i) % numPoints];
+            auto& p2 = points[area > 0 ? (i + 1) % numPoints : numPoints - 1 - i];
+            table.addLine (p1.x, p1.y, p2.x, p2.y);
+        }
+    }
+
+    JUCE_DECLARE_NON_COPYABLE (PolylineStroker)
+};
+
+EdgeTable::EdgeTable (Rectangle<int> area, const Path& path,
+                      const AffineTransform& transform, const PathStrokeType& strokeType)
+   : bounds (area),
+     maxEdgesPerLine (jmax (juce_edgeTableDefaultEdgesPerLine / 2,
+                            4 * (int) std::sqrt (path.data.size()))),
+     lineStrideElements (maxEdgesPerLine * 2 + 1)
+{
+    jassert (canStrokeDirectly (path, strokeType));
+
+    allocate();
+    clearLineSizes();
+
+    PolylineStroker stroker (*this, strokeType.getStrokeThickness(),
+                             strokeType.getJointStyle() == PathStrokeType::mitered);
+
+    for (int i = 0; i < path.data.size();)
+    {
+        auto type = path.data.getUnchecked (i);
+
+        if (type == Path::closeSubPathMarker)
+        {
+            stroker.closeSubPath();
+            ++i;
+            continue;
+        }
+
+        Point<float> p (path.data.getUnchecked (i + 1),
+                        path.data.getUnchecked (i + 2));
+        transform.transformPoint (p.x, p.y);
+
+        if (type == Path::moveMarker)
+            stroker.startNewSubPath (p);
+        else
+            stroker.lineTo (p);
+
+        i += 3;
+    }
+
+    stroker.finishSubPath();
+    sanitiseLevels (true);
+}
+
+bool EdgeTable::canStrokeDirectly (const Path& path, const PathStrokeType& strokeType) noexcept
+{
+    if (strokeType.getEndStyle() != PathStrokeType::butt
+         || strokeType.getJointStyle() == PathStrokeType::curved
+         || strokeType.getStrokeThickness() <= 0.0f)
+        return false;
+
+    for (int i = 0; i < path.data.size();)
+    {
+        auto type = path.data.getUnchecked (i);
+
+        if (type == Path::moveMarker || type == Path::lineMarker)
+            i += 3;
+        else if (type == Path::closeSubPathMarker)
+            ++i;
+        else
+            return false;
+    }
+
+    return true;
 }
 
 EdgeTable::EdgeTable (Rectangle<int> rectangleToAdd)
@@ -838,4 +1130,197 @@ bool EdgeTable::isEmpty() noexcept
     return bounds.getHeight() == 0;
 }
 
+
+//==============================================================================
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class EdgeTableTests  : public UnitTest
+{
+public:
+    EdgeTableTests()
+        : UnitTest ("EdgeTable", UnitTestCategories::graphics)
+    {}
+
+    void runTest() override
+    {
+        auto r = getRandom();
+
+        const PathStrokeType::JointStyle jointStyles[] = { PathStrokeType::mitered, PathStrokeType::curved, PathStrokeType::beveled };
+        const PathStrokeType::EndCapStyle endStyles[]  = { PathStrokeType::butt, PathStrokeType::square, PathStrokeType::rounded };
+
+        beginTest ("Stroked polylines match PathStrokeType");
+        {
+            for (auto joint : jointStyles)
+            {
+                for (auto end : endStyles)
+                {
+                    for (int i = 0; i < 20; ++i)
+                    {
+                        PathStrokeType stroke (0.3f + r.nextFloat() * (i < 10 ? 3.0f : 15.0f), joint, end);
+                        auto path = createRandomPolyline (r, i % 3 == 0, stroke.getStrokeThickness() * 2.0f);
+
+                        expect (EdgeTable::canStrokeDirectly (path, stroke)
+                                  == (end == PathStrokeType::butt && joint != PathStrokeType::curved));
+
+                        compareWithStrokedPath (path, stroke);
+                    }
+                }
+            }
+        }
+
+        beginTest ("Stroking degenerate polylines");
+        {
+            auto line = [] (std::initializer_list<Point<float>> points, bool closed)
+            {
+                Path p;
+                p.startNewSubPath (*points.begin());
+
+                for (auto& point : points)
+                    p.lineTo (point);
+
+                if (closed)
+                    p.closeSubPath();
+
+                return p;
+            };
+
+            const Path paths[] =
+            {
+                line ({ { 20, 20 } }, false),                                         // a lone point
+                line ({ { 20, 20 }, { 20, 20 } }, false),                             // a zero-length line
+                line ({ { 10, 10 }, { 50, 50 }, { 50, 50 }, { 90, 10 } }, false),     // a repeated point
+                line ({ { 10, 50 }, { 90, 50 }, { 30, 50 } }, false),                 // doubling back
+                line ({ { 10, 50 }, { 50, 50 }, { 90, 50 } }, false),                 // collinear
+                line ({ { 10, 10 }, { 90, 10 }, { 50, 80 }, { 10, 10 } }, true),      // closed at its start point
+                line ({ { 10, 10 }, { 90, 10 }, { 50, 80 } }, true),
+                line ({ { 30, 30 }, { 30.01f, 30.01f }, { 60, 30 } }, false),         // a tiny segment
+            };
+
+            for (auto& path : paths)
+                for (auto joint : { PathStrokeType::mitered, PathStrokeType::beveled })
+                    for (auto thickness : { 0.1f, 1.0f, 7.0f })
+                        compareWithStrokedPath (path, PathStrokeType (thickness, joint, PathStrokeType::butt));
+
+            // This corner is too sharp to be mitered, so both joint styles should give the same
+            // shape. It's compared against PathStrokeType's mitered outline, because its beveled
+            // one loops back on itself inside the corner, which upsets the antialiasing.
+            auto sharpCorner = line ({ { 10, 10 }, { 90, 12 }, { 10, 14 } }, false);
+
+            for (auto joint : { PathStrokeType::mitered, PathStrokeType::beveled })
+                for (auto thickness : { 0.1f, 1.0f, 7.0f })
+                    compareWithStrokedPath (sharpCorner, PathStrokeType (thickness, joint, PathStrokeType::butt),
+                                            PathStrokeType (thickness, PathStrokeType::mitered, PathStrokeType::butt));
+
+            // a lone point or a zero-length line has nothing to draw
+            for (auto& path : { paths[0], paths[1] })
+                expectEquals (getTotalCoverage (render ([&] (Graphics& g) { g.strokePath (path, PathStrokeType (5.0f)); })), (int64) 0);
+        }
+    }
+
+private:
+    // (The segments are kept longer than the stroke is wide, because PathStrokeType can cut
+    // into the corner of a segment that's followed by a very short one)
+    static Path createRandomPolyline (Random& r, bool closed, float minSegmentLength)
+    {
+        auto randomPoint = [&r] { return Point<float> (10.0f + r.nextFloat() * 80.0f, 10.0f + r.nextFloat() * 80.0f); };
+
+        Array<Point<float>> points { randomPoint() };
+
+        while (points.size() < 3 + r.nextInt (6))
+        {
+            auto p = randomPoint();
+
+            if (p.getDistanceFrom (points.getLast()) >= minSegmentLength
+                 && (! closed || p.getDistanceFrom (points.getFirst()) >= minSegmentLength))
+                points.add (p);
+        }
+
+        Path path;
+        path.startNewSubPath (points.getFirst());
+
+        for (int i = 1; i < points.size(); ++i)
+            path.lineTo (points[i]);
+
+        if (closed)
+            path.closeSubPath();
+
+        return path;
+    }
+
+    static Image render (std::function<void (Graphics&)> draw)
+    {
+        Image image (Image::SingleChannel, 100, 100, true, SoftwareImageType());
+        Graphics g (image);
+        g.setColour (Colours::white);
+        draw (g);
+        return image;
+    }
+
+    static int64 getTotalCoverage (const Image& image)
+    {
+        const Image::BitmapData data (image, Image::BitmapData::readOnly);
+        int64 total = 0;
+
+        for (int y = 0; y < data.height; ++y)
+            for (int x = 0; x < data.width; ++x)
+                total += *data.getPixelPointer (x, y);
+
+        return total;
+    }
+
+    // Renders a polyline directly (with the stroker, where it's able to) and by filling
+    // the outline from PathStrokeType::createStrokedPath(), and compares the coverage.
+    void compareWithStrokedPath (const Path& path, const PathStrokeType& stroke)
+    {
+        compareWithStrokedPath (path, stroke, stroke);
+    }
+
+    void compareWithStrokedPath (const Path& path, const PathStrokeType& stroke, const PathStrokeType& outlineStroke)
+    {
+        auto direct = render ([&] (Graphics& g) { g.strokePath (path, stroke); });
+
+        auto outline = render ([&] (Graphics& g)
+        {
+            Path strokedPath;
+            outlineStroke.createStrokedPath (strokedPath, path);
+            g.fillPath (strokedPath);
+        });
+
+        const Image::BitmapData directData (direct, Image::BitmapData::readOnly);
+        const Image::BitmapData outlineData (outline, Image::BitmapData::readOnly);
+        int64 directTotal = 0, outlineTotal = 0;
+        int numDifferentPixels = 0;
+
+        for (int y = 0; y < directData.height; ++y)
+        {
+            for (int x = 0; x < directData.width; ++x)
+            {
+                auto d = (int) *directData.getPixelPointer (x, y);
+                auto o = (int) *outlineData.getPixelPointer (x, y);
+
+                if (std::abs (d - o) > 32)
+                    ++numDifferentPixels;
+
+                directTotal += d;
+                outlineTotal += o;
+            }
+        }
+
+        int numPoints = 0;
+
+        for (Path::Iterator i (path); i.next();)
+            ++numPoints;
+
+        // The two can only differ around the corners, where the antialiasing of the
+        // outline's overlapping edges differs from that of the stroker's pieces
+        expectLessOrEqual (numDifferentPixels, 6 * numPoints, path.toString());
+        expectLessOrEqual (std::abs (directTotal - outlineTotal), outlineTotal / 50 + 3 * 255 * numPoints, path.toString());
+    }
+};
+
+static EdgeTableTests edgeTableTests;
+
+#endif
+
 } // namespace juce
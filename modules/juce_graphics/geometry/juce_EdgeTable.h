@@ -51,6 +51,32 @@ public:
                const Path& pathToAdd,
                const AffineTransform& transform);
 
+    /** Creates an edge table containing the outline of a stroked path.
+
+        This rasterises the stroke directly, without first building the stroked outline
+        as a Path, which makes it much cheaper for long polylines such as waveforms. It
+        can only be used for paths and stroke types for which canStrokeDirectly() returns
+        true, and it produces the same shape as PathStrokeType::createStrokedPath().
+
+        @param clipLimits               only the region of the stroke that lies within this area will be added
+        @param pathToStroke             the path to stroke
+        @param transform                a transform to apply to the path's points before stroking it (note
+                                        that like PathStrokeType::createStrokedPath(), this doesn't affect
+                                        the stroke thickness)
+        @param strokeType               the stroke to use
+    */
+    EdgeTable (Rectangle<int> clipLimits,
+               const Path& pathToStroke,
+               const AffineTransform& transform,
+               const PathStrokeType& strokeType);
+
+    /** Returns true if the stroking constructor can be used for this path and stroke type.
+
+        This requires a path made only of straight lines, and a stroke with butt end-caps
+        and mitered or bevelled joints.
+    */
+    static bool canStrokeDirectly (const Path& path, const PathStrokeType& strokeType) noexcept;
+
     /** Creates an edge table containing a rectangle. */
     explicit EdgeTable (Rectangle<int> rectangleToAdd);
 
@@ -200,6 +226,8 @@ private:
         bool operator< (const LineItem& other) const noexcept   { return x < other.x; }
     };
 
+    struct PolylineStroker;
+
     HeapBlock<int> table;
     Rectangle<int> bounds;
     int maxEdgesPerLine, lineStrideElements;
@@ -208,6 +236,7 @@ private:
     void allocate();
     void clearLineSizes() noexcept;
     void addEdgePoint (int x, int y, int winding);
+    void addLine (float x1, float y1, float x2, float y2);
     void addEdgePointPair (int x1, int x2, int y, int winding);
     void remapTableForNumEdges (int newNumEdgesPerLine);
     void remapWithExtraSpace (int numPointsNeeded);
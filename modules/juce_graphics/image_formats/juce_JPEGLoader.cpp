@@ -174,6 +174,168 @@ namespace JPEGHelpers
     {
         return 0;
     }
+
+    // Picks the largest power-of-two reduction that libjpeg can apply in its IDCT while
+    // still leaving the image at least as big as the target size.
+    static unsigned int getScaleDenominatorForSize (const jpeg_decompress_struct& decomp,
+                                                    int targetWidth, int targetHeight) noexcept
+    {
+        if (targetWidth <= 0 && targetHeight <= 0)
+            return 1;
+
+        auto isBigEnough = [&] (unsigned int denom)
+        {
+            auto scaledWidth  = (int) ((decomp.image_width  + denom - 1) / denom);
+            auto scaledHeight = (int) ((decomp.image_height + denom - 1) / denom);
+
+            return scaledWidth >= targetWidth && scaledHeight >= targetHeight;
+        };
+
+        unsigned int denom = 1;
+
+        while (denom < 8 && isBigEnough (denom * 2))
+            denom *= 2;
+
+        return denom;
+    }
+
+    // (The direct decoding can be turned off, so that the tests can compare it with the conversion)
+    static Image readImage (InputStream& in, int targetWidth, int targetHeight,
+                            Rectangle<int>* originalBounds = nullptr, bool allowDirectDecoding = true)
+    {
+        MemoryOutputStream mb;
+        mb << in;
+
+        Image image;
+
+        if (mb.getDataSize() > 16)
+        {
+            struct jpeg_decompress_struct jpegDecompStruct;
+
+            struct jpeg_error_mgr jerr;
+            setupSilentErrorHandler (jerr);
+            jpegDecompStruct.err = &jerr;
+
+            jpeg_create_decompress (&jpegDecompStruct);
+
+            jpegDecompStruct.src = (jpeg_source_mgr*)(jpegDecompStruct.mem->alloc_small)
+                ((j_common_ptr)(&jpegDecompStruct), JPOOL_PERMANENT, sizeof (jpeg_source_mgr));
+
+            bool hasFailed = false;
+            jpegDecompStruct.client_data = &hasFailed;
+
+            jpegDecompStruct.src->init_source       = dummyCallback1;
+            jpegDecompStruct.src->fill_input_buffer = jpegFill;
+            jpegDecompStruct.src->skip_input_data   = jpegSkip;
+            jpegDecompStruct.src->resync_to_restart = jpeg_resync_to_restart;
+            jpegDecompStruct.src->term_source       = dummyCallback1;
+
+            jpegDecompStruct.src->next_input_byte   = static_cast<const unsigned char*> (mb.getData());
+            jpegDecompStruct.src->bytes_in_buffer   = mb.getDataSize();
+
+            jpeg_read_header (&jpegDecompStruct, TRUE);
+
+            if (! hasFailed)
+            {
+                if (originalBounds != nullptr)
+                    *originalBounds = { (int) jpegDecompStruct.image_width, (int) jpegDecompStruct.image_height };
+
+                jpegDecompStruct.scale_num = 1;
+                jpegDecompStruct.scale_denom = getScaleDenominatorForSize (jpegDecompStruct, targetWidth, targetHeight);
+                jpegDecompStruct.out_color_space = JCS_RGB;
+
+                jpeg_calc_output_dimensions (&jpegDecompStruct);
+
+                if (! hasFailed)
+                {
+                    const int width  = (int) jpegDecompStruct.output_width;
+                    const int height = (int) jpegDecompStruct.output_height;
+
+                    JSAMPARRAY buffer
+                        = (*jpegDecompStruct.mem->alloc_sarray) ((j_common_ptr) &jpegDecompStruct,
+                                                                 JPOOL_IMAGE,
+                                                                 (JDIMENSION) width * 3, 1);
+
+                    if (jpeg_start_decompress (&jpegDecompStruct) && ! hasFailed)
+                    {
+                        image = Image (Image::RGB, width, height, false);
+                        image.getProperties()->set ("originalImageHadAlpha", false);
+
+                        const Image::BitmapData destData (image, Image::BitmapData::writeOnly);
+
+                        // If the image has the layout we asked for, the scanlines can be decoded
+                        // straight into it, leaving only the red and blue channels to be swapped.
+                        if (allowDirectDecoding && destData.pixelFormat == Image::RGB && destData.pixelStride == 3)
+                        {
+                            HeapBlock<JSAMPROW> lines (height);
+
+                            for (int y = 0; y < height; ++y)
+                                lines[y] = destData.getLinePointer (y);
+
+                            for (int y = 0; y < height && ! hasFailed;)
+                            {
+                                auto numRead = (int) jpeg_read_scanlines (&jpegDecompStruct, lines + y, (JDIMENSION) (height - y));
+
+                                if (numRead <= 0)
+                                    break;
+
+                                if (PixelRGB::indexR != 0)
+                                    for (int i = y; i < y + numRead; ++i)
+                                        for (auto* p = destData.getLinePointer (i), *end = p + width * 3; p < end; p += 3)
+                                            std::swap (p[0], p[2]);
+
+                                y += numRead;
+                            }
+                        }
+                        else
+                        {
+                            const bool hasAlphaChan = image.hasAlphaChannel(); // (the native image creator may not give back what we expect)
+
+                            for (int y = 0; y < height; ++y)
+                            {
+                                jpeg_read_scanlines (&jpegDecompStruct, buffer, 1);
+
+                                if (hasFailed)
+                                    break;
+
+                                const uint8* src = *buffer;
+                                uint8* dest = destData.getLinePointer (y);
+
+                                if (hasAlphaChan)
+                                {
+                                    for (int i = width; --i >= 0;)
+                                    {
+                                        ((PixelARGB*) dest)->setARGB (0xff, src[0], src[1], src[2]);
+                                        ((PixelARGB*) dest)->premultiply();
+                                        dest += destData.pixelStride;
+                                        src += 3;
+                                    }
+                                }
+                                else
+                                {
+                                    for (int i = width; --i >= 0;)
+                                    {
+                                        ((PixelRGB*) dest)->setARGB (0xff, src[0], src[1], src[2]);
+                                        dest += destData.pixelStride;
+                                        src += 3;
+                                    }
+                                }
+                            }
+                        }
+
+                        if (! hasFailed)
+                            jpeg_finish_decompress (&jpegDecompStruct);
+
+                        in.setPosition (((char*) jpegDecompStruct.src->next_input_byte) - (char*) mb.getData());
+                    }
+                }
+            }
+
+            jpeg_destroy_decompress (&jpegDecompStruct);
+        }
+
+        return image;
+    }
    #endif
 
     //==============================================================================
@@ -251,112 +413,31 @@ bool JPEGImageFormat::canUnderstand (InputStream& in)
 
 Image JPEGImageFormat::decodeImage (InputStream& in)
 {
-#if JUCE_USING_COREIMAGE_LOADER
+   #if JUCE_USING_COREIMAGE_LOADER
     return juce_loadWithCoreImage (in);
-#else
-    using namespace jpeglibNamespace;
-    using namespace JPEGHelpers;
-
-    MemoryOutputStream mb;
-    mb << in;
-
-    Image image;
-
-    if (mb.getDataSize() > 16)
-    {
-        struct jpeg_decompress_struct jpegDecompStruct;
-
-        struct jpeg_error_mgr jerr;
-        setupSilentErrorHandler (jerr);
-        jpegDecompStruct.err = &jerr;
-
-        jpeg_create_decompress (&jpegDecompStruct);
-
-        jpegDecompStruct.src = (jpeg_source_mgr*)(jpegDecompStruct.mem->alloc_small)
-            ((j_common_ptr)(&jpegDecompStruct), JPOOL_PERMANENT, sizeof (jpeg_source_mgr));
-
-        bool hasFailed = false;
-        jpegDecompStruct.client_data = &hasFailed;
-
-        jpegDecompStruct.src->init_source       = dummyCallback1;
-        jpegDecompStruct.src->fill_input_buffer = jpegFill;
-        jpegDecompStruct.src->skip_input_data   = jpegSkip;
-        jpegDecompStruct.src->resync_to_restart = jpeg_resync_to_restart;
-        jpegDecompStruct.src->term_source       = dummyCallback1;
-
-        jpegDecompStruct.src->next_input_byte   = static_cast<const unsigned char*> (mb.getData());
-        jpegDecompStruct.src->bytes_in_buffer   = mb.getDataSize();
-
-        jpeg_read_header (&jpegDecompStruct, TRUE);
-
-        if (! hasFailed)
-        {
-            jpeg_calc_output_dimensions (&jpegDecompStruct);
-
-            if (! hasFailed)
-            {
-                const int width  = (int) jpegDecompStruct.output_width;
-                const int height = (int) jpegDecompStruct.output_height;
-
-                jpegDecompStruct.out_color_space = JCS_RGB;
-
-                JSAMPARRAY buffer
-                    = (*jpegDecompStruct.mem->alloc_sarray) ((j_common_ptr) &jpegDecompStruct,
-                                                             JPOOL_IMAGE,
-                                                             (JDIMENSION) width * 3, 1);
-
-                if (jpeg_start_decompress (&jpegDecompStruct) && ! hasFailed)
-                {
-                    image = Image (Image::RGB, width, height, false);
-                    image.getProperties()->set ("originalImageHadAlpha", false);
-                    const bool hasAlphaChan = image.hasAlphaChannel(); // (the native image creator may not give back what we expect)
-
-                    const Image::BitmapData destData (image, Image::BitmapData::writeOnly);
-
-                    for (int y = 0; y < height; ++y)
-                    {
-                        jpeg_read_scanlines (&jpegDecompStruct, buffer, 1);
-
-                        if (hasFailed)
-                            break;
-
-                        const uint8* src = *buffer;
-                        uint8* dest = destData.getLinePointer (y);
-
-                        if (hasAlphaChan)
-                        {
-                            for (int i = width; --i >= 0;)
-                            {
-                                ((PixelARGB*) dest)->setARGB (0xff, src[0], src[1], src[2]);
-                                ((PixelARGB*) dest)->premultiply();
-                                dest += destData.pixelStride;
-                                src += 3;
-                            }
-                        }
-                        else
-                        {
-                            for (int i = width; --i >= 0;)
-                            {
-                                ((PixelRGB*) dest)->setARGB (0xff, src[0], src[1], src[2]);
-                                dest += destData.pixelStride;
-                                src += 3;
-                            }
-                        }
-                    }
-
-                    if (! hasFailed)
-                        jpeg_finish_decompress (&jpegDecompStruct);
-
-                    in.setPosition (((char*) jpegDecompStruct.src->next_input_byte) - (char*) mb.getData());
-                }
-            }
-        }
-
-        jpeg_destroy_decompress (&jpegDecompStruct);
-    }
+   #else
+    return JPEGHelpers::readImage (in, 0, 0);
+   #endif
+}
 
-    return image;
-#endif
+Image JPEGImageFormat::decodeImageForSize (InputStream& in, int targetWidth, int targetHeight)
+{
+   #if JUCE_USING_COREIMAGE_LOADER
+    return ImageFileFormat::decodeImageForSize (in, targetWidth, targetHeight);
+   #else
+    // The IDCT can only scale by powers of two, so this gets us close, and the
+    // final step down to the target size is done by resampling the smaller image.
+    // (The final size is worked out from the original one, because the rounding
+    // of the reduced size would give slightly different proportions)
+    Rectangle<int> originalBounds;
+    auto image = JPEGHelpers::readImage (in, targetWidth, targetHeight, &originalBounds);
+    auto bounds = getReducedBounds (originalBounds, targetWidth, targetHeight);
+
+    if (image.isNull() || image.getBounds() == bounds)
+        return image;
+
+    return image.rescaled (bounds.getWidth(), bounds.getHeight(), Graphics::highResamplingQuality);
+   #endif
 }
 
 bool JPEGImageFormat::writeImageToStream (const Image& image, OutputStream& out)
@@ -448,4 +529,127 @@ bool JPEGImageFormat::writeImageToStream (const Image& image, OutputStream& out)
     return true;
 }
 
+//==============================================================================
+#if JUCE_UNIT_TESTS && ! JUCE_USING_COREIMAGE_LOADER
+
+class JPEGImageFormatTests  : public UnitTest
+{
+public:
+    JPEGImageFormatTests()
+        : UnitTest ("JPEGImageFormat", UnitTestCategories::graphics)
+    {}
+
+    void runTest() override
+    {
+        beginTest ("Decoding straight into the image matches the conversion");
+        {
+            for (auto format : { Image::RGB, Image::ARGB })
+            {
+                auto data = createTestFile (format, 123, 45);
+
+                MemoryInputStream directStream (data, false), convertedStream (data, false);
+                auto direct = JPEGImageFormat().decodeImage (directStream);
+                auto converted = JPEGHelpers::readImage (convertedStream, 0, 0, nullptr, false);
+
+                expect (direct.getFormat() == Image::RGB && converted.getFormat() == Image::RGB);
+                expect (direct.getBounds() == Rectangle<int> (123, 45));
+                expect (converted.getBounds() == direct.getBounds());
+                expectEquals (countDifferentPixels (direct, converted), 0);
+            }
+        }
+
+        beginTest ("Scaled decoding gives the requested size");
+        {
+            struct Size  { int width, height, targetWidth, targetHeight; };
+
+            const Size sizes[] = { { 640, 480, 100, 0 },      // using only the width
+                                   { 640, 480, 0, 100 },      // using only the height
+                                   { 640, 480, 100, 100 },    // using the larger ratio
+                                   { 640, 480, 320, 240 },    // exactly half the size
+                                   { 640, 480, 80, 60 },      // exactly an eighth
+                                   { 333, 517, 50, 50 },
+                                   { 333, 517, 41, 0 },
+                                   { 333, 517, 7, 3 },
+                                   { 1001, 99, 0, 12 },
+                                   { 640, 480, 700, 0 },      // bigger than the image
+                                   { 640, 480, 0, 0 } };      // no target size
+
+            for (auto& size : sizes)
+            {
+                auto data = createTestFile (Image::RGB, size.width, size.height);
+                auto description = String (size.width) + "x" + String (size.height) + " to "
+                                      + String (size.targetWidth) + "x" + String (size.targetHeight);
+
+                MemoryInputStream scaledStream (data, false), fullStream (data, false);
+                JPEGImageFormat format;
+
+                auto scaled = format.decodeImageForSize (scaledStream, size.targetWidth, size.targetHeight);
+                auto reduced = format.ImageFileFormat::decodeImageForSize (fullStream, size.targetWidth, size.targetHeight);
+
+                // It should give the same size as the default implementation, which decodes the
+                // whole image and then scales it, and roughly the same overall colour (they're
+                // resampled from different sizes, so the edges get weighted differently)
+                expect (reduced.isValid());
+                expect (scaled.getBounds() == reduced.getBounds(), description);
+
+                auto scaledColour = getAverageColour (scaled), reducedColour = getAverageColour (reduced);
+
+                expectWithinAbsoluteError ((int) scaledColour.getRed(),   (int) reducedColour.getRed(),   8, description);
+                expectWithinAbsoluteError ((int) scaledColour.getGreen(), (int) reducedColour.getGreen(), 8, description);
+                expectWithinAbsoluteError ((int) scaledColour.getBlue(),  (int) reducedColour.getBlue(),  8, description);
+            }
+        }
+    }
+
+private:
+    static MemoryBlock createTestFile (Image::PixelFormat format, int width, int height)
+    {
+        Image image (format, width, height, false);
+
+        for (int y = 0; y < height; ++y)
+            for (int x = 0; x < width; ++x)
+                image.setPixelAt (x, y, Colour ((uint8) (x * 255 / width), (uint8) (y * 255 / height),
+                                                (uint8) (128 + 100 * std::sin ((x + y) * 0.05))));
+
+        MemoryOutputStream out;
+        JPEGImageFormat().writeImageToStream (image, out);
+        return out.getMemoryBlock();
+    }
+
+    static int countDifferentPixels (const Image& a, const Image& b)
+    {
+        int numDifferent = 0;
+
+        for (int y = 0; y < a.getHeight(); ++y)
+            for (int x = 0; x < a.getWidth(); ++x)
+                if (a.getPixelAt (x, y) != b.getPixelAt (x, y))
+                    ++numDifferent;
+
+        return numDifferent;
+    }
+
+    static Colour getAverageColour (const Image& image)
+    {
+        int64 red = 0, green = 0, blue = 0;
+
+        for (int y = 0; y < image.getHeight(); ++y)
+        {
+            for (int x = 0; x < image.getWidth(); ++x)
+            {
+                auto c = image.getPixelAt (x, y);
+                red   += c.getRed();
+                green += c.getGreen();
+                blue  += c.getBlue();
+            }
+        }
+
+        auto numPixels = jmax ((int64) 1, (int64) image.getWidth() * image.getHeight());
+        return Colour ((uint8) (red / numPixels), (uint8) (green / numPixels), (uint8) (blue / numPixels));
+    }
+};
+
+static JPEGImageFormatTests jpegImageFormatTests;
+
+#endif
+
 } // namespace juce
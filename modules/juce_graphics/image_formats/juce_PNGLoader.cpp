@@ -391,14 +391,19 @@ namespace PNGHelpers
         return false;
     }
 
-    static bool readImageData (png_structp pngReadStruct, png_infop pngInfoStruct, jmp_buf& errorJumpBuf, png_bytepp rows) noexcept
+    static bool readImageData (png_structp pngReadStruct, png_infop pngInfoStruct, jmp_buf& errorJumpBuf, png_bytepp rows,
+                               bool addAlphaChannel = true, bool swapRedAndBlue = false) noexcept
     {
         if (setjmp (errorJumpBuf) == 0)
         {
             if (png_get_valid (pngReadStruct, pngInfoStruct, PNG_INFO_tRNS))
                 png_set_expand (pngReadStruct);
 
-            png_set_add_alpha (pngReadStruct, 0xff, PNG_FILLER_AFTER);
+            if (addAlphaChannel)
+                png_set_add_alpha (pngReadStruct, 0xff, PNG_FILLER_AFTER);
+
+            if (swapRedAndBlue)
+                png_set_bgr (pngReadStruct);
 
             png_read_image (pngReadStruct, rows);
             png_read_end (pngReadStruct, pngInfoStruct);
@@ -449,7 +454,78 @@ namespace PNGHelpers
         return image;
     }
 
-    static Image readImage (InputStream& in, png_structp pngReadStruct, png_infop pngInfoStruct)
+    //==============================================================================
+    static void premultiplyLine (PixelARGB* pixels, int numPixels) noexcept
+    {
+       #if JUCE_GRAPHICS_USE_SSE2
+        const auto alphaMask = _mm_set1_epi32 ((int) (0xffu << (8 * PixelARGB::indexA)));
+        const auto rounding  = _mm_set1_epi16 (0x7f);
+        const auto zero      = _mm_setzero_si128();
+
+        auto multiplyByAlpha = [&] (__m128i components)
+        {
+            auto alpha = _mm_shufflehi_epi16 (_mm_shufflelo_epi16 (components, PixelARGB::indexA * 0x55),
+                                              PixelARGB::indexA * 0x55);
+
+            return _mm_srli_epi16 (_mm_add_epi16 (_mm_mullo_epi16 (components, alpha), rounding), 8);
+        };
+
+        for (; numPixels >= 4; numPixels -= 4, pixels += 4)
+        {
+            auto source = _mm_loadu_si128 ((const __m128i*) pixels);
+            auto opaque = _mm_cmpeq_epi32 (_mm_and_si128 (source, alphaMask), alphaMask);
+
+            if (_mm_movemask_epi8 (opaque) == 0xffff)
+                continue;
+
+            // This uses the same rounding as PixelARGB::premultiply(), so the results are identical
+            auto result = _mm_packus_epi16 (multiplyByAlpha (_mm_unpacklo_epi8 (source, zero)),
+                                            multiplyByAlpha (_mm_unpackhi_epi8 (source, zero)));
+
+            // put back the original alpha values, and leave any opaque pixels untouched
+            result = _mm_or_si128 (_mm_andnot_si128 (alphaMask, result), _mm_and_si128 (alphaMask, source));
+            result = _mm_or_si128 (_mm_andnot_si128 (opaque, result), _mm_and_si128 (opaque, source));
+
+            _mm_storeu_si128 ((__m128i*) pixels, result);
+        }
+       #endif
+
+        for (int i = 0; i < numPixels; ++i)
+            pixels[i].premultiply();
+    }
+
+    // Returns true if libpng can be told to produce rows in exactly the layout that the image uses.
+    static bool canDecodeDirectly (const Image::BitmapData& destData, bool hasAlphaChan) noexcept
+    {
+        if (hasAlphaChan)
+            return destData.pixelFormat == Image::ARGB && destData.pixelStride == 4
+                    && PixelARGB::indexA == 3 && (PixelARGB::indexR == 0 || PixelARGB::indexB == 0);
+
+        return destData.pixelFormat == Image::RGB && destData.pixelStride == 3;
+    }
+
+    static bool readImageDataDirectly (png_structp pngReadStruct, png_infop pngInfoStruct, jmp_buf& errorJumpBuf,
+                                       const Image::BitmapData& destData, bool hasAlphaChan)
+    {
+        HeapBlock<png_bytep> rows (destData.height);
+
+        for (int y = 0; y < destData.height; ++y)
+            rows[y] = (png_bytep) destData.getLinePointer (y);
+
+        const bool swapRedAndBlue = hasAlphaChan ? (PixelARGB::indexR != 0)
+                                                 : (PixelRGB::indexR != 0);
+
+        if (! readImageData (pngReadStruct, pngInfoStruct, errorJumpBuf, rows, hasAlphaChan, swapRedAndBlue))
+            return false;
+
+        if (hasAlphaChan)
+            for (int y = 0; y < destData.height; ++y)
+                premultiplyLine ((PixelARGB*) rows[y], destData.width);
+
+        return true;
+    }
+
+    static Image readImage (InputStream& in, png_structp pngReadStruct, png_infop pngInfoStruct, bool allowDirectDecoding)
     {
         jmp_buf errorJumpBuf;
         png_set_error_fn (pngReadStruct, &errorJumpBuf, errorCallback, warningCallback);
@@ -460,6 +536,28 @@ namespace PNGHelpers
         if (readHeader (in, pngReadStruct, pngInfoStruct, errorJumpBuf,
                         width, height, bitDepth, colorType, interlaceType))
         {
+            png_bytep trans_alpha = nullptr;
+            png_color_16p trans_color = nullptr;
+            int num_trans = 0;
+            png_get_tRNS (pngReadStruct, pngInfoStruct, &trans_alpha, &num_trans, &trans_color);
+
+            const bool hasAlphaChan = (colorType & PNG_COLOR_MASK_ALPHA) != 0 || num_trans != 0;
+
+            {
+                Image image (hasAlphaChan ? Image::ARGB : Image::RGB, (int) width, (int) height, false);
+                const Image::BitmapData destData (image, Image::BitmapData::writeOnly);
+
+                if (allowDirectDecoding && canDecodeDirectly (destData, hasAlphaChan))
+                {
+                    image.getProperties()->set ("originalImageHadAlpha", hasAlphaChan);
+
+                    if (readImageDataDirectly (pngReadStruct, pngInfoStruct, errorJumpBuf, destData, hasAlphaChan))
+                        return image;
+
+                    return {};
+                }
+            }
+
             // Load the image into a temp buffer..
             const size_t lineStride = width * 4;
             HeapBlock<uint8> tempBuffer (height * lineStride);
@@ -468,26 +566,21 @@ namespace PNGHelpers
             for (size_t y = 0; y < height; ++y)
                 rows[y] = (png_bytep) (tempBuffer + lineStride * y);
 
-            png_bytep trans_alpha = nullptr;
-            png_color_16p trans_color = nullptr;
-            int num_trans = 0;
-            png_get_tRNS (pngReadStruct, pngInfoStruct, &trans_alpha, &num_trans, &trans_color);
-
             if (readImageData (pngReadStruct, pngInfoStruct, errorJumpBuf, rows))
-                return createImageFromData ((colorType & PNG_COLOR_MASK_ALPHA) != 0 || num_trans != 0,
-                                            (int) width, (int) height, rows);
+                return createImageFromData (hasAlphaChan, (int) width, (int) height, rows);
         }
 
         return Image();
     }
 
-    static Image readImage (InputStream& in)
+    // (The direct decoding can be turned off, so that the tests can compare it with the conversion)
+    static Image readImage (InputStream& in, bool allowDirectDecoding = true)
     {
         if (png_structp pngReadStruct = png_create_read_struct (PNG_LIBPNG_VER_STRING, nullptr, nullptr, nullptr))
         {
             if (png_infop pngInfoStruct = png_create_info_struct (pngReadStruct))
             {
-                Image image (readImage (in, pngReadStruct, pngInfoStruct));
+                Image image (readImage (in, pngReadStruct, pngInfoStruct, allowDirectDecoding));
                 png_destroy_read_struct (&pngReadStruct, &pngInfoStruct, nullptr);
                 return image;
             }
@@ -616,4 +709,265 @@ bool PNGImageFormat::writeImageToStream (const Image& image, OutputStream& out)
     return true;
 }
 
+//==============================================================================
+#if JUCE_UNIT_TESTS && ! JUCE_USING_COREIMAGE_LOADER
+
+class PNGImageFormatTests  : public UnitTest
+{
+public:
+    PNGImageFormatTests()
+        : UnitTest ("PNGImageFormat", UnitTestCategories::graphics)
+    {}
+
+    void runTest() override
+    {
+        using namespace pnglibNamespace;
+
+        beginTest ("Round-tripping an image with alpha");
+        {
+            for (auto format : { Image::ARGB, Image::RGB })
+            {
+                Image image (format, 37, 23, true);
+
+                for (int y = 0; y < image.getHeight(); ++y)
+                    for (int x = 0; x < image.getWidth(); ++x)
+                        image.setPixelAt (x, y, Colour ((uint8) (x * 7), (uint8) (y * 11), (uint8) (x * y),
+                                                        (uint8) (y < 5 ? 255 : (x * 37 + y * 13) & 0xff)));
+
+                MemoryOutputStream out;
+                expect (PNGImageFormat().writeImageToStream (image, out));
+
+                auto decoded = decodeAndCompareWithConversion (out.getMemoryBlock());
+                expect (decoded.getFormat() == format);
+
+                const Image::BitmapData originalData (image, Image::BitmapData::readOnly);
+                const Image::BitmapData decodedData (decoded, Image::BitmapData::readOnly);
+
+                // (the colours are un-premultiplied when they're written, which is only approximate)
+                for (int y = 0; y < image.getHeight(); ++y)
+                {
+                    for (int x = 0; x < image.getWidth(); ++x)
+                    {
+                        auto original = getPixel (originalData, x, y);
+                        auto result = getPixel (decodedData, x, y);
+
+                        expectEquals ((int) result.getAlpha(), (int) original.getAlpha());
+                        expectWithinAbsoluteError ((int) result.getRed(),   (int) original.getRed(),   2);
+                        expectWithinAbsoluteError ((int) result.getGreen(), (int) original.getGreen(), 2);
+                        expectWithinAbsoluteError ((int) result.getBlue(),  (int) original.getBlue(),  2);
+                    }
+                }
+            }
+        }
+
+        beginTest ("Decoding grey, palette and transparent-colour files");
+        {
+            auto red   = [] (int x, int y) { return (uint8) (x * 7 + y); };
+            auto green = [] (int, int y) { return (uint8) (y * 11); };
+            auto blue  = [] (int x, int y) { return (uint8) (x * y); };
+            auto alpha = [] (int x, int y) { return (uint8) (y < 5 ? 255 : (x * 37 + y * 13) & 0xff); };
+
+            TestFile rgb (PNG_COLOR_TYPE_RGB);
+            rgb.getPixel = [&] (int x, int y) { return Colour (red (x, y), green (x, y), blue (x, y)); };
+            rgb.getSamples = [&] (int x, int y) { return Array<int> { red (x, y), green (x, y), blue (x, y) }; };
+            checkDecoding (rgb, false);
+
+            TestFile rgba (PNG_COLOR_TYPE_RGB_ALPHA);
+            rgba.getPixel = [&] (int x, int y) { return Colour (red (x, y), green (x, y), blue (x, y), alpha (x, y)); };
+            rgba.getSamples = [&] (int x, int y) { return Array<int> { red (x, y), green (x, y), blue (x, y), alpha (x, y) }; };
+            checkDecoding (rgba, true);
+
+            rgba.interlaced = true;
+            checkDecoding (rgba, true);
+
+            TestFile grey (PNG_COLOR_TYPE_GRAY);
+            grey.getPixel = [&] (int x, int y) { return Colour (red (x, y), red (x, y), red (x, y)); };
+            grey.getSamples = [&] (int x, int y) { return Array<int> { red (x, y) }; };
+            checkDecoding (grey, false);
+
+            TestFile sixteenBitGrey (PNG_COLOR_TYPE_GRAY, 16);
+            sixteenBitGrey.getPixel = grey.getPixel;
+            sixteenBitGrey.getSamples = [&] (int x, int y) { return Array<int> { red (x, y) * 256 + blue (x, y) }; };
+            checkDecoding (sixteenBitGrey, false);
+
+            TestFile greyAndAlpha (PNG_COLOR_TYPE_GRAY_ALPHA);
+            greyAndAlpha.getPixel = [&] (int x, int y) { return Colour (red (x, y), red (x, y), red (x, y), alpha (x, y)); };
+            greyAndAlpha.getSamples = [&] (int x, int y) { return Array<int> { red (x, y), alpha (x, y) }; };
+            checkDecoding (greyAndAlpha, true);
+
+            TestFile palette (PNG_COLOR_TYPE_PALETTE);
+
+            for (int i = 0; i < 256; ++i)
+                palette.palette.add ({ (png_byte) i, (png_byte) (255 - i), (png_byte) (i * 3) });
+
+            palette.getPixel = [&] (int x, int y) { auto i = red (x, y); return Colour (i, (uint8) (255 - i), (uint8) (i * 3)); };
+            palette.getSamples = [&] (int x, int y) { return Array<int> { red (x, y) }; };
+            checkDecoding (palette, false);
+
+            TestFile smallPalette (PNG_COLOR_TYPE_PALETTE, 4);
+
+            for (int i = 0; i < 16; ++i)
+            {
+                smallPalette.palette.add ({ (png_byte) (i * 16), (png_byte) (i * 5), (png_byte) (255 - i) });
+                smallPalette.transparency.add ((png_byte) (i * 17));
+            }
+
+            smallPalette.getPixel = [&] (int x, int y)
+            {
+                auto i = (x + y) % 16;
+                return Colour ((uint8) (i * 16), (uint8) (i * 5), (uint8) (255 - i), (uint8) (i * 17));
+            };
+
+            smallPalette.getSamples = [&] (int x, int y) { return Array<int> { (x + y) % 16 }; };
+            checkDecoding (smallPalette, true);
+
+            TestFile transparentColour (PNG_COLOR_TYPE_RGB);
+            transparentColour.transparentColour = std::make_unique<png_color_16> (png_color_16 { 0, 10, 20, 30, 0 });
+            transparentColour.getPixel = [&] (int x, int y) { return x == y ? Colours::transparentBlack : Colour (red (x, y), green (x, y), (uint8) 200); };
+            transparentColour.getSamples = [&] (int x, int y) { return x == y ? Array<int> { 10, 20, 30 } : Array<int> { red (x, y), green (x, y), 200 }; };
+            checkDecoding (transparentColour, true);
+        }
+    }
+
+private:
+    // JUCE's own writer only produces RGB and RGBA files, so these describe the other
+    // kinds of file, for writing with libpng directly
+    struct TestFile
+    {
+        TestFile (int type, int depth = 8) : colourType (type), bitDepth (depth) {}
+
+        int colourType, bitDepth;
+        bool interlaced = false;
+        int width = 37, height = 23;
+        std::function<Array<int> (int, int)> getSamples;
+        std::function<Colour (int, int)> getPixel;
+        Array<pnglibNamespace::png_color> palette;
+        Array<pnglibNamespace::png_byte> transparency;
+        std::unique_ptr<pnglibNamespace::png_color_16> transparentColour;
+
+        MemoryBlock write() const
+        {
+            using namespace pnglibNamespace;
+
+            MemoryOutputStream out;
+            auto pngWriteStruct = png_create_write_struct (PNG_LIBPNG_VER_STRING, nullptr, nullptr, nullptr);
+            auto pngInfoStruct = png_create_info_struct (pngWriteStruct);
+
+            png_set_write_fn (pngWriteStruct, &out, PNGHelpers::writeDataCallback, nullptr);
+            png_set_IHDR (pngWriteStruct, pngInfoStruct, (png_uint_32) width, (png_uint_32) height, bitDepth, colourType,
+                          interlaced ? PNG_INTERLACE_ADAM7 : PNG_INTERLACE_NONE,
+                          PNG_COMPRESSION_TYPE_BASE, PNG_FILTER_TYPE_BASE);
+
+            if (! palette.isEmpty())
+                png_set_PLTE (pngWriteStruct, pngInfoStruct, palette.getRawDataPointer(), palette.size());
+
+            if (! transparency.isEmpty() || transparentColour != nullptr)
+                png_set_tRNS (pngWriteStruct, pngInfoStruct, transparency.getRawDataPointer(), transparency.size(), transparentColour.get());
+
+            png_write_info (pngWriteStruct, pngInfoStruct);
+
+            if (bitDepth < 8)
+                png_set_packing (pngWriteStruct);
+
+            auto bytesPerSample = bitDepth > 8 ? 2 : 1;
+            MemoryBlock data;
+            HeapBlock<png_bytep> rows (height);
+
+            for (int y = 0; y < height; ++y)
+            {
+                for (int x = 0; x < width; ++x)
+                {
+                    for (auto sample : getSamples (x, y))
+                    {
+                        uint8 bytes[] = { (uint8) (sample >> 8), (uint8) sample };
+                        data.append (bytes + 2 - bytesPerSample, (size_t) bytesPerSample);
+                    }
+                }
+            }
+
+            auto lineStride = data.getSize() / (size_t) height;
+
+            for (int y = 0; y < height; ++y)
+                rows[y] = static_cast<png_bytep> (data.getData()) + lineStride * (size_t) y;
+
+            png_write_image (pngWriteStruct, rows);
+            png_write_end (pngWriteStruct, pngInfoStruct);
+            png_destroy_write_struct (&pngWriteStruct, &pngInfoStruct);
+
+            return out.getMemoryBlock();
+        }
+    };
+
+    static PixelARGB getPixel (const Image::BitmapData& data, int x, int y)
+    {
+        PixelARGB pixel;
+
+        if (data.pixelFormat == Image::ARGB)
+            pixel.set (*(const PixelARGB*) data.getPixelPointer (x, y));
+        else
+            pixel.set (*(const PixelRGB*) data.getPixelPointer (x, y));
+
+        return pixel;
+    }
+
+    void checkDecoding (const TestFile& file, bool shouldHaveAlpha)
+    {
+        auto image = decodeAndCompareWithConversion (file.write());
+
+        expectEquals (image.getWidth(), file.width);
+        expectEquals (image.getHeight(), file.height);
+        expect (image.hasAlphaChannel() == shouldHaveAlpha);
+
+        const Image::BitmapData data (image, Image::BitmapData::readOnly);
+        int numWrongPixels = 0;
+
+        for (int y = 0; y < data.height; ++y)
+        {
+            for (int x = 0; x < data.width; ++x)
+            {
+                if (getPixel (data, x, y).getNativeARGB() != file.getPixel (x, y).getPixelARGB().getNativeARGB())
+                    ++numWrongPixels;
+            }
+        }
+
+        expectEquals (numWrongPixels, 0);
+    }
+
+    // Decodes a file straight into its image, and checks that the result is identical to
+    // decoding it into a temporary buffer and converting it row by row
+    Image decodeAndCompareWithConversion (const MemoryBlock& data)
+    {
+        MemoryInputStream directStream (data, false), convertedStream (data, false);
+
+        auto direct = PNGImageFormat().decodeImage (directStream);
+        auto converted = PNGHelpers::readImage (convertedStream, false);
+
+        expect (direct.isValid() && converted.isValid());
+        expect (direct.getFormat() == converted.getFormat());
+        expect (direct.getBounds() == converted.getBounds());
+        expect (direct.getProperties()->getWithDefault ("originalImageHadAlpha", {})
+                  == converted.getProperties()->getWithDefault ("originalImageHadAlpha", {}));
+
+        if (direct.getFormat() == converted.getFormat() && direct.getBounds() == converted.getBounds())
+        {
+            const Image::BitmapData directData (direct, Image::BitmapData::readOnly);
+            const Image::BitmapData convertedData (converted, Image::BitmapData::readOnly);
+            int numDifferentPixels = 0;
+
+            for (int y = 0; y < directData.height; ++y)
+                for (int x = 0; x < directData.width; ++x)
+                    if (memcmp (directData.getPixelPointer (x, y), convertedData.getPixelPointer (x, y), (size_t) directData.pixelStride) != 0)
+                        ++numDifferentPixels;
+
+            expectEquals (numDifferentPixels, 0);
+        }
+
+        return direct;
+    }
+};
+
+static PNGImageFormatTests pngImageFormatTests;
+
+#endif
+
 } // namespace juce
@@ -34,15 +34,35 @@ struct ImageCache::Pimpl     : private Timer,
 
     JUCE_DECLARE_SINGLETON_SINGLETHREADED_MINIMAL (ImageCache::Pimpl)
 
-    Image getFromHashCode (const int64 hashCode) noexcept
+    // Images that were scaled to a target size are stored under their source's hash
+    // code along with that size, so that they can't be confused with each other, or
+    // with an image that was added with a user-defined hash code.
+    struct Key
+    {
+        int64 hashCode;
+        int width, height;
+
+        bool operator== (const Key& other) const noexcept
+        {
+            return hashCode == other.hashCode && width == other.width && height == other.height;
+        }
+    };
+
+    static Key getKey (int64 hashCode, int targetWidth = 0, int targetHeight = 0) noexcept
+    {
+        return { hashCode, jmax (0, targetWidth), jmax (0, targetHeight) };
+    }
+
+    Image getFromKey (const Key& key) noexcept
     {
         const ScopedLock sl (lock);
 
         for (auto& item : images)
         {
-            if (item.hashCode == hashCode)
+            if (item.key == key)
             {
                 item.lastUseTime = Time::getApproximateMillisecondCounter();
+                item.useOrder = ++lastUseOrder;
                 return item.image;
             }
         }
@@ -50,7 +70,15 @@ struct ImageCache::Pimpl     : private Timer,
         return {};
      }
 
-    void addImageToCache (const Image& image, const int64 hashCode)
+    static Image getFromCache (const Key& key)
+    {
+        if (auto* instance = getInstanceWithoutCreating())
+            return instance->getFromKey (key);
+
+        return {};
+    }
+
+    void addImageToCache (const Image& image, const Key& key)
     {
         if (image.isValid())
         {
@@ -58,7 +86,9 @@ struct ImageCache::Pimpl     : private Timer,
                 startTimer (2000);
 
             const ScopedLock sl (lock);
-            images.add ({ image, hashCode, Time::getApproximateMillisecondCounter() });
+            images.add ({ image, key, Time::getApproximateMillisecondCounter(), ++lastUseOrder, getImageSizeInBytes (image) });
+            totalBytes += images.getLast().numBytes;
+            applySizeLimit();
         }
     }
 
@@ -75,7 +105,7 @@ struct ImageCache::Pimpl     : private Timer,
             if (item.image.getReferenceCount() <= 1)
             {
                 if (now > item.lastUseTime + cacheTimeout || now < item.lastUseTime - 1000)
-                    images.remove (i);
+                    removeItem (i);
             }
             else
             {
@@ -83,6 +113,8 @@ struct ImageCache::Pimpl     : private Timer,
             }
         }
 
+        applySizeLimit();
+
         if (images.isEmpty())
             stopTimer();
     }
@@ -93,19 +125,151 @@ struct ImageCache::Pimpl     : private Timer,
 
         for (int i = images.size(); --i >= 0;)
             if (images.getReference(i).image.getReferenceCount() <= 1)
-                images.remove (i);
+                removeItem (i);
+    }
+
+    void setMaximumSize (size_t newMaximumBytes)
+    {
+        const ScopedLock sl (lock);
+        maximumBytes = newMaximumBytes;
+        applySizeLimit();
     }
 
+    //==============================================================================
+    Image loadAsync (const Key& key, std::function<Image()> decodeImage, ImageCache::LoadCallback callback)
+    {
+        jassert (MessageManager::getInstance()->isThisTheMessageThread());
+
+        auto image = getFromKey (key);
+
+        if (image.isValid())
+            return image;
+
+        for (auto& pending : pendingLoads)
+        {
+            if (pending.key == key)
+            {
+                if (callback != nullptr)
+                    pending.callbacks.add (std::move (callback));
+
+                return {};
+            }
+        }
+
+        PendingLoad pending { key, {} };
+
+        if (callback != nullptr)
+            pending.callbacks.add (std::move (callback));
+
+        pendingLoads.add (std::move (pending));
+
+        if (decodeThreads == nullptr)
+            decodeThreads.reset (new ThreadPool (jlimit (1, 4, SystemStats::getNumCpus() - 1)));
+
+        decodeThreads->addJob ([key, decodeImage]
+        {
+            auto decoded = decodeImage();
+
+            MessageManager::callAsync ([key, decoded]
+            {
+                if (auto* instance = getInstanceWithoutCreating())
+                    instance->asyncLoadFinished (key, decoded);
+            });
+        });
+
+        return {};
+    }
+
+    void asyncLoadFinished (const Key& key, const Image& image)
+    {
+        addImageToCache (image, key);
+
+        for (int i = 0; i < pendingLoads.size(); ++i)
+        {
+            if (pendingLoads.getReference (i).key == key)
+            {
+                auto callbacks = std::move (pendingLoads.getReference (i).callbacks);
+                pendingLoads.remove (i);
+
+                for (auto& c : callbacks)
+                    c (image);
+
+                break;
+            }
+        }
+    }
+
+    //==============================================================================
     struct Item
     {
         Image image;
-        int64 hashCode;
+        Key key;
         uint32 lastUseTime;
+        uint64 useOrder;
+        size_t numBytes;
+    };
+
+    struct PendingLoad
+    {
+        Key key;
+        Array<ImageCache::LoadCallback> callbacks;
     };
 
     Array<Item> images;
     CriticalSection lock;
     unsigned int cacheTimeout = 5000;
+    size_t totalBytes = 0, maximumBytes = 0;
+    uint64 lastUseOrder = 0;
+
+    Array<PendingLoad> pendingLoads;
+    std::unique_ptr<ThreadPool> decodeThreads;
+
+private:
+    static size_t getImageSizeInBytes (const Image& image) noexcept
+    {
+        auto bytesPerPixel = image.getFormat() == Image::SingleChannel ? 1
+                                                                       : (image.getFormat() == Image::RGB ? 3 : 4);
+
+        return (size_t) image.getWidth() * (size_t) image.getHeight() * (size_t) bytesPerPixel;
+    }
+
+    void removeItem (int index)
+    {
+        totalBytes -= images.getReference (index).numBytes;
+        images.remove (index);
+    }
+
+    // Releases the least-recently used images that nobody else is holding, until the
+    // cache is back within its size limit. (This goes by the order in which the images
+    // were used rather than the time, because the millisecond counter is too coarse to
+    // tell apart images that were loaded together).
+    void applySizeLimit()
+    {
+        if (maximumBytes == 0)
+            return;
+
+        while (totalBytes > maximumBytes)
+        {
+            int oldestIndex = -1;
+            auto oldestOrder = std::numeric_limits<uint64>::max();
+
+            for (int i = 0; i < images.size(); ++i)
+            {
+                auto& item = images.getReference (i);
+
+                if (item.image.getReferenceCount() <= 1 && item.useOrder < oldestOrder)
+                {
+                    oldestOrder = item.useOrder;
+                    oldestIndex = i;
+                }
+            }
+
+            if (oldestIndex < 0)
+                break;
+
+            removeItem (oldestIndex);
+        }
+    }
 
     JUCE_DECLARE_NON_COPYABLE (Pimpl)
 };
@@ -116,26 +280,28 @@ JUCE_IMPLEMENT_SINGLETON (ImageCache::Pimpl)
 //==============================================================================
 Image ImageCache::getFromHashCode (const int64 hashCode)
 {
-    if (Pimpl::getInstanceWithoutCreating() != nullptr)
-        return Pimpl::getInstanceWithoutCreating()->getFromHashCode (hashCode);
-
-    return {};
+    return Pimpl::getFromCache (Pimpl::getKey (hashCode));
 }
 
 void ImageCache::addImageToCache (const Image& image, const int64 hashCode)
 {
-    Pimpl::getInstance()->addImageToCache (image, hashCode);
+    Pimpl::getInstance()->addImageToCache (image, Pimpl::getKey (hashCode));
 }
 
 Image ImageCache::getFromFile (const File& file)
 {
-    auto hashCode = file.hashCode64();
-    auto image = getFromHashCode (hashCode);
+    return getFromFile (file, 0, 0);
+}
+
+Image ImageCache::getFromFile (const File& file, int targetWidth, int targetHeight)
+{
+    auto key = Pimpl::getKey (file.hashCode64(), targetWidth, targetHeight);
+    auto image = Pimpl::getFromCache (key);
 
     if (image.isNull())
     {
-        image = ImageFileFormat::loadFrom (file);
-        addImageToCache (image, hashCode);
+        image = ImageFileFormat::loadFrom (file, targetWidth, targetHeight);
+        Pimpl::getInstance()->addImageToCache (image, key);
     }
 
     return image;
@@ -143,27 +309,216 @@ Image ImageCache::getFromFile (const File& file)
 
 Image ImageCache::getFromMemory (const void* imageData, const int dataSize)
 {
-    auto hashCode = (int64) (pointer_sized_int) imageData;
-    auto image = getFromHashCode (hashCode);
+    return getFromMemory (imageData, dataSize, 0, 0);
+}
+
+Image ImageCache::getFromMemory (const void* imageData, const int dataSize, int targetWidth, int targetHeight)
+{
+    auto key = Pimpl::getKey ((int64) (pointer_sized_int) imageData, targetWidth, targetHeight);
+    auto image = Pimpl::getFromCache (key);
 
     if (image.isNull())
     {
-        image = ImageFileFormat::loadFrom (imageData, (size_t) dataSize);
-        addImageToCache (image, hashCode);
+        image = ImageFileFormat::loadFrom (imageData, (size_t) dataSize, targetWidth, targetHeight);
+        Pimpl::getInstance()->addImageToCache (image, key);
     }
 
     return image;
 }
 
+Image ImageCache::getFromFileAsync (const File& file, LoadCallback callback, int targetWidth, int targetHeight)
+{
+    return Pimpl::getInstance()->loadAsync (Pimpl::getKey (file.hashCode64(), targetWidth, targetHeight),
+                                            [file, targetWidth, targetHeight]
+                                            {
+                                                return ImageFileFormat::loadFrom (file, targetWidth, targetHeight);
+                                            },
+                                            std::move (callback));
+}
+
+Image ImageCache::getFromMemoryAsync (const void* imageData, int dataSize, LoadCallback callback,
+                                      int targetWidth, int targetHeight)
+{
+    return Pimpl::getInstance()->loadAsync (Pimpl::getKey ((int64) (pointer_sized_int) imageData, targetWidth, targetHeight),
+                                            [imageData, dataSize, targetWidth, targetHeight]
+                                            {
+                                                return ImageFileFormat::loadFrom (imageData, (size_t) dataSize,
+                                                                                  targetWidth, targetHeight);
+                                            },
+                                            std::move (callback));
+}
+
 void ImageCache::setCacheTimeout (const int millisecs)
 {
     jassert (millisecs >= 0);
     Pimpl::getInstance()->cacheTimeout = (unsigned int) millisecs;
 }
 
+void ImageCache::setMaximumCacheSize (size_t maximumBytes)
+{
+    Pimpl::getInstance()->setMaximumSize (maximumBytes);
+}
+
+size_t ImageCache::getCurrentCacheSize()
+{
+    if (auto* instance = Pimpl::getInstanceWithoutCreating())
+    {
+        const ScopedLock sl (instance->lock);
+        return instance->totalBytes;
+    }
+
+    return 0;
+}
+
 void ImageCache::releaseUnusedImages()
 {
     Pimpl::getInstance()->releaseUnusedImages();
 }
 
+//==============================================================================
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class ImageCacheTests  : public UnitTest
+{
+public:
+    ImageCacheTests()
+        : UnitTest ("ImageCache", UnitTestCategories::graphics)
+    {}
+
+    static MemoryBlock createPNG (int width, int height)
+    {
+        Image image (Image::ARGB, width, height, true);
+        image.clear (image.getBounds(), Colours::red);
+
+        MemoryOutputStream out;
+        PNGImageFormat().writeImageToStream (image, out);
+        return out.getMemoryBlock();
+    }
+
+    void runTest() override
+    {
+        // (the cache uses a timer and delivers asynchronous loads on the message thread)
+        MessageManager::getInstance();
+        ImageCache::releaseUnusedImages();
+
+        beginTest ("Scaled images have their own entries");
+        {
+            auto png = createPNG (64, 32);
+            auto* data = png.getData();
+            auto size = (int) png.getSize();
+
+            auto full = ImageCache::getFromMemory (data, size);
+            auto small = ImageCache::getFromMemory (data, size, 16, 8);
+            expect (full.getWidth() == 64 && small.getWidth() == 16);
+
+            // these are the hash codes that the scaled image used to be stored under..
+            auto hash = (int64) (pointer_sized_int) data;
+            ImageCache::addImageToCache (Image (Image::RGB, 3, 3, true), hash * 101 + (((int64) 16) << 24) + 8);
+
+            expect (ImageCache::getFromMemory (data, size, 16, 8) == small);
+            expect (ImageCache::getFromMemory (data, size) == full);
+            expect (ImageCache::getFromHashCode (hash) == full);
+
+            auto otherShape = ImageCache::getFromMemory (data, size, 8, 16);
+            expect (otherShape != small && otherShape.getWidth() == 32);
+        }
+
+        ImageCache::releaseUnusedImages();
+
+        beginTest ("Least-recently used images are released first");
+        {
+            auto addImage = [] (int64 hash)  { ImageCache::addImageToCache (Image (Image::ARGB, 10, 10, true), hash); };
+            auto isCached = [] (int64 hash)  { return ImageCache::getFromHashCode (hash).isValid(); };
+            const int64 a = 1001, b = 1002, c = 1003, d = 1004, e = 1005;
+
+            ImageCache::setMaximumCacheSize (3 * 400);
+            addImage (a);
+            addImage (b);
+            addImage (c);
+            expectEquals ((int) ImageCache::getCurrentCacheSize(), 3 * 400);
+
+            ImageCache::getFromHashCode (a);
+            addImage (d);
+            expect (! isCached (b));
+            expectEquals ((int) ImageCache::getCurrentCacheSize(), 3 * 400);
+
+            {
+                auto inUse = ImageCache::getFromHashCode (c);
+                expect (isCached (d)); // (which makes d more recent than a)
+                addImage (e);
+
+                // c is the oldest, but it can't go while it's being used, so a goes next
+                expect (! isCached (a));
+                expect (inUse.isValid() && isCached (d) && isCached (e));
+            }
+
+            expect (isCached (c));
+
+            ImageCache::setMaximumCacheSize (400);
+            expectEquals ((int) ImageCache::getCurrentCacheSize(), 400);
+            expect (isCached (c) && ! isCached (d) && ! isCached (e));
+
+            ImageCache::setMaximumCacheSize (0);
+        }
+
+        ImageCache::releaseUnusedImages();
+
+       #if JUCE_MODAL_LOOPS_PERMITTED
+        beginTest ("Asynchronous loading");
+        {
+            TemporaryFile tempFile (".png");
+            auto png = createPNG (40, 20);
+            expect (tempFile.getFile().replaceWithData (png.getData(), png.getSize()));
+            auto file = tempFile.getFile();
+
+            Array<Image> delivered;
+            auto callback = [&delivered] (const Image& image)
+            {
+                jassert (MessageManager::getInstance()->isThisTheMessageThread());
+                delivered.add (image);
+            };
+
+            expect (ImageCache::getFromFileAsync (file, callback).isNull());
+            expect (ImageCache::getFromFileAsync (file, callback).isNull());
+            expect (ImageCache::getFromFileAsync (file, callback, 10, 5).isNull());
+
+            auto endTime = Time::getMillisecondCounter() + 10000;
+
+            while (delivered.size() < 3 && Time::getMillisecondCounter() < endTime)
+                MessageManager::getInstance()->runDispatchLoopUntil (10);
+
+            expectEquals (delivered.size(), 3);
+
+            auto full = ImageCache::getFromFile (file);
+            auto small = ImageCache::getFromFile (file, 10, 5);
+            expect (full.getWidth() == 40 && small.getWidth() == 10);
+
+            for (auto& image : delivered)
+                expect (image == full || image == small);
+
+            // now that they're cached, they come straight back and the callback isn't used
+            expect (ImageCache::getFromFileAsync (file, callback) == full);
+            expect (ImageCache::getFromFileAsync (file, callback, 10, 5) == small);
+            MessageManager::getInstance()->runDispatchLoopUntil (20);
+            expectEquals (delivered.size(), 3);
+
+            auto missing = file.getSiblingFile ("doesnt_exist.png");
+            ImageCache::getFromFileAsync (missing, callback);
+
+            while (delivered.size() < 4 && Time::getMillisecondCounter() < endTime)
+                MessageManager::getInstance()->runDispatchLoopUntil (10);
+
+            expect (delivered.size() == 4 && delivered.getLast().isNull());
+        }
+
+        ImageCache::releaseUnusedImages();
+       #endif
+    }
+};
+
+static ImageCacheTests imageCacheTests;
+
+#endif
+
 } // namespace juce
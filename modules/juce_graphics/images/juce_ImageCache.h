@@ -80,6 +80,65 @@ public:
     */
     static Image getFromMemory (const void* imageData, int dataSize);
 
+    /** Loads an image from a file at a reduced size, (or just returns the image if it's already cached).
+
+        This is like getFromFile(), but if the image is bigger than it needs to be for drawing at
+        the given size, it's scaled down (preserving its aspect ratio) before being cached, which
+        can save a lot of memory for large images that only get drawn small. See
+        ImageFileFormat::decodeImageForSize() for how the target size is used.
+
+        Each target size is cached as a separate image.
+
+        @see getFromFile, ImageFileFormat::decodeImageForSize
+    */
+    static Image getFromFile (const File& file, int targetWidth, int targetHeight);
+
+    /** Loads an image from an in-memory image file at a reduced size, (or just returns the
+        image if it's already cached).
+
+        @see getFromMemory, getFromFile (const File&, int, int)
+    */
+    static Image getFromMemory (const void* imageData, int dataSize, int targetWidth, int targetHeight);
+
+    //==============================================================================
+    /** A callback that receives an image once an asynchronous load has completed.
+        If the image couldn't be loaded, it will be passed an invalid image.
+    */
+    using LoadCallback = std::function<void (const Image&)>;
+
+    /** Loads an image from a file on a background thread.
+
+        If the image is already in the cache, it's returned immediately and the callback isn't
+        used. Otherwise, this returns an invalid image as a placeholder, and the file is decoded
+        on one of the cache's background threads. When it has loaded, the image is added to the
+        cache and the callback is invoked on the message thread - typically you'd use it to
+        trigger a repaint of whatever needs the image.
+
+        If more than one request is made for the same image before it has loaded, it's only
+        decoded once, and all of the callbacks are invoked when it's ready.
+
+        This must be called on the message thread.
+
+        @param file             the file to load
+        @param callback         the function to call when the image is ready (may be nullptr)
+        @param targetWidth      if this or targetHeight is non-zero, the image will be reduced
+                                to this size, as for getFromFile (const File&, int, int)
+        @param targetHeight     if this or targetWidth is non-zero, the image will be reduced
+                                to this size, as for getFromFile (const File&, int, int)
+    */
+    static Image getFromFileAsync (const File& file, LoadCallback callback,
+                                   int targetWidth = 0, int targetHeight = 0);
+
+    /** Loads an image from an in-memory image file on a background thread.
+
+        The data must remain valid until the load has finished. See getFromFileAsync() for
+        details about how the callback is used.
+
+        @see getFromFileAsync
+    */
+    static Image getFromMemoryAsync (const void* imageData, int dataSize, LoadCallback callback,
+                                     int targetWidth = 0, int targetHeight = 0);
+
     //==============================================================================
     /** Checks the cache for an image with a particular hashcode.
 
@@ -108,6 +167,24 @@ public:
     */
     static void setCacheTimeout (int millisecs);
 
+    /** Sets a limit on the amount of memory used by the images in the cache.
+
+        When the total size of the cached images exceeds this limit, the least-recently used
+        images that aren't referenced anywhere else are released, without waiting for the cache
+        timeout. Images that are still in use elsewhere are never released, so the cache may
+        still exceed its limit if they are large enough.
+
+        Pass 0 to remove the limit (which is the default).
+
+        @see getCurrentCacheSize, setCacheTimeout
+    */
+    static void setMaximumCacheSize (size_t maximumBytes);
+
+    /** Returns the approximate number of bytes used by the images in the cache.
+        @see setMaximumCacheSize
+    */
+    static size_t getCurrentCacheSize();
+
     /** Releases any images in the cache that aren't being referenced by active
         Image objects.
     */
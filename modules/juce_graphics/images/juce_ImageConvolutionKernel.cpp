@@ -101,10 +101,294 @@ void ImageConvolutionKernel::createGaussianBlur (const float radius)
     setOverallSum (1.0f);
 }
 
+//==============================================================================
+namespace ConvolutionHelpers
+{
+    // Calls processRows (startRow, endRow) for bands of rows, spreading them across the
+    // thread pool (if there is one) and waiting for them all to finish.
+    template <typename RowProcessor>
+    static void processRowsInBands (ThreadPool* threadPool, int numRows, RowProcessor&& processRows)
+    {
+        const int minRowsPerBand = 32;
+
+        auto numBands = threadPool != nullptr ? jmin (threadPool->getNumThreads() + 1, numRows / minRowsPerBand) : 1;
+
+        if (numBands <= 1)
+        {
+            processRows (0, numRows);
+            return;
+        }
+
+        WaitableEvent finished;
+        Atomic<int> numBandsRemaining (numBands - 1);
+
+        for (int i = 1; i < numBands; ++i)
+        {
+            threadPool->addJob ([&, i]
+            {
+                processRows ((numRows * i) / numBands, (numRows * (i + 1)) / numBands);
+
+                if (--numBandsRemaining == 0)
+                    finished.signal();
+            });
+        }
+
+        processRows (0, numRows / numBands);
+        finished.wait();
+    }
+
+    //==============================================================================
+    // If the kernel is the outer product of a row and a column vector, this finds them.
+    static bool findSeparableComponents (const float* values, int size, float* row, float* column) noexcept
+    {
+        int pivotX = 0, pivotY = 0;
+        float largest = 0;
+
+        for (int y = 0; y < size; ++y)
+        {
+            for (int x = 0; x < size; ++x)
+            {
+                auto v = std::abs (values[x + y * size]);
+
+                if (v > largest)
+                {
+                    largest = v;
+                    pivotX = x;
+                    pivotY = y;
+                }
+            }
+        }
+
+        if (largest == 0)
+            return false;
+
+        auto pivot = values[pivotX + pivotY * size];
+
+        for (int i = 0; i < size; ++i)
+        {
+            row[i] = values[i + pivotY * size];
+            column[i] = values[pivotX + i * size] / pivot;
+        }
+
+        auto tolerance = largest * 1.0e-5f;
+
+        for (int y = 0; y < size; ++y)
+            for (int x = 0; x < size; ++x)
+                if (std::abs (values[x + y * size] - row[x] * column[y]) > tolerance)
+                    return false;
+
+        return true;
+    }
+
+    // sums[i] += multiplier * src[i]
+    static void addScaledLine (float* sums, const uint8* src, float multiplier, int num) noexcept
+    {
+        int i = 0;
+
+       #if JUCE_GRAPHICS_USE_SSE2
+        const auto zero = _mm_setzero_si128();
+        const auto mult = _mm_set1_ps (multiplier);
+
+        auto addFour = [&] (__m128i values, int offset)
+        {
+            auto* d = sums + i + offset;
+            _mm_storeu_ps (d, _mm_add_ps (_mm_loadu_ps (d), _mm_mul_ps (mult, _mm_cvtepi32_ps (values))));
+        };
+
+        for (; i + 16 <= num; i += 16)
+        {
+            auto bytes = _mm_loadu_si128 ((const __m128i*) (src + i));
+            auto lo = _mm_unpacklo_epi8 (bytes, zero);
+            auto hi = _mm_unpackhi_epi8 (bytes, zero);
+
+            addFour (_mm_unpacklo_epi16 (lo, zero), 0);
+            addFour (_mm_unpackhi_epi16 (lo, zero), 4);
+            addFour (_mm_unpacklo_epi16 (hi, zero), 8);
+            addFour (_mm_unpackhi_epi16 (hi, zero), 12);
+        }
+       #endif
+
+        for (; i < num; ++i)
+            sums[i] += multiplier * src[i];
+    }
+
+    static void applySeparableKernel (const Image::BitmapData& destData, const Image::BitmapData& srcData,
+                                      Rectangle<int> area, const float* rowValues, const float* columnValues,
+                                      int size, ThreadPool* threadPool)
+    {
+        auto numChannels = srcData.pixelStride;
+        auto centre = size >> 1;
+
+        // the range of source columns that can contribute to the destination area
+        auto startX = jmax (0, area.getX() - centre);
+        auto endX   = jmin (srcData.width, area.getRight() + size - centre - 1);
+        auto numValues = (endX - startX) * numChannels;
+
+        processRowsInBands (threadPool, area.getHeight(), [&] (int startRow, int endRow)
+        {
+            HeapBlock<float> columnSums ((size_t) numValues);
+
+            for (int row = startRow; row < endRow; ++row)
+            {
+                auto y = area.getY() + row;
+
+                // First convolve vertically into a line of floats..
+                zeromem (columnSums, sizeof (float) * (size_t) numValues);
+
+                for (int k = 0; k < size; ++k)
+                {
+                    auto sy = y + k - centre;
+
+                    if (sy >= 0 && sy < srcData.height && columnValues[k] != 0)
+                        addScaledLine (columnSums, srcData.getPixelPointer (startX, sy), columnValues[k], numValues);
+                }
+
+                // ..and then horizontally along that line
+                auto* dest = destData.getLinePointer (row);
+
+                for (int x = area.getX(); x < area.getRight(); ++x)
+                {
+                    auto firstK = jmax (0, startX - (x - centre));
+                    auto endK   = jmin (size, endX - (x - centre));
+                    auto* src = columnSums + (x - centre + firstK - startX) * numChannels;
+
+                   #if JUCE_GRAPHICS_USE_SSE2
+                    if (numChannels == 4)
+                    {
+                        auto total = _mm_setzero_ps();
+
+                        for (int k = firstK; k < endK; ++k, src += 4)
+                            total = _mm_add_ps (total, _mm_mul_ps (_mm_set1_ps (rowValues[k]), _mm_loadu_ps (src)));
+
+                        auto result = _mm_cvtps_epi32 (total);
+                        result = _mm_packs_epi32 (result, result);
+                        result = _mm_packus_epi16 (result, result);
+
+                        auto packed = (uint32) _mm_cvtsi128_si32 (result);
+                        memcpy (dest, &packed, 4);
+                        dest += 4;
+                        continue;
+                    }
+                   #endif
+
+                    float totals[4] = {};
+
+                    for (int k = firstK; k < endK; ++k, src += numChannels)
+                        for (int c = 0; c < numChannels; ++c)
+                            totals[c] += rowValues[k] * src[c];
+
+                    for (int c = 0; c < numChannels; ++c)
+                        *dest++ = (uint8) jlimit (0, 0xff, roundToInt (totals[c]));
+                }
+            }
+        });
+    }
+
+    //==============================================================================
+    // Works out the radii of three successive box blurs which together approximate a
+    // gaussian with the given standard deviation.
+    static void getBoxBlurRadii (float standardDeviation, int* radii) noexcept
+    {
+        const int numBoxes = 3;
+        auto variance = (double) standardDeviation * standardDeviation;
+
+        auto lowerWidth = (int) std::floor (std::sqrt (12.0 * variance / numBoxes + 1.0));
+
+        if ((lowerWidth & 1) == 0)
+            --lowerWidth;
+
+        auto numLower = roundToInt ((12.0 * variance - numBoxes * lowerWidth * lowerWidth - 4 * numBoxes * lowerWidth - 3 * numBoxes)
+                                       / (-4.0 * lowerWidth - 4.0));
+
+        for (int i = 0; i < numBoxes; ++i)
+            radii[i] = jmax (0, ((i < numLower ? lowerWidth : lowerWidth + 2) - 1) / 2);
+    }
+
+    static uint32 getBoxMultiplier (int radius) noexcept
+    {
+        auto width = (uint32) (radius * 2 + 1);
+        return ((1u << 24) + width / 2) / width;
+    }
+
+    static inline uint8 getBoxAverage (uint32 sum, uint32 multiplier) noexcept
+    {
+        return (uint8) ((sum * multiplier + (1u << 23)) >> 24);
+    }
+
+    // Box-blurs a line of pixels in place, treating anything beyond its ends as zero.
+    static void boxBlurLine (uint8* line, uint8* temp, int width, int numChannels, int radius) noexcept
+    {
+        memcpy (temp, line, (size_t) (width * numChannels));
+        auto multiplier = getBoxMultiplier (radius);
+
+        for (int c = 0; c < numChannels; ++c)
+        {
+            uint32 sum = 0;
+
+            for (int x = 0; x < jmin (radius, width); ++x)
+                sum += temp[x * numChannels + c];
+
+            for (int x = 0; x < width; ++x)
+            {
+                if (x + radius < width)
+                    sum += temp[(x + radius) * numChannels + c];
+
+                line[x * numChannels + c] = getBoxAverage (sum, multiplier);
+
+                if (x - radius >= 0)
+                    sum -= temp[(x - radius) * numChannels + c];
+            }
+        }
+    }
+
+    // Box-blurs a band of rows vertically, from one block of rows into another, treating
+    // anything above or below the block as zero.
+    static void boxBlurColumns (uint8* dest, const uint8* source, int lineStride, int numRows,
+                                int startRow, int endRow, int radius)
+    {
+        auto multiplier = getBoxMultiplier (radius);
+
+        HeapBlock<uint32> sums ((size_t) lineStride, true);
+
+        for (int y = jmax (0, startRow - radius); y < jmin (numRows, startRow + radius); ++y)
+        {
+            auto* src = source + y * lineStride;
+
+            for (int i = 0; i < lineStride; ++i)
+                sums[i] += src[i];
+        }
+
+        for (int y = startRow; y < endRow; ++y)
+        {
+            if (y + radius < numRows)
+            {
+                auto* src = source + (y + radius) * lineStride;
+
+                for (int i = 0; i < lineStride; ++i)
+                    sums[i] += src[i];
+            }
+
+            auto* d = dest + y * lineStride;
+
+            for (int i = 0; i < lineStride; ++i)
+                d[i] = getBoxAverage (sums[i], multiplier);
+
+            if (y - radius >= 0)
+            {
+                auto* src = source + (y - radius) * lineStride;
+
+                for (int i = 0; i < lineStride; ++i)
+                    sums[i] -= src[i];
+            }
+        }
+    }
+}
+
 //==============================================================================
 void ImageConvolutionKernel::applyToImage (Image& destImage,
                                            const Image& sourceImage,
-                                           const Rectangle<int>& destinationArea) const
+                                           const Rectangle<int>& destinationArea,
+                                           ThreadPool* threadPool) const
 {
     if (sourceImage == destImage)
     {
@@ -126,6 +410,29 @@ void ImageConvolutionKernel::applyToImage (Image& destImage,
     if (area.isEmpty())
         return;
 
+    // (when working in-place, the pixels must be read from a copy, or they'd be
+    // overwritten before their neighbours have finished using them)
+    const Image source (sourceImage == destImage ? sourceImage.createCopy() : sourceImage);
+
+    {
+        // Most useful kernels (including gaussian blurs) are separable, so can be applied as
+        // a vertical pass followed by a horizontal one, which is O (size) per pixel rather than O (size^2)
+        HeapBlock<float> row ((size_t) size), column ((size_t) size);
+
+        if (ConvolutionHelpers::findSeparableComponents (values, size, row, column))
+        {
+            const Image::BitmapData srcData (source, Image::BitmapData::readOnly);
+            const Image::BitmapData destData (destImage, area.getX(), area.getY(), area.getWidth(), area.getHeight(),
+                                              Image::BitmapData::writeOnly);
+
+            if (srcData.pixelStride == destData.pixelStride && srcData.pixelStride <= 4)
+            {
+                ConvolutionHelpers::applySeparableKernel (destData, srcData, area, row, column, size, threadPool);
+                return;
+            }
+        }
+    }
+
     auto right = area.getRight();
     auto bottom = area.getBottom();
 
@@ -133,7 +440,7 @@ void ImageConvolutionKernel::applyToImage (Image& destImage,
                                       Image::BitmapData::writeOnly);
     uint8* line = destData.data;
 
-    const Image::BitmapData srcData (sourceImage, Image::BitmapData::readOnly);
+    const Image::BitmapData srcData (source, Image::BitmapData::readOnly);
 
     if (destData.pixelStride == 4)
     {
@@ -279,7 +586,7 @@ void ImageConvolutionKernel::applyToImage (Image& destImage,
                             }
                             else
                             {
-                                src += 3;
+                                ++src;
                             }
 
                             ++sx;
@@ -293,4 +600,339 @@ void ImageConvolutionKernel::applyToImage (Image& destImage,
     }
 }
 
+//==============================================================================
+void ImageConvolutionKernel::applyGaussianBlur (Image& image, float standardDeviation, ThreadPool* threadPool)
+{
+    if (! image.isValid() || standardDeviation <= 0)
+        return;
+
+    image.duplicateIfShared();
+
+    int radii[3];
+    ConvolutionHelpers::getBoxBlurRadii (standardDeviation, radii);
+
+    const Image::BitmapData data (image, Image::BitmapData::readWrite);
+    auto numChannels = data.pixelStride;
+
+    // Each pass spreads the image outwards by its radius, and the later passes need to see
+    // what was spread beyond the edges, so the lines are blurred with enough margin around
+    // them to hold everything. Otherwise the edges would come out too dark.
+    for (auto& radius : radii)
+        radius = jmin (radius, 0xffff);
+
+    auto margin = radii[0] + radii[1] + radii[2];
+    auto lineStride = data.width * numChannels;
+    auto marginBytes = (size_t) (margin * numChannels);
+    auto extendedWidth = data.width + margin * 2;
+
+    ConvolutionHelpers::processRowsInBands (threadPool, data.height, [&] (int startRow, int endRow)
+    {
+        HeapBlock<uint8> line ((size_t) (extendedWidth * numChannels), true), temp ((size_t) (extendedWidth * numChannels));
+
+        for (int y = startRow; y < endRow; ++y)
+        {
+            memcpy (line + marginBytes, data.getLinePointer (y), (size_t) lineStride);
+            zeromem (line, marginBytes);
+            zeromem (line + marginBytes + lineStride, marginBytes);
+
+            for (auto radius : radii)
+                if (radius > 0)
+                    ConvolutionHelpers::boxBlurLine (line, temp, extendedWidth, numChannels, radius);
+
+            memcpy (data.getLinePointer (y), line + marginBytes, (size_t) lineStride);
+        }
+    });
+
+    auto extendedHeight = data.height + margin * 2;
+    HeapBlock<uint8> rows ((size_t) (lineStride * extendedHeight), true), blurredRows ((size_t) (lineStride * extendedHeight));
+
+    for (int y = 0; y < data.height; ++y)
+        memcpy (rows + (y + margin) * lineStride, data.getLinePointer (y), (size_t) lineStride);
+
+    for (auto radius : radii)
+    {
+        if (radius <= 0)
+            continue;
+
+        ConvolutionHelpers::processRowsInBands (threadPool, extendedHeight, [&] (int startRow, int endRow)
+        {
+            ConvolutionHelpers::boxBlurColumns (blurredRows, rows, lineStride, extendedHeight, startRow, endRow, radius);
+        });
+
+        rows.swapWith (blurredRows);
+    }
+
+    for (int y = 0; y < data.height; ++y)
+        memcpy (data.getLinePointer (y), rows + (y + margin) * lineStride, (size_t) lineStride);
+}
+
+
+//==============================================================================
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class ImageConvolutionKernelTests  : public UnitTest
+{
+public:
+    ImageConvolutionKernelTests()
+        : UnitTest ("ImageConvolutionKernel", UnitTestCategories::graphics)
+    {}
+
+    void runTest() override
+    {
+        auto r = getRandom();
+        const Image::PixelFormat formats[] = { Image::ARGB, Image::RGB, Image::SingleChannel };
+
+        beginTest ("Separable kernels match a 2-D convolution");
+        {
+            for (auto format : formats)
+            {
+                for (int i = 0; i < 10; ++i)
+                {
+                    auto source = createRandomImage (r, format, 1 + r.nextInt (80), 1 + r.nextInt (80));
+                    auto kernel = createRandomKernel (r, true);
+                    auto area = createRandomArea (r, source.getBounds());
+
+                    Image expected (source.createCopy());
+                    applyReferenceConvolution (*kernel, expected, source, area);
+
+                    Image result (source.createCopy());
+                    kernel->applyToImage (result, source, area);
+                    expect (getMaxDifference (result, expected) <= 1);
+
+                    kernel->applyToImage (source, source, area);
+                    expect (getMaxDifference (source, expected) <= 1);
+                }
+            }
+        }
+
+        beginTest ("Non-separable kernels");
+        {
+            for (auto format : formats)
+            {
+                for (int i = 0; i < 4; ++i)
+                {
+                    auto source = createRandomImage (r, format, 1 + r.nextInt (40), 1 + r.nextInt (40));
+                    auto kernel = createRandomKernel (r, false);
+                    auto area = createRandomArea (r, source.getBounds());
+
+                    Image expected (source.createCopy());
+                    applyReferenceConvolution (*kernel, expected, source, area);
+
+                    kernel->applyToImage (source, source, area);
+                    expect (getMaxDifference (source, expected) <= 1);
+                }
+            }
+        }
+
+        beginTest ("Using a thread pool gives the same results");
+        {
+            ThreadPool pool (3);
+
+            for (auto format : formats)
+            {
+                auto source = createRandomImage (r, format, 150 + r.nextInt (50), 150 + r.nextInt (100));
+                auto kernel = createRandomKernel (r, true);
+                auto area = createRandomArea (r, source.getBounds()).getUnion ({ 0, 0, 10, 140 });
+
+                Image withoutPool (source.createCopy()), withPool (source.createCopy());
+                kernel->applyToImage (withoutPool, source, area);
+                kernel->applyToImage (withPool, source, area, &pool);
+                expectEquals (getMaxDifference (withoutPool, withPool), 0);
+
+                auto blurredWithoutPool = source.createCopy();
+                auto blurredWithPool = source.createCopy();
+                auto standardDeviation = 0.5f + r.nextFloat() * 20.0f;
+                ImageConvolutionKernel::applyGaussianBlur (blurredWithoutPool, standardDeviation);
+                ImageConvolutionKernel::applyGaussianBlur (blurredWithPool, standardDeviation, &pool);
+                expectEquals (getMaxDifference (blurredWithoutPool, blurredWithPool), 0);
+            }
+        }
+
+        beginTest ("Box blur edges");
+        {
+            for (auto format : formats)
+            {
+                for (auto standardDeviation : { 0.3f, 1.0f, 2.5f, 6.0f, 30.0f })
+                {
+                    // (some of these are smaller than the blur, which then reaches past both edges)
+                    auto image = createRandomImage (r, format, 1 + r.nextInt (60), 1 + r.nextInt (60));
+                    auto expected = image.createCopy();
+                    applyReferenceBoxBlur (expected, standardDeviation);
+
+                    ImageConvolutionKernel::applyGaussianBlur (image, standardDeviation);
+                    expect (getMaxDifference (image, expected) <= 1);
+                }
+            }
+
+            // pixels beyond the edges count as transparent black, so a uniform image fades
+            // towards its edges, to about a quarter of its level in the corners
+            Image image (Image::SingleChannel, 100, 100, false);
+            image.clear (image.getBounds(), Colours::white.withAlpha ((uint8) 200));
+            ImageConvolutionKernel::applyGaussianBlur (image, 5.0f);
+
+            const Image::BitmapData data (image, Image::BitmapData::readOnly);
+            expectEquals ((int) *data.getPixelPointer (50, 50), 200);
+            expectEquals ((int) *data.getPixelPointer (0, 50), (int) *data.getPixelPointer (50, 0));
+            expectWithinAbsoluteError ((int) *data.getPixelPointer (0, 50), 100, 8);
+            expectWithinAbsoluteError ((int) *data.getPixelPointer (99, 99), 50, 8);
+        }
+    }
+
+private:
+    static Image createRandomImage (Random& r, Image::PixelFormat format, int width, int height)
+    {
+        Image image (format, width, height, false, SoftwareImageType());
+        const Image::BitmapData data (image, Image::BitmapData::writeOnly);
+
+        for (int y = 0; y < height; ++y)
+        {
+            auto* line = data.getLinePointer (y);
+
+            for (int i = 0; i < width * data.pixelStride; ++i)
+                line[i] = (uint8) r.nextInt (256);
+        }
+
+        return image;
+    }
+
+    static std::unique_ptr<ImageConvolutionKernel> createRandomKernel (Random& r, bool separable)
+    {
+        auto size = (separable ? 1 : 2) + r.nextInt (8);
+        std::unique_ptr<ImageConvolutionKernel> kernel (new ImageConvolutionKernel (size));
+
+        if (separable && r.nextBool())
+        {
+            kernel->createGaussianBlur (0.5f + r.nextFloat() * (float) size);
+            return kernel;
+        }
+
+        Array<float> row, column;
+
+        for (int i = 0; i < size; ++i)
+        {
+            row.add (r.nextFloat());
+            column.add (r.nextFloat());
+        }
+
+        for (int y = 0; y < size; ++y)
+            for (int x = 0; x < size; ++x)
+                kernel->setKernelValue (x, y, separable ? row[x] * column[y] : r.nextFloat());
+
+        kernel->setOverallSum (1.0f);
+        return kernel;
+    }
+
+    // An area that may be partly outside the image
+    static Rectangle<int> createRandomArea (Random& r, Rectangle<int> imageBounds)
+    {
+        return { r.nextInt (imageBounds.getWidth()) - 10, r.nextInt (imageBounds.getHeight()) - 10,
+                 1 + r.nextInt (imageBounds.getWidth() + 20), 1 + r.nextInt (imageBounds.getHeight() + 20) };
+    }
+
+    static int getMaxDifference (const Image& a, const Image& b)
+    {
+        const Image::BitmapData dataA (a, Image::BitmapData::readOnly);
+        const Image::BitmapData dataB (b, Image::BitmapData::readOnly);
+        int maxDifference = 0;
+
+        for (int y = 0; y < dataA.height; ++y)
+            for (int i = 0; i < dataA.width * dataA.pixelStride; ++i)
+                maxDifference = jmax (maxDifference, std::abs (dataA.getLinePointer (y)[i] - dataB.getLinePointer (y)[i]));
+
+        return maxDifference;
+    }
+
+    // The straightforward 2-D convolution, which visits every kernel cell for each pixel
+    static void applyReferenceConvolution (const ImageConvolutionKernel& kernel, Image& dest,
+                                           const Image& source, Rectangle<int> area)
+    {
+        area = area.getIntersection (dest.getBounds());
+
+        const Image::BitmapData srcData (source, Image::BitmapData::readOnly);
+        const Image::BitmapData destData (dest, Image::BitmapData::readWrite);
+        auto size = kernel.getKernelSize();
+        auto centre = size >> 1;
+
+        for (int y = area.getY(); y < area.getBottom(); ++y)
+        {
+            for (int x = area.getX(); x < area.getRight(); ++x)
+            {
+                for (int c = 0; c < destData.pixelStride; ++c)
+                {
+                    float total = 0;
+
+                    for (int yy = 0; yy < size; ++yy)
+                    {
+                        for (int xx = 0; xx < size; ++xx)
+                        {
+                            auto sx = x + xx - centre;
+                            auto sy = y + yy - centre;
+
+                            if (isPositiveAndBelow (sx, srcData.width) && isPositiveAndBelow (sy, srcData.height))
+                                total += kernel.getKernelValue (xx, yy) * srcData.getPixelPointer (sx, sy)[c];
+                        }
+                    }
+
+                    destData.getPixelPointer (x, y)[c] = (uint8) jlimit (0, 0xff, roundToInt (total));
+                }
+            }
+        }
+    }
+
+    // Three box blurs in each direction, averaging over the whole of each window, as if
+    // the image were surrounded by an infinite area of zeros.
+    static void applyReferenceBoxBlur (Image& image, float standardDeviation)
+    {
+        int radii[3];
+        ConvolutionHelpers::getBoxBlurRadii (standardDeviation, radii);
+        auto margin = radii[0] + radii[1] + radii[2];
+
+        const Image::BitmapData data (image, Image::BitmapData::readWrite);
+
+        auto blurLine = [&] (uint8* start, int num, int stride)
+        {
+            Array<int> values;
+            values.insertMultiple (0, 0, num + margin * 2);
+
+            for (int i = 0; i < num; ++i)
+                values.set (i + margin, start[i * stride]);
+
+            for (auto radius : radii)
+            {
+                if (radius <= 0)
+                    continue;
+
+                auto original = values;
+
+                for (int i = 0; i < values.size(); ++i)
+                {
+                    int sum = 0;
+
+                    for (int j = jmax (0, i - radius); j <= jmin (values.size() - 1, i + radius); ++j)
+                        sum += original[j];
+
+                    values.set (i, roundToInt (sum / (double) (radius * 2 + 1)));
+                }
+            }
+
+            for (int i = 0; i < num; ++i)
+                start[i * stride] = (uint8) values[i + margin];
+        };
+
+        for (int c = 0; c < data.pixelStride; ++c)
+        {
+            for (int y = 0; y < data.height; ++y)
+                blurLine (data.getPixelPointer (0, y) + c, data.width, data.pixelStride);
+
+            for (int x = 0; x < data.width; ++x)
+                blurLine (data.getPixelPointer (x, 0) + c, data.height, data.lineStride);
+        }
+    }
+};
+
+static ImageConvolutionKernelTests imageConvolutionKernelTests;
+
+#endif
+
 } // namespace juce
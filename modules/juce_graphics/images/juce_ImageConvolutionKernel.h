@@ -96,10 +96,32 @@ public:
                                 the destination, but if different, it must be exactly the same
                                 size and format.
         @param destinationArea  the region of the image to apply the filter to
+        @param threadPool       if this is non-null, the rows of the image will be split into
+                                bands that are processed by the pool's threads. This only
+                                happens for kernels that are separable (like a gaussian blur),
+                                and the method still blocks until all the rows are done.
     */
     void applyToImage (Image& destImage,
                        const Image& sourceImage,
-                       const Rectangle<int>& destinationArea) const;
+                       const Rectangle<int>& destinationArea,
+                       ThreadPool* threadPool = nullptr) const;
+
+    //==============================================================================
+    /** Applies a fast approximation of a gaussian blur to an image, in-place.
+
+        Rather than convolving the image with a kernel, this performs three successive
+        box blurs horizontally and vertically, which is visually very close to a true
+        gaussian, and takes the same time regardless of the blur radius. Pixels beyond
+        the edges of the image are treated as being transparent black.
+
+        @param image                the image to blur - any format is supported
+        @param standardDeviation    the standard deviation of the gaussian, in pixels
+        @param threadPool           if this is non-null, bands of rows will be processed in
+                                    parallel by the pool's threads. The method still blocks
+                                    until the whole image has been blurred.
+    */
+    static void applyGaussianBlur (Image& image, float standardDeviation,
+                                   ThreadPool* threadPool = nullptr);
 
 private:
     //==============================================================================
@@ -75,6 +75,40 @@ ImageFileFormat* ImageFileFormat::findImageFormatForFileExtension (const File& f
     return nullptr;
 }
 
+//==============================================================================
+Image ImageFileFormat::decodeImageForSize (InputStream& input, int targetWidth, int targetHeight)
+{
+    return reduceToTargetSize (decodeImage (input), targetWidth, targetHeight);
+}
+
+Image ImageFileFormat::reduceToTargetSize (const Image& image, int targetWidth, int targetHeight)
+{
+    if (image.isNull())
+        return image;
+
+    auto bounds = getReducedBounds (image.getBounds(), targetWidth, targetHeight);
+
+    if (bounds == image.getBounds())
+        return image;
+
+    return image.rescaled (bounds.getWidth(), bounds.getHeight(), Graphics::highResamplingQuality);
+}
+
+Rectangle<int> ImageFileFormat::getReducedBounds (Rectangle<int> imageBounds, int targetWidth, int targetHeight)
+{
+    if (imageBounds.isEmpty() || (targetWidth <= 0 && targetHeight <= 0))
+        return imageBounds;
+
+    auto scale = jmax (targetWidth  > 0 ? targetWidth  / (double) imageBounds.getWidth()  : 0.0,
+                       targetHeight > 0 ? targetHeight / (double) imageBounds.getHeight() : 0.0);
+
+    if (scale >= 1.0)
+        return imageBounds;
+
+    return { jmax (1, roundToInt (imageBounds.getWidth()  * scale)),
+             jmax (1, roundToInt (imageBounds.getHeight() * scale)) };
+}
+
 //==============================================================================
 Image ImageFileFormat::loadFrom (InputStream& input)
 {
@@ -108,4 +142,36 @@ Image ImageFileFormat::loadFrom (const void* rawData, const size_t numBytes)
     return Image();
 }
 
+Image ImageFileFormat::loadFrom (InputStream& input, int targetWidth, int targetHeight)
+{
+    if (ImageFileFormat* format = findImageFormatForStream (input))
+        return format->decodeImageForSize (input, targetWidth, targetHeight);
+
+    return Image();
+}
+
+Image ImageFileFormat::loadFrom (const File& file, int targetWidth, int targetHeight)
+{
+    FileInputStream stream (file);
+
+    if (stream.openedOk())
+    {
+        BufferedInputStream b (stream, 8192);
+        return loadFrom (b, targetWidth, targetHeight);
+    }
+
+    return Image();
+}
+
+Image ImageFileFormat::loadFrom (const void* rawData, const size_t numBytes, int targetWidth, int targetHeight)
+{
+    if (rawData != nullptr && numBytes > 4)
+    {
+        MemoryInputStream stream (rawData, numBytes, false);
+        return loadFrom (stream, targetWidth, targetHeight);
+    }
+
+    return Image();
+}
+
 } // namespace juce
@@ -84,6 +84,27 @@ public:
     */
     virtual Image decodeImage (InputStream& input) = 0;
 
+    /** Tries to decode an image that will only be needed at a reduced size.
+
+        This returns the image scaled down (preserving its aspect ratio) so that it's no
+        smaller than the target width and height. If either target dimension is zero, only
+        the other one is used, and if the image is already smaller than the target, it's
+        returned at its original size.
+
+        The default implementation decodes the whole image and then scales it down, but
+        formats which are able to decode directly at a lower resolution can override it to
+        avoid the cost of decoding all the original pixels.
+
+        @param input            the stream to read the data from (see decodeImage())
+        @param targetWidth      the width at which the image will be used, or 0 if only
+                                the height matters
+        @param targetHeight     the height at which the image will be used, or 0 if only
+                                the width matters
+        @returns                the image that was decoded, or an invalid image if it fails.
+        @see decodeImage, loadFrom
+    */
+    virtual Image decodeImageForSize (InputStream& input, int targetWidth, int targetHeight);
+
     //==============================================================================
     /** Attempts to write an image to a stream.
 
@@ -137,6 +158,41 @@ public:
     */
     static Image loadFrom (const void* rawData,
                            size_t numBytesOfData);
+
+    /** Tries to load an image from a stream, decoding it at a reduced size if it's
+        bigger than needed.
+
+        @see decodeImageForSize
+    */
+    static Image loadFrom (InputStream& input, int targetWidth, int targetHeight);
+
+    /** Tries to load an image from a file, decoding it at a reduced size if it's
+        bigger than needed.
+
+        @see decodeImageForSize
+    */
+    static Image loadFrom (const File& file, int targetWidth, int targetHeight);
+
+    /** Tries to load an image from a block of raw image data, decoding it at a reduced
+        size if it's bigger than needed.
+
+        @see decodeImageForSize
+    */
+    static Image loadFrom (const void* rawData, size_t numBytesOfData,
+                           int targetWidth, int targetHeight);
+
+protected:
+    //==============================================================================
+    /** Returns a copy of an image, scaled down so that it's no smaller than the target size.
+        If the image is already small enough, it is returned unchanged.
+        @see decodeImageForSize
+    */
+    static Image reduceToTargetSize (const Image& image, int targetWidth, int targetHeight);
+
+    /** Returns the size that reduceToTargetSize() would give an image of the given size.
+        @see decodeImageForSize
+    */
+    static Rectangle<int> getReducedBounds (Rectangle<int> imageBounds, int targetWidth, int targetHeight);
 };
 
 //==============================================================================
@@ -191,6 +247,7 @@ public:
     bool usesFileExtension (const File&) override;
     bool canUnderstand (InputStream&) override;
     Image decodeImage (InputStream&) override;
+    Image decodeImageForSize (InputStream&, int targetWidth, int targetHeight) override;
     bool writeImageToStream (const Image&, OutputStream&) override;
 
 private:
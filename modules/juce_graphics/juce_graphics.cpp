@@ -92,6 +92,13 @@
 
 #undef SIZEOF
 
+#if JUCE_INTEL && (defined (__SSE2__) || defined (_M_X64) || (defined (_M_IX86_FP) && _M_IX86_FP >= 2))
+ #include <emmintrin.h>
+ #define JUCE_GRAPHICS_USE_SSE2 1
+#else
+ #define JUCE_GRAPHICS_USE_SSE2 0
+#endif
+
 #if (JUCE_MAC || JUCE_IOS) && USE_COREGRAPHICS_RENDERING && JUCE_USE_COREIMAGE_LOADER
  #define JUCE_USING_COREIMAGE_LOADER 1
 #else
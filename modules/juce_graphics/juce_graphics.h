@@ -104,6 +104,7 @@ namespace juce
     class Image;
     class AffineTransform;
     class Path;
+    class PathStrokeType;
     class Font;
     class Graphics;
     class FillType;
@@ -266,6 +266,12 @@ private:
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (GlyphCache)
 };
 
+/** Empties the cache of laid-out strings that the Graphics text-drawing methods use.
+    This is defined alongside the Graphics class, and gets called whenever the
+    typeface cache is cleared, so that no stale glyphs are left behind.
+*/
+void clearGlyphArrangementCache();
+
 //==============================================================================
 /** Caches a glyph as an edge-table.
 
@@ -307,6 +313,250 @@ public:
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (CachedGlyphEdgeTable)
 };
 
+//==============================================================================
+/** Holds a cache of recently-used path edge-tables, so that shapes which get
+    redrawn repeatedly (icons, knob outlines, etc) don't need to be flattened and
+    rasterised again every time they're painted.
+
+    The tables are stored without the whole-pixel part of their translation, so a
+    shape that has only been moved by an integer amount can reuse its entry.
+
+    @tags{Graphics}
+*/
+class PathEdgeTableCache  : private DeletedAtShutdown
+{
+public:
+    PathEdgeTableCache()
+    {
+        entries.insertMultiple (0, {}, numEntries);
+        recentMisses.insertMultiple (0, 0, numEntries * 4);
+    }
+
+    ~PathEdgeTableCache() override
+    {
+        getSingletonPointer() = nullptr;
+    }
+
+    static PathEdgeTableCache& getInstance()
+    {
+        auto& c = getSingletonPointer();
+
+        if (c == nullptr)
+            c = new PathEdgeTableCache();
+
+        return *c;
+    }
+
+    //==============================================================================
+    struct CachedEdgeTable  : public ReferenceCountedObject
+    {
+        using Ptr = ReferenceCountedObjectPtr<CachedEdgeTable>;
+
+        Path path;
+        PathStrokeType strokeType { 0.0f };
+        AffineTransform pathTransform, transform;
+        uint32 hash = 0, lastAccessCount = 0;
+        bool isStroke = false;
+        std::unique_ptr<EdgeTable> edgeTable;
+    };
+
+    /** Removes the whole-pixel part of a transform's translation, and returns it. */
+    static Point<int> removeIntegerTranslation (AffineTransform& t) noexcept
+    {
+        Point<int> offset ((int) std::floor (t.getTranslationX()),
+                           (int) std::floor (t.getTranslationY()));
+
+        t = t.translated ((float) -offset.x, (float) -offset.y);
+        return offset;
+    }
+
+    /** Returns the edge-table for a filled path, rendering it if it isn't already in the cache.
+        The transform must have had its integer translation removed with removeIntegerTranslation().
+        Returns nullptr if the path isn't suitable for caching.
+    */
+    CachedEdgeTable::Ptr getFilledPath (const Path& path, const AffineTransform& transform)
+    {
+        return findOrCreate (path, nullptr, {}, transform, 1.0f);
+    }
+
+    /** Returns the edge-table for a stroked path, rendering it if it isn't already in the cache.
+        The pathTransform is applied to the path before it's stroked, and the transform (which
+        must have had its integer translation removed) is applied to the resulting outline.
+        Returns nullptr if the path isn't suitable for caching.
+    */
+    CachedEdgeTable::Ptr getStrokedPath (const Path& path, const PathStrokeType& strokeType,
+                                         const AffineTransform& pathTransform, const AffineTransform& transform,
+                                         float extraAccuracy)
+    {
+        return findOrCreate (path, &strokeType, pathTransform, transform, extraAccuracy);
+    }
+
+private:
+    enum
+    {
+        numEntries = 64,
+        maxElementsPerPath = 256,
+        maxTableHeight = 1024
+    };
+
+    Array<CachedEdgeTable::Ptr> entries;
+    Array<uint32> recentMisses;
+    int nextMissIndex = 0;
+    uint32 accessCounter = 0;
+    CriticalSection lock;
+
+    CachedEdgeTable::Ptr findOrCreate (const Path& path, const PathStrokeType* strokeType,
+                                       const AffineTransform& pathTransform, const AffineTransform& transform,
+                                       float extraAccuracy)
+    {
+        uint32 hash = 0;
+
+        // Anything more complicated than this is probably a waveform or some other kind of
+        // path that changes on every repaint, so wouldn't benefit from being cached.
+        if (! getPathHash (path, hash))
+            return {};
+
+        addToHash (hash, transform.mat00, transform.mat01, transform.mat02,
+                   transform.mat10, transform.mat11, transform.mat12);
+
+        if (strokeType != nullptr)
+        {
+            addToHash (hash, strokeType->getStrokeThickness(),
+                       pathTransform.mat00, pathTransform.mat01, pathTransform.mat02,
+                       pathTransform.mat10, pathTransform.mat11, pathTransform.mat12);
+
+            hash = hash * 31 + (uint32) strokeType->getJointStyle() * 7 + (uint32) strokeType->getEndStyle();
+        }
+
+        {
+            const ScopedLock sl (lock);
+
+            for (auto& e : entries)
+            {
+                if (e != nullptr && e->hash == hash
+                     && e->isStroke == (strokeType != nullptr)
+                     && e->transform == transform
+                     && (strokeType == nullptr || (e->strokeType == *strokeType && e->pathTransform == pathTransform))
+                     && e->path == path)
+                {
+                    e->lastAccessCount = ++accessCounter;
+                    return e;
+                }
+            }
+
+            // Only shapes that get drawn more than once are worth caching - this stops
+            // a stream of one-off shapes from pushing the useful entries out of the cache.
+            if (! recentMisses.contains (hash))
+            {
+                recentMisses.getReference (nextMissIndex) = hash;
+                nextMissIndex = (nextMissIndex + 1) % recentMisses.size();
+                return {};
+            }
+        }
+
+        CachedEdgeTable::Ptr newEntry (new CachedEdgeTable());
+        newEntry->path = path;
+        newEntry->transform = transform;
+        newEntry->hash = hash;
+
+        if (strokeType != nullptr)
+        {
+            Path stroke;
+            strokeType->createStrokedPath (stroke, path, pathTransform, extraAccuracy);
+
+            newEntry->isStroke = true;
+            newEntry->strokeType = *strokeType;
+            newEntry->pathTransform = pathTransform;
+
+            if (! createTable (*newEntry, stroke, transform))
+                return {};
+        }
+        else if (! createTable (*newEntry, path, transform))
+        {
+            return {};
+        }
+
+        const ScopedLock sl (lock);
+        newEntry->lastAccessCount = ++accessCounter;
+        entries.getReference (findLeastRecentlyUsedIndex()) = newEntry;
+        return newEntry;
+    }
+
+    static bool createTable (CachedEdgeTable& entry, const Path& path, const AffineTransform& transform)
+    {
+        auto area = path.getBoundsTransformed (transform).getSmallestIntegerContainer().expanded (1, 0);
+
+        if (area.getHeight() > maxTableHeight)
+            return false;
+
+        entry.edgeTable.reset (new EdgeTable (area, path, transform));
+        entry.edgeTable->optimiseTable();
+        return true;
+    }
+
+    static void addToHash (uint32& hash, float value) noexcept
+    {
+        uint32 bits;
+        memcpy (&bits, &value, sizeof (bits));
+        hash = hash * 31 + bits;
+    }
+
+    template <typename... OtherValues>
+    static void addToHash (uint32& hash, float value, OtherValues... others) noexcept
+    {
+        addToHash (hash, value);
+        addToHash (hash, others...);
+    }
+
+    static bool getPathHash (const Path& path, uint32& hash) noexcept
+    {
+        Path::Iterator i (path);
+        int numElements = 0;
+
+        while (i.next())
+        {
+            if (++numElements > maxElementsPerPath)
+                return false;
+
+            hash = hash * 31 + (uint32) i.elementType;
+            addToHash (hash, i.x1, i.y1, i.x2, i.y2, i.x3, i.y3);
+        }
+
+        hash = hash * 31 + (path.isUsingNonZeroWinding() ? 1u : 0u);
+        return numElements > 0;
+    }
+
+    int findLeastRecentlyUsedIndex() const noexcept
+    {
+        int oldestIndex = 0;
+        auto oldestCounter = std::numeric_limits<uint32>::max();
+
+        for (int i = 0; i < entries.size(); ++i)
+        {
+            auto* e = entries.getReference (i).get();
+
+            if (e == nullptr)
+                return i;
+
+            if (e->lastAccessCount < oldestCounter)
+            {
+                oldestCounter = e->lastAccessCount;
+                oldestIndex = i;
+            }
+        }
+
+        return oldestIndex;
+    }
+
+    static PathEdgeTableCache*& getSingletonPointer() noexcept
+    {
+        static PathEdgeTableCache* c = nullptr;
+        return c;
+    }
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (PathEdgeTableCache)
+};
+
 //==============================================================================
 /** Calculates the alpha values and positions for rendering the edges of a
     non-pixel-aligned rectangle.
@@ -1628,6 +1878,7 @@ struct ClipRegions
         EdgeTableRegion (const RectangleList<int>& r)   : edgeTable (r) {}
         EdgeTableRegion (const RectangleList<float>& r) : edgeTable (r) {}
         EdgeTableRegion (Rectangle<int> bounds, const Path& p, const AffineTransform& t) : edgeTable (bounds, p, t) {}
+        EdgeTableRegion (Rectangle<int> bounds, const Path& p, const AffineTransform& t, const PathStrokeType& st) : edgeTable (bounds, p, t, st) {}
 
         EdgeTableRegion (const EdgeTableRegion& other)  : Base(), edgeTable (other.edgeTable) {}
         EdgeTableRegion& operator= (const EdgeTableRegion&) = delete;
@@ -2328,10 +2579,60 @@ public:
             auto clipRect = clip->getClipBounds();
 
             if (path.getBoundsTransformed (trans).getSmallestIntegerContainer().intersects (clipRect))
-                fillShape (*new EdgeTableRegionType (clipRect, path, trans), false);
+            {
+                auto untranslated = trans;
+                auto offset = PathEdgeTableCache::removeIntegerTranslation (untranslated);
+
+                if (auto cached = PathEdgeTableCache::getInstance().getFilledPath (path, untranslated))
+                    fillCachedEdgeTable (*cached->edgeTable, offset);
+                else
+                    fillShape (*new EdgeTableRegionType (clipRect, path, trans), false);
+            }
+        }
+    }
+
+    void strokePath (const Path& path, const PathStrokeType& strokeType, const AffineTransform& t)
+    {
+        if (clip != nullptr)
+        {
+            auto scale = transform.getPhysicalPixelScaleFactor();
+
+            // Polylines can be rasterised straight from their points, as long as the stroke
+            // thickness doesn't get distorted by our transform..
+            if ((transform.isOnlyTranslated
+                  || (! transform.isRotated && transform.complexTransform.mat00 == transform.complexTransform.mat11))
+                 && EdgeTable::canStrokeDirectly (path, strokeType))
+            {
+                PathStrokeType scaledStroke (strokeType.getStrokeThickness() * scale,
+                                             strokeType.getJointStyle(), strokeType.getEndStyle());
+
+                fillShape (*new EdgeTableRegionType (clip->getClipBounds(), path,
+                                                     transform.getTransformWith (t), scaledStroke), false);
+                return;
+            }
+
+            auto untranslated = transform.getTransform();
+            auto offset = PathEdgeTableCache::removeIntegerTranslation (untranslated);
+
+            if (auto cached = PathEdgeTableCache::getInstance().getStrokedPath (path, strokeType, t, untranslated, scale))
+            {
+                fillCachedEdgeTable (*cached->edgeTable, offset);
+                return;
+            }
+
+            Path stroke;
+            strokeType.createStrokedPath (stroke, path, t, scale);
+            fillPath (stroke, {});
         }
     }
 
+    void fillCachedEdgeTable (const EdgeTable& edgeTable, Point<int> offset)
+    {
+        auto* region = new EdgeTableRegionType (edgeTable);
+        region->edgeTable.translate ((float) offset.x, offset.y);
+        fillShape (*region, false);
+    }
+
     void fillEdgeTable (const EdgeTable& edgeTable, float x, int y)
     {
         if (clip != nullptr)
@@ -2721,6 +3022,8 @@ public:
     void fillRect (const Rectangle<float>& r) override                           { stack->fillRect (r); }
     void fillRectList (const RectangleList<float>& list) override                { stack->fillRectList (list); }
     void fillPath (const Path& path, const AffineTransform& t) override          { stack->fillPath (path, t); }
+    void strokePath (const Path& path, const PathStrokeType& st,
+                     const AffineTransform& t) override                          { stack->strokePath (path, st, t); }
     void drawImage (const Image& im, const AffineTransform& t) override          { stack->drawImage (im, t); }
     void drawGlyph (int glyphNumber, const AffineTransform& t) override          { stack->drawGlyph (glyphNumber, t); }
     void drawLine (const Line<float>& line) override                             { stack->drawLine (line); }